@@ -20,7 +20,7 @@ android {
 
         externalNativeBuild {
             cmake {
-                cppFlags += "-std=c++17"
+                cppFlags += "-std=c++20"
                 arguments += "-DANDROID_STL=c++_shared"
             }
         }
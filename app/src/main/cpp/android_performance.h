@@ -0,0 +1,108 @@
+#ifndef ANDROID_PERFORMANCE_H
+#define ANDROID_PERFORMANCE_H
+
+#include <dlfcn.h>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include "thermal_governor.h"
+
+/**
+ * thermal::Platform backed by the NDK thermal (API 30+) and performance hint
+ * (ADPF, API 33+) APIs.
+ *
+ * The app's minSdk predates both, so entry points are resolved from
+ * libandroid.so at runtime; whatever is missing degrades to "unknown"
+ * readings and no-op hints.
+ */
+namespace thermal {
+
+class AndroidPlatform : public Platform {
+public:
+    /** @param renderThreadId Thread whose work the hint session describes (gettid()) */
+    explicit AndroidPlatform(int32_t renderThreadId) {
+        library_ = dlopen("libandroid.so", RTLD_NOW | RTLD_LOCAL);
+        if (library_ == nullptr) return;
+
+        acquireThermal_ = reinterpret_cast<AcquireThermalFn>(dlsym(library_, "AThermal_acquireManager"));
+        releaseThermal_ = reinterpret_cast<ReleaseThermalFn>(dlsym(library_, "AThermal_releaseManager"));
+        getStatus_ = reinterpret_cast<GetStatusFn>(dlsym(library_, "AThermal_getCurrentThermalStatus"));
+        getHeadroom_ = reinterpret_cast<GetHeadroomFn>(dlsym(library_, "AThermal_getThermalHeadroom"));
+        if (acquireThermal_ != nullptr && releaseThermal_ != nullptr) {
+            thermalManager_ = acquireThermal_();
+        }
+
+        auto getHintManager = reinterpret_cast<GetHintManagerFn>(dlsym(library_, "APerformanceHint_getManager"));
+        auto createSession = reinterpret_cast<CreateSessionFn>(dlsym(library_, "APerformanceHint_createSession"));
+        updateTarget_ = reinterpret_cast<UpdateTargetFn>(dlsym(library_, "APerformanceHint_updateTargetWorkDuration"));
+        reportActual_ = reinterpret_cast<ReportActualFn>(dlsym(library_, "APerformanceHint_reportActualWorkDuration"));
+        closeSession_ = reinterpret_cast<CloseSessionFn>(dlsym(library_, "APerformanceHint_closeSession"));
+        if (getHintManager != nullptr && createSession != nullptr && updateTarget_ != nullptr &&
+            reportActual_ != nullptr && closeSession_ != nullptr) {
+            void* manager = getHintManager();
+            if (manager != nullptr) {
+                const int32_t tids[] = {renderThreadId};
+                session_ = createSession(manager, tids, 1, INITIAL_TARGET_NANOS);
+            }
+        }
+    }
+
+    ~AndroidPlatform() override {
+        if (session_ != nullptr) closeSession_(session_);
+        if (thermalManager_ != nullptr) releaseThermal_(thermalManager_);
+        if (library_ != nullptr) dlclose(library_);
+    }
+
+    AndroidPlatform(const AndroidPlatform&) = delete;
+    AndroidPlatform& operator=(const AndroidPlatform&) = delete;
+
+    bool hasThermal() const { return thermalManager_ != nullptr; }
+    bool hasHintSession() const { return session_ != nullptr; }
+
+    float thermalHeadroom(int forecastSeconds) override {
+        if (thermalManager_ == nullptr || getHeadroom_ == nullptr) return std::numeric_limits<float>::quiet_NaN();
+        return getHeadroom_(thermalManager_, forecastSeconds);  // NaN if unsupported or polled too often
+    }
+
+    Status thermalStatus() override {
+        if (thermalManager_ == nullptr || getStatus_ == nullptr) return Status::Unknown;
+        return static_cast<Status>(getStatus_(thermalManager_));
+    }
+
+    void updateTargetWorkDuration(int64_t nanos) override {
+        if (session_ != nullptr) updateTarget_(session_, nanos);
+    }
+
+    void reportActualWorkDuration(int64_t nanos) override {
+        if (session_ != nullptr) reportActual_(session_, nanos);
+    }
+
+private:
+    static constexpr int64_t INITIAL_TARGET_NANOS = 1000000000LL / 60;
+
+    // Manager and session types are opaque; void* keeps this free of API-level guards
+    using AcquireThermalFn = void* (*)();
+    using ReleaseThermalFn = void (*)(void*);
+    using GetStatusFn = int (*)(void*);
+    using GetHeadroomFn = float (*)(void*, int);
+    using GetHintManagerFn = void* (*)();
+    using CreateSessionFn = void* (*)(void*, const int32_t*, size_t, int64_t);
+    using UpdateTargetFn = int (*)(void*, int64_t);
+    using ReportActualFn = int (*)(void*, int64_t);
+    using CloseSessionFn = void (*)(void*);
+
+    void* library_ = nullptr;
+    AcquireThermalFn acquireThermal_ = nullptr;
+    ReleaseThermalFn releaseThermal_ = nullptr;
+    GetStatusFn getStatus_ = nullptr;
+    GetHeadroomFn getHeadroom_ = nullptr;
+    UpdateTargetFn updateTarget_ = nullptr;
+    ReportActualFn reportActual_ = nullptr;
+    CloseSessionFn closeSession_ = nullptr;
+    void* thermalManager_ = nullptr;
+    void* session_ = nullptr;
+};
+
+} // namespace thermal
+
+#endif // ANDROID_PERFORMANCE_H
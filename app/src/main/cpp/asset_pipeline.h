@@ -0,0 +1,267 @@
+#ifndef ASSET_PIPELINE_H
+#define ASSET_PIPELINE_H
+
+#include <algorithm>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include "job_system.h"
+
+/**
+ * Coroutine building blocks for loading assets off the render thread.
+ *
+ * A load is a coroutine returning Load that moves between threads with
+ * co_await as it goes through its stages:
+ *
+ *   auto ticket = group.join();                         // tracked for shutdown
+ *   auto memory = co_await budget.reserve(bytes);       // bounded bytes in flight
+ *   co_await resumeOn(jobs::shared());                  // I/O and decode on a worker
+ *   co_await timeline.nextFrame();                      // render thread: upload
+ *   co_await timeline.reached(framesUsingOldData);      // old GPU data idle: free it
+ *
+ * The render thread calls FrameTimeline::advance() once per frame after its
+ * fence wait; that is where finished loads hand their results over and
+ * where GPU-side waits complete. Loads start eagerly and free their frame
+ * when they finish.
+ */
+namespace assets {
+
+/** Coroutine type of a detached load. */
+struct Load {
+    struct promise_type {
+        Load get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::abort(); }
+    };
+};
+
+/**
+ * Counts loads in flight so shutdown can drain them. A load takes a Ticket
+ * as its first local, so the ticket is released after every other local.
+ */
+class LoadGroup {
+public:
+    class Ticket {
+    public:
+        explicit Ticket(LoadGroup* group) : group_(group) { group_->inFlight_.fetch_add(1); }
+        ~Ticket() { group_->inFlight_.fetch_sub(1); }
+        Ticket(const Ticket&) = delete;
+        Ticket& operator=(const Ticket&) = delete;
+
+    private:
+        LoadGroup* group_;
+    };
+
+    Ticket join() { return Ticket(this); }
+    int inFlight() const { return inFlight_.load(); }
+
+private:
+    std::atomic<int> inFlight_{0};
+};
+
+/** Awaitable: continue on a job system worker. */
+struct ResumeOn {
+    jobs::JobSystem& system;
+    jobs::Priority priority;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) {
+        system.post(priority, [](void* address, size_t, size_t) {
+            std::coroutine_handle<>::from_address(address).resume();
+        }, handle.address());
+    }
+    void await_resume() const noexcept {}
+};
+
+inline ResumeOn resumeOn(jobs::JobSystem& system, jobs::Priority priority = jobs::Priority::Background) {
+    return {system, priority};
+}
+
+/**
+ * Async semaphore over bytes. Loads reserve what they will hold before
+ * reading; when the budget is spent they queue in FIFO order and resume on
+ * the thread that releases enough. A request larger than the whole budget
+ * is granted once nothing else is held, so it cannot stall forever.
+ */
+class MemoryBudget {
+public:
+    explicit MemoryBudget(size_t limitBytes) : limit_(limitBytes) {}
+
+    MemoryBudget(const MemoryBudget&) = delete;
+    MemoryBudget& operator=(const MemoryBudget&) = delete;
+
+    /** Held bytes, returned to the budget on destruction or release(). */
+    class Reservation {
+    public:
+        Reservation() = default;
+        Reservation(MemoryBudget* owner, size_t bytes) : owner_(owner), bytes_(bytes) {}
+        Reservation(Reservation&& other) noexcept : owner_(other.owner_), bytes_(other.bytes_) {
+            other.owner_ = nullptr;
+        }
+        Reservation& operator=(Reservation&& other) noexcept {
+            if (this != &other) {
+                release();
+                owner_ = other.owner_;
+                bytes_ = other.bytes_;
+                other.owner_ = nullptr;
+            }
+            return *this;
+        }
+        ~Reservation() { release(); }
+
+        void release() {
+            if (owner_ != nullptr) owner_->release(bytes_);
+            owner_ = nullptr;
+        }
+        size_t bytes() const { return owner_ != nullptr ? bytes_ : 0; }
+
+    private:
+        MemoryBudget* owner_ = nullptr;
+        size_t bytes_ = 0;
+    };
+
+    class Awaiter {
+    public:
+        Awaiter(MemoryBudget& budget, size_t bytes) : budget_(budget), bytes_(bytes) {}
+
+        bool await_ready() { return false; }
+        bool await_suspend(std::coroutine_handle<> handle) {
+            handle_ = handle;
+            std::lock_guard<std::mutex> lock(budget_.mutex_);
+            if (budget_.waiters_.empty() && budget_.fits(bytes_)) {
+                budget_.inUse_ += bytes_;
+                return false;
+            }
+            budget_.waiters_.push_back(this);
+            return true;
+        }
+        Reservation await_resume() { return Reservation(&budget_, bytes_); }
+
+    private:
+        friend class MemoryBudget;
+        MemoryBudget& budget_;
+        size_t bytes_;
+        std::coroutine_handle<> handle_;
+    };
+
+    Awaiter reserve(size_t bytes) { return Awaiter(*this, bytes); }
+
+    size_t limit() const { return limit_; }
+    size_t inUse() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return inUse_;
+    }
+    size_t waiting() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return waiters_.size();
+    }
+
+private:
+    bool fits(size_t bytes) const { return inUse_ == 0 || inUse_ + bytes <= limit_; }
+
+    void release(size_t bytes) {
+        std::vector<std::coroutine_handle<>> ready;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            inUse_ -= bytes;
+            while (!waiters_.empty() && fits(waiters_.front()->bytes_)) {
+                inUse_ += waiters_.front()->bytes_;
+                ready.push_back(waiters_.front()->handle_);
+                waiters_.pop_front();
+            }
+        }
+        for (auto handle : ready) handle.resume();
+    }
+
+    const size_t limit_;
+    mutable std::mutex mutex_;
+    size_t inUse_ = 0;
+    std::deque<Awaiter*> waiters_;
+};
+
+/**
+ * Frames completed by the GPU, as seen by the render thread. Coroutines
+ * wait here to run on the render thread (nextFrame) or until frames that
+ * may still read old data have finished (reached). Waiters resume inside
+ * advance(), on the render thread.
+ */
+class FrameTimeline {
+public:
+    FrameTimeline() = default;
+    FrameTimeline(const FrameTimeline&) = delete;
+    FrameTimeline& operator=(const FrameTimeline&) = delete;
+
+    class Awaiter {
+    public:
+        Awaiter(FrameTimeline& timeline, uint64_t frames, bool nextFrame)
+            : timeline_(timeline), frames_(frames), nextFrame_(nextFrame) {}
+
+        bool await_ready() const { return !nextFrame_ && timeline_.completed() >= frames_; }
+        bool await_suspend(std::coroutine_handle<> handle) {
+            handle_ = handle;
+            std::lock_guard<std::mutex> lock(timeline_.mutex_);
+            if (!nextFrame_ && timeline_.completed_ >= frames_) return false;
+            timeline_.waiters_.push_back(this);
+            return true;
+        }
+        void await_resume() const noexcept {}
+
+    private:
+        friend class FrameTimeline;
+        FrameTimeline& timeline_;
+        uint64_t frames_;
+        bool nextFrame_;
+        std::coroutine_handle<> handle_;
+    };
+
+    /** Resume once at least `frames` frames have completed. */
+    Awaiter reached(uint64_t frames) { return Awaiter(*this, frames, false); }
+
+    /** Resume on the render thread at the next advance(). */
+    Awaiter nextFrame() { return Awaiter(*this, 0, true); }
+
+    uint64_t completed() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return completed_;
+    }
+
+    size_t waiting() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return waiters_.size();
+    }
+
+    /**
+     * Render thread, once per frame: record completed frames and resume
+     * waiters that are due. Waiters added while resuming wait for the next
+     * call.
+     */
+    void advance(uint64_t completedFrames) {
+        std::vector<std::coroutine_handle<>> due;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            completed_ = std::max(completed_, completedFrames);
+            auto keep = std::stable_partition(waiters_.begin(), waiters_.end(), [this](const Awaiter* w) {
+                return !w->nextFrame_ && w->frames_ > completed_;
+            });
+            for (auto it = keep; it != waiters_.end(); ++it) due.push_back((*it)->handle_);
+            waiters_.erase(keep, waiters_.end());
+        }
+        for (auto handle : due) handle.resume();
+    }
+
+private:
+    mutable std::mutex mutex_;
+    uint64_t completed_ = 0;
+    std::vector<Awaiter*> waiters_;
+};
+
+} // namespace assets
+
+#endif // ASSET_PIPELINE_H
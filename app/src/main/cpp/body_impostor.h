@@ -0,0 +1,129 @@
+#ifndef BODY_IMPOSTOR_H
+#define BODY_IMPOSTOR_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include "dso.h"
+
+/**
+ * Sphere impostors for the Sun, Moon and planets.
+ *
+ * Each body is one 40-byte instance drawn as a single screen-facing quad
+ * (four vertices, triangle strip). body.vert sizes the quad to the body's
+ * angular radius and moves the sunlight into the quad's frame; body.frag
+ * intersects the view ray with the sphere per pixel and shades the lit
+ * phase with limb darkening. Discs stay round and sharp at any zoom without
+ * sphere meshes.
+ *
+ * Glyph space, as in dso.h: the limb is the unit circle, x toward east and
+ * y toward north, and z toward the observer.
+ */
+namespace bodies {
+
+constexpr double AU_KM = 149597870.7;
+
+// Instance flags
+constexpr uint32_t FLAG_EMISSIVE = 1u << 0;  // Shines by itself (the Sun): no phase
+
+/** Per-instance vertex data; layout must match the attributes in body.vert. */
+struct Instance {
+    float x, y, z;                 // Unit direction of the center (equatorial)
+    float radius;                  // Angular radius (radians)
+    float lightX, lightY, lightZ;  // Unit direction from the body toward the Sun
+    float limbDarkening;           // Linear coefficient u: I = 1 - u (1 - mu)
+    uint32_t color;                // RGBA8, R in the low byte
+    uint32_t flags;
+};
+static_assert(sizeof(Instance) == 40, "Instance must stay 40 bytes (see body.vert)");
+
+/** Angular radius (radians) of a sphere of radiusKm at distanceAu. */
+inline float angularRadius(double radiusKm, double distanceAu) {
+    const double ratio = radiusKm / (distanceAu * AU_KM);
+    return static_cast<float>(std::asin(std::min(1.0, ratio)));
+}
+
+/**
+ * Build an instance from ephemeris values.
+ *
+ * @param dir Unit direction of the body from the observer
+ * @param sun Unit direction of the Sun from the observer
+ * @param argb Catalog color, as for dso::packColor
+ */
+inline Instance makeInstance(const float dir[3], double distanceAu, double radiusKm,
+                             const float sun[3], double sunDistanceAu,
+                             float limbDarkening, uint32_t argb, uint32_t flags) {
+    Instance inst;
+    inst.x = dir[0];
+    inst.y = dir[1];
+    inst.z = dir[2];
+    inst.radius = angularRadius(radiusKm, distanceAu);
+    inst.limbDarkening = std::clamp(limbDarkening, 0.0f, 1.0f);
+    inst.color = dso::packColor(argb);
+    inst.flags = flags;
+
+    // Sunlight comes from the Sun's position relative to the body, not the observer
+    double light[3];
+    double length2 = 0.0;
+    for (int i = 0; i < 3; i++) {
+        light[i] = sun[i] * sunDistanceAu - dir[i] * distanceAu;
+        length2 += light[i] * light[i];
+    }
+    const double length = std::sqrt(length2);
+    if (length > 0.0) {
+        inst.lightX = static_cast<float>(light[0] / length);
+        inst.lightY = static_cast<float>(light[1] / length);
+        inst.lightZ = static_cast<float>(light[2] / length);
+    } else {
+        inst.lightX = inst.lightY = inst.lightZ = 0.0f;
+    }
+    return inst;
+}
+
+/** Fraction of the disc that is lit, from the phase angle (1 = full). */
+inline float illuminatedFraction(const Instance& inst) {
+    if (inst.flags & FLAG_EMISSIVE) return 1.0f;
+    // cos(phase angle) = light . (toward the observer) = -(light . dir)
+    const float cosPhase = -(inst.lightX * inst.x + inst.lightY * inst.y + inst.lightZ * inst.z);
+    return 0.5f * (1.0f + cosPhase);
+}
+
+/** Sunlight in glyph space, as body.vert passes it to body.frag. */
+inline void localLight(const Instance& inst, float out[3]) {
+    float north[3], east[3];
+    dso::tangentFrame(inst.x, inst.y, inst.z, north, east);
+    const float light[3] = {inst.lightX, inst.lightY, inst.lightZ};
+    const float dir[3] = {inst.x, inst.y, inst.z};
+    out[0] = out[1] = out[2] = 0.0f;
+    for (int i = 0; i < 3; i++) {
+        out[0] += light[i] * east[i];
+        out[1] += light[i] * north[i];
+        out[2] -= light[i] * dir[i];
+    }
+}
+
+/**
+ * Relative brightness at glyph point (u, v) of the disc; mirrors body.frag
+ * except for its antialiasing and faint night-side floor. Lit bodies follow
+ * Lommel-Seeliger (flat at full phase, like the Moon) times linear limb
+ * darkening; emissive ones only darken toward the limb.
+ *
+ * @return Brightness in [0, 1]; 0 off the disc or on the night side
+ */
+inline float shade(const Instance& inst, float u, float v) {
+    const float r2 = u * u + v * v;
+    if (r2 > 1.0f) return 0.0f;
+    const float mu = std::sqrt(1.0f - r2);
+    const float limb = 1.0f - inst.limbDarkening * (1.0f - mu);
+    if (inst.flags & FLAG_EMISSIVE) return limb;
+
+    float light[3];
+    localLight(inst, light);
+    const float mu0 = u * light[0] + v * light[1] + mu * light[2];
+    if (mu0 <= 0.0f) return 0.0f;
+    return std::min(1.0f, 2.0f * mu0 / (mu0 + mu)) * limb;
+}
+
+} // namespace bodies
+
+#endif // BODY_IMPOSTOR_H
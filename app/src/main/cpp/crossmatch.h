@@ -0,0 +1,306 @@
+#ifndef CROSSMATCH_H
+#define CROSSMATCH_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+#include "healpix.h"
+#include "job_system.h"
+
+/**
+ * Positional cross-match and merge of star catalogs, for the catalog tooling.
+ *
+ * Catalogs are merged in priority order (e.g. Hipparcos, then Tycho, then
+ * Gaia). The stars merged so far are bucketed by HEALPix pixel at an order
+ * whose pixels are several match radii wide, so every counterpart of a
+ * source lies in the source's pixel or one of its eight neighbors. Each
+ * bucket keeps its unit vectors as separate x/y/z arrays, so the distance
+ * test is a plain loop the compiler vectorizes. A match costs a few dozen
+ * distance tests rather than a scan of the whole catalog.
+ *
+ * A source joins the merged star it matches best: the one with the
+ * smallest combined position and magnitude difference, within the radius
+ * and the magnitude tolerance. Each merged star takes at most one source
+ * per catalog. Where two sources want the same star, the better match
+ * wins and the other is kept as a star of its own. The merged star keeps
+ * its higher-priority position and magnitude, and fills a missing name or
+ * spectral type from its matches.
+ *
+ * Sources are fed in chunks, so only the merged catalog has to fit in
+ * memory, not the catalog being matched. Chunks are matched in parallel
+ * on a JobSystem if one is given.
+ */
+namespace crossmatch {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr double ARCSEC = PI / (180.0 * 3600.0);
+
+// Bucket pixels are at least this many match radii across, so a match
+// never lies beyond the neighboring pixels
+constexpr double PIXEL_RADII = 4.0;
+constexpr int MAX_BUCKET_ORDER = 20;
+constexpr uint32_t NO_MATCH = ~uint32_t(0);
+
+struct Options {
+    double radiusArcsec = 1.0;
+    float maxMagnitudeDifference = 1.0f;  // Counterparts differ by at most this much
+    size_t grain = 4096;                  // Sources per job when matching in parallel
+};
+
+/** One input row; ra/dec in degrees. */
+struct Source {
+    uint64_t id = 0;
+    double ra = 0.0;
+    double dec = 0.0;
+    float magnitude = 0.0f;
+    std::string name;
+    std::string spectralType;
+};
+
+/** A merged star: its highest-priority source and how many catalogs matched it. */
+struct Star {
+    Source source;
+    uint32_t catalog = 0;  // Index of the catalog the position comes from
+    uint32_t matches = 0;  // Sources of later catalogs merged into it
+};
+
+inline void unitVector(double raDeg, double decDeg, double out[3]) {
+    const double ra = raDeg * PI / 180.0, dec = decDeg * PI / 180.0;
+    out[0] = std::cos(dec) * std::cos(ra);
+    out[1] = std::cos(dec) * std::sin(ra);
+    out[2] = std::sin(dec);
+}
+
+/** Largest HEALPix order whose pixels are at least PIXEL_RADII match radii wide. */
+inline int bucketOrder(double radiusRad) {
+    int order = 0;
+    while (order < MAX_BUCKET_ORDER && healpix::resolution(order + 1) >= PIXEL_RADII * radiusRad) order++;
+    return order;
+}
+
+/** Best match of one source: row in the index and its score (lower is better). */
+struct Match {
+    uint32_t row = NO_MATCH;
+    float score = std::numeric_limits<float>::infinity();
+};
+
+/**
+ * Stars bucketed by HEALPix pixel. Rows are the indices of the stars given
+ * to build(); buckets hold them sorted by pixel, positions as x/y/z arrays.
+ */
+class Index {
+public:
+    void build(const std::vector<Star>& stars, double radiusRad) {
+        order_ = bucketOrder(radiusRad);
+        const double chord = 2.0 * std::sin(0.5 * radiusRad);
+        maxChord2_ = chord * chord;
+
+        std::vector<std::pair<uint64_t, uint32_t>> keyed(stars.size());
+        for (uint32_t r = 0; r < stars.size(); r++) {
+            double v[3];
+            unitVector(stars[r].source.ra, stars[r].source.dec, v);
+            keyed[r] = {healpix::vecToNest(order_, v[0], v[1], v[2]), r};
+        }
+        std::sort(keyed.begin(), keyed.end());
+
+        pixels_.clear();
+        starts_.clear();
+        rows_.resize(keyed.size());
+        x_.resize(keyed.size());
+        y_.resize(keyed.size());
+        z_.resize(keyed.size());
+        magnitude_.resize(keyed.size());
+        for (size_t i = 0; i < keyed.size(); i++) {
+            if (pixels_.empty() || pixels_.back() != keyed[i].first) {
+                pixels_.push_back(keyed[i].first);
+                starts_.push_back(static_cast<uint32_t>(i));
+            }
+            const Star& star = stars[keyed[i].second];
+            double v[3];
+            unitVector(star.source.ra, star.source.dec, v);
+            rows_[i] = keyed[i].second;
+            x_[i] = v[0];
+            y_[i] = v[1];
+            z_[i] = v[2];
+            magnitude_[i] = star.source.magnitude;
+        }
+        starts_.push_back(static_cast<uint32_t>(keyed.size()));
+    }
+
+    /**
+     * Nearest star to a direction within the radius and the magnitude
+     * tolerance. The score adds the squared distance and magnitude
+     * difference, each relative to its limit.
+     */
+    Match best(const double v[3], float magnitude, float maxMagnitudeDifference) const {
+        Match match;
+        if (rows_.empty()) return match;
+
+        uint64_t pixels[9];
+        pixels[0] = healpix::vecToNest(order_, v[0], v[1], v[2]);
+        healpix::neighbors(order_, pixels[0], pixels + 1);
+        const float magnitudeScale = maxMagnitudeDifference > 0.0f ? 1.0f / maxMagnitudeDifference : 0.0f;
+        for (uint64_t pixel : pixels) {
+            if (pixel == healpix::NO_NEIGHBOR) continue;
+            const auto it = std::lower_bound(pixels_.begin(), pixels_.end(), pixel);
+            if (it == pixels_.end() || *it != pixel) continue;
+            const size_t bucket = static_cast<size_t>(it - pixels_.begin());
+            scan(starts_[bucket], starts_[bucket + 1], v, magnitude, maxMagnitudeDifference, magnitudeScale, match);
+        }
+        return match;
+    }
+
+    int order() const { return order_; }
+    size_t size() const { return rows_.size(); }
+    size_t bucketCount() const { return pixels_.size(); }
+
+private:
+    void scan(uint32_t begin, uint32_t end, const double v[3], float magnitude, float maxMagnitudeDifference,
+              float magnitudeScale, Match& match) const {
+        // Squared chords first, in one branch-free pass over the bucket
+        const uint32_t count = end - begin;
+        chord2_.resize(std::max<size_t>(chord2_.size(), count));
+        const double* x = x_.data() + begin;
+        const double* y = y_.data() + begin;
+        const double* z = z_.data() + begin;
+        double* chord2 = chord2_.data();
+        for (uint32_t i = 0; i < count; i++) {
+            const double dx = x[i] - v[0], dy = y[i] - v[1], dz = z[i] - v[2];
+            chord2[i] = dx * dx + dy * dy + dz * dz;
+        }
+
+        for (uint32_t i = 0; i < count; i++) {
+            if (chord2[i] > maxChord2_) continue;
+            const float dm = std::abs(magnitude_[begin + i] - magnitude);
+            if (dm > maxMagnitudeDifference) continue;
+            const float score = static_cast<float>(chord2[i] / maxChord2_) + dm * dm * magnitudeScale * magnitudeScale;
+            // Ties go to the lower row, so results do not depend on bucket order
+            if (score < match.score || (score == match.score && rows_[begin + i] < match.row)) {
+                match.score = score;
+                match.row = rows_[begin + i];
+            }
+        }
+    }
+
+    int order_ = 0;
+    double maxChord2_ = 0.0;
+    std::vector<uint64_t> pixels_;  // Sorted pixel of each bucket
+    std::vector<uint32_t> starts_;  // First entry of each bucket, plus the end
+    std::vector<uint32_t> rows_;
+    std::vector<double> x_, y_, z_;
+    std::vector<float> magnitude_;
+    static thread_local std::vector<double> chord2_;  // Scratch, per matching thread
+};
+
+inline thread_local std::vector<double> Index::chord2_;
+
+/**
+ * Merges catalogs in priority order:
+ *
+ *   Merger merger(options);
+ *   for each catalog: beginCatalog(); addChunk(...) per chunk; endCatalog();
+ *   merger.stars();
+ */
+class Merger {
+public:
+    explicit Merger(Options options = Options(), jobs::JobSystem* jobs = nullptr)
+        : options_(options), jobs_(jobs) {}
+
+    /** Start the next, lower-priority catalog: it is matched against every star so far. */
+    void beginCatalog() {
+        index_.build(stars_, options_.radiusArcsec * ARCSEC);
+        claims_.assign(stars_.size(), NO_CLAIM);
+        claimed_.clear();
+        unmatched_.clear();
+    }
+
+    /** Match a chunk of the current catalog. The chunk's sources are moved from. */
+    void addChunk(std::vector<Source>& chunk) {
+        std::vector<Match> matches(chunk.size());
+        auto body = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                double v[3];
+                unitVector(chunk[i].ra, chunk[i].dec, v);
+                matches[i] = index_.best(v, chunk[i].magnitude, options_.maxMagnitudeDifference);
+            }
+        };
+        if (jobs_ != nullptr) {
+            jobs_->parallelFor(0, chunk.size(), options_.grain, body, jobs::Priority::Background);
+        } else {
+            body(0, chunk.size());
+        }
+
+        // Claims are resolved in input order, so the result does not depend on threading
+        for (size_t i = 0; i < chunk.size(); i++) {
+            const Match& m = matches[i];
+            if (m.row == NO_MATCH) {
+                unmatched_.push_back(std::move(chunk[i]));
+                continue;
+            }
+            uint32_t& claim = claims_[m.row];
+            if (claim == NO_CLAIM) {
+                claim = static_cast<uint32_t>(claimed_.size());
+                claimed_.push_back({std::move(chunk[i]), m.score});
+            } else if (m.score < claimed_[claim].score) {
+                unmatched_.push_back(std::move(claimed_[claim].source));
+                claimed_[claim] = {std::move(chunk[i]), m.score};
+            } else {
+                unmatched_.push_back(std::move(chunk[i]));
+            }
+        }
+    }
+
+    /** Merge the current catalog's matches and add its unmatched sources as new stars. */
+    void endCatalog() {
+        for (size_t row = 0; row < claims_.size(); row++) {
+            if (claims_[row] == NO_CLAIM) continue;
+            Star& star = stars_[row];
+            const Source& source = claimed_[claims_[row]].source;
+            star.matches++;
+            if (star.source.name.empty()) star.source.name = source.name;
+            if (star.source.spectralType.empty()) star.source.spectralType = source.spectralType;
+        }
+        matched_ += claimed_.size();
+        for (Source& source : unmatched_) {
+            Star star;
+            star.source = std::move(source);
+            star.catalog = catalogs_;
+            stars_.push_back(std::move(star));
+        }
+        catalogs_++;
+        claims_.clear();
+        claimed_.clear();
+        unmatched_.clear();
+    }
+
+    const std::vector<Star>& stars() const { return stars_; }
+    /** Sources merged into an existing star, over all catalogs. */
+    size_t matched() const { return matched_; }
+    uint32_t catalogCount() const { return catalogs_; }
+    const Index& index() const { return index_; }
+
+private:
+    static constexpr uint32_t NO_CLAIM = ~uint32_t(0);
+
+    struct Claim {
+        Source source;
+        float score;
+    };
+
+    Options options_;
+    jobs::JobSystem* jobs_;
+    Index index_;
+    std::vector<Star> stars_;
+    std::vector<uint32_t> claims_;  // Per star: entry in claimed_, or NO_CLAIM
+    std::vector<Claim> claimed_;
+    std::vector<Source> unmatched_;
+    uint32_t catalogs_ = 0;
+    size_t matched_ = 0;
+};
+
+} // namespace crossmatch
+
+#endif // CROSSMATCH_H
@@ -0,0 +1,445 @@
+#ifndef CULL_SERVICE_H
+#define CULL_SERVICE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "healpix.h"
+#include "math_utils.h"
+
+/**
+ * Bounding-cap culling for the line, point and triangle batches of every
+ * layer (grid, ecliptic, constellations, comets, meteors, the ISS, ...).
+ *
+ * A batch is split into chunks of whole primitives, each bounded by one cap
+ * (unit center and angular radius) or by the caps of a HEALPix coverage
+ * set. A cap is tested as the ball through its rim, which contains every
+ * point of the cap, against the side planes of the view frustum and the
+ * ground's horizon plane. The planes come from projection * view * model,
+ * so the test runs in the batch's own coordinates. Caps are kept as
+ * separate x/y/z/radius arrays and the plane test is a branch-free loop the
+ * compiler vectorizes.
+ *
+ * Registered batches keep their vertices here; cull() tests all of their
+ * caps once per frame, and drawing copies only the visible chunks (adjacent
+ * ones merged into one range). Batches rebuilt every frame are culled as
+ * they are drawn with cullVertices(). Either way the vertices submitted and
+ * drawn are counted per layer, so the savings of each layer can be shown.
+ */
+namespace cull {
+
+constexpr int MAX_LAYERS = 32;  // Layer ordinals, as budget::MAX_LAYERS
+
+// Vertices per chunk when a batch is split automatically; a multiple of
+// 2 and 3 so lines and triangles never straddle a chunk. Grid lines at 5
+// degree steps make chunks about 60 degrees long
+constexpr uint32_t CHUNK_VERTICES = 24;
+
+// Added to every ball radius, so float rounding never drops an edge
+constexpr float RADIUS_MARGIN = 1e-4f;
+
+constexpr double PI = healpix::PI;
+
+/** Bounding cap on the unit sphere: center direction and angular radius (radians). */
+struct Cap {
+    float x = 0.0f, y = 0.0f, z = 1.0f;
+    float radius = static_cast<float>(PI);  // PI covers the whole sky
+};
+
+/** Vertex range of a batch. */
+struct Range {
+    uint32_t first;
+    uint32_t count;
+};
+
+/** Chunk of a batch with explicit bounds; visible if any of its caps is. */
+struct Chunk {
+    uint32_t firstVertex = 0;
+    uint32_t vertexCount = 0;
+    std::vector<Cap> caps;
+};
+
+/** Vertices submitted and drawn by one layer over a frame. */
+struct LayerStats {
+    uint32_t vertices = 0;
+    uint32_t drawn = 0;
+};
+
+/** Ball (chord radius) of a cap: it contains every point of the cap. */
+inline float chordRadius(float angle) {
+    return 2.0f * std::sin(0.5f * std::min(angle, static_cast<float>(PI))) + RADIUS_MARGIN;
+}
+
+/**
+ * Cap of a HEALPix pixel: its center and farthest corner, widened since
+ * pixel edges are not great circles (as sky::Store does for cells).
+ */
+inline Cap pixelCap(int order, uint64_t pix) {
+    double center[3], corners[4][3];
+    healpix::nestToVec(order, pix, center[0], center[1], center[2]);
+    healpix::nestCorners(order, pix, corners);
+    double maxChord = 0.0;
+    for (const double* corner : corners) {
+        maxChord = std::max(maxChord, std::hypot(corner[0] - center[0], corner[1] - center[1], corner[2] - center[2]));
+    }
+    Cap cap;
+    cap.x = static_cast<float>(center[0]);
+    cap.y = static_cast<float>(center[1]);
+    cap.z = static_cast<float>(center[2]);
+    cap.radius = static_cast<float>(std::min(PI, 2.2 * std::asin(std::min(1.0, 0.5 * maxChord))));
+    return cap;
+}
+
+/** Caps of a HEALPix coverage set (nested pixels at one order). */
+inline std::vector<Cap> coverageCaps(int order, const std::vector<uint64_t>& pixels) {
+    std::vector<Cap> caps;
+    caps.reserve(pixels.size());
+    for (uint64_t pix : pixels) caps.push_back(pixelCap(order, pix));
+    return caps;
+}
+
+/**
+ * Bounding ball of vertices (the first 3 floats of each are the position):
+ * centered on their mean direction, out to the farthest one. For points on
+ * the unit sphere it is the ball of their bounding cap.
+ */
+inline void boundingBall(const float* vertices, uint32_t count, uint32_t stride, float out[4]) {
+    double sx = 0.0, sy = 0.0, sz = 0.0;
+    for (uint32_t i = 0; i < count; i++) {
+        const float* v = vertices + static_cast<size_t>(i) * stride;
+        sx += v[0];
+        sy += v[1];
+        sz += v[2];
+    }
+    const double length = std::sqrt(sx * sx + sy * sy + sz * sz);
+    if (length > 1e-6 * count) {
+        out[0] = static_cast<float>(sx / length);
+        out[1] = static_cast<float>(sy / length);
+        out[2] = static_cast<float>(sz / length);
+    } else {
+        // Directions that cancel out (a great circle); any center will do
+        std::copy(vertices, vertices + 3, out);
+    }
+    float maxDistance2 = 0.0f;
+    for (uint32_t i = 0; i < count; i++) {
+        const float* v = vertices + static_cast<size_t>(i) * stride;
+        const float dx = v[0] - out[0], dy = v[1] - out[1], dz = v[2] - out[2];
+        maxDistance2 = std::max(maxDistance2, dx * dx + dy * dy + dz * dz);
+    }
+    out[3] = std::sqrt(maxDistance2) + RADIUS_MARGIN;
+}
+
+/**
+ * Planes a visible point p satisfies: a p.x + b p.y + c p.z + d >= 0, with
+ * unit normals so a ball passes when its center is within its radius.
+ */
+struct Frustum {
+    static constexpr int PLANES = 5;  // Left, right, bottom, top, horizon
+    float a[PLANES], b[PLANES], c[PLANES], d[PLANES];
+
+    /**
+     * Side planes of projection * view * model (near and far are left out:
+     * the sky sits at one distance and its depth is set per layer), and the
+     * world-space horizon plane brought into model coordinates. A null
+     * horizon keeps everything.
+     */
+    static Frustum from(const float view[16], const float projection[16], const float model[16],
+                        const float horizon[4] = nullptr) {
+        float viewModel[16], clip[16];
+        math::multiply(view, model, viewModel);
+        math::multiply(projection, viewModel, clip);
+
+        Frustum f;
+        // Gribb-Hartmann: w +/- x and w +/- y, rows of the column-major matrix
+        for (int p = 0; p < 4; p++) {
+            const int row = p / 2;
+            const float sign = p % 2 == 0 ? 1.0f : -1.0f;
+            float plane[4];
+            for (int j = 0; j < 4; j++) plane[j] = clip[3 + 4 * j] + sign * clip[row + 4 * j];
+            f.set(p, plane);
+        }
+
+        // p . (M x) = (M^T p) . x
+        float plane[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+        if (horizon != nullptr) {
+            for (int j = 0; j < 4; j++) {
+                plane[j] = 0.0f;
+                for (int i = 0; i < 4; i++) plane[j] += model[i + 4 * j] * horizon[i];
+            }
+        }
+        f.set(4, plane);
+        return f;
+    }
+
+    /** Test balls (center x/y/z, radius r); visible[i] is 1 if ball i reaches inside every plane. */
+    void test(const float* x, const float* y, const float* z, const float* r, size_t n, uint8_t* visible) const {
+        for (size_t i = 0; i < n; i++) {
+            uint8_t inside = 1;
+            for (int p = 0; p < PLANES; p++) {
+                inside &= static_cast<uint8_t>(a[p] * x[i] + b[p] * y[i] + c[p] * z[i] + d[p] + r[i] >= 0.0f);
+            }
+            visible[i] = inside;
+        }
+    }
+
+private:
+    void set(int p, const float plane[4]) {
+        const float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        if (length < 1e-12f) {
+            // No orientation (the disabled horizon, or a degenerate matrix): keep everything
+            a[p] = b[p] = c[p] = 0.0f;
+            d[p] = 1.0f;
+            return;
+        }
+        a[p] = plane[0] / length;
+        b[p] = plane[1] / length;
+        c[p] = plane[2] / length;
+        d[p] = plane[3] / length;
+    }
+};
+
+/** Vertices per chunk for a primitive size: whole primitives, about CHUNK_VERTICES. */
+inline uint32_t chunkVertices(uint32_t verticesPerPrimitive) {
+    const uint32_t p = std::max(verticesPerPrimitive, 1u);
+    return std::max(p, CHUNK_VERTICES / p * p);
+}
+
+/**
+ * Cull a batch that is rebuilt every frame: split it into chunks, bound and
+ * test them, and call emit(Range) for each run of visible chunks.
+ *
+ * @return Number of vertices in the visible chunks
+ */
+template<typename Emit>
+uint32_t cullVertices(const Frustum& frustum, const float* vertices, uint32_t vertexCount, uint32_t floatsPerVertex,
+                      uint32_t verticesPerPrimitive, Emit emit) {
+    constexpr uint32_t BLOCK = 64;  // Chunks bounded and tested together
+    const uint32_t size = chunkVertices(verticesPerPrimitive);
+    float x[BLOCK], y[BLOCK], z[BLOCK], r[BLOCK];
+    uint8_t visible[BLOCK];
+
+    uint32_t drawn = 0;
+    Range run{0, 0};
+    for (uint32_t blockStart = 0; blockStart < vertexCount; blockStart += BLOCK * size) {
+        uint32_t n = 0;
+        for (uint32_t first = blockStart; n < BLOCK && first < vertexCount; first += size, n++) {
+            float ball[4];
+            boundingBall(vertices + static_cast<size_t>(first) * floatsPerVertex,
+                         std::min(size, vertexCount - first), floatsPerVertex, ball);
+            x[n] = ball[0];
+            y[n] = ball[1];
+            z[n] = ball[2];
+            r[n] = ball[3];
+        }
+        frustum.test(x, y, z, r, n, visible);
+
+        for (uint32_t i = 0; i < n; i++) {
+            const uint32_t first = blockStart + i * size;
+            const uint32_t count = std::min(size, vertexCount - first);
+            if (!visible[i]) continue;
+            drawn += count;
+            if (run.count > 0 && run.first + run.count == first) {
+                run.count += count;
+            } else {
+                if (run.count > 0) emit(run);
+                run = {first, count};
+            }
+        }
+    }
+    if (run.count > 0) emit(run);
+    return drawn;
+}
+
+/**
+ * Registered batches and the per-layer counts. Not thread-safe; owned and
+ * used by the render thread.
+ */
+class Service {
+public:
+    /**
+     * Register a batch, split automatically into chunks of whole primitives
+     * with a bounding cap each. Vertices are copied.
+     *
+     * @param model Model matrix the batch is drawn with (column-major)
+     * @return Batch id, or -1 if the layout is invalid
+     */
+    int add(int layer, const float* vertices, uint32_t vertexCount, uint32_t floatsPerVertex,
+            uint32_t verticesPerPrimitive, const float model[16]) {
+        if (floatsPerVertex < 3 || verticesPerPrimitive == 0) return -1;
+        Batch batch;
+        if (!begin(batch, layer, vertices, vertexCount, floatsPerVertex, model)) return -1;
+
+        const uint32_t size = chunkVertices(verticesPerPrimitive);
+        for (uint32_t first = 0; first < vertexCount; first += size) {
+            const uint32_t count = std::min(size, vertexCount - first);
+            float ball[4];
+            boundingBall(batch.vertices.data() + static_cast<size_t>(first) * floatsPerVertex, count,
+                         floatsPerVertex, ball);
+            batch.addBall(ball, static_cast<uint32_t>(batch.chunks.size()));
+            batch.chunks.push_back({first, count});
+        }
+        return store(std::move(batch));
+    }
+
+    /**
+     * Register a batch with explicit chunks, such as one per HEALPix pixel
+     * of a layer's index with coverageCaps() as its bounds. Chunks must lie
+     * within the vertices and hold whole primitives.
+     *
+     * @return Batch id, or -1 if a chunk is out of range
+     */
+    int add(int layer, const float* vertices, uint32_t vertexCount, uint32_t floatsPerVertex,
+            const std::vector<Chunk>& chunks, const float model[16]) {
+        if (floatsPerVertex < 3) return -1;
+        Batch batch;
+        if (!begin(batch, layer, vertices, vertexCount, floatsPerVertex, model)) return -1;
+
+        for (const Chunk& chunk : chunks) {
+            if (chunk.firstVertex > vertexCount || chunk.vertexCount > vertexCount - chunk.firstVertex) return -1;
+            const uint32_t index = static_cast<uint32_t>(batch.chunks.size());
+            for (const Cap& cap : chunk.caps) {
+                const float ball[4] = {cap.x, cap.y, cap.z, chordRadius(cap.radius)};
+                batch.addBall(ball, index);
+            }
+            batch.chunks.push_back({chunk.firstVertex, chunk.vertexCount});
+        }
+        return store(std::move(batch));
+    }
+
+    /** Forget a batch; its id may be reused. */
+    bool remove(int id) {
+        if (!live(id)) return false;
+        batches_[id] = Batch();
+        return true;
+    }
+
+    void clear() { batches_.clear(); }
+
+    /**
+     * Start a frame: test every registered cap against the view and roll
+     * the per-layer counts over. horizon is the world-space ground plane,
+     * or null if nothing is clipped.
+     */
+    void cull(const float view[16], const float projection[16], const float horizon[4]) {
+        std::copy(current_, current_ + MAX_LAYERS, last_);
+        std::fill(current_, current_ + MAX_LAYERS, LayerStats());
+
+        for (Batch& batch : batches_) {
+            if (!batch.used) continue;
+            const Frustum frustum = Frustum::from(view, projection, batch.model, horizon);
+            const size_t balls = batch.ballChunk.size();
+            batch.ballVisible.resize(balls);
+            frustum.test(batch.x.data(), batch.y.data(), batch.z.data(), batch.r.data(), balls,
+                         batch.ballVisible.data());
+
+            batch.chunkVisible.assign(batch.chunks.size(), 0);
+            for (size_t i = 0; i < balls; i++) batch.chunkVisible[batch.ballChunk[i]] |= batch.ballVisible[i];
+        }
+    }
+
+    /**
+     * Call emit(Range) for each run of visible chunks of a batch, as of the
+     * last cull(), and count the batch towards its layer.
+     *
+     * @return Number of vertices in the visible chunks
+     */
+    template<typename Emit>
+    uint32_t forEachVisible(int id, Emit emit) {
+        if (!live(id)) return 0;
+        const Batch& batch = batches_[id];
+        uint32_t drawn = 0;
+        Range run{0, 0};
+        for (size_t i = 0; i < batch.chunks.size(); i++) {
+            // Chunks registered since the last cull() have not been tested yet
+            if (i < batch.chunkVisible.size() && !batch.chunkVisible[i]) continue;
+            const Range& chunk = batch.chunks[i];
+            drawn += chunk.count;
+            if (run.count > 0 && run.first + run.count == chunk.first) {
+                run.count += chunk.count;
+            } else {
+                if (run.count > 0) emit(run);
+                run = chunk;
+            }
+        }
+        if (run.count > 0) emit(run);
+        account(batch.layer, batch.vertexCount, drawn);
+        return drawn;
+    }
+
+    /** Count vertices a layer submitted and drew this frame (for batches culled by cullVertices). */
+    void account(int layer, uint32_t vertices, uint32_t drawn) {
+        if (layer < 0 || layer >= MAX_LAYERS) return;
+        current_[layer].vertices += vertices;
+        current_[layer].drawn += drawn;
+    }
+
+    bool live(int id) const { return id >= 0 && static_cast<size_t>(id) < batches_.size() && batches_[id].used; }
+
+    const float* vertices(int id) const { return live(id) ? batches_[id].vertices.data() : nullptr; }
+    uint32_t floatsPerVertex(int id) const { return live(id) ? batches_[id].floatsPerVertex : 0; }
+    const float* model(int id) const { return live(id) ? batches_[id].model : nullptr; }
+
+    /** Counts of the last complete frame, indexed by layer. */
+    const LayerStats* frameStats() const { return last_; }
+
+private:
+    struct Batch {
+        bool used = false;
+        int layer = -1;
+        uint32_t floatsPerVertex = 0;
+        uint32_t vertexCount = 0;
+        float model[16] = {};
+        std::vector<float> vertices;
+        std::vector<Range> chunks;
+        // Balls, owner chunk and test results, as separate arrays for the test
+        std::vector<float> x, y, z, r;
+        std::vector<uint32_t> ballChunk;
+        std::vector<uint8_t> ballVisible;
+        std::vector<uint8_t> chunkVisible;
+
+        void addBall(const float ball[4], uint32_t chunk) {
+            x.push_back(ball[0]);
+            y.push_back(ball[1]);
+            z.push_back(ball[2]);
+            r.push_back(ball[3]);
+            ballChunk.push_back(chunk);
+        }
+    };
+
+    static bool begin(Batch& batch, int layer, const float* vertices, uint32_t vertexCount, uint32_t floatsPerVertex,
+                      const float model[16]) {
+        if (vertexCount > 0 && vertices == nullptr) return false;
+        batch.used = true;
+        batch.layer = layer;
+        batch.floatsPerVertex = floatsPerVertex;
+        batch.vertexCount = vertexCount;
+        if (model != nullptr) {
+            std::memcpy(batch.model, model, sizeof(batch.model));
+        } else {
+            math::identity(batch.model);
+        }
+        batch.vertices.assign(vertices, vertices + static_cast<size_t>(vertexCount) * floatsPerVertex);
+        return true;
+    }
+
+    int store(Batch&& batch) {
+        for (size_t i = 0; i < batches_.size(); i++) {
+            if (!batches_[i].used) {
+                batches_[i] = std::move(batch);
+                return static_cast<int>(i);
+            }
+        }
+        batches_.push_back(std::move(batch));
+        return static_cast<int>(batches_.size() - 1);
+    }
+
+    std::vector<Batch> batches_;
+    LayerStats current_[MAX_LAYERS];
+    LayerStats last_[MAX_LAYERS];
+};
+
+} // namespace cull
+
+#endif // CULL_SERVICE_H
@@ -0,0 +1,156 @@
+#ifndef DSO_H
+#define DSO_H
+
+#include <cmath>
+#include <cstdint>
+
+/**
+ * Deep-sky object instances for the instanced DSO pipeline.
+ *
+ * Each object is one 32-byte instance: its direction, angular extent,
+ * orientation, color and glyph. dso.vert expands every instance into a
+ * screen-facing quad (culling objects behind the camera or off screen) and
+ * dso.frag draws the glyph procedurally, so a whole catalog is one draw.
+ */
+namespace dso {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr double ARCMIN_TO_RAD = PI / (180.0 * 60.0);
+
+// Edge-on galaxies are drawn no thinner than this fraction of their length
+constexpr float MIN_AXIS_RATIO = 0.15f;
+
+/** Object shapes; values match the Shape enum in source.proto. */
+enum class Shape : uint32_t {
+    Circle = 0,
+    Star = 1,
+    EllipticalGalaxy = 2,
+    SpiralGalaxy = 3,
+    IrregularGalaxy = 4,
+    LenticularGalaxy = 5,
+    GlobularCluster = 6,
+    OpenCluster = 7,
+    Nebula = 8,
+    HubbleDeepField = 9,
+};
+
+/** Glyphs drawn by dso.frag; keep in sync with the GLYPH_ constants there. */
+enum class Glyph : uint32_t {
+    Disc = 0,            // Filled disc
+    Ellipse = 1,         // Ellipse outline
+    Spiral = 2,          // Ellipse outline with a bright core
+    GlobularCluster = 3, // Circle with a cross
+    OpenCluster = 4,     // Dashed circle
+    Nebula = 5,          // Square outline
+};
+
+/** Per-instance vertex data; layout must match the attributes in dso.vert. */
+struct Instance {
+    float x, y, z;          // Unit direction (equatorial)
+    float semiMajor;        // Radians; 0 means "draw at the minimum size"
+    float axisRatio;        // Minor / major, in [MIN_AXIS_RATIO, 1]
+    float positionAngle;    // Radians, major axis measured from north through east
+    uint32_t color;         // RGBA8, R in the low byte
+    uint32_t glyph;         // Glyph
+};
+static_assert(sizeof(Instance) == 32, "Instance must stay 32 bytes (see dso.vert)");
+
+inline Glyph glyphFor(Shape shape) {
+    switch (shape) {
+        case Shape::EllipticalGalaxy:
+        case Shape::IrregularGalaxy:
+        case Shape::LenticularGalaxy:
+            return Glyph::Ellipse;
+        case Shape::SpiralGalaxy:
+            return Glyph::Spiral;
+        case Shape::GlobularCluster:
+            return Glyph::GlobularCluster;
+        case Shape::OpenCluster:
+            return Glyph::OpenCluster;
+        case Shape::Nebula:
+            return Glyph::Nebula;
+        default:
+            return Glyph::Disc;
+    }
+}
+
+/**
+ * Convert a catalog ARGB color to RGBA8 for a R8G8B8A8_UNORM attribute.
+ * Catalog colors written without alpha (alpha byte 0) are treated as opaque.
+ */
+inline uint32_t packColor(uint32_t argb) {
+    uint32_t a = (argb >> 24) & 0xFF;
+    if (a == 0) a = 0xFF;
+    const uint32_t r = (argb >> 16) & 0xFF;
+    const uint32_t g = (argb >> 8) & 0xFF;
+    const uint32_t b = argb & 0xFF;
+    return r | (g << 8) | (b << 16) | (a << 24);
+}
+
+/**
+ * Build an instance from catalog values.
+ *
+ * @param majorArcmin Full major axis; <= 0 if unknown
+ * @param minorArcmin Full minor axis; <= 0 if unknown (drawn round)
+ * @param positionAngleDeg Major axis angle, north through east
+ * @param shape Raw source.proto Shape value; unknown values draw as discs
+ */
+inline Instance makeInstance(float raDeg, float decDeg, float majorArcmin, float minorArcmin,
+                             float positionAngleDeg, uint32_t shape, uint32_t argb) {
+    const double ra = raDeg * PI / 180.0;
+    const double dec = decDeg * PI / 180.0;
+
+    double major = majorArcmin > 0.0f ? majorArcmin : 0.0;
+    double minor = minorArcmin > 0.0f ? minorArcmin : major;
+    double pa = positionAngleDeg;
+    if (minor > major) {
+        // Axes given the wrong way round: the long axis is perpendicular to the stated angle
+        const double t = major;
+        major = minor;
+        minor = t;
+        pa += 90.0;
+    }
+
+    Instance inst;
+    inst.x = static_cast<float>(std::cos(dec) * std::cos(ra));
+    inst.y = static_cast<float>(std::cos(dec) * std::sin(ra));
+    inst.z = static_cast<float>(std::sin(dec));
+    inst.semiMajor = static_cast<float>(0.5 * major * ARCMIN_TO_RAD);
+    float ratio = major > 0.0 ? static_cast<float>(minor / major) : 1.0f;
+    inst.axisRatio = ratio < MIN_AXIS_RATIO ? MIN_AXIS_RATIO : (ratio > 1.0f ? 1.0f : ratio);
+    inst.positionAngle = static_cast<float>(std::fmod(pa, 180.0) * PI / 180.0);
+    inst.color = packColor(argb);
+    inst.glyph = static_cast<uint32_t>(glyphFor(static_cast<Shape>(shape)));
+    return inst;
+}
+
+/**
+ * Local north and east unit vectors at direction (x, y, z).
+ * Mirrors tangentFrame() in dso.vert; at the poles east falls back to +y.
+ */
+inline void tangentFrame(float x, float y, float z, float north[3], float east[3]) {
+    // east = normalize(cross(+z, d))
+    float ex = -y, ey = x, ez = 0.0f;
+    float len = std::sqrt(ex * ex + ey * ey);
+    if (len < 1e-6f) {
+        ex = 0.0f; ey = 1.0f; len = 1.0f;
+    }
+    east[0] = ex / len; east[1] = ey / len; east[2] = ez;
+    // north = cross(d, east)
+    north[0] = y * east[2] - z * east[1];
+    north[1] = z * east[0] - x * east[2];
+    north[2] = x * east[1] - y * east[0];
+}
+
+/** Unit vector along the major axis, as dso.vert orients the quad. */
+inline void majorAxis(const Instance& inst, float out[3]) {
+    float north[3], east[3];
+    tangentFrame(inst.x, inst.y, inst.z, north, east);
+    const float c = std::cos(inst.positionAngle);
+    const float s = std::sin(inst.positionAngle);
+    for (int i = 0; i < 3; i++) out[i] = c * north[i] + s * east[i];
+}
+
+} // namespace dso
+
+#endif // DSO_H
@@ -0,0 +1,216 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Linear (bump) arenas for transient per-frame data.
+ *
+ * Culling lists, label candidates and sort keys live for one frame at
+ * most. Allocating them from an arena that is rewound when the frame is
+ * retired (its fence has signaled) replaces malloc/free traffic with a
+ * pointer bump. Arenas are std::pmr::memory_resources, so containers use
+ * them via std::pmr::vector and friends.
+ *
+ * An arena starts with one block. If a frame needs more, overflow blocks
+ * come from the upstream resource; the next reset() frees them and grows the
+ * main block to the observed high-water mark, so after warm-up a steady
+ * workload makes no upstream allocations at all.
+ */
+namespace arena {
+
+class LinearArena : public std::pmr::memory_resource {
+public:
+    explicit LinearArena(size_t capacity = 0,
+                         std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream_(upstream) {
+        if (capacity > 0) allocateMain(capacity);
+    }
+
+    ~LinearArena() override {
+        releaseOverflow();
+        if (base_ != nullptr) upstream_->deallocate(base_, capacity_, alignof(std::max_align_t));
+    }
+
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    /** Rewind to empty. Everything allocated since the last reset becomes invalid. */
+    void reset() {
+        const size_t needed = used_;
+        const bool overflowed = !overflow_.empty();
+        releaseOverflow();
+        if (overflowed || base_ == nullptr) {
+            // Grow once to what this frame needed, with slack for jitter
+            const size_t grown = std::max(needed + needed / 2, MIN_CAPACITY);
+            if (base_ != nullptr) upstream_->deallocate(base_, capacity_, alignof(std::max_align_t));
+            base_ = nullptr;
+            capacity_ = 0;
+            allocateMain(grown);
+        }
+        offset_ = 0;
+        used_ = 0;
+    }
+
+    /** Bytes handed out since the last reset (including alignment padding). */
+    size_t used() const { return used_; }
+    size_t capacity() const { return capacity_; }
+    size_t highWater() const { return highWater_; }
+    /** Upstream allocations made because the main block was full, ever. */
+    size_t overflowCount() const { return overflowCount_; }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        if (void* p = bump(bytes, alignment)) return p;
+
+        // Main block full: serve from a dedicated upstream block until the next reset
+        overflowCount_++;
+        void* p = upstream_->allocate(bytes, alignment);
+        overflow_.push_back({p, bytes, alignment});
+        used_ += bytes;
+        highWater_ = std::max(highWater_, used_);
+        return p;
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {
+        // Freed in bulk by reset()
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    static constexpr size_t MIN_CAPACITY = 4096;
+
+    struct Block {
+        void* ptr;
+        size_t bytes;
+        size_t alignment;
+    };
+
+    void* bump(size_t bytes, size_t alignment) {
+        if (base_ == nullptr) return nullptr;
+        const uintptr_t start = reinterpret_cast<uintptr_t>(base_) + offset_;
+        const uintptr_t aligned = (start + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+        const size_t end = (aligned - reinterpret_cast<uintptr_t>(base_)) + bytes;
+        if (end > capacity_) return nullptr;
+        used_ += end - offset_;
+        offset_ = end;
+        highWater_ = std::max(highWater_, used_);
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    void allocateMain(size_t capacity) {
+        base_ = static_cast<std::byte*>(upstream_->allocate(capacity, alignof(std::max_align_t)));
+        capacity_ = capacity;
+        overflow_.reserve(8);
+    }
+
+    void releaseOverflow() {
+        for (const Block& b : overflow_) upstream_->deallocate(b.ptr, b.bytes, b.alignment);
+        overflow_.clear();
+    }
+
+    std::pmr::memory_resource* upstream_;
+    std::byte* base_ = nullptr;
+    size_t capacity_ = 0;
+    size_t offset_ = 0;
+    size_t used_ = 0;
+    size_t highWater_ = 0;
+    size_t overflowCount_ = 0;
+    std::vector<Block> overflow_;
+};
+
+/**
+ * One arena per frame in flight. The render thread allocates from the
+ * current slot's arena and retires a slot once its fence has signaled.
+ */
+template<size_t FRAMES>
+class FrameArenas {
+public:
+    explicit FrameArenas(size_t capacity = 64 * 1024) {
+        for (auto& a : arenas_) a = std::make_unique<LinearArena>(capacity);
+    }
+
+    LinearArena& operator[](size_t slot) { return *arenas_[slot]; }
+    void retire(size_t slot) { arenas_[slot]->reset(); }
+
+private:
+    std::unique_ptr<LinearArena> arenas_[FRAMES];
+};
+
+/**
+ * Per-thread arenas for worker threads, one per frame slot. A worker's
+ * first call registers it (the only locked path); retire() rewinds that slot
+ * for every worker, so it must only run once workers are done with the
+ * slot's frame.
+ */
+template<size_t FRAMES>
+class WorkerArenas {
+public:
+    explicit WorkerArenas(size_t capacity = 16 * 1024) : capacity_(capacity), id_(nextId()) {}
+
+    /** The calling thread's arena for a frame slot. */
+    LinearArena& local(size_t slot) {
+        // Keyed by instance id, not address, so a new instance never sees a stale entry
+        thread_local uint64_t cachedOwner = 0;
+        thread_local Worker* cachedWorker = nullptr;
+        if (cachedOwner != id_) {
+            cachedWorker = registerThread();
+            cachedOwner = id_;
+        }
+        return *cachedWorker->arenas[slot];
+    }
+
+    void retire(size_t slot) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& w : workers_) w->arenas[slot]->reset();
+    }
+
+    size_t workerCount() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return workers_.size();
+    }
+
+private:
+    struct Worker {
+        std::thread::id id;
+        std::unique_ptr<LinearArena> arenas[FRAMES];
+    };
+
+    static uint64_t nextId() {
+        static std::atomic<uint64_t> counter{0};
+        return ++counter;
+    }
+
+    Worker* registerThread() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::thread::id id = std::this_thread::get_id();
+        for (auto& w : workers_) {
+            if (w->id == id) return w.get();
+        }
+        auto worker = std::make_unique<Worker>();
+        worker->id = id;
+        for (auto& a : worker->arenas) a = std::make_unique<LinearArena>(capacity_);
+        workers_.push_back(std::move(worker));
+        return workers_.back().get();
+    }
+
+    size_t capacity_;
+    uint64_t id_;
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+};
+
+} // namespace arena
+
+#endif // FRAME_ARENA_H
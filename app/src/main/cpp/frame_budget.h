@@ -0,0 +1,226 @@
+#ifndef FRAME_BUDGET_H
+#define FRAME_BUDGET_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Frame-time budget governor.
+ *
+ * Fed one sample per completed frame (CPU recording time, GPU time from
+ * timestamp queries, and both split per layer), it keeps smoothed costs and
+ * trades quality for time: when the smoothed frame time stays over budget
+ * it lowers one quality knob a step - the knob that trims the most
+ * expensive layer, or a GPU/CPU fallback - and when there is sustained
+ * headroom it restores the most recently lowered knob. Every change is
+ * recorded as a Decision for telemetry.
+ */
+namespace budget {
+
+constexpr int MAX_LAYERS = 32;
+constexpr int NO_LAYER = -1;
+
+/** Quality knobs; values are shared with Kotlin (QualityKnob). */
+enum class Knob : uint32_t {
+    StarDensity = 0,      // Fraction of stars drawn, brightest first
+    Tessellation = 1,     // Segment density of procedural lines
+    LabelCount = 2,       // Label budget
+    Glow = 3,             // Additive glow passes (integrated starlight)
+    ResolutionScale = 4,  // Render resolution relative to the display
+};
+constexpr int KNOB_COUNT = 5;
+
+/** Number of steps each knob can be lowered. */
+constexpr int KNOB_MAX_STEP[KNOB_COUNT] = {3, 2, 3, 1, 2};
+
+/** Concrete settings for the current knob steps. */
+struct Quality {
+    float starFraction = 1.0f;
+    float tessellationScale = 1.0f;
+    float labelFraction = 1.0f;
+    bool glow = true;
+    float resolutionScale = 1.0f;
+};
+
+inline Quality qualityFor(const int steps[KNOB_COUNT]) {
+    static const float STAR_FRACTION[] = {1.0f, 0.6f, 0.35f, 0.2f};
+    static const float TESSELLATION[] = {1.0f, 0.5f, 0.25f};
+    static const float LABEL_FRACTION[] = {1.0f, 0.6f, 0.35f, 0.2f};
+    static const float RESOLUTION[] = {1.0f, 0.85f, 0.7f};
+
+    Quality q;
+    q.starFraction = STAR_FRACTION[steps[static_cast<int>(Knob::StarDensity)]];
+    q.tessellationScale = TESSELLATION[steps[static_cast<int>(Knob::Tessellation)]];
+    q.labelFraction = LABEL_FRACTION[steps[static_cast<int>(Knob::LabelCount)]];
+    q.glow = steps[static_cast<int>(Knob::Glow)] == 0;
+    q.resolutionScale = RESOLUTION[steps[static_cast<int>(Knob::ResolutionScale)]];
+    return q;
+}
+
+struct Config {
+    float budgetMs = 1000.0f / 60.0f;
+    float restoreRatio = 0.75f;  // Headroom needed before quality comes back
+    int degradeFrames = 5;       // Consecutive over-budget frames before lowering
+    int restoreFrames = 120;     // Consecutive frames with headroom before raising
+    int settleFrames = 15;       // Frames ignored after any change
+    float smoothing = 0.1f;      // EMA weight of the newest sample
+};
+
+/** One completed frame. GPU values are 0 when timestamps are unavailable. */
+struct FrameSample {
+    float cpuMs = 0.0f;
+    float gpuMs = 0.0f;
+    float layerCpuMs[MAX_LAYERS] = {};
+    float layerGpuMs[MAX_LAYERS] = {};
+    float overdraw = 0.0f;  // Fragment shader invocations per pixel; 0 if not measured
+};
+
+/** A quality change, kept for telemetry. */
+struct Decision {
+    uint64_t frame;
+    Knob knob;
+    int step;         // Knob step after the change
+    bool degraded;    // true = quality lowered
+    int layer;        // Layer that triggered it, or NO_LAYER
+    float frameMs;    // Smoothed frame time when it was made
+};
+
+class Governor {
+public:
+    static constexpr size_t MAX_DECISIONS = 32;
+
+    explicit Governor(Config config = Config()) : config_(config) {
+        std::fill(layerKnob_, layerKnob_ + MAX_LAYERS, -1);
+    }
+
+    void setBudgetMs(float ms) { config_.budgetMs = ms; }
+    float budgetMs() const { return config_.budgetMs; }
+
+    /** Declare which knob trims a layer's cost. Unassigned layers only count toward totals. */
+    void assignLayer(int layer, Knob knob) {
+        if (layer >= 0 && layer < MAX_LAYERS) layerKnob_[layer] = static_cast<int>(knob);
+    }
+
+    /** Feed one frame. Returns true if quality changed. */
+    bool update(const FrameSample& sample) {
+        frame_++;
+        const float a = frame_ == 1 ? 1.0f : config_.smoothing;
+        cpuMs_ += a * (sample.cpuMs - cpuMs_);
+        gpuMs_ += a * (sample.gpuMs - gpuMs_);
+        overdraw_ += a * (sample.overdraw - overdraw_);
+        for (int i = 0; i < MAX_LAYERS; i++) {
+            layerMs_[i] += a * (std::max(sample.layerCpuMs[i], sample.layerGpuMs[i]) - layerMs_[i]);
+        }
+
+        if (settle_ > 0) {
+            settle_--;
+            return false;
+        }
+
+        const float frameMs = smoothedMs();
+        if (frameMs > config_.budgetMs) {
+            restoreCount_ = 0;
+            if (++overCount_ >= config_.degradeFrames) {
+                overCount_ = 0;
+                return degrade(frameMs);
+            }
+        } else if (frameMs < config_.budgetMs * config_.restoreRatio) {
+            overCount_ = 0;
+            if (++restoreCount_ >= config_.restoreFrames) {
+                restoreCount_ = 0;
+                return restore(frameMs);
+            }
+        } else {
+            overCount_ = 0;
+            restoreCount_ = 0;
+        }
+        return false;
+    }
+
+    const Quality& quality() const { return quality_; }
+    int step(Knob knob) const { return steps_[static_cast<int>(knob)]; }
+
+    /** Frame cost is whichever of CPU and GPU is the bottleneck. */
+    float smoothedMs() const { return std::max(cpuMs_, gpuMs_); }
+    float smoothedCpuMs() const { return cpuMs_; }
+    float smoothedGpuMs() const { return gpuMs_; }
+    float smoothedLayerMs(int layer) const { return layerMs_[layer]; }
+    /** Telemetry only; overdraw does not drive decisions (GPU time already reflects it). */
+    float smoothedOverdraw() const { return overdraw_; }
+
+    /** Most recent quality changes, oldest first. */
+    const std::vector<Decision>& decisions() const { return decisions_; }
+    uint64_t frame() const { return frame_; }
+
+private:
+    bool canLower(int knob) const { return steps_[knob] < KNOB_MAX_STEP[knob]; }
+
+    bool degrade(float frameMs) {
+        // Prefer the knob of the most expensive layer that can still give
+        int layer = NO_LAYER;
+        int knob = -1;
+        float worst = 0.0f;
+        for (int i = 0; i < MAX_LAYERS; i++) {
+            const int k = layerKnob_[i];
+            if (k >= 0 && canLower(k) && layerMs_[i] > worst) {
+                worst = layerMs_[i];
+                layer = i;
+                knob = k;
+            }
+        }
+
+        if (knob < 0) {
+            // Nothing attributable: fill rate if GPU-bound, per-object work if CPU-bound
+            static const Knob GPU_ORDER[] = {Knob::ResolutionScale, Knob::Glow, Knob::StarDensity,
+                                             Knob::Tessellation, Knob::LabelCount};
+            static const Knob CPU_ORDER[] = {Knob::StarDensity, Knob::LabelCount, Knob::Tessellation,
+                                             Knob::Glow, Knob::ResolutionScale};
+            const Knob* order = gpuMs_ >= cpuMs_ ? GPU_ORDER : CPU_ORDER;
+            for (int i = 0; i < KNOB_COUNT && knob < 0; i++) {
+                if (canLower(static_cast<int>(order[i]))) knob = static_cast<int>(order[i]);
+            }
+        }
+        if (knob < 0) return false;  // Already at the floor
+
+        steps_[knob]++;
+        lowered_.push_back(knob);
+        apply(knob, true, layer, frameMs);
+        return true;
+    }
+
+    bool restore(float frameMs) {
+        if (lowered_.empty()) return false;
+        const int knob = lowered_.back();
+        lowered_.pop_back();
+        steps_[knob]--;
+        apply(knob, false, NO_LAYER, frameMs);
+        return true;
+    }
+
+    void apply(int knob, bool degraded, int layer, float frameMs) {
+        quality_ = qualityFor(steps_);
+        settle_ = config_.settleFrames;
+        if (decisions_.size() == MAX_DECISIONS) decisions_.erase(decisions_.begin());
+        decisions_.push_back({frame_, static_cast<Knob>(knob), steps_[knob], degraded, layer, frameMs});
+    }
+
+    Config config_;
+    int layerKnob_[MAX_LAYERS];
+    float layerMs_[MAX_LAYERS] = {};
+    float cpuMs_ = 0.0f;
+    float gpuMs_ = 0.0f;
+    float overdraw_ = 0.0f;
+    int steps_[KNOB_COUNT] = {};
+    std::vector<int> lowered_;  // Knobs in the order they were lowered (restored LIFO)
+    Quality quality_;
+    std::vector<Decision> decisions_;
+    uint64_t frame_ = 0;
+    int overCount_ = 0;
+    int restoreCount_ = 0;
+    int settle_ = 0;
+};
+
+} // namespace budget
+
+#endif // FRAME_BUDGET_H
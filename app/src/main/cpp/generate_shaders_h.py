@@ -26,13 +26,12 @@ def spv_to_c_array(spv_path, array_name):
     return "\n".join(lines)
 
 def main():
-    if len(sys.argv) < 4:
-        print(f"Usage: {sys.argv[0]} <output.h> <vert.spv> <frag.spv>")
+    if len(sys.argv) < 3:
+        print(f"Usage: {sys.argv[0]} <output.h> <shader.spv>...")
         sys.exit(1)
 
     output_path = sys.argv[1]
-    vert_spv = sys.argv[2]
-    frag_spv = sys.argv[3]
+    spv_paths = sys.argv[2:]
 
     header = [
         "// Auto-generated shader header - do not edit",
@@ -41,10 +40,11 @@ def main():
         "",
     ]
 
-    header.append(spv_to_c_array(vert_spv, "triangle_vert_spv"))
-    header.append("")
-    header.append(spv_to_c_array(frag_spv, "triangle_frag_spv"))
-    header.append("")
+    # Array name follows the file name: triangle_vert.spv -> triangle_vert_spv
+    for spv_path in spv_paths:
+        stem = os.path.splitext(os.path.basename(spv_path))[0]
+        header.append(spv_to_c_array(spv_path, f"{stem}_spv"))
+        header.append("")
 
     with open(output_path, 'w') as f:
         f.write("\n".join(header))
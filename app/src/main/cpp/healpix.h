@@ -0,0 +1,272 @@
+#ifndef HEALPIX_H
+#define HEALPIX_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * Native HEALPix in the NESTED numbering scheme.
+ *
+ * Pixel ids are 64-bit so every order up to MAX_ORDER (nside = 2^29) is
+ * addressable. In the nested scheme the children of pixel p at order k are
+ * the four pixels 4p..4p+3 at order k+1, so a whole subtree is one
+ * contiguous id range - aggregating data between orders is a shift.
+ *
+ * Follows the reference implementation in healpix_base.cc.
+ * Reference: https://healpix.jpl.nasa.gov/
+ */
+namespace healpix {
+
+constexpr int MAX_ORDER = 29;
+constexpr double PI = 3.14159265358979323846;
+constexpr double HALF_PI = PI / 2.0;
+constexpr double TWO_THIRDS = 2.0 / 3.0;
+
+// Face layout: ring index and longitude offset of each of the 12 base faces
+constexpr int JRLL[12] = {2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4};
+constexpr int JPLL[12] = {1, 3, 5, 7, 0, 2, 4, 6, 1, 3, 5, 7};
+
+inline uint64_t nside(int order) { return uint64_t(1) << order; }
+inline uint64_t npix(int order) { return uint64_t(12) << (2 * order); }
+
+/** Solid angle of one pixel in steradians. */
+inline double pixelArea(int order) { return 4.0 * PI / static_cast<double>(npix(order)); }
+
+/** Approximate pixel side length in radians. */
+inline double resolution(int order) { return std::sqrt(pixelArea(order)); }
+
+/** Parent of a pixel `levels` orders up. */
+inline uint64_t parent(uint64_t pix, int levels) { return pix >> (2 * levels); }
+
+/** First descendant of a pixel `levels` orders down; the rest follow contiguously. */
+inline uint64_t firstChild(uint64_t pix, int levels) { return pix << (2 * levels); }
+
+/** Interleave the low 32 bits of v with zeros (bit i moves to bit 2i). */
+inline uint64_t spreadBits(uint64_t v) {
+    v &= 0xffffffffull;
+    v = (v | (v << 16)) & 0x0000ffff0000ffffull;
+    v = (v | (v << 8))  & 0x00ff00ff00ff00ffull;
+    v = (v | (v << 4))  & 0x0f0f0f0f0f0f0f0full;
+    v = (v | (v << 2))  & 0x3333333333333333ull;
+    v = (v | (v << 1))  & 0x5555555555555555ull;
+    return v;
+}
+
+/** Inverse of spreadBits: gather the even bits of v. */
+inline uint64_t compressBits(uint64_t v) {
+    v &= 0x5555555555555555ull;
+    v = (v | (v >> 1))  & 0x3333333333333333ull;
+    v = (v | (v >> 2))  & 0x0f0f0f0f0f0f0f0full;
+    v = (v | (v >> 4))  & 0x00ff00ff00ff00ffull;
+    v = (v | (v >> 8))  & 0x0000ffff0000ffffull;
+    v = (v | (v >> 16)) & 0x00000000ffffffffull;
+    return v;
+}
+
+/** Compose a nested id from face-local integer coordinates. */
+inline uint64_t xyfToNest(int order, uint64_t ix, uint64_t iy, int face) {
+    return (uint64_t(face) << (2 * order)) + spreadBits(ix) + (spreadBits(iy) << 1);
+}
+
+/** Split a nested id into face-local integer coordinates. */
+inline void nestToXyf(int order, uint64_t pix, uint64_t& ix, uint64_t& iy, int& face) {
+    face = static_cast<int>(pix >> (2 * order));
+    pix &= (uint64_t(1) << (2 * order)) - 1;
+    ix = compressBits(pix);
+    iy = compressBits(pix >> 1);
+}
+
+/**
+ * Convert z = cos(theta) and longitude phi to a nested pixel id.
+ * sth = sin(theta) is used near the poles where z alone loses precision.
+ */
+inline uint64_t locToNest(int order, double z, double phi, double sth, bool haveSth) {
+    const uint64_t ns = nside(order);
+    const double za = std::fabs(z);
+    double tt = std::fmod(phi / HALF_PI, 4.0);  // phi normalized to [0, 4)
+    if (tt < 0.0) tt += 4.0;
+
+    if (za <= TWO_THIRDS) {
+        // Equatorial region
+        const double temp1 = ns * (0.5 + tt);
+        const double temp2 = ns * (z * 0.75);
+        const uint64_t jp = static_cast<uint64_t>(temp1 - temp2);  // Ascending edge line
+        const uint64_t jm = static_cast<uint64_t>(temp1 + temp2);  // Descending edge line
+        const uint64_t ifp = jp >> order;
+        const uint64_t ifm = jm >> order;
+        const int face = (ifp == ifm) ? static_cast<int>(ifp | 4)
+                                      : ((ifp < ifm) ? static_cast<int>(ifp) : static_cast<int>(ifm + 8));
+        const uint64_t ix = jm & (ns - 1);
+        const uint64_t iy = ns - (jp & (ns - 1)) - 1;
+        return xyfToNest(order, ix, iy, face);
+    }
+
+    // Polar caps
+    const int ntt = std::min(3, static_cast<int>(tt));
+    const double tp = tt - ntt;
+    const double tmp = (za < 0.99 || !haveSth)
+        ? ns * std::sqrt(3.0 * (1.0 - za))
+        : ns * sth / std::sqrt((1.0 + za) / 3.0);
+
+    const uint64_t jp = std::min<uint64_t>(static_cast<uint64_t>(tp * tmp), ns - 1);
+    const uint64_t jm = std::min<uint64_t>(static_cast<uint64_t>((1.0 - tp) * tmp), ns - 1);
+    return (z > 0.0) ? xyfToNest(order, ns - jm - 1, ns - jp - 1, ntt)
+                     : xyfToNest(order, jp, jm, ntt + 8);
+}
+
+/** Nested pixel containing direction (x, y, z). The vector need not be normalized. */
+inline uint64_t vecToNest(int order, double x, double y, double z) {
+    const double xl = 1.0 / std::sqrt(x * x + y * y + z * z);
+    const double phi = std::atan2(y, x);
+    const double nz = z * xl;
+    if (std::fabs(nz) > 0.99) {
+        return locToNest(order, nz, phi, std::sqrt(x * x + y * y) * xl, true);
+    }
+    return locToNest(order, nz, phi, 0.0, false);
+}
+
+/** Nested pixel containing (raDeg, decDeg). */
+inline uint64_t raDecToNest(int order, double raDeg, double decDeg) {
+    const double dec = decDeg * PI / 180.0;
+    const double ra = raDeg * PI / 180.0;
+    return locToNest(order, std::sin(dec), ra, std::cos(dec), true);
+}
+
+/**
+ * Unit vector of the point with continuous face coordinates (x, y) in [0, 1]
+ * on the given base face. (0.5, 0.5) is the face center; pixel (ix, iy) at
+ * nside n spans [ix/n, (ix+1)/n] x [iy/n, (iy+1)/n].
+ */
+inline void xyfToVec(double x, double y, int face, double& vx, double& vy, double& vz) {
+    const double jr = JRLL[face] - x - y;
+    double nr;
+    double z;
+    double sth = 0.0;
+    bool haveSth = false;
+
+    if (jr < 1.0) {
+        nr = jr;
+        const double tmp = nr * nr / 3.0;
+        z = 1.0 - tmp;
+        if (z > 0.99) {
+            sth = std::sqrt(tmp * (2.0 - tmp));
+            haveSth = true;
+        }
+    } else if (jr > 3.0) {
+        nr = 4.0 - jr;
+        const double tmp = nr * nr / 3.0;
+        z = tmp - 1.0;
+        if (z < -0.99) {
+            sth = std::sqrt(tmp * (2.0 - tmp));
+            haveSth = true;
+        }
+    } else {
+        nr = 1.0;
+        z = (2.0 - jr) * 2.0 / 3.0;
+    }
+
+    double tmp = JPLL[face] * nr + x - y;
+    if (tmp < 0.0) tmp += 8.0;
+    if (tmp >= 8.0) tmp -= 8.0;
+    const double phi = (nr < 1e-15) ? 0.0 : (0.5 * HALF_PI * tmp) / nr;
+
+    if (!haveSth) sth = std::sqrt((1.0 - z) * (1.0 + z));
+    vx = sth * std::cos(phi);
+    vy = sth * std::sin(phi);
+    vz = z;
+}
+
+/** Unit vector of a pixel center. */
+inline void nestToVec(int order, uint64_t pix, double& vx, double& vy, double& vz) {
+    uint64_t ix, iy;
+    int face;
+    nestToXyf(order, pix, ix, iy, face);
+    const double ns = static_cast<double>(nside(order));
+    xyfToVec((ix + 0.5) / ns, (iy + 0.5) / ns, face, vx, vy, vz);
+}
+
+/**
+ * Unit vectors of the four pixel corners, in N, W, S, E order
+ * (counter-clockwise seen from outside the sphere).
+ */
+inline void nestCorners(int order, uint64_t pix, double corners[4][3]) {
+    uint64_t ix, iy;
+    int face;
+    nestToXyf(order, pix, ix, iy, face);
+    const double ns = static_cast<double>(nside(order));
+    const double x0 = ix / ns, x1 = (ix + 1) / ns;
+    const double y0 = iy / ns, y1 = (iy + 1) / ns;
+    xyfToVec(x1, y1, face, corners[0][0], corners[0][1], corners[0][2]);  // N
+    xyfToVec(x0, y1, face, corners[1][0], corners[1][1], corners[1][2]);  // W
+    xyfToVec(x0, y0, face, corners[2][0], corners[2][1], corners[2][2]);  // S
+    xyfToVec(x1, y0, face, corners[3][0], corners[3][1], corners[3][2]);  // E
+}
+
+// Missing neighbor: only three pixels meet at some base face corners
+constexpr uint64_t NO_NEIGHBOR = ~uint64_t(0);
+
+/**
+ * The eight neighbors of a pixel, in SW, W, NW, N, NE, E, SE, S order
+ * (as in healpix_base.cc); NO_NEIGHBOR where one does not exist.
+ */
+inline void neighbors(int order, uint64_t pix, uint64_t out[8]) {
+    static constexpr int X_OFFSET[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+    static constexpr int Y_OFFSET[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+    // Face across each edge or corner, indexed by (x side) + 3 * (y side) and face
+    static constexpr int FACES[9][12] = {
+        {8, 9, 10, 11, -1, -1, -1, -1, 10, 11, 8, 9},  // S
+        {5, 6, 7, 4, 8, 9, 10, 11, 9, 10, 11, 8},      // SE
+        {-1, -1, -1, -1, 5, 6, 7, 4, -1, -1, -1, -1},  // E
+        {4, 5, 6, 7, 11, 8, 9, 10, 11, 8, 9, 10},      // SW
+        {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11},        // Same face
+        {1, 2, 3, 0, 0, 1, 2, 3, 5, 6, 7, 4},          // NE
+        {-1, -1, -1, -1, 7, 4, 5, 6, -1, -1, -1, -1},  // W
+        {3, 0, 1, 2, 3, 0, 1, 2, 4, 5, 6, 7},          // NW
+        {2, 3, 0, 1, -1, -1, -1, -1, 0, 1, 2, 3},      // N
+    };
+    // How coordinates turn on the new face (bit 0: flip x, 1: flip y, 2: swap), by face row
+    static constexpr int SWAPS[9][3] = {
+        {0, 0, 3}, {0, 0, 6}, {0, 0, 0}, {0, 0, 5}, {0, 0, 0},
+        {5, 0, 0}, {0, 0, 0}, {6, 0, 0}, {3, 0, 0},
+    };
+
+    uint64_t ix, iy;
+    int face;
+    nestToXyf(order, pix, ix, iy, face);
+    const int64_t n = static_cast<int64_t>(nside(order));
+    for (int i = 0; i < 8; i++) {
+        int64_t x = static_cast<int64_t>(ix) + X_OFFSET[i];
+        int64_t y = static_cast<int64_t>(iy) + Y_OFFSET[i];
+        int side = 4;
+        if (x < 0) {
+            x += n;
+            side -= 1;
+        } else if (x >= n) {
+            x -= n;
+            side += 1;
+        }
+        if (y < 0) {
+            y += n;
+            side -= 3;
+        } else if (y >= n) {
+            y -= n;
+            side += 3;
+        }
+
+        const int f = FACES[side][face];
+        if (f < 0) {
+            out[i] = NO_NEIGHBOR;
+            continue;
+        }
+        const int bits = SWAPS[side][face >> 2];
+        if (bits & 1) x = n - x - 1;
+        if (bits & 2) y = n - y - 1;
+        if (bits & 4) std::swap(x, y);
+        out[i] = xyfToNest(order, static_cast<uint64_t>(x), static_cast<uint64_t>(y), f);
+    }
+}
+
+} // namespace healpix
+
+#endif // HEALPIX_H
@@ -0,0 +1,206 @@
+#ifndef HORIZON_PROFILE_H
+#define HORIZON_PROFILE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Terrain horizon of an observing site: the altitude of the skyline
+ * (mountains, trees, buildings) as a function of azimuth.
+ *
+ * The profile is a lookup table of BINS equal azimuth bins holding the sine
+ * of the skyline altitude, so "is this direction above the terrain" is one
+ * bin lookup and one compare. The table is in local (alt-az) coordinates and
+ * does not change as the sky turns; a Frame maps sky directions into it.
+ * The same table is packed into the uniform buffer for the shaders.
+ */
+namespace horizon {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr double DEG_TO_RAD = PI / 180.0;
+
+// Azimuth resolution of the table (power of two; 256 bins is ~1.4 degrees)
+constexpr int BINS = 256;
+
+/** One user-supplied skyline point, in degrees (azimuth from north through east). */
+struct Sample {
+    float azimuthDeg;
+    float altitudeDeg;
+};
+
+class Profile {
+public:
+    /** Flat horizon at altitude 0. */
+    Profile() { std::fill(sinAltitude_, sinAltitude_ + BINS, 0.0f); }
+
+    /**
+     * Rebuild from skyline points, interpolated linearly in azimuth (wrapping
+     * at 360) and sampled at bin centers. Points need not be sorted.
+     *
+     * @return false (leaving the profile unchanged) if there are no points
+     *         or an altitude is outside [-90, 90]
+     */
+    bool build(std::vector<Sample> samples) {
+        if (samples.empty()) return false;
+        for (Sample& s : samples) {
+            if (!(s.altitudeDeg >= -90.0f && s.altitudeDeg <= 90.0f) || !std::isfinite(s.azimuthDeg)) return false;
+            s.azimuthDeg = std::fmod(s.azimuthDeg, 360.0f);
+            if (s.azimuthDeg < 0.0f) s.azimuthDeg += 360.0f;
+        }
+        std::sort(samples.begin(), samples.end(),
+                  [](const Sample& a, const Sample& b) { return a.azimuthDeg < b.azimuthDeg; });
+
+        const size_t n = samples.size();
+        for (int bin = 0; bin < BINS; bin++) {
+            const float az = (bin + 0.5f) * 360.0f / BINS;
+            // First sample at or after az; its predecessor wraps around
+            size_t next = std::lower_bound(samples.begin(), samples.end(), az,
+                                           [](const Sample& s, float value) { return s.azimuthDeg < value; }) -
+                          samples.begin();
+            if (next == n) next = 0;
+            const size_t prev = (next + n - 1) % n;
+
+            float span = samples[next].azimuthDeg - samples[prev].azimuthDeg;
+            float offset = az - samples[prev].azimuthDeg;
+            if (span <= 0.0f) span += 360.0f;
+            if (offset < 0.0f) offset += 360.0f;
+            const float t = n == 1 ? 0.0f : std::clamp(offset / span, 0.0f, 1.0f);
+            const float altitude = samples[prev].altitudeDeg + t * (samples[next].altitudeDeg - samples[prev].altitudeDeg);
+            sinAltitude_[bin] = static_cast<float>(std::sin(altitude * DEG_TO_RAD));
+        }
+        return true;
+    }
+
+    static int binFor(float azimuth) {
+        const float turns = azimuth / static_cast<float>(2.0 * PI);
+        if (!std::isfinite(turns)) return 0;  // Casting NaN to int is undefined
+        return static_cast<int>(std::floor((turns - std::floor(turns)) * BINS)) & (BINS - 1);
+    }
+
+    /** Sine of the skyline altitude at an azimuth (radians). */
+    float sinAltitudeAt(float azimuth) const { return sinAltitude_[binFor(azimuth)]; }
+
+    /** True if a direction at this azimuth and sine of altitude is above the skyline. */
+    bool clears(float azimuth, float sinAltitude) const { return sinAltitude >= sinAltitudeAt(azimuth); }
+
+    /** Lowest skyline point; nothing below it is ever visible. */
+    float minSinAltitude() const { return *std::min_element(sinAltitude_, sinAltitude_ + BINS); }
+
+    /** The table, BINS entries from azimuth 0 eastwards. */
+    const float* sinAltitudes() const { return sinAltitude_; }
+
+private:
+    float sinAltitude_[BINS];
+};
+
+/** Local horizontal frame of the observer, in the sky's (world) coordinates. */
+struct Frame {
+    float zenith[3] = {0.0f, 0.0f, 1.0f};
+    float north[3] = {0.0f, 1.0f, 0.0f};
+    float east[3] = {1.0f, 0.0f, 0.0f};
+
+    /**
+     * Frame from the zenith and a northward vector (need not be orthogonal to
+     * it). A zero zenith gives the default frame; a north along the zenith is
+     * replaced by the celestial pole, or by +y when the zenith is at a pole.
+     */
+    static Frame fromZenithNorth(const float z[3], const float n[3]) {
+        Frame f;
+        const float zl = std::sqrt(z[0] * z[0] + z[1] * z[1] + z[2] * z[2]);
+        if (!(zl > DEGENERATE_LENGTH)) return f;
+        for (int i = 0; i < 3; i++) f.zenith[i] = z[i] / zl;
+        if (!f.projectNorth(n)) {
+            const float pole[3] = {0.0f, 0.0f, 1.0f}, y[3] = {0.0f, 1.0f, 0.0f};
+            if (!f.projectNorth(pole)) f.projectNorth(y);
+        }
+        // East = north x zenith, so that azimuth runs from north through east
+        f.east[0] = f.north[1] * f.zenith[2] - f.north[2] * f.zenith[1];
+        f.east[1] = f.north[2] * f.zenith[0] - f.north[0] * f.zenith[2];
+        f.east[2] = f.north[0] * f.zenith[1] - f.north[1] * f.zenith[0];
+        return f;
+    }
+
+    float sinAltitude(float x, float y, float z) const {
+        return x * zenith[0] + y * zenith[1] + z * zenith[2];
+    }
+
+    float azimuth(float x, float y, float z) const {
+        return std::atan2(x * east[0] + y * east[1] + z * east[2], x * north[0] + y * north[1] + z * north[2]);
+    }
+
+private:
+    // Shorter vectors have no usable direction
+    static constexpr float DEGENERATE_LENGTH = 1e-6f;
+
+    // North as n minus its zenith component; false if that leaves nothing
+    bool projectNorth(const float n[3]) {
+        const float d = n[0] * zenith[0] + n[1] * zenith[1] + n[2] * zenith[2];
+        float projected[3], nl = 0.0f;
+        for (int i = 0; i < 3; i++) {
+            projected[i] = n[i] - d * zenith[i];
+            nl += projected[i] * projected[i];
+        }
+        nl = std::sqrt(nl);
+        if (!(nl > DEGENERATE_LENGTH)) return false;
+        for (int i = 0; i < 3; i++) north[i] = projected[i] / nl;
+        return true;
+    }
+};
+
+/** A profile placed in the sky for one frame; what culling paths test against. */
+struct Occluder {
+    const Profile* profile = nullptr;
+    Frame frame;
+
+    /** True if the unit direction is above the skyline (always, without a profile). */
+    bool visible(float x, float y, float z) const {
+        if (profile == nullptr) return true;
+        return profile->clears(frame.azimuth(x, y, z), frame.sinAltitude(x, y, z));
+    }
+};
+
+/**
+ * First time in [t0, t1] when an object rises above the skyline, or NAN if
+ * it does not (or if step or tolerance is not positive, or step is too fine
+ * for doubles to resolve in the range). altAz(t, azimuth, altitude) gives
+ * the object's local position in radians. The range is stepped at `step`
+ * and each crossing refined by bisection to `tolerance`; steps should be
+ * short against how fast the object moves across bins.
+ */
+template<typename AltAz>
+double firstClear(const Profile& profile, double t0, double t1, double step, double tolerance, AltAz altAz) {
+    auto clearAt = [&](double t) {
+        double azimuth = 0.0, altitude = 0.0;
+        altAz(t, azimuth, altitude);
+        return profile.clears(static_cast<float>(azimuth), static_cast<float>(std::sin(altitude)));
+    };
+
+    if (!(step > 0.0) || !(tolerance > 0.0)) return NAN;  // Would never finish
+    if (clearAt(t0)) return t0;
+    // Steps are counted, so rounding in lo never stalls the scan
+    for (int64_t k = 0;; k++) {
+        const double lo = t0 + static_cast<double>(k) * step;
+        if (!(lo < t1)) break;
+        double hi = std::min(lo + step, t1);
+        if (!(hi > lo)) return NAN;  // Step below the resolution of doubles at lo
+        if (!clearAt(hi)) continue;
+        double below = lo;
+        while (hi - below > tolerance) {
+            const double mid = 0.5 * (below + hi);
+            if (mid <= below || mid >= hi) break;  // Tolerance finer than doubles resolve here
+            if (clearAt(mid)) {
+                hi = mid;
+            } else {
+                below = mid;
+            }
+        }
+        return hi;
+    }
+    return NAN;
+}
+
+} // namespace horizon
+
+#endif // HORIZON_PROFILE_H
@@ -0,0 +1,346 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+/**
+ * Work-stealing job system shared by the native subsystems.
+ *
+ * Each worker owns one deque per priority class. A worker pushes and pops
+ * its own jobs at the back (LIFO, cache-warm) and, when idle, steals from
+ * the front of other workers' deques; threads that are not workers (the
+ * JNI/render thread) submit through a shared injection queue. Frame-critical
+ * jobs are always taken before background jobs, from any queue.
+ *
+ * Completion is tracked with Counters: submitting a job increments its
+ * counter and finishing it decrements. A running job may submit children
+ * to the same counter, so wait() covers the whole tree. Waiting threads run
+ * queued jobs instead of blocking.
+ *
+ * Jobs are a function pointer plus a data pointer and a range, so
+ * submitting never allocates; the data must outlive the job (fork/join).
+ */
+namespace jobs {
+
+enum class Priority : int {
+    Frame = 0,       // Needed by the frame being recorded
+    Background = 1,  // Decode, preparation; runs when no frame work is queued
+};
+constexpr int PRIORITY_COUNT = 2;
+
+class Counter {
+public:
+    Counter() = default;
+    Counter(const Counter&) = delete;
+    Counter& operator=(const Counter&) = delete;
+
+    bool done() const { return pending_.load(std::memory_order_acquire) == 0; }
+    int pending() const { return pending_.load(std::memory_order_acquire); }
+
+private:
+    friend class JobSystem;
+    std::atomic<int> pending_{0};
+};
+
+using JobFn = void (*)(void* data, size_t begin, size_t end);
+
+struct Job {
+    JobFn fn = nullptr;
+    void* data = nullptr;
+    size_t begin = 0;
+    size_t end = 0;
+    Counter* counter = nullptr;
+};
+
+class SpinLock {
+public:
+    void lock() {
+        while (flag_.test_and_set(std::memory_order_acquire)) std::this_thread::yield();
+    }
+    void unlock() { flag_.clear(std::memory_order_release); }
+
+private:
+    std::atomic_flag flag_ = ATOMIC_FLAG_INIT;
+};
+
+/** Fixed-capacity ring: owner works at the back, thieves take from the front. */
+class JobDeque {
+public:
+    explicit JobDeque(size_t capacity = 1024) : ring_(roundUpPow2(capacity)), mask_(ring_.size() - 1) {}
+
+    bool push(const Job& job) {
+        std::lock_guard<SpinLock> lock(lock_);
+        if (tail_ - head_ == ring_.size()) return false;
+        ring_[tail_++ & mask_] = job;
+        return true;
+    }
+
+    bool pop(Job& job) {
+        std::lock_guard<SpinLock> lock(lock_);
+        if (tail_ == head_) return false;
+        job = ring_[--tail_ & mask_];
+        return true;
+    }
+
+    bool steal(Job& job) {
+        std::lock_guard<SpinLock> lock(lock_);
+        if (tail_ == head_) return false;
+        job = ring_[head_++ & mask_];
+        return true;
+    }
+
+private:
+    static size_t roundUpPow2(size_t n) {
+        size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    SpinLock lock_;
+    std::vector<Job> ring_;
+    size_t mask_;
+    size_t head_ = 0;
+    size_t tail_ = 0;
+};
+
+/**
+ * Logical CPUs ordered by maximum frequency, fastest first, so workers can
+ * be placed on big cores before little ones. Without cpufreq information
+ * the natural order is kept.
+ */
+inline std::vector<int> coresByCapacity() {
+    const int n = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<std::pair<long, int>> cores;
+    for (int cpu = 0; cpu < n; cpu++) {
+        long khz = 0;
+        char path[96];
+        std::snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", cpu);
+        if (FILE* f = std::fopen(path, "r")) {
+            if (std::fscanf(f, "%ld", &khz) != 1) khz = 0;
+            std::fclose(f);
+        }
+        cores.push_back({khz, cpu});
+    }
+    std::stable_sort(cores.begin(), cores.end(),
+                     [](const auto& a, const auto& b) { return a.first > b.first; });
+    std::vector<int> order;
+    for (const auto& c : cores) order.push_back(c.second);
+    return order;
+}
+
+/** Restrict the calling thread to one CPU. Returns false where unsupported. */
+inline bool pinCurrentThread(int cpu) {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+struct Config {
+    unsigned workerCount = 0;   // 0: one per CPU, minus one for the render thread
+    bool pinWorkers = true;     // Pin worker i to the (i+1)-th fastest core
+    size_t queueCapacity = 1024;
+};
+
+class JobSystem {
+public:
+    explicit JobSystem(Config config = Config())
+        : injected_{JobDeque(config.queueCapacity * 4), JobDeque(config.queueCapacity * 4)} {
+        const unsigned cpus = std::max(1u, std::thread::hardware_concurrency());
+        const unsigned count = config.workerCount > 0 ? config.workerCount : std::max(1u, cpus - 1);
+        const std::vector<int> cores = config.pinWorkers ? coresByCapacity() : std::vector<int>();
+
+        for (unsigned i = 0; i < count; i++) {
+            workers_.push_back(std::make_unique<Worker>(config.queueCapacity));
+        }
+        for (unsigned i = 0; i < count; i++) {
+            // The fastest core is left to the render thread
+            const int core = cores.size() > 1 ? cores[(i + 1) % cores.size()] : -1;
+            workers_[i]->thread = std::thread([this, i, core] {
+                if (core >= 0) pinCurrentThread(core);
+                workerLoop(static_cast<int>(i));
+            });
+        }
+    }
+
+    ~JobSystem() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& w : workers_) w->thread.join();
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    unsigned workerCount() const { return static_cast<unsigned>(workers_.size()); }
+
+    /** Queue fn(data, begin, end). If the queue is full the job runs inline. */
+    void run(Counter& counter, Priority priority, JobFn fn, void* data, size_t begin = 0, size_t end = 0) {
+        counter.pending_.fetch_add(1, std::memory_order_relaxed);
+        submit({fn, data, begin, end, &counter}, priority);
+    }
+
+    /**
+     * Queue a job nobody waits on, such as a coroutine continuation whose
+     * frame may be gone by the time a counter would be decremented.
+     */
+    void post(Priority priority, JobFn fn, void* data, size_t begin = 0, size_t end = 0) {
+        submit({fn, data, begin, end, nullptr}, priority);
+    }
+
+    /** Queue f(); f must stay alive until the counter is waited on. */
+    template<typename F>
+    void run(Counter& counter, Priority priority, F& f) {
+        run(counter, priority, [](void* data, size_t, size_t) { (*static_cast<F*>(data))(); },
+            const_cast<void*>(static_cast<const void*>(&f)));
+    }
+
+    /** Run queued jobs until the counter reaches zero. */
+    void wait(Counter& counter) {
+        const int self = currentWorker();
+        while (!counter.done()) {
+            Job job;
+            if (take(self, job)) {
+                execute(job);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    /**
+     * Call body(chunkBegin, chunkEnd) over [begin, end) in chunks of `grain`
+     * and return when all have finished. The calling thread takes part.
+     */
+    template<typename F>
+    void parallelFor(size_t begin, size_t end, size_t grain, F&& body, Priority priority = Priority::Frame) {
+        if (end <= begin) return;
+        grain = std::max<size_t>(1, grain);
+        if (end - begin <= grain || workers_.empty()) {
+            body(begin, end);
+            return;
+        }
+
+        using Body = std::remove_reference_t<F>;
+        auto trampoline = [](void* data, size_t b, size_t e) { (*static_cast<Body*>(data))(b, e); };
+        void* data = const_cast<void*>(static_cast<const void*>(&body));
+
+        Counter counter;
+        for (size_t b = begin; b < end; b += grain) {
+            run(counter, priority, trampoline, data, b, std::min(end, b + grain));
+        }
+        wait(counter);
+    }
+
+private:
+    struct Worker {
+        explicit Worker(size_t capacity) : queues{JobDeque(capacity), JobDeque(capacity)} {}
+        JobDeque queues[PRIORITY_COUNT];
+        std::thread thread;
+    };
+
+    struct ThreadIdentity {
+        const JobSystem* owner = nullptr;
+        int index = -1;
+    };
+
+    static ThreadIdentity& threadIdentity() {
+        thread_local ThreadIdentity identity;
+        return identity;
+    }
+
+    static int index(Priority p) { return static_cast<int>(p); }
+
+    void submit(const Job& job, Priority priority) {
+        const int self = currentWorker();
+        JobDeque& queue = self >= 0 ? workers_[self]->queues[index(priority)] : injected_[index(priority)];
+        if (!queue.push(job)) {
+            execute(job);
+            return;
+        }
+        queued_.fetch_add(1, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+        }
+        wake_.notify_one();
+    }
+
+    int currentWorker() const {
+        const ThreadIdentity& id = threadIdentity();
+        return id.owner == this ? id.index : -1;
+    }
+
+    // Highest priority first; within a priority: own deque, injected jobs, then steal
+    bool take(int self, Job& job) {
+        const int n = static_cast<int>(workers_.size());
+        for (int p = 0; p < PRIORITY_COUNT; p++) {
+            bool found = (self >= 0 && workers_[self]->queues[p].pop(job)) || injected_[p].steal(job);
+            for (int k = 1; !found && k <= n; k++) {
+                const int victim = (std::max(self, 0) + k) % n;
+                if (victim != self) found = workers_[victim]->queues[p].steal(job);
+            }
+            if (found) {
+                queued_.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static void execute(const Job& job) {
+        job.fn(job.data, job.begin, job.end);
+        if (job.counter != nullptr) job.counter->pending_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    void workerLoop(int self) {
+        threadIdentity() = {this, self};
+        for (;;) {
+            Job job;
+            if (take(self, job)) {
+                execute(job);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            wake_.wait(lock, [this] { return stop_ || queued_.load(std::memory_order_acquire) > 0; });
+            if (stop_) return;
+        }
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    JobDeque injected_[PRIORITY_COUNT];
+    std::atomic<int> queued_{0};
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    bool stop_ = false;
+};
+
+/** Process-wide job system, started on first use. */
+inline JobSystem& shared() {
+    static JobSystem system;
+    return system;
+}
+
+} // namespace jobs
+
+#endif // JOB_SYSTEM_H
@@ -0,0 +1,198 @@
+#ifndef LABEL_PLACER_H
+#define LABEL_PLACER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/**
+ * Screen-space label decluttering.
+ *
+ * Candidates are ranked by priority (object kind, then brightness) and
+ * placed greedily: each label's box is tested against a coarse occupancy
+ * grid stored as one bitmask row per cell row, and claimed if free. Ranking
+ * is a linear-time radix sort and each test touches O(box rows) words, so a
+ * frame is O(n) instead of the O(n^2) of pairwise box checks. Labels shown
+ * last frame get a priority bonus so two labels of similar rank do not swap
+ * every frame.
+ */
+namespace labels {
+
+/** Object kinds, most important first. Values are shared with Kotlin. */
+enum class Kind : uint32_t {
+    Planet = 0,
+    Constellation = 1,
+    DeepSky = 2,
+    Star = 3,
+};
+
+struct Candidate {
+    uint32_t id;            // Stable across frames (used for hysteresis)
+    float x, y;             // Top-left of the label box, pixels
+    float width, height;    // Pixels
+    float priority;         // Higher wins; see rankPriority()
+};
+
+struct Params {
+    int cellSize = 8;            // Grid resolution in pixels
+    float padding = 2.0f;        // Extra clearance around every box, pixels
+    float stickyBonus = 1.5f;    // Priority added to labels accepted last frame
+};
+
+/**
+ * Priority of a label: kind dominates, brighter (smaller magnitude) breaks ties.
+ * Magnitudes are expected in roughly [-30, 30].
+ */
+inline float rankPriority(Kind kind, float magnitude) {
+    constexpr float KIND_STEP = 100.0f;
+    const float kindRank = 3.0f - static_cast<float>(kind);
+    return kindRank * KIND_STEP - magnitude;
+}
+
+class Placer {
+public:
+    explicit Placer(Params params = Params()) : params_(params) {}
+
+    /** Set the screen size; clears the grid but keeps hysteresis state. */
+    void resize(int width, int height) {
+        width_ = std::max(0, width);
+        height_ = std::max(0, height);
+        cols_ = (width_ + params_.cellSize - 1) / params_.cellSize;
+        rows_ = (height_ + params_.cellSize - 1) / params_.cellSize;
+        wordsPerRow_ = (cols_ + 63) / 64;
+        grid_.assign(static_cast<size_t>(rows_) * wordsPerRow_, 0);
+    }
+
+    /**
+     * Place one frame's candidates, accepting at most maxLabels. Returns the
+     * ids of accepted labels in placement (priority) order; the vector is
+     * reused by the next call.
+     */
+    const std::vector<uint32_t>& place(const Candidate* candidates, size_t count,
+                                       size_t maxLabels = SIZE_MAX) {
+        std::fill(grid_.begin(), grid_.end(), 0);
+
+        order_.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            float key = candidates[i].priority;
+            if (std::binary_search(previous_.begin(), previous_.end(), candidates[i].id)) {
+                key += params_.stickyBonus;
+            }
+            order_[i] = {descendingKey(key), static_cast<uint32_t>(i)};
+        }
+        radixSort();
+
+        accepted_.clear();
+        for (const Ranked& r : order_) {
+            if (accepted_.size() >= maxLabels) break;
+            const Candidate& c = candidates[r.index];
+            int c0, r0, c1, r1;
+            if (!cellRange(c, c0, r0, c1, r1)) continue;
+            if (occupied(c0, r0, c1, r1)) continue;
+            claim(c0, r0, c1, r1);
+            accepted_.push_back(c.id);
+        }
+
+        previous_ = accepted_;
+        std::sort(previous_.begin(), previous_.end());
+        return accepted_;
+    }
+
+    /** Forget which labels were shown (e.g. after a large view jump). */
+    void resetHysteresis() { previous_.clear(); }
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    int columns() const { return cols_; }
+    int rows() const { return rows_; }
+
+private:
+    struct Ranked {
+        uint32_t key;  // descendingKey(priority)
+        uint32_t index;
+    };
+
+    // Map a float to a uint32 whose ascending order is the float's descending order
+    static uint32_t descendingKey(float f) {
+        uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        const uint32_t ascending = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+        return ~ascending;
+    }
+
+    // Stable LSD radix sort of order_ by key, 8 bits per pass; equal keys keep input order
+    void radixSort() {
+        scratch_.resize(order_.size());
+        for (int shift = 0; shift < 32; shift += 8) {
+            size_t counts[257] = {};
+            for (const Ranked& r : order_) counts[((r.key >> shift) & 0xFF) + 1]++;
+            if (counts[((order_.empty() ? 0 : order_[0].key) >> shift & 0xFF) + 1] == order_.size()) {
+                continue;  // All keys share this byte
+            }
+            for (int b = 0; b < 256; b++) counts[b + 1] += counts[b];
+            for (const Ranked& r : order_) scratch_[counts[(r.key >> shift) & 0xFF]++] = r;
+            order_.swap(scratch_);
+        }
+    }
+
+    // Inclusive cell range covered by a padded box; false if it is entirely off screen
+    bool cellRange(const Candidate& c, int& c0, int& r0, int& c1, int& r1) const {
+        const float left = c.x - params_.padding;
+        const float top = c.y - params_.padding;
+        const float right = c.x + c.width + params_.padding;
+        const float bottom = c.y + c.height + params_.padding;
+        if (!(right > 0.0f && bottom > 0.0f && left < width_ && top < height_)) return false;
+
+        const float cell = static_cast<float>(params_.cellSize);
+        c0 = std::max(0, static_cast<int>(std::floor(left / cell)));
+        r0 = std::max(0, static_cast<int>(std::floor(top / cell)));
+        c1 = std::min(cols_ - 1, static_cast<int>(std::ceil(right / cell)) - 1);
+        r1 = std::min(rows_ - 1, static_cast<int>(std::ceil(bottom / cell)) - 1);
+        return c0 <= c1 && r0 <= r1;
+    }
+
+    // Bits c0..c1 (inclusive) of 64-bit word w, or 0 if the word is outside the range
+    static uint64_t wordMask(int w, int c0, int c1) {
+        const int lo = std::max(c0 - w * 64, 0);
+        const int hi = std::min(c1 - w * 64, 63);
+        if (lo > hi) return 0;
+        const uint64_t upper = hi == 63 ? ~uint64_t(0) : ((uint64_t(1) << (hi + 1)) - 1);
+        return upper & ~((uint64_t(1) << lo) - 1);
+    }
+
+    bool occupied(int c0, int r0, int c1, int r1) const {
+        const int w0 = c0 / 64, w1 = c1 / 64;
+        for (int row = r0; row <= r1; row++) {
+            const uint64_t* words = &grid_[static_cast<size_t>(row) * wordsPerRow_];
+            for (int w = w0; w <= w1; w++) {
+                if (words[w] & wordMask(w, c0, c1)) return true;
+            }
+        }
+        return false;
+    }
+
+    void claim(int c0, int r0, int c1, int r1) {
+        const int w0 = c0 / 64, w1 = c1 / 64;
+        for (int row = r0; row <= r1; row++) {
+            uint64_t* words = &grid_[static_cast<size_t>(row) * wordsPerRow_];
+            for (int w = w0; w <= w1; w++) {
+                words[w] |= wordMask(w, c0, c1);
+            }
+        }
+    }
+
+    Params params_;
+    int width_ = 0, height_ = 0;
+    int cols_ = 0, rows_ = 0, wordsPerRow_ = 0;
+    std::vector<uint64_t> grid_;
+    std::vector<Ranked> order_;
+    std::vector<Ranked> scratch_;
+    std::vector<uint32_t> accepted_;
+    std::vector<uint32_t> previous_;  // Sorted ids accepted last frame
+};
+
+} // namespace labels
+
+#endif // LABEL_PLACER_H
@@ -0,0 +1,160 @@
+#ifndef LIGHT_CURVE_H
+#define LIGHT_CURVE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "sky_store.h"
+
+/**
+ * Light curves of variable stars, novae and supernovae.
+ *
+ * Curves are evaluated natively each frame and only the stars whose
+ * brightness actually changed are written back, as (row, alpha) updates
+ * to the sky store's alpha column. Star vertices are packed from the store
+ * at draw time, so an update costs a few bytes per changed star; nothing
+ * else is rebuilt or re-uploaded.
+ *
+ * Brightness is shown through the star's alpha: the catalog alpha at
+ * maximum light, scaled by flux (10^(-0.4 dm)) as the star fades.
+ */
+namespace variability {
+
+constexpr double PI = 3.14159265358979323846;
+
+/** Curve shapes; values match LightCurves.KIND_* in Primitive.kt. */
+enum class Kind : uint8_t {
+    Pulsating = 0,  // Cepheids, Miras, semiregulars: smooth cycle
+    Eclipsing = 1,  // Algol type: constant but for a V-shaped primary eclipse
+    Eruptive = 2,   // Novae, supernovae: one linear rise, then a linear decline
+};
+
+struct Curve {
+    uint32_t source;     // Index in the array given to sky::Store::build()
+    Kind kind;
+    double epoch;        // JD of maximum light (Pulsating, Eruptive) or mid-eclipse (Eclipsing)
+    double period;       // Days; for Eruptive, the rise time to peak
+    float maxMagnitude;  // Brightest magnitude
+    float amplitude;     // Magnitudes fainter at minimum (Eruptive: in quiescence)
+    float shape;         // Eclipsing: eclipse length as a fraction of the period
+                         // Eruptive: decline after peak, magnitudes per day
+};
+
+/** Magnitude of a curve at a Julian date. */
+inline float magnitudeAt(const Curve& curve, double jd) {
+    const double dt = jd - curve.epoch;
+    switch (curve.kind) {
+    case Kind::Pulsating: {
+        if (!(curve.period > 0.0)) return curve.maxMagnitude;
+        const double phase = dt / curve.period;
+        return curve.maxMagnitude + curve.amplitude * static_cast<float>(0.5 * (1.0 - std::cos(2.0 * PI * phase)));
+    }
+    case Kind::Eclipsing: {
+        if (!(curve.period > 0.0) || !(curve.shape > 0.0f)) return curve.maxMagnitude;
+        double phase = dt / curve.period;
+        phase -= std::round(phase);  // [-0.5, 0.5], 0 at mid-eclipse
+        const double halfWidth = 0.5 * curve.shape;
+        const double depth = std::max(0.0, 1.0 - std::abs(phase) / halfWidth);
+        return curve.maxMagnitude + curve.amplitude * static_cast<float>(depth);
+    }
+    case Kind::Eruptive: {
+        const float quiescent = curve.maxMagnitude + curve.amplitude;
+        if (dt < 0.0) {
+            if (!(curve.period > 0.0) || dt < -curve.period) return quiescent;
+            return curve.maxMagnitude + curve.amplitude * static_cast<float>(-dt / curve.period);
+        }
+        return std::min(quiescent, curve.maxMagnitude + curve.shape * static_cast<float>(dt));
+    }
+    }
+    return curve.maxMagnitude;
+}
+
+/** Alpha for a star shown with peakAlpha at maximum light, at magnitude m. */
+inline uint8_t alphaAt(const Curve& curve, uint8_t peakAlpha, float magnitude) {
+    const float flux = std::pow(10.0f, -0.4f * std::max(0.0f, magnitude - curve.maxMagnitude));
+    return static_cast<uint8_t>(std::lround(peakAlpha * flux));
+}
+
+/** One sparse write to the store's alpha column. */
+struct Update {
+    uint32_t row;
+    uint8_t alpha;
+};
+
+/**
+ * The curves bound to a built store: each curve's row and peak alpha, and
+ * the alpha last written, so evaluate() emits only real changes.
+ */
+class Tracker {
+public:
+    /**
+     * Bind curves to a freshly built store (its alphas are taken as the
+     * peak alphas). Curves whose source is out of range are dropped.
+     *
+     * @return Number of curves bound
+     */
+    size_t build(std::vector<Curve> curves, const sky::Store& store) {
+        curves_.clear();
+        rows_.clear();
+        peakAlpha_.clear();
+        lastAlpha_.clear();
+
+        std::vector<uint32_t> rowOf(store.size());
+        for (uint32_t r = 0; r < store.size(); r++) rowOf[store.sourceIndex()[r]] = r;
+
+        for (const Curve& curve : curves) {
+            if (curve.source >= store.size()) continue;
+            const uint32_t row = rowOf[curve.source];
+            curves_.push_back(curve);
+            rows_.push_back(row);
+            peakAlpha_.push_back(store.alpha()[row]);
+            lastAlpha_.push_back(-1);  // First evaluate() writes every curve
+        }
+        return curves_.size();
+    }
+
+    /** Put the peak alphas back, as they were when the store was built. */
+    void restore(sky::Store& store) const {
+        for (size_t i = 0; i < rows_.size(); i++) {
+            if (rows_[i] < store.size()) store.setAlpha(rows_[i], peakAlpha_[i]);
+        }
+    }
+
+    /**
+     * Append an update for every curve whose alpha differs from the last
+     * one emitted.
+     *
+     * @return Number of updates appended
+     */
+    template<typename Updates>
+    size_t evaluate(double jd, Updates& out) {
+        const size_t before = out.size();
+        for (size_t i = 0; i < curves_.size(); i++) {
+            const uint8_t alpha = alphaAt(curves_[i], peakAlpha_[i], magnitudeAt(curves_[i], jd));
+            if (alpha == lastAlpha_[i]) continue;
+            lastAlpha_[i] = alpha;
+            out.push_back({rows_[i], alpha});
+        }
+        return out.size() - before;
+    }
+
+    size_t size() const { return curves_.size(); }
+    const std::vector<Curve>& curves() const { return curves_; }
+
+private:
+    std::vector<Curve> curves_;
+    std::vector<uint32_t> rows_;
+    std::vector<uint8_t> peakAlpha_;
+    std::vector<int16_t> lastAlpha_;  // -1 until first written
+};
+
+/** Apply updates to the store. */
+template<typename Updates>
+void apply(const Updates& updates, sky::Store& store) {
+    for (const Update& u : updates) store.setAlpha(u.row, u.alpha);
+}
+
+} // namespace variability
+
+#endif // LIGHT_CURVE_H
@@ -0,0 +1,349 @@
+#ifndef LIGHT_MAP_H
+#define LIGHT_MAP_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "healpix.h"
+#include "job_system.h"
+
+/**
+ * Integrated-light maps for stars too faint to draw individually.
+ *
+ * For every LOD cutoff magnitude the catalog tooling sums the flux and the
+ * flux-weighted mean color of all stars FAINTER than the cutoff into HEALPix
+ * pixels at several orders. At runtime the renderer draws the map matching
+ * its current limiting magnitude as one additive background pass, so the
+ * unresolved Milky Way glow costs a few thousand patches instead of one
+ * point per star.
+ */
+namespace lightmap {
+
+// Maps and the build accumulator are dense: at order 8 (786432 pixels of
+// ~0.23 degrees, far finer than a glow needs) the accumulator is 25 MB and
+// each map 12.6 MB. Each order above that multiplies both by four
+constexpr int MAX_MAP_ORDER = 8;
+
+constexpr uint32_t FILE_MAGIC = 0x504d4c53;  // "SLMP" little-endian
+constexpr uint32_t FILE_VERSION = 1;
+
+/** Input star: unit vector, apparent magnitude and linear RGB color. */
+struct StarSample {
+    float x, y, z;
+    float magnitude;
+    float r, g, b;
+};
+
+/** Accumulated light of one pixel. Flux is in units of a magnitude-0 star. */
+struct PixelLight {
+    float flux = 0.0f;
+    float r = 0.0f;  // Flux-weighted mean color
+    float g = 0.0f;
+    float b = 0.0f;
+};
+
+/** One map: all stars fainter than cutoffMagnitude, binned at one order. */
+struct LightMap {
+    int order = 0;
+    float cutoffMagnitude = 0.0f;
+    std::vector<PixelLight> pixels;  // npix(order) entries in nested order
+};
+
+inline double magnitudeToFlux(double magnitude) {
+    return std::pow(10.0, -0.4 * magnitude);
+}
+
+/**
+ * Build one map per (cutoff, order) pair, cutoff-major: the map for
+ * cutoffs[i] at orders[j] is result[i * orders.size() + j].
+ *
+ * Stars are swept faintest-first into a single accumulator at the finest
+ * requested order, snapshotting it as each cutoff is passed; coarser orders
+ * are sums over contiguous nested child ranges. Memory is one accumulator of
+ * npix(max order) cells regardless of the number of cutoffs. Orders are
+ * clamped to [0, MAX_MAP_ORDER].
+ */
+inline std::vector<LightMap> build(const std::vector<StarSample>& stars,
+                                   const std::vector<float>& cutoffs,
+                                   const std::vector<int>& orders) {
+    std::vector<LightMap> result;
+    if (cutoffs.empty() || orders.empty()) return result;
+
+    const int maxOrder = std::clamp(*std::max_element(orders.begin(), orders.end()), 0, MAX_MAP_ORDER);
+    const size_t fineCount = static_cast<size_t>(healpix::npix(maxOrder));
+
+    std::vector<const StarSample*> faintestFirst;
+    faintestFirst.reserve(stars.size());
+    for (const StarSample& s : stars) faintestFirst.push_back(&s);
+    std::sort(faintestFirst.begin(), faintestFirst.end(),
+              [](const StarSample* a, const StarSample* b) { return a->magnitude > b->magnitude; });
+
+    std::vector<size_t> cutoffOrder(cutoffs.size());
+    for (size_t i = 0; i < cutoffOrder.size(); i++) cutoffOrder[i] = i;
+    std::sort(cutoffOrder.begin(), cutoffOrder.end(),
+              [&cutoffs](size_t a, size_t b) { return cutoffs[a] > cutoffs[b]; });
+
+    // Double accumulators: faint tails of large catalogs sum millions of tiny fluxes
+    std::vector<double> fine(fineCount * 4, 0.0);
+    size_t next = 0;
+
+    result.resize(cutoffs.size() * orders.size());
+    for (size_t ci : cutoffOrder) {
+        const float cutoff = cutoffs[ci];
+        for (; next < faintestFirst.size() && faintestFirst[next]->magnitude > cutoff; next++) {
+            const StarSample& s = *faintestFirst[next];
+            const uint64_t pix = healpix::vecToNest(maxOrder, s.x, s.y, s.z);
+            const double flux = magnitudeToFlux(s.magnitude);
+            double* cell = &fine[pix * 4];
+            cell[0] += flux;
+            cell[1] += flux * s.r;
+            cell[2] += flux * s.g;
+            cell[3] += flux * s.b;
+        }
+
+        for (size_t oi = 0; oi < orders.size(); oi++) {
+            const int order = std::clamp(orders[oi], 0, maxOrder);
+            const int levels = maxOrder - order;
+            const uint64_t childCount = uint64_t(1) << (2 * levels);
+
+            LightMap& map = result[ci * orders.size() + oi];
+            map.order = order;
+            map.cutoffMagnitude = cutoff;
+            map.pixels.assign(static_cast<size_t>(healpix::npix(order)), PixelLight{});
+
+            for (size_t p = 0; p < map.pixels.size(); p++) {
+                double sum[4] = {0.0, 0.0, 0.0, 0.0};
+                const uint64_t first = healpix::firstChild(p, levels);
+                for (uint64_t c = first; c < first + childCount; c++) {
+                    for (int k = 0; k < 4; k++) sum[k] += fine[c * 4 + k];
+                }
+                if (sum[0] > 0.0) {
+                    PixelLight& px = map.pixels[p];
+                    px.flux = static_cast<float>(sum[0]);
+                    px.r = static_cast<float>(sum[1] / sum[0]);
+                    px.g = static_cast<float>(sum[2] / sum[0]);
+                    px.b = static_cast<float>(sum[3] / sum[0]);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * Serialize maps to the lightmap.binary asset format (little-endian):
+ *   uint32 magic, uint32 version, uint32 mapCount
+ *   per map: int32 order, float cutoff, uint32 litCount,
+ *            litCount x { uint32 pixel, float flux, float r, float g, float b }
+ * Only lit pixels are stored.
+ */
+inline std::vector<uint8_t> serialize(const std::vector<LightMap>& maps) {
+    std::vector<uint8_t> out;
+    auto put = [&out](const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        out.insert(out.end(), bytes, bytes + size);
+    };
+
+    const uint32_t header[3] = {FILE_MAGIC, FILE_VERSION, static_cast<uint32_t>(maps.size())};
+    put(header, sizeof(header));
+
+    for (const LightMap& map : maps) {
+        uint32_t litCount = 0;
+        for (const PixelLight& px : map.pixels) {
+            if (px.flux > 0.0f) litCount++;
+        }
+        const int32_t order = map.order;
+        put(&order, sizeof(order));
+        put(&map.cutoffMagnitude, sizeof(float));
+        put(&litCount, sizeof(litCount));
+
+        for (size_t p = 0; p < map.pixels.size(); p++) {
+            const PixelLight& px = map.pixels[p];
+            if (px.flux <= 0.0f) continue;
+            const uint32_t pixel = static_cast<uint32_t>(p);
+            const float values[4] = {px.flux, px.r, px.g, px.b};
+            put(&pixel, sizeof(pixel));
+            put(values, sizeof(values));
+        }
+    }
+    return out;
+}
+
+/**
+ * Parse the lightmap.binary format.
+ * @return false if the data is truncated or not a light map file
+ */
+inline bool deserialize(const uint8_t* data, size_t size, std::vector<LightMap>& maps) {
+    size_t offset = 0;
+    auto get = [&](void* dst, size_t bytes) {
+        if (offset + bytes > size) return false;
+        memcpy(dst, data + offset, bytes);
+        offset += bytes;
+        return true;
+    };
+
+    uint32_t header[3];
+    if (!get(header, sizeof(header))) return false;
+    if (header[0] != FILE_MAGIC || header[1] != FILE_VERSION) return false;
+
+    maps.clear();
+    maps.reserve(header[2]);
+    for (uint32_t m = 0; m < header[2]; m++) {
+        int32_t order;
+        float cutoff;
+        uint32_t litCount;
+        if (!get(&order, sizeof(order)) || !get(&cutoff, sizeof(cutoff)) ||
+            !get(&litCount, sizeof(litCount))) {
+            return false;
+        }
+        if (order < 0 || order > MAX_MAP_ORDER) return false;
+
+        LightMap map;
+        map.order = order;
+        map.cutoffMagnitude = cutoff;
+        map.pixels.resize(static_cast<size_t>(healpix::npix(order)));
+
+        for (uint32_t i = 0; i < litCount; i++) {
+            uint32_t pixel;
+            float values[4];
+            if (!get(&pixel, sizeof(pixel)) || !get(values, sizeof(values))) return false;
+            if (pixel >= map.pixels.size()) return false;
+            map.pixels[pixel] = PixelLight{values[0], values[1], values[2], values[3]};
+        }
+        maps.push_back(std::move(map));
+    }
+    return true;
+}
+
+/**
+ * Pick the map drawn behind a star layer whose limiting magnitude is
+ * limitingMagnitude: the brightest cutoff at or above it (so no star is
+ * counted twice), preferring the order closest to preferredOrder.
+ * @return nullptr if no map covers the limit
+ */
+inline const LightMap* select(const std::vector<LightMap>& maps, float limitingMagnitude, int preferredOrder) {
+    const LightMap* best = nullptr;
+    for (const LightMap& map : maps) {
+        if (map.cutoffMagnitude < limitingMagnitude) continue;
+        if (best == nullptr || map.cutoffMagnitude < best->cutoffMagnitude ||
+            (map.cutoffMagnitude == best->cutoffMagnitude &&
+             std::abs(map.order - preferredOrder) < std::abs(best->order - preferredOrder))) {
+            best = &map;
+        }
+    }
+    return best;
+}
+
+// Pixels per job when building patches on a job system
+constexpr size_t SHADE_GRAIN = 4096;
+constexpr size_t PATCH_GRAIN = 1024;
+
+/**
+ * Tone-map a pixel to premultiplied RGBA for additive blending.
+ * Surface brightness (flux per steradian) is scaled by `gain` and
+ * compressed with x / (1 + x) so dense regions saturate smoothly.
+ */
+inline void shadePixel(const PixelLight& px, double area, float gain, float rgba[4]) {
+    const double brightness = px.flux / area * gain;
+    const float alpha = static_cast<float>(brightness / (1.0 + brightness));
+    rgba[0] = px.r * alpha;
+    rgba[1] = px.g * alpha;
+    rgba[2] = px.b * alpha;
+    rgba[3] = alpha;
+}
+
+/**
+ * Append the map as background patches: two triangles per pixel with any lit
+ * corner, 7 floats per vertex (x, y, z, r, g, b, a) to match the triangle
+ * pipeline. Corner colors average the pixels that meet at the corner, so the
+ * patches shade smoothly instead of showing the pixel grid.
+ *
+ * With a job system the shading and patch generation are split across its
+ * workers; chunks are appended in pixel order, so the output is identical.
+ *
+ * @return Number of vertices appended
+ */
+inline size_t appendPatchVertices(const LightMap& map, float gain, std::vector<float>& out,
+                                  jobs::JobSystem* jobs = nullptr) {
+    const int order = map.order;
+    const double area = healpix::pixelArea(order);
+    const double ns = static_cast<double>(healpix::nside(order));
+    const double nudge = 0.25 / ns;  // Quarter pixel toward each pixel sharing a corner
+
+    const size_t count = map.pixels.size();
+    std::vector<float> shaded(count * 4);
+    auto shadeRange = [&](size_t begin, size_t end) {
+        for (size_t p = begin; p < end; p++) shadePixel(map.pixels[p], area, gain, &shaded[p * 4]);
+    };
+    if (jobs != nullptr) {
+        jobs->parallelFor(0, count, SHADE_GRAIN, shadeRange);
+    } else {
+        shadeRange(0, count);
+    }
+
+    auto cornerColor = [&](double x, double y, int face, float rgba[4]) {
+        static const double offsets[4][2] = {{1, 1}, {-1, 1}, {-1, -1}, {1, -1}};
+        rgba[0] = rgba[1] = rgba[2] = rgba[3] = 0.0f;
+        for (const auto& o : offsets) {
+            double vx, vy, vz;
+            healpix::xyfToVec(x + o[0] * nudge, y + o[1] * nudge, face, vx, vy, vz);
+            const float* c = &shaded[healpix::vecToNest(order, vx, vy, vz) * 4];
+            for (int k = 0; k < 4; k++) rgba[k] += c[k] * 0.25f;
+        }
+    };
+
+    auto appendPatch = [&](size_t p, std::vector<float>& dst) {
+        uint64_t ix, iy;
+        int face;
+        healpix::nestToXyf(order, p, ix, iy, face);
+
+        // Corners in N, W, S, E order (see healpix::nestCorners)
+        const double cx[4] = {(ix + 1) / ns, ix / ns, ix / ns, (ix + 1) / ns};
+        const double cy[4] = {(iy + 1) / ns, (iy + 1) / ns, iy / ns, iy / ns};
+
+        float colors[4][4];
+        float maxAlpha = 0.0f;
+        for (int c = 0; c < 4; c++) {
+            cornerColor(cx[c], cy[c], face, colors[c]);
+            maxAlpha = std::max(maxAlpha, colors[c][3]);
+        }
+        if (maxAlpha <= 0.0f) return;
+
+        double pos[4][3];
+        for (int c = 0; c < 4; c++) {
+            healpix::xyfToVec(cx[c], cy[c], face, pos[c][0], pos[c][1], pos[c][2]);
+        }
+
+        static const int triangles[6] = {0, 1, 2, 0, 2, 3};
+        for (int idx : triangles) {
+            dst.push_back(static_cast<float>(pos[idx][0]));
+            dst.push_back(static_cast<float>(pos[idx][1]));
+            dst.push_back(static_cast<float>(pos[idx][2]));
+            dst.insert(dst.end(), colors[idx], colors[idx] + 4);
+        }
+    };
+
+    const size_t before = out.size();
+    if (jobs == nullptr) {
+        for (size_t p = 0; p < count; p++) appendPatch(p, out);
+        return (out.size() - before) / 7;
+    }
+
+    // One output buffer per chunk, concatenated in order
+    const size_t chunks = (count + PATCH_GRAIN - 1) / PATCH_GRAIN;
+    std::vector<std::vector<float>> parts(chunks);
+    jobs->parallelFor(0, chunks, 1, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; c++) {
+            const size_t last = std::min(count, (c + 1) * PATCH_GRAIN);
+            for (size_t p = c * PATCH_GRAIN; p < last; p++) appendPatch(p, parts[c]);
+        }
+    });
+    for (const auto& part : parts) out.insert(out.end(), part.begin(), part.end());
+    return (out.size() - before) / 7;
+}
+
+} // namespace lightmap
+
+#endif // LIGHT_MAP_H
@@ -0,0 +1,388 @@
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if defined(__ANDROID__)
+#include <android/log.h>
+#endif
+
+/**
+ * Asynchronous logging for latency-critical code.
+ *
+ * __android_log_print takes locks and makes a syscall per message, which
+ * shows up in frame times when the render thread logs. Here the calling
+ * thread only formats the message into a slot of its own single-producer
+ * ring, with no locks or syscalls; a background thread drains every
+ * thread's ring to the sink (logcat on Android, stderr elsewhere) in
+ * timestamp order.
+ *
+ * Messages go through the LOG_RING macro, which:
+ *   - compiles away below LOG_RING_MIN_LEVEL, arguments included;
+ *   - rate-limits each call site to a number of messages per second; the
+ *     next admitted message reports how many were suppressed;
+ *   - drops the message if the thread's ring is full; the drain reports
+ *     dropped counts, so a burst never blocks the caller.
+ *
+ * Errors are the exception: they are neither rate-limited nor queued, but
+ * written by the caller after draining what is queued, so the last words
+ * before a crash reach the log.
+ *
+ * A thread's first message registers its ring (under a mutex, once). The
+ * ring outlives the thread until it has been drained.
+ */
+
+// Least severe level compiled in: Debug in debug builds, Info in release
+#ifndef LOG_RING_MIN_LEVEL
+#ifdef NDEBUG
+#define LOG_RING_MIN_LEVEL 4
+#else
+#define LOG_RING_MIN_LEVEL 3
+#endif
+#endif
+
+/**
+ * Log through a Logger: LOG_RING(logger, level, tag, perSecond, format, ...).
+ * perSecond 0 disables rate limiting for the site.
+ */
+#define LOG_RING(logger, level, tag, perSecond, ...)                                           \
+    do {                                                                                       \
+        if constexpr (static_cast<int>(level) >= LOG_RING_MIN_LEVEL) {                         \
+            static logring::Site logRingSite_(tag, perSecond);                                 \
+            (logger).log(logRingSite_, level, __VA_ARGS__);                                    \
+        }                                                                                      \
+    } while (0)
+
+namespace logring {
+
+// Same values as the android_LogPriority constants
+enum class Level : int {
+    Verbose = 2,
+    Debug = 3,
+    Info = 4,
+    Warn = 5,
+    Error = 6,
+};
+
+constexpr size_t RING_CAPACITY = 256;  // Messages per thread; power of two
+constexpr size_t TEXT_BYTES = 224;     // Longer messages are truncated
+constexpr int64_t RATE_WINDOW_NANOS = 1000000000;
+
+inline int64_t nowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * One LOG_RING call site: its tag and rate limit. Counting is approximate
+ * under contention, which is fine for a limit.
+ */
+class Site {
+public:
+    constexpr Site(const char* tag, uint32_t perSecond) : tag_(tag), perSecond_(perSecond) {}
+    Site(const Site&) = delete;
+    Site& operator=(const Site&) = delete;
+
+    /** Whether a message at time now fits in the site's budget; counts it as suppressed if not. */
+    bool admit(int64_t now) {
+        if (perSecond_ == 0) return true;
+        int64_t start = windowStart_.load(std::memory_order_relaxed);
+        if (now - start >= RATE_WINDOW_NANOS &&
+            windowStart_.compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+            count_.store(0, std::memory_order_relaxed);
+        }
+        if (count_.fetch_add(1, std::memory_order_relaxed) < perSecond_) return true;
+        suppressed_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    /** Messages suppressed since the last call. */
+    uint32_t takeSuppressed() { return suppressed_.exchange(0, std::memory_order_relaxed); }
+
+    const char* tag() const { return tag_; }
+
+private:
+    const char* tag_;
+    uint32_t perSecond_;
+    std::atomic<int64_t> windowStart_{INT64_MIN / 2};
+    std::atomic<uint32_t> count_{0};
+    std::atomic<uint32_t> suppressed_{0};
+};
+
+/** A message as handed to the sink. */
+struct Message {
+    Level level;
+    const char* tag;
+    const char* text;
+    uint32_t thread;      // Kernel thread id of the caller
+    int64_t nanos;        // steady_clock time of the call
+    uint32_t suppressed;  // Messages of the same site rate-limited before this one
+};
+
+using Sink = std::function<void(const Message&)>;
+
+/** Logcat on Android, stderr elsewhere; notes the caller's thread and skipped messages. */
+inline void defaultSink(const Message& m) {
+    char suffix[64] = "";
+    if (m.suppressed > 0) snprintf(suffix, sizeof(suffix), " [%u similar suppressed]", m.suppressed);
+#if defined(__ANDROID__)
+    __android_log_print(static_cast<int>(m.level), m.tag, "%s (tid %u)%s", m.text, m.thread, suffix);
+#else
+    static const char LETTERS[] = "??VDIWE";
+    fprintf(stderr, "%c/%s(%u): %s%s\n", LETTERS[static_cast<int>(m.level)], m.tag, m.thread, m.text, suffix);
+#endif
+}
+
+/** Single-producer, single-consumer message ring of one thread. */
+class Ring {
+public:
+    struct Entry {
+        int64_t nanos;
+        Site* site;
+        Level level;
+        uint32_t suppressed;
+        char text[TEXT_BYTES];
+    };
+
+    explicit Ring(uint32_t thread) : thread_(thread) {}
+
+    /** Producer: the slot for the next message, or nullptr if the ring is full. */
+    Entry* reserve() {
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == RING_CAPACITY) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        return &entries_[head & (RING_CAPACITY - 1)];
+    }
+
+    /** Producer: hand the reserved slot to the consumer. */
+    void publish() { head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    // Consumer side
+    uint64_t tail() const { return tail_.load(std::memory_order_relaxed); }
+    uint64_t head() const { return head_.load(std::memory_order_acquire); }
+    const Entry& at(uint64_t index) const { return entries_[index & (RING_CAPACITY - 1)]; }
+    void release(uint64_t tail) { tail_.store(tail, std::memory_order_release); }
+    uint32_t takeDropped() { return dropped_.exchange(0, std::memory_order_relaxed); }
+
+    uint32_t thread() const { return thread_; }
+
+private:
+    Entry entries_[RING_CAPACITY];
+    alignas(64) std::atomic<uint64_t> head_{0};  // Written by the producer
+    alignas(64) std::atomic<uint64_t> tail_{0};  // Written by the consumer
+    std::atomic<uint32_t> dropped_{0};
+    uint32_t thread_;
+};
+
+struct Config {
+    std::chrono::milliseconds interval{20};  // Drain period
+    bool startThread = true;                 // Otherwise the owner calls drain()
+    Sink sink = defaultSink;
+};
+
+class Logger {
+public:
+    explicit Logger(Config config = Config()) : config_(std::move(config)), id_(nextId()) {
+        if (config_.startThread) thread_ = std::thread([this] { run(); });
+    }
+
+    ~Logger() {
+        if (thread_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(wakeMutex_);
+                stopping_ = true;
+            }
+            wake_.notify_one();
+            thread_.join();
+        }
+        drain();
+    }
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    /**
+     * Format a message into the calling thread's ring. Never blocks once the
+     * thread is registered, except for errors, which are written at once.
+     */
+    __attribute__((format(printf, 4, 5))) void log(Site& site, Level level, const char* format, ...) {
+        const int64_t now = nowNanos();
+        if (level >= Level::Error) {
+            char text[TEXT_BYTES];
+            va_list args;
+            va_start(args, format);
+            vsnprintf(text, TEXT_BYTES, format, args);
+            va_end(args);
+            std::lock_guard<std::mutex> drainLock(drainMutex_);
+            drainLocked();
+            config_.sink({level, site.tag(), text, static_cast<uint32_t>(syscall(SYS_gettid)), now, 0});
+            return;
+        }
+        if (!site.admit(now)) return;
+        Ring& ring = threadRing();
+        Ring::Entry* entry = ring.reserve();
+        if (entry == nullptr) return;
+
+        entry->nanos = now;
+        entry->site = &site;
+        entry->level = level;
+        entry->suppressed = site.takeSuppressed();
+        va_list args;
+        va_start(args, format);
+        vsnprintf(entry->text, TEXT_BYTES, format, args);
+        va_end(args);
+        ring.publish();
+    }
+
+    /**
+     * Write every published message to the sink in timestamp order, then
+     * report dropped messages and free the rings of exited threads.
+     * Called by the drain thread; safe to call from others.
+     * @return messages written
+     */
+    size_t drain() {
+        std::lock_guard<std::mutex> drainLock(drainMutex_);
+        return drainLocked();
+    }
+
+    /** Rings registered and not yet freed. */
+    size_t ringCount() const {
+        std::lock_guard<std::mutex> lock(ringsMutex_);
+        return rings_.size();
+    }
+
+private:
+    struct Pending {
+        int64_t nanos;
+        size_t ring;
+        uint64_t index;
+    };
+
+    // Rings of the calling thread, one per logger it has used
+    struct ThreadRings {
+        uint64_t lastId = 0;
+        Ring* last = nullptr;
+        std::vector<std::pair<uint64_t, std::shared_ptr<Ring>>> rings;
+    };
+
+    // drain() with drainMutex_ held
+    size_t drainLocked() {
+        {
+            std::lock_guard<std::mutex> lock(ringsMutex_);
+            snapshot_ = rings_;
+        }
+
+        pending_.clear();
+        heads_.clear();
+        for (size_t r = 0; r < snapshot_.size(); r++) {
+            const uint64_t head = snapshot_[r]->head();
+            heads_.push_back(head);
+            for (uint64_t i = snapshot_[r]->tail(); i < head; i++) pending_.push_back({snapshot_[r]->at(i).nanos, r, i});
+        }
+        std::sort(pending_.begin(), pending_.end(), [](const Pending& a, const Pending& b) {
+            return a.nanos != b.nanos ? a.nanos < b.nanos : a.ring != b.ring ? a.ring < b.ring : a.index < b.index;
+        });
+        for (const Pending& p : pending_) {
+            const Ring& ring = *snapshot_[p.ring];
+            const Ring::Entry& e = ring.at(p.index);
+            config_.sink({e.level, e.site->tag(), e.text, ring.thread(), e.nanos, e.suppressed});
+        }
+
+        for (size_t r = 0; r < snapshot_.size(); r++) {
+            Ring& ring = *snapshot_[r];
+            ring.release(heads_[r]);
+            const uint32_t dropped = ring.takeDropped();
+            if (dropped > 0) {
+                char text[64];
+                snprintf(text, sizeof(text), "%u messages dropped, log ring full", dropped);
+                config_.sink({Level::Warn, "LogRing", text, ring.thread(), nowNanos(), 0});
+            }
+        }
+
+        snapshot_.clear();
+        {
+            // A ring only the logger holds belongs to an exited thread; free it once drained
+            std::lock_guard<std::mutex> lock(ringsMutex_);
+            rings_.erase(std::remove_if(rings_.begin(), rings_.end(), [](const std::shared_ptr<Ring>& ring) {
+                return ring.use_count() == 1 && ring->tail() == ring->head();
+            }), rings_.end());
+        }
+        return pending_.size();
+    }
+
+    static uint64_t nextId() {
+        static std::atomic<uint64_t> next{1};
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Ring& threadRing() {
+        thread_local ThreadRings local;
+        if (local.lastId == id_) return *local.last;
+
+        auto it = std::find_if(local.rings.begin(), local.rings.end(),
+                               [this](const auto& entry) { return entry.first == id_; });
+        if (it == local.rings.end()) {
+            auto ring = std::make_shared<Ring>(static_cast<uint32_t>(syscall(SYS_gettid)));
+            {
+                std::lock_guard<std::mutex> lock(ringsMutex_);
+                rings_.push_back(ring);
+            }
+            local.rings.emplace_back(id_, std::move(ring));
+            it = local.rings.end() - 1;
+        }
+        local.lastId = id_;
+        local.last = it->second.get();
+        return *local.last;
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        while (!stopping_) {
+            wake_.wait_for(lock, config_.interval, [this] { return stopping_; });
+            lock.unlock();
+            drain();
+            lock.lock();
+        }
+    }
+
+    Config config_;
+    const uint64_t id_;
+    mutable std::mutex ringsMutex_;
+    std::vector<std::shared_ptr<Ring>> rings_;
+
+    // Drain state, reused between drains; errors write under the same lock
+    std::mutex drainMutex_;
+    std::vector<std::shared_ptr<Ring>> snapshot_;
+    std::vector<Pending> pending_;
+    std::vector<uint64_t> heads_;
+
+    std::mutex wakeMutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+/** Process-wide logger used by the renderer. */
+inline Logger& shared() {
+    static Logger logger;
+    return logger;
+}
+
+} // namespace logring
+
+#endif // LOG_RING_H
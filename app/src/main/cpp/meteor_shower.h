@@ -0,0 +1,199 @@
+#ifndef METEOR_SHOWER_H
+#define METEOR_SHOWER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * Live meteors for the GPU particle system.
+ *
+ * A fixed pool of MAX_PARTICLES particles lives in a device-local storage
+ * buffer. Each frame meteor.comp runs one invocation per slot: free slots
+ * spawn a meteor from an active radiant with a chance set by the showers'
+ * rates, live ones age, and every live meteor appends one Streak instance
+ * and bumps the instance count of an indirect draw. meteor.vert/.frag draw
+ * the streaks additively. The CPU only resets the draw arguments and
+ * dispatches, so the cost is fixed by the pool size, not by activity.
+ *
+ * Meteors move along great circles away from their radiant. This header
+ * holds the buffer layouts and a CPU reference of the shader math (spawn,
+ * motion, streak), which meteor.comp must match.
+ */
+namespace meteors {
+
+constexpr uint32_t MAX_PARTICLES = 4096;
+constexpr uint32_t WORKGROUP_SIZE = 64;  // local_size_x in meteor.comp
+constexpr uint32_t MAX_RADIANTS = 16;
+
+// Meteors first appear between these angles from their radiant (radians)
+constexpr float MIN_RADIANT_DISTANCE = 0.17f;  // ~10 degrees
+constexpr float MAX_RADIANT_DISTANCE = 1.40f;  // ~80 degrees
+// Angular speed 90 degrees from the radiant; slower nearer it (foreshortening)
+constexpr float MAX_SPEED = 0.6f;  // radians per second
+constexpr float MIN_LIFETIME = 0.3f;
+constexpr float MAX_LIFETIME = 1.2f;
+constexpr float TRAIL_SECONDS = 0.25f;  // The streak covers this much of the path behind the head
+// Longest step integrated at once; hitches do not make meteors jump
+constexpr float MAX_STEP = 0.1f;
+
+/** An active radiant (std430 vec4 in meteor.comp). */
+struct Radiant {
+    float x, y, z;  // Unit direction
+    float rate;     // Meteors per second
+};
+static_assert(sizeof(Radiant) == 16, "Radiant must stay 16 bytes (see meteor.comp)");
+
+/** One pool slot; free while age >= lifetime (a zeroed buffer is all free). */
+struct Particle {
+    float x, y, z, age;         // Start point (unit vector), seconds since spawn
+    float dx, dy, dz, lifetime; // Unit tangent at the start, away from the radiant; seconds
+    float speed, brightness;    // Radians per second; peak brightness in [0, 1]
+    float reserved[2];
+};
+static_assert(sizeof(Particle) == 48, "Particle must stay 48 bytes (see meteor.comp)");
+
+/** Per-instance vertex data; layout must match the attributes in meteor.vert. */
+struct Streak {
+    float headX, headY, headZ, brightness;
+    float tailX, tailY, tailZ, widthPixels;
+};
+static_assert(sizeof(Streak) == 32, "Streak must stay 32 bytes (see meteor.vert)");
+
+/** Push constants of meteor.comp. */
+struct SimulationConstants {
+    float dt;                 // Seconds since the last step, at most MAX_STEP
+    uint32_t spawnThreshold;  // A free slot spawns if its 32-bit draw is below this
+    float totalRate;          // Sum of radiant rates (meteors per second)
+    uint32_t seed;            // Changes every step
+    uint32_t radiantCount;
+};
+
+/**
+ * Meteors per second seen from a radiant: the zenithal hourly rate scaled
+ * by the radiant's altitude (none while it is below the horizon).
+ */
+inline float ratePerSecond(float zhr, float sinRadiantAltitude) {
+    return std::max(0.0f, zhr) * std::clamp(sinRadiantAltitude, 0.0f, 1.0f) / 3600.0f;
+}
+
+/** Integer hash (PCG output function); meteor.comp uses the same. */
+inline uint32_t hash(uint32_t v) {
+    const uint32_t state = v * 747796405u + 2891336453u;
+    const uint32_t word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    return (word >> 22u) ^ word;
+}
+
+/**
+ * Threshold on a free slot's raw 32-bit draw, so that the pool as a whole
+ * spawns totalRate * dt meteors per step while mostly free.
+ *
+ * The per-slot chance of a weak shower is around 1e-8, below the 2^-24 step
+ * of a float in [0, 1), so it is compared as a 32-bit integer. Even that is
+ * only a few dozen counts at 10 per hour; the fraction is rounded up or down
+ * by the step's seed so the rate is right on average.
+ */
+inline uint32_t spawnThreshold(float totalRate, float dt, uint32_t seed) {
+    const double chance = static_cast<double>(totalRate) * dt / MAX_PARTICLES;
+    const double scaled = std::clamp(chance * 4294967296.0, 0.0, 4294967295.0);
+    const double whole = std::floor(scaled);
+    const double dither = hash(~seed) / 4294967296.0;
+    return static_cast<uint32_t>(whole) + (dither < scaled - whole ? 1u : 0u);
+}
+
+/** Next uniform number in [0, 1) from a hash chain. */
+inline float random(uint32_t& state) {
+    state = hash(state);
+    return static_cast<float>(state >> 8) * (1.0f / 16777216.0f);
+}
+
+/** Index of the radiant a uniform u in [0, 1) picks, weighted by rate. */
+inline uint32_t pickRadiant(const Radiant* radiants, uint32_t count, float totalRate, float u) {
+    float target = u * totalRate;
+    for (uint32_t i = 0; i + 1 < count; i++) {
+        if (target < radiants[i].rate) return i;
+        target -= radiants[i].rate;
+    }
+    return count - 1;
+}
+
+/** A new meteor from a radiant, drawing its randomness from state. */
+inline Particle spawn(const Radiant& radiant, uint32_t& state) {
+    const float r[3] = {radiant.x, radiant.y, radiant.z};
+    // Basis around the radiant
+    const float a[3] = {std::abs(r[2]) < 0.9f ? 0.0f : 1.0f, 0.0f, std::abs(r[2]) < 0.9f ? 1.0f : 0.0f};
+    float e1[3] = {r[1] * a[2] - r[2] * a[1], r[2] * a[0] - r[0] * a[2], r[0] * a[1] - r[1] * a[0]};
+    const float length = std::sqrt(e1[0] * e1[0] + e1[1] * e1[1] + e1[2] * e1[2]);
+    for (float& c : e1) c /= length;
+    const float e2[3] = {r[1] * e1[2] - r[2] * e1[1], r[2] * e1[0] - r[0] * e1[2], r[0] * e1[1] - r[1] * e1[0]};
+
+    const float theta = MIN_RADIANT_DISTANCE + (MAX_RADIANT_DISTANCE - MIN_RADIANT_DISTANCE) * random(state);
+    const float phi = 6.28318531f * random(state);
+    const float ct = std::cos(theta), st = std::sin(theta);
+    const float cp = std::cos(phi), sp = std::sin(phi);
+
+    Particle p{};
+    float radial[3];
+    for (int i = 0; i < 3; i++) radial[i] = e1[i] * cp + e2[i] * sp;
+    p.x = r[0] * ct + radial[0] * st;
+    p.y = r[1] * ct + radial[1] * st;
+    p.z = r[2] * ct + radial[2] * st;
+    // d/dtheta of the start point: along the great circle, away from the radiant
+    p.dx = -r[0] * st + radial[0] * ct;
+    p.dy = -r[1] * st + radial[1] * ct;
+    p.dz = -r[2] * st + radial[2] * ct;
+    p.speed = MAX_SPEED * st * (0.5f + 0.5f * random(state));
+    p.lifetime = MIN_LIFETIME + (MAX_LIFETIME - MIN_LIFETIME) * random(state);
+    const float b = random(state);
+    p.brightness = 0.3f + 0.7f * b * b;
+    p.age = 0.0f;
+    return p;
+}
+
+/** Direction of a meteor t seconds after it spawned. */
+inline void positionAt(const Particle& p, float t, float out[3]) {
+    const float angle = p.speed * t;
+    const float c = std::cos(angle), s = std::sin(angle);
+    out[0] = p.x * c + p.dx * s;
+    out[1] = p.y * c + p.dy * s;
+    out[2] = p.z * c + p.dz * s;
+}
+
+/** The streak a live meteor draws: head now, tail TRAIL_SECONDS behind, fading in and out. */
+inline Streak streakFor(const Particle& p) {
+    Streak s;
+    float head[3], tail[3];
+    positionAt(p, p.age, head);
+    positionAt(p, std::max(0.0f, p.age - TRAIL_SECONDS), tail);
+    s.headX = head[0];
+    s.headY = head[1];
+    s.headZ = head[2];
+    s.tailX = tail[0];
+    s.tailY = tail[1];
+    s.tailZ = tail[2];
+    const float envelope = std::sin(3.14159265f * std::clamp(p.age / p.lifetime, 0.0f, 1.0f));
+    s.brightness = p.brightness * envelope;
+    s.widthPixels = 1.5f + 1.5f * p.brightness;
+    return s;
+}
+
+/**
+ * One simulation step of one slot, as meteor.comp runs it.
+ *
+ * @return true if the slot holds a live meteor afterwards (and draws a streak)
+ */
+inline bool step(Particle& p, uint32_t slot, const SimulationConstants& constants, const Radiant* radiants) {
+    if (p.age >= p.lifetime) {
+        uint32_t state = hash(hash(slot ^ hash(constants.seed)));
+        if (constants.radiantCount == 0 || state >= constants.spawnThreshold) return false;
+        const uint32_t r = pickRadiant(radiants, constants.radiantCount, constants.totalRate, random(state));
+        p = spawn(radiants[r], state);
+    } else {
+        p.age += constants.dt;
+    }
+    return p.age < p.lifetime;
+}
+
+} // namespace meteors
+
+#endif // METEOR_SHOWER_H
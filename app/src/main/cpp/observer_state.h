@@ -0,0 +1,277 @@
+#ifndef OBSERVER_STATE_H
+#define OBSERVER_STATE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * Observer-dependent transforms, recomputed only when their inputs move.
+ *
+ * Everything that depends on where and when the observer is (the site's
+ * Earth-fixed position, the local north/east/zenith frame in celestial
+ * coordinates, the refraction table and the horizon) is derived here from
+ * the location, the time and the atmosphere. update() is cheap to call every
+ * frame: it compares the inputs with those of the last recomputation and
+ * only redoes the parts whose inputs moved past a threshold:
+ *
+ *   site        location moved more than positionMeters
+ *   frame       site changed, or the Earth turned more than frameArcsec
+ *   refraction  site altitude or atmosphere changed past their thresholds
+ *   horizon     site or refraction changed (frame changes move it too)
+ *
+ * Each part carries a version stamp, taken from one counter that only
+ * increases. A dependent cache stores the stamp it was built from and
+ * rebuilds exactly when the stamp differs, rather than every frame.
+ *
+ * Celestial coordinates are those of the rest of the app: x toward RA 0,
+ * z toward the north celestial pole, with the Earth turned by Greenwich mean
+ * sidereal time (no precession or nutation).
+ */
+namespace observer {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr double DEG = PI / 180.0;
+constexpr double ARCSEC = DEG / 3600.0;
+
+// WGS84 ellipsoid
+constexpr double EARTH_A = 6378137.0;
+constexpr double EARTH_F = 1.0 / 298.257223563;
+constexpr double EARTH_E2 = EARTH_F * (2.0 - EARTH_F);
+
+// Standard atmosphere used when no reading is given: sea-level pressure
+// scaled by altitude, and a fixed temperature
+constexpr double SEA_LEVEL_PRESSURE_HPA = 1013.25;
+constexpr double PRESSURE_SCALE_HEIGHT_M = 8434.0;
+constexpr double DEFAULT_TEMPERATURE_C = 10.0;
+
+// Refraction table: true altitude from REFRACTION_MIN_DEG to 90 degrees
+constexpr double REFRACTION_MIN_DEG = -2.0;
+constexpr double REFRACTION_STEP_DEG = 0.25;
+constexpr int REFRACTION_ENTRIES = static_cast<int>((90.0 - REFRACTION_MIN_DEG) / REFRACTION_STEP_DEG) + 1;
+
+struct Thresholds {
+    double positionMeters = 50.0;
+    double frameArcsec = 30.0;       // Earth rotation; 30" is two seconds of time
+    double pressureHpa = 1.0;
+    double temperatureC = 1.0;
+};
+
+struct Location {
+    double latitudeDeg = 0.0;   // Geodetic
+    double longitudeDeg = 0.0;  // East positive
+    double altitudeM = 0.0;     // Above the ellipsoid
+};
+
+/** Earth-fixed position of the site. */
+struct Site {
+    Location location;
+    double ecef[3] = {EARTH_A, 0.0, 0.0};  // Meters
+    uint64_t version = 0;
+};
+
+/** Local frame in celestial coordinates, at the sidereal time it was computed for. */
+struct Frame {
+    double zenith[3] = {1.0, 0.0, 0.0};
+    double north[3] = {0.0, 0.0, 1.0};
+    double east[3] = {0.0, 1.0, 0.0};
+    double localSiderealRad = 0.0;
+    uint64_t version = 0;
+};
+
+/** Refraction by true altitude, for the site's atmosphere. */
+struct Refraction {
+    double pressureHpa = SEA_LEVEL_PRESSURE_HPA;
+    double temperatureC = DEFAULT_TEMPERATURE_C;
+    float table[REFRACTION_ENTRIES] = {};  // Radians
+    uint64_t version = 0;
+
+    /** Refraction (radians, to add to the altitude) at a true altitude in radians. */
+    double at(double altitudeRad) const {
+        const double x = (altitudeRad / DEG - REFRACTION_MIN_DEG) / REFRACTION_STEP_DEG;
+        if (x <= 0.0) return table[0];
+        if (x >= REFRACTION_ENTRIES - 1) return table[REFRACTION_ENTRIES - 1];
+        const int i = static_cast<int>(x);
+        const double t = x - i;
+        return table[i] + t * (table[i + 1] - table[i]);
+    }
+};
+
+/**
+ * Horizon plane in celestial coordinates: a direction v is above the
+ * visible horizon when dot(plane.xyz, v) + plane.w >= 0. The visible
+ * horizon lies below the astronomical one by the dip of an elevated site
+ * plus the refraction at the horizon, so w is the sine of that depression.
+ */
+struct Horizon {
+    float plane[4] = {1.0f, 0.0f, 0.0f, 0.0f};
+    double depressionRad = 0.0;
+    uint64_t version = 0;
+};
+
+/** Julian date of a Unix time in seconds. */
+inline double julianDate(double unixSeconds) {
+    return 2440587.5 + unixSeconds / 86400.0;
+}
+
+/** Greenwich mean sidereal time in radians, [0, 2 pi) (IAU 1982). */
+inline double greenwichSiderealRad(double unixSeconds) {
+    const double d = julianDate(unixSeconds) - 2451545.0;
+    const double t = d / 36525.0;
+    const double deg = 280.46061837 + 360.98564736629 * d + 0.000387933 * t * t - t * t * t / 38710000.0;
+    const double wrapped = std::fmod(deg, 360.0);
+    return (wrapped < 0.0 ? wrapped + 360.0 : wrapped) * DEG;
+}
+
+/** Geodetic location to Earth-fixed coordinates (meters) on the WGS84 ellipsoid. */
+inline void geodeticToEcef(const Location& location, double out[3]) {
+    const double lat = location.latitudeDeg * DEG, lon = location.longitudeDeg * DEG;
+    const double sinLat = std::sin(lat), cosLat = std::cos(lat);
+    const double n = EARTH_A / std::sqrt(1.0 - EARTH_E2 * sinLat * sinLat);
+    out[0] = (n + location.altitudeM) * cosLat * std::cos(lon);
+    out[1] = (n + location.altitudeM) * cosLat * std::sin(lon);
+    out[2] = (n * (1.0 - EARTH_E2) + location.altitudeM) * sinLat;
+}
+
+/**
+ * Refraction at a true altitude in degrees (Saemundsson 1986), radians,
+ * scaled for pressure and temperature. Held at its -1 degree value below
+ * that, where the formula diverges.
+ */
+inline double refractionRad(double altitudeDeg, double pressureHpa, double temperatureC) {
+    const double h = std::max(altitudeDeg, -1.0);
+    const double arcmin = 1.02 / std::tan((h + 10.3 / (h + 5.11)) * DEG);
+    const double scale = (pressureHpa / 1010.0) * (283.0 / (273.0 + temperatureC));
+    return std::max(0.0, arcmin * scale) * 60.0 * ARCSEC;
+}
+
+class State {
+public:
+    explicit State(Thresholds thresholds = Thresholds()) : thresholds_(thresholds) {}
+
+    /**
+     * Bring the state to a location and time, recomputing only the parts
+     * whose inputs moved past the thresholds.
+     * @return true if any part's version changed
+     */
+    bool update(const Location& location, double unixSeconds) {
+        const uint64_t before = counter_;
+        if (!valid_ || moved(location)) computeSite(location);
+        const double sidereal = greenwichSiderealRad(unixSeconds) + site_.location.longitudeDeg * DEG;
+        if (frame_.version < site_.version || turned(sidereal)) computeFrame(sidereal);
+        applyAtmosphere();
+        if (horizon_.version < std::max(frame_.version, refraction_.version)) computeHorizon();
+        valid_ = true;
+        return counter_ != before;
+    }
+
+    /**
+     * Use measured pressure and temperature instead of the standard
+     * atmosphere; takes effect now if update() has run.
+     * @return true if the refraction table changed
+     */
+    bool setAtmosphere(double pressureHpa, double temperatureC) {
+        measured_ = true;
+        measuredPressureHpa_ = pressureHpa;
+        measuredTemperatureC_ = temperatureC;
+        if (!valid_) return false;
+        const uint64_t before = refraction_.version;
+        applyAtmosphere();
+        if (horizon_.version < refraction_.version) computeHorizon();
+        return refraction_.version != before;
+    }
+
+    /** Whether update() has run; the parts hold defaults until then. */
+    bool valid() const { return valid_; }
+
+    const Site& site() const { return site_; }
+    const Frame& frame() const { return frame_; }
+    const Refraction& refraction() const { return refraction_; }
+    const Horizon& horizon() const { return horizon_; }
+
+    /** Latest stamp of any part; unchanged means nothing changed. */
+    uint64_t version() const { return counter_; }
+
+private:
+    bool moved(const Location& location) const {
+        double ecef[3];
+        geodeticToEcef(location, ecef);
+        const double dx = ecef[0] - site_.ecef[0], dy = ecef[1] - site_.ecef[1], dz = ecef[2] - site_.ecef[2];
+        return dx * dx + dy * dy + dz * dz > thresholds_.positionMeters * thresholds_.positionMeters;
+    }
+
+    bool turned(double sidereal) const {
+        double delta = std::fmod(std::abs(sidereal - frame_.localSiderealRad), 2.0 * PI);
+        delta = std::min(delta, 2.0 * PI - delta);
+        return delta > thresholds_.frameArcsec * ARCSEC;
+    }
+
+    void computeSite(const Location& location) {
+        site_.location = location;
+        geodeticToEcef(location, site_.ecef);
+        site_.version = ++counter_;
+
+        // The site's dip follows its altitude, so the horizon is redone with the frame
+        const double drop = std::max(0.0, location.altitudeM);
+        dipRad_ = std::acos(std::min(1.0, EARTH_A / (EARTH_A + drop)));
+    }
+
+    void computeFrame(double sidereal) {
+        const double lat = site_.location.latitudeDeg * DEG;
+        const double sinLat = std::sin(lat), cosLat = std::cos(lat);
+        const double sinLst = std::sin(sidereal), cosLst = std::cos(sidereal);
+        frame_.zenith[0] = cosLat * cosLst;
+        frame_.zenith[1] = cosLat * sinLst;
+        frame_.zenith[2] = sinLat;
+        frame_.north[0] = -sinLat * cosLst;
+        frame_.north[1] = -sinLat * sinLst;
+        frame_.north[2] = cosLat;
+        // East = north x zenith, so azimuth runs from north through east
+        frame_.east[0] = -sinLst;
+        frame_.east[1] = cosLst;
+        frame_.east[2] = 0.0;
+        frame_.localSiderealRad = sidereal;
+        frame_.version = ++counter_;
+    }
+
+    void applyAtmosphere() {
+        const double pressureHpa = measured_ ? measuredPressureHpa_
+            : SEA_LEVEL_PRESSURE_HPA * std::exp(-site_.location.altitudeM / PRESSURE_SCALE_HEIGHT_M);
+        const double temperatureC = measured_ ? measuredTemperatureC_ : DEFAULT_TEMPERATURE_C;
+        const bool changed = refraction_.version == 0 ||
+                             std::abs(pressureHpa - refraction_.pressureHpa) > thresholds_.pressureHpa ||
+                             std::abs(temperatureC - refraction_.temperatureC) > thresholds_.temperatureC;
+        if (!changed) return;
+        refraction_.pressureHpa = pressureHpa;
+        refraction_.temperatureC = temperatureC;
+        for (int i = 0; i < REFRACTION_ENTRIES; i++) {
+            const double altitude = REFRACTION_MIN_DEG + i * REFRACTION_STEP_DEG;
+            refraction_.table[i] = static_cast<float>(refractionRad(altitude, pressureHpa, temperatureC));
+        }
+        refraction_.version = ++counter_;
+    }
+
+    void computeHorizon() {
+        // What shows at apparent altitude -dip has a true altitude of -dip - R(-dip)
+        horizon_.depressionRad = dipRad_ + refraction_.at(-dipRad_);
+        for (int i = 0; i < 3; i++) horizon_.plane[i] = static_cast<float>(frame_.zenith[i]);
+        horizon_.plane[3] = static_cast<float>(std::sin(horizon_.depressionRad));
+        horizon_.version = ++counter_;
+    }
+
+    Thresholds thresholds_;
+    bool valid_ = false;
+    bool measured_ = false;  // Atmosphere from setAtmosphere rather than the standard one
+    double measuredPressureHpa_ = SEA_LEVEL_PRESSURE_HPA;
+    double measuredTemperatureC_ = DEFAULT_TEMPERATURE_C;
+    uint64_t counter_ = 0;
+    double dipRad_ = 0.0;
+    Site site_;
+    Frame frame_;
+    Refraction refraction_;
+    Horizon horizon_;
+};
+
+} // namespace observer
+
+#endif // OBSERVER_STATE_H
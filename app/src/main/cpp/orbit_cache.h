@@ -0,0 +1,316 @@
+#ifndef ORBIT_CACHE_H
+#define ORBIT_CACHE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Orbit tracks: the path a planet, comet or satellite traces on the sky
+ * over a time window, as polylines of unit directions.
+ *
+ * Tracks are sampled adaptively: a segment is split while the true
+ * position at its midpoint lies farther from the drawn chord than the
+ * tolerance (the on-screen error, in radians), so tight loops near
+ * opposition get many vertices and slow drifts few. The cache keeps every
+ * polyline and re-samples a track only when its elements change, the
+ * window moves by a good part of its span or the zoom changes the
+ * tolerance by more than TOLERANCE_RATIO; otherwise a frame costs nothing.
+ *
+ * Positions come from two-body Kepler orbits (elliptic, parabolic or
+ * hyperbolic) in the ecliptic of J2000, seen from the Earth's center.
+ */
+namespace orbits {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr double J2000 = 2451545.0;
+constexpr double GAUSS_K = 0.01720209895;           // Sun: sqrt(GM) in AU^1.5 per day
+constexpr double SUN_EARTH_MASS_RATIO = 332946.0487;
+constexpr double OBLIQUITY = 23.4392911 * PI / 180.0;  // J2000
+
+constexpr uint32_t SEED_SEGMENTS = 8;  // Uniform segments refined from, so loops are not missed
+constexpr int MAX_DEPTH = 10;          // Each seed segment splits into at most 2^MAX_DEPTH
+constexpr double WINDOW_SHIFT = 0.1;   // Re-sample once the window moves by this fraction of its span
+constexpr double TOLERANCE_RATIO = 2.0;
+
+/** Body an orbit is around; values match OrbitElements.CENTER_* in Primitive.kt. */
+enum class Center : uint8_t {
+    Sun = 0,    // Planets, comets, asteroids
+    Earth = 1,  // Satellites (directions from the Earth's center)
+};
+
+/** Osculating elements, ecliptic and equinox J2000. */
+struct Elements {
+    double q;              // Pericenter distance (AU)
+    double e;              // Eccentricity
+    double inclination;    // Radians
+    double argPericenter;  // Radians
+    double node;           // Longitude of the ascending node (radians)
+    double pericenterJd;   // Time of pericenter passage
+    Center center;
+
+    bool operator==(const Elements&) const = default;
+};
+
+/** The Earth's orbit, J2000 mean elements (as in PlanetCalculator.kt). */
+inline Elements earth() {
+    const double a = 1.00000261;
+    const double e = 0.01671123;
+    const double perihelion = 102.93768193 * PI / 180.0;  // Longitude of perihelion
+    const double meanLongitude = 100.46457166 * PI / 180.0;
+    const double n = GAUSS_K / (a * std::sqrt(a));
+    const double meanAnomaly = std::remainder(meanLongitude - perihelion, 2.0 * PI);
+    return {a * (1.0 - e), e, 0.0, perihelion, 0.0, J2000 - meanAnomaly / n, Center::Sun};
+}
+
+/** Position relative to the center at a Julian date (ecliptic J2000, AU). */
+inline void position(const Elements& el, double jd, double out[3]) {
+    const double k = el.center == Center::Sun ? GAUSS_K : GAUSS_K / std::sqrt(SUN_EARTH_MASS_RATIO);
+    const double dt = jd - el.pericenterJd;
+    double x, y;  // In the orbital plane, x toward the pericenter
+    if (el.e < 1.0) {
+        const double a = el.q / (1.0 - el.e);
+        const double meanAnomaly = std::remainder(k / (a * std::sqrt(a)) * dt, 2.0 * PI);
+        double E = el.e < 0.8 ? meanAnomaly : (meanAnomaly < 0.0 ? -PI : PI);
+        for (int i = 0; i < 50; i++) {
+            const double dE = (E - el.e * std::sin(E) - meanAnomaly) / (1.0 - el.e * std::cos(E));
+            E -= dE;
+            if (std::abs(dE) < 1e-12) break;
+        }
+        x = a * (std::cos(E) - el.e);
+        y = a * std::sqrt(1.0 - el.e * el.e) * std::sin(E);
+    } else if (el.e > 1.0) {
+        const double a = el.q / (el.e - 1.0);
+        const double meanAnomaly = k / (a * std::sqrt(a)) * dt;
+        double H = std::asinh(meanAnomaly / el.e);
+        for (int i = 0; i < 50; i++) {
+            const double dH = (el.e * std::sinh(H) - H - meanAnomaly) / (el.e * std::cosh(H) - 1.0);
+            H -= dH;
+            if (std::abs(dH) < 1e-12) break;
+        }
+        x = a * (el.e - std::cosh(H));
+        y = a * std::sqrt(el.e * el.e - 1.0) * std::sinh(H);
+    } else {
+        // Barker's equation: s^3 + 3s = W, s = tan(true anomaly / 2)
+        const double W = 3.0 * k / std::sqrt(2.0 * el.q * el.q * el.q) * dt;
+        const double Y = std::cbrt(0.5 * W + std::sqrt(0.25 * W * W + 1.0));
+        const double s = Y - 1.0 / Y;
+        x = el.q * (1.0 - s * s);
+        y = 2.0 * el.q * s;
+    }
+
+    const double co = std::cos(el.argPericenter), so = std::sin(el.argPericenter);
+    const double cn = std::cos(el.node), sn = std::sin(el.node);
+    const double ci = std::cos(el.inclination), si = std::sin(el.inclination);
+    out[0] = x * (cn * co - sn * so * ci) - y * (cn * so + sn * co * ci);
+    out[1] = x * (sn * co + cn * so * ci) - y * (sn * so - cn * co * ci);
+    out[2] = x * (so * si) + y * (co * si);
+}
+
+/** Equatorial unit direction of a body seen from the Earth's center at a Julian date. */
+inline void skyDirection(const Elements& body, const Elements& earthOrbit, double jd, double out[3]) {
+    double p[3];
+    position(body, jd, p);
+    if (body.center == Center::Sun) {
+        double e[3];
+        position(earthOrbit, jd, e);
+        for (int i = 0; i < 3; i++) p[i] -= e[i];
+    }
+    const double ce = std::cos(OBLIQUITY), se = std::sin(OBLIQUITY);
+    const double eq[3] = {p[0], p[1] * ce - p[2] * se, p[1] * se + p[2] * ce};
+    const double length = std::sqrt(eq[0] * eq[0] + eq[1] * eq[1] + eq[2] * eq[2]);
+    for (int i = 0; i < 3; i++) out[i] = length > 0.0 ? eq[i] / length : 0.0;
+}
+
+/** Angle between the true midpoint and the chord from a to b, as drawn (radians). */
+inline double chordError(const double a[3], const double b[3], const double mid[3]) {
+    double c[3];
+    double length2 = 0.0;
+    for (int i = 0; i < 3; i++) {
+        c[i] = a[i] + b[i];
+        length2 += c[i] * c[i];
+    }
+    if (length2 < 1e-24) return PI;  // Antipodal ends: any chord is wrong
+    const double inv = 1.0 / std::sqrt(length2);
+    double d2 = 0.0;
+    for (int i = 0; i < 3; i++) {
+        const double d = c[i] * inv - mid[i];
+        d2 += d * d;
+    }
+    return 2.0 * std::asin(std::min(1.0, 0.5 * std::sqrt(d2)));
+}
+
+/**
+ * Sample the sky path of a body from startJd to endJd, appending unit
+ * directions (x, y, z) to out.
+ *
+ * @return Number of ephemeris evaluations
+ */
+inline size_t sample(const Elements& body, const Elements& earthOrbit, double startJd, double endJd,
+                     double tolerance, std::vector<float>& out) {
+    size_t evaluations = 0;
+    auto emit = [&](const double d[3]) {
+        out.push_back(static_cast<float>(d[0]));
+        out.push_back(static_cast<float>(d[1]));
+        out.push_back(static_cast<float>(d[2]));
+    };
+    auto refine = [&](auto& self, double ta, const double* a, double tb, const double* b, int depth) -> void {
+        const double tm = 0.5 * (ta + tb);
+        double m[3];
+        skyDirection(body, earthOrbit, tm, m);
+        evaluations++;
+        if (depth < MAX_DEPTH && chordError(a, b, m) > tolerance) {
+            self(self, ta, a, tm, m, depth + 1);
+            self(self, tm, m, tb, b, depth + 1);
+        } else {
+            emit(b);
+        }
+    };
+
+    double a[3], b[3];
+    skyDirection(body, earthOrbit, startJd, a);
+    evaluations++;
+    emit(a);
+    for (uint32_t s = 1; s <= SEED_SEGMENTS; s++) {
+        const double ta = startJd + (endJd - startJd) * (s - 1) / SEED_SEGMENTS;
+        const double tb = startJd + (endJd - startJd) * s / SEED_SEGMENTS;
+        skyDirection(body, earthOrbit, tb, b);
+        evaluations++;
+        refine(refine, ta, a, tb, b, 0);
+        std::copy(b, b + 3, a);
+    }
+    return evaluations;
+}
+
+/** One tracked orbit. */
+struct Track {
+    uint32_t id;     // Caller's key; a track keeps its polyline while id and elements stay
+    Elements elements;
+    uint32_t argb;   // Line color
+};
+
+/**
+ * Polylines for a set of tracks, re-sampled only when needed, and packed
+ * as one line list: 7-float vertices (position, RGBA) and index pairs.
+ */
+class Cache {
+public:
+    /** Replace the tracked orbits; unchanged tracks keep their polylines. */
+    void set(const std::vector<Track>& tracks) {
+        std::vector<Entry> entries;
+        entries.reserve(tracks.size());
+        for (const Track& track : tracks) {
+            auto old = std::find_if(entries_.begin(), entries_.end(), [&](const Entry& e) {
+                return e.track.id == track.id && e.track.elements == track.elements;
+            });
+            if (old != entries_.end()) {
+                entries.push_back(std::move(*old));
+                entries.back().track.argb = track.argb;
+            } else {
+                Entry entry;
+                entry.track = track;
+                entries.push_back(std::move(entry));
+            }
+        }
+        entries_ = std::move(entries);
+        dirty_ = true;
+    }
+
+    /**
+     * Bring the polylines up to date for a time window and tolerance
+     * (radians of on-screen error).
+     *
+     * @return Number of tracks re-sampled
+     */
+    size_t update(double startJd, double endJd, double tolerance) {
+        if (!(endJd > startJd) || !(tolerance > 0.0)) return 0;
+        lastEvaluations_ = 0;
+        size_t resampled = 0;
+        for (Entry& entry : entries_) {
+            if (!stale(entry, startJd, endJd, tolerance)) continue;
+            entry.points.clear();
+            lastEvaluations_ += sample(entry.track.elements, earth_, startJd, endJd, tolerance, entry.points);
+            entry.startJd = startJd;
+            entry.endJd = endJd;
+            entry.tolerance = tolerance;
+            entry.sampled = true;
+            resampled++;
+        }
+        if (resampled > 0) dirty_ = true;
+        return resampled;
+    }
+
+    /** True when the packed lines changed since the last markClean(). */
+    bool dirty() const { return dirty_; }
+    void markClean() { dirty_ = false; }
+
+    size_t vertexCount() const {
+        size_t n = 0;
+        for (const Entry& entry : entries_) n += entry.points.size() / 3;
+        return n;
+    }
+
+    size_t indexCount() const {
+        size_t n = 0;
+        for (const Entry& entry : entries_) {
+            const size_t points = entry.points.size() / 3;
+            if (points > 1) n += 2 * (points - 1);
+        }
+        return n;
+    }
+
+    /**
+     * Pack every polyline: vertexCount() * 7 floats into vertices and
+     * indexCount() line-list indices into indices.
+     */
+    void write(float* vertices, uint32_t* indices) const {
+        uint32_t base = 0;
+        for (const Entry& entry : entries_) {
+            const uint32_t argb = entry.track.argb;
+            const float rgba[4] = {((argb >> 16) & 0xff) / 255.0f, ((argb >> 8) & 0xff) / 255.0f,
+                                   (argb & 0xff) / 255.0f, ((argb >> 24) & 0xff) / 255.0f};
+            const uint32_t points = static_cast<uint32_t>(entry.points.size() / 3);
+            for (uint32_t i = 0; i < points; i++) {
+                std::copy(entry.points.begin() + i * 3, entry.points.begin() + i * 3 + 3, vertices);
+                std::copy(rgba, rgba + 4, vertices + 3);
+                vertices += 7;
+            }
+            for (uint32_t i = 0; i + 1 < points; i++) {
+                *indices++ = base + i;
+                *indices++ = base + i + 1;
+            }
+            base += points;
+        }
+    }
+
+    size_t size() const { return entries_.size(); }
+    /** Ephemeris evaluations made by the last update(). */
+    size_t lastEvaluations() const { return lastEvaluations_; }
+
+private:
+    struct Entry {
+        Track track;
+        std::vector<float> points;
+        double startJd = 0.0;
+        double endJd = 0.0;
+        double tolerance = 0.0;
+        bool sampled = false;
+    };
+
+    static bool stale(const Entry& entry, double startJd, double endJd, double tolerance) {
+        if (!entry.sampled) return true;
+        const double shift = WINDOW_SHIFT * (endJd - startJd);
+        return std::abs(startJd - entry.startJd) > shift || std::abs(endJd - entry.endJd) > shift ||
+               tolerance * TOLERANCE_RATIO < entry.tolerance || tolerance > entry.tolerance * TOLERANCE_RATIO;
+    }
+
+    std::vector<Entry> entries_;
+    Elements earth_ = earth();
+    size_t lastEvaluations_ = 0;
+    bool dirty_ = false;
+};
+
+} // namespace orbits
+
+#endif // ORBIT_CACHE_H
@@ -0,0 +1,443 @@
+#ifndef SKY_STORE_H
+#define SKY_STORE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <vector>
+#include "healpix.h"
+#include "horizon_profile.h"
+
+/**
+ * Structure-of-arrays store of fixed sky objects shared by the layers.
+ *
+ * Every object lives once, as one row across parallel columns: unit
+ * direction (x, y, z), magnitude, palette color index and alpha, type
+ * flags, name id and layer id. Kernels stream only the columns they need.
+ *
+ * Rows are sorted by HEALPix cell and, within a cell, brightest first. Each
+ * occupied cell records its row range and a bounding cap (center and
+ * cosine of its radius), so culling and picking reject whole cells with
+ * one dot product and then scan contiguous rows.
+ *
+ * The cell order follows the catalog's density, up to nside 2^16 (about
+ * 3 arcseconds) for deep tiles. Fine stores are culled by descending the
+ * nested pixel tree, so a narrow eyepiece view touches only the few cells
+ * under it. For such views vertices are written relative to an anchor
+ * tile at the view center; the anchor's eye position is composed in double
+ * (see writeStarVertices), which keeps stars steady at arcsecond scales.
+ */
+namespace sky {
+
+// Type flags
+constexpr uint16_t FLAG_STAR = 1 << 0;
+constexpr uint16_t FLAG_DEEP_SKY = 1 << 1;
+constexpr uint16_t FLAG_SOLAR_SYSTEM = 1 << 2;
+constexpr uint16_t FLAG_NAMED = 1 << 8;
+
+constexpr int32_t NO_NAME = -1;
+constexpr uint32_t ALL_LAYERS = 0xffffffffu;
+
+// Cells are sized for roughly this many objects each
+constexpr size_t OBJECTS_PER_CELL = 32;
+constexpr int MAX_CELL_ORDER = 16;
+
+// Stores with at most this many cells are culled by scanning every cell
+constexpr size_t LINEAR_SCAN_CELLS = 1024;
+// Pixel tree descent stops at ranges this small and tests the cells directly
+constexpr size_t LEAF_CELLS = 16;
+
+/** One object as supplied to build(). */
+struct Object {
+    float x, y, z;        // Unit direction
+    float magnitude;
+    uint8_t colorIndex;   // Star palette slot
+    uint8_t alpha;
+    uint16_t flags;
+    int32_t nameId;       // NO_NAME if unnamed
+    uint8_t layer;        // Layer ordinal, < 32
+};
+
+/** Which rows a kernel considers. */
+struct Filter {
+    uint32_t layerMask = ALL_LAYERS;
+    uint16_t requiredFlags = 0;
+    float maxMagnitude = std::numeric_limits<float>::infinity();
+    float fraction = 1.0f;  // Share of each cell's rows, brightest first (frame budget)
+    // Plane dot(p, xyz) + w >= 0 that rows must lie on (zenith and margin while
+    // the ground hides the sky); the default keeps everything
+    float horizon[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+    // Terrain skyline rows must clear, tested after the plane (none by default)
+    horizon::Occluder terrain;
+
+    bool accepts(uint8_t layer, uint16_t flags) const {
+        return ((layerMask >> layer) & 1u) != 0 && (flags & requiredFlags) == requiredFlags;
+    }
+
+    bool aboveHorizon(float x, float y, float z) const {
+        return x * horizon[0] + y * horizon[1] + z * horizon[2] + horizon[3] >= 0.0f && terrain.visible(x, y, z);
+    }
+};
+
+/**
+ * Packed star vertex bits: color index in byte 0, alpha in byte 1 (see
+ * StarVertex) and the twinkle seed in bytes 2-3 (0: star.vert derives one).
+ */
+inline float packStarColor(uint8_t colorIndex, uint8_t alpha, uint16_t seed = 0) {
+    const uint32_t bits = static_cast<uint32_t>(colorIndex) | (static_cast<uint32_t>(alpha) << 8) |
+                          (static_cast<uint32_t>(seed) << 16);
+    float packed;
+    std::memcpy(&packed, &bits, sizeof(packed));
+    return packed;
+}
+
+/** Twinkle seed of an object, from its catalog index so it survives rebuilds; never 0. */
+inline uint16_t twinkleSeed(uint32_t source) {
+    uint32_t h = (source + 1u) * 2654435761u;
+    h ^= h >> 16;
+    return static_cast<uint16_t>(h & 0xffffu) | 1u;
+}
+
+class Store {
+public:
+    /**
+     * Lowest cell order at which occupied cells hold about OBJECTS_PER_CELL
+     * objects on average, from each object's pixel at MAX_CELL_ORDER. An
+     * even all-sky catalog gets a coarse order; a dense patch goes deep.
+     */
+    static int orderFor(std::vector<uint64_t> deepCells) {
+        std::sort(deepCells.begin(), deepCells.end());
+        const size_t n = deepCells.size();
+        for (int order = 0; order < MAX_CELL_ORDER; order++) {
+            const int shift = 2 * (MAX_CELL_ORDER - order);
+            size_t occupied = 0;
+            for (size_t i = 0; i < n; i++) {
+                if (i == 0 || (deepCells[i] >> shift) != (deepCells[i - 1] >> shift)) occupied++;
+            }
+            if (n <= occupied * OBJECTS_PER_CELL) return order;
+        }
+        return MAX_CELL_ORDER;
+    }
+
+    /** Replace the contents. Row order is not input order; see sourceIndex(). */
+    void build(const std::vector<Object>& objects) {
+        const size_t n = objects.size();
+
+        std::vector<uint64_t> cellOf(n);
+        for (size_t i = 0; i < n; i++) {
+            cellOf[i] = healpix::vecToNest(MAX_CELL_ORDER, objects[i].x, objects[i].y, objects[i].z);
+        }
+        order_ = orderFor(cellOf);
+        for (uint64_t& cell : cellOf) cell = healpix::parent(cell, MAX_CELL_ORDER - order_);
+        std::vector<uint32_t> rows(n);
+        std::iota(rows.begin(), rows.end(), 0u);
+        std::stable_sort(rows.begin(), rows.end(), [&](uint32_t a, uint32_t b) {
+            if (cellOf[a] != cellOf[b]) return cellOf[a] < cellOf[b];
+            return objects[a].magnitude < objects[b].magnitude;
+        });
+
+        resize(n);
+        for (size_t r = 0; r < n; r++) {
+            const Object& o = objects[rows[r]];
+            x_[r] = o.x;
+            y_[r] = o.y;
+            z_[r] = o.z;
+            magnitude_[r] = o.magnitude;
+            colorIndex_[r] = o.colorIndex;
+            alpha_[r] = o.alpha;
+            flags_[r] = o.flags;
+            nameId_[r] = o.nameId;
+            layer_[r] = o.layer;
+            sourceIndex_[r] = rows[r];
+        }
+
+        buildCells(cellOf, rows);
+        buildNameIndex();
+    }
+
+    size_t size() const { return x_.size(); }
+    int cellOrder() const { return order_; }
+    size_t cellCount() const { return cells_.size(); }
+
+    // Columns, indexed by row
+    const float* x() const { return x_.data(); }
+    const float* y() const { return y_.data(); }
+    const float* z() const { return z_.data(); }
+    const float* magnitude() const { return magnitude_.data(); }
+    const uint8_t* colorIndex() const { return colorIndex_.data(); }
+    const uint8_t* alpha() const { return alpha_.data(); }
+    const uint16_t* flags() const { return flags_.data(); }
+    const int32_t* nameId() const { return nameId_.data(); }
+    const uint8_t* layer() const { return layer_.data(); }
+    /** Position of each row in the array given to build(). */
+    const uint32_t* sourceIndex() const { return sourceIndex_.data(); }
+
+    /** Change a row's alpha in place (variable stars; see light_curve.h). */
+    void setAlpha(uint32_t row, uint8_t alpha) { alpha_[row] = alpha; }
+
+    /**
+     * Append rows within halfAngle radians of dir (unit vector) that pass
+     * the filter. Rows come out cell by cell, brightest first within a cell.
+     *
+     * @return Number of rows appended
+     */
+    template<typename Rows>
+    size_t cull(const float dir[3], float halfAngle, const Filter& filter, Rows& out) const {
+        const size_t before = out.size();
+        const double maxChord2 = chord2For(halfAngle);
+        visitCells(dir, halfAngle, [&](const Cell& cell) {
+            if (capBelowHorizon(cell, filter)) return;
+
+            const uint32_t count = cell.end - cell.begin;
+            const uint32_t take = filter.fraction >= 1.0f
+                ? count
+                : static_cast<uint32_t>(std::ceil(count * std::max(0.0f, filter.fraction)));
+            const uint32_t end = cell.begin + take;
+            for (uint32_t r = cell.begin; r < end; r++) {
+                if (magnitude_[r] > filter.maxMagnitude) break;  // Rest of the cell is fainter
+                if (!filter.accepts(layer_[r], flags_[r])) continue;
+                if (chord2(r, dir) > maxChord2) continue;
+                if (!filter.aboveHorizon(x_[r], y_[r], z_[r])) continue;
+                out.push_back(r);
+            }
+        });
+        return out.size() - before;
+    }
+
+    /**
+     * Row closest to dir within maxAngle radians, preferring the brighter of
+     * equally close rows; -1 if none.
+     */
+    int64_t pick(const float dir[3], float maxAngle, const Filter& filter = Filter()) const {
+        int64_t best = -1;
+        double bestChord2 = chord2For(maxAngle);
+        visitCells(dir, maxAngle, [&](const Cell& cell) {
+            if (capBelowHorizon(cell, filter)) return;
+            for (uint32_t r = cell.begin; r < cell.end; r++) {
+                if (magnitude_[r] > filter.maxMagnitude || !filter.accepts(layer_[r], flags_[r])) continue;
+                if (!filter.aboveHorizon(x_[r], y_[r], z_[r])) continue;
+                const double d = chord2(r, dir);
+                if (d < bestChord2 || (d == bestChord2 && best >= 0 && magnitude_[r] < magnitude_[best])) {
+                    bestChord2 = d;
+                    best = r;
+                }
+            }
+        });
+        return best;
+    }
+
+    /** Row with the given name id (the brightest if several share it); -1 if none. */
+    int64_t findName(int32_t nameId) const {
+        auto it = std::lower_bound(names_.begin(), names_.end(), NameEntry{nameId, 0},
+                                   [](const NameEntry& a, const NameEntry& b) { return a.nameId < b.nameId; });
+        if (it == names_.end() || it->nameId != nameId) return -1;
+        return it->row;
+    }
+
+    /**
+     * Write packed star vertices (x, y, z, packed color; 4 floats each) for
+     * the given rows, in order. Positions are relative to anchor, subtracted
+     * in double: near the anchor they stay small and keep full float
+     * precision, where unit vectors would carry only about 0.01 arcsecond.
+     */
+    template<typename Rows>
+    void writeStarVertices(const Rows& rows, float* out, const double anchor[3] = nullptr) const {
+        const double ax = anchor ? anchor[0] : 0.0, ay = anchor ? anchor[1] : 0.0, az = anchor ? anchor[2] : 0.0;
+        for (uint32_t r : rows) {
+            out[0] = static_cast<float>(x_[r] - ax);
+            out[1] = static_cast<float>(y_[r] - ay);
+            out[2] = static_cast<float>(z_[r] - az);
+            out[3] = packStarColor(colorIndex_[r], alpha_[r], twinkleSeed(sourceIndex_[r]));
+            out += 4;
+        }
+    }
+
+    /**
+     * Anchor for vertices around dir: the center of its pixel at
+     * MAX_CELL_ORDER. It only moves when the view crosses a tile edge, so
+     * vertex values stay put as the view drifts within the tile.
+     */
+    static void anchorFor(const float dir[3], double anchor[3]) {
+        healpix::nestToVec(MAX_CELL_ORDER, healpix::vecToNest(MAX_CELL_ORDER, dir[0], dir[1], dir[2]),
+                           anchor[0], anchor[1], anchor[2]);
+    }
+
+private:
+    struct Cell {
+        uint64_t id;           // Nested pixel at the store's order
+        uint32_t begin, end;   // Row range
+        float cx, cy, cz;      // Unit center of the cell's objects
+        float radius;          // Angular radius (radians) covering them
+    };
+
+    struct NameEntry {
+        int32_t nameId;
+        uint32_t row;
+    };
+
+    void resize(size_t n) {
+        x_.assign(n, 0.0f);
+        y_.assign(n, 0.0f);
+        z_.assign(n, 0.0f);
+        magnitude_.assign(n, 0.0f);
+        colorIndex_.assign(n, 0);
+        alpha_.assign(n, 0);
+        flags_.assign(n, 0);
+        nameId_.assign(n, NO_NAME);
+        layer_.assign(n, 0);
+        sourceIndex_.assign(n, 0);
+    }
+
+    // Bounding cap per occupied cell, from the rows it actually holds
+    void buildCells(const std::vector<uint64_t>& cellOf, const std::vector<uint32_t>& rows) {
+        cells_.clear();
+        const uint32_t n = static_cast<uint32_t>(rows.size());
+        for (uint32_t begin = 0; begin < n;) {
+            uint32_t end = begin + 1;
+            while (end < n && cellOf[rows[end]] == cellOf[rows[begin]]) end++;
+
+            double cx = 0.0, cy = 0.0, cz = 0.0;
+            for (uint32_t r = begin; r < end; r++) {
+                cx += x_[r];
+                cy += y_[r];
+                cz += z_[r];
+            }
+            const double len = std::sqrt(cx * cx + cy * cy + cz * cz);
+            if (len > 0.0) {
+                cx /= len;
+                cy /= len;
+                cz /= len;
+            } else {
+                cx = x_[begin];
+                cy = y_[begin];
+                cz = z_[begin];
+            }
+
+            // From the chord, not the dot product: the few-arcsecond cells of
+            // a deep store are below what acos of a dot can resolve
+            double maxChord = 0.0;
+            for (uint32_t r = begin; r < end; r++) {
+                maxChord = std::max(maxChord, std::hypot(x_[r] - cx, y_[r] - cy, z_[r] - cz));
+            }
+            const float radius = static_cast<float>(2.0 * std::asin(std::min(1.0, 0.5 * maxChord))) + 1e-5f;
+            cells_.push_back({cellOf[rows[begin]], begin, end, static_cast<float>(cx), static_cast<float>(cy),
+                              static_cast<float>(cz), radius});
+            begin = end;
+        }
+    }
+
+    void buildNameIndex() {
+        names_.clear();
+        for (uint32_t r = 0; r < size(); r++) {
+            if (nameId_[r] != NO_NAME) names_.push_back({nameId_[r], r});
+        }
+        std::stable_sort(names_.begin(), names_.end(), [this](const NameEntry& a, const NameEntry& b) {
+            if (a.nameId != b.nameId) return a.nameId < b.nameId;
+            return magnitude_[a.row] < magnitude_[b.row];
+        });
+    }
+
+    // Call visit(cell) for every cell whose cap comes within angle of dir
+    template<typename Visit>
+    void visitCells(const float dir[3], float angle, Visit&& visit) const {
+        if (cells_.size() <= LINEAR_SCAN_CELLS) {
+            for (const Cell& cell : cells_) {
+                if (capIntersects(cell, dir, angle)) visit(cell);
+            }
+            return;
+        }
+        for (uint64_t face = 0; face < 12; face++) {
+            descend(0, face, dir, angle, 0, cells_.size(), visit);
+        }
+    }
+
+    // Visit the cells under pixel `pix` at `order`, among cells_[lo, hi)
+    template<typename Visit>
+    void descend(int order, uint64_t pix, const float dir[3], float angle, size_t lo, size_t hi,
+                 Visit& visit) const {
+        const int shift = 2 * (order_ - order);
+        auto firstAtOrAfter = [&](uint64_t id) {
+            return static_cast<size_t>(std::lower_bound(cells_.begin() + lo, cells_.begin() + hi, id,
+                                                         [](const Cell& c, uint64_t v) { return c.id < v; }) -
+                                        cells_.begin());
+        };
+        const size_t begin = firstAtOrAfter(pix << shift);
+        const size_t end = firstAtOrAfter((pix + 1) << shift);
+        if (begin == end || !pixelIntersects(order, pix, dir, angle)) return;
+
+        if (order == order_ || end - begin <= LEAF_CELLS) {
+            for (size_t c = begin; c < end; c++) {
+                if (capIntersects(cells_[c], dir, angle)) visit(cells_[c]);
+            }
+            return;
+        }
+        for (uint64_t child = pix << 2; child < (pix << 2) + 4; child++) {
+            descend(order + 1, child, dir, angle, begin, end, visit);
+        }
+    }
+
+    // Conservative test of a whole pixel against the cone: its center plus
+    // the farthest corner, widened since pixel edges are not great circles
+    static bool pixelIntersects(int order, uint64_t pix, const float dir[3], float angle) {
+        double center[3], corners[4][3];
+        healpix::nestToVec(order, pix, center[0], center[1], center[2]);
+        healpix::nestCorners(order, pix, corners);
+        double maxChord = 0.0;
+        for (const double* corner : corners) {
+            maxChord = std::max(maxChord,
+                                std::hypot(corner[0] - center[0], corner[1] - center[1], corner[2] - center[2]));
+        }
+        const double reach = 2.2 * std::asin(std::min(1.0, 0.5 * maxChord)) + angle;
+        if (reach >= healpix::PI) return true;
+        return chord2(center[0], center[1], center[2], dir) <= chord2For(reach);
+    }
+
+    // Cone tests compare squared chords in double. A dot product of float
+    // unit vectors resolves angles near 0 only to about 0.02 degrees, coarser
+    // than an eyepiece field; the chord keeps its precision at any size.
+    static double chord2For(double angle) {
+        const double chord = 2.0 * std::sin(0.5 * std::min(angle, healpix::PI));
+        return chord * chord;
+    }
+
+    static double chord2(double x, double y, double z, const float dir[3]) {
+        const double dx = x - dir[0], dy = y - dir[1], dz = z - dir[2];
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    double chord2(uint32_t row, const float dir[3]) const { return chord2(x_[row], y_[row], z_[row], dir); }
+
+    static bool capIntersects(const Cell& cell, const float dir[3], float angle) {
+        const double reach = static_cast<double>(cell.radius) + angle;
+        if (reach >= healpix::PI) return true;
+        return chord2(cell.cx, cell.cy, cell.cz, dir) <= chord2For(reach);
+    }
+
+    // True when no point of the cell's cap reaches the filter's horizon plane.
+    // With theta the angle from the plane normal to the cap center, the cap's
+    // highest point is cos(theta - r) <= cos(theta) cos(r) + sin(r).
+    static bool capBelowHorizon(const Cell& cell, const Filter& filter) {
+        const float* h = filter.horizon;
+        const float center = cell.cx * h[0] + cell.cy * h[1] + cell.cz * h[2];
+        return center * std::cos(cell.radius) + std::sin(cell.radius) + h[3] < 0.0f;
+    }
+
+    int order_ = 0;
+    std::vector<float> x_, y_, z_;
+    std::vector<float> magnitude_;
+    std::vector<uint8_t> colorIndex_;
+    std::vector<uint8_t> alpha_;
+    std::vector<uint16_t> flags_;
+    std::vector<int32_t> nameId_;
+    std::vector<uint8_t> layer_;
+    std::vector<uint32_t> sourceIndex_;
+    std::vector<Cell> cells_;
+    std::vector<NameEntry> names_;
+};
+
+} // namespace sky
+
+#endif // SKY_STORE_H
@@ -0,0 +1,180 @@
+#ifndef SKY_TILES_H
+#define SKY_TILES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "healpix.h"
+#include "sky_store.h"
+
+/**
+ * Tiled sky object file format, read by memory-mapping the whole file
+ * (little-endian):
+ *
+ *   Header      uint32 magic, uint32 version, uint32 tileOrder,
+ *               uint32 tileCount, uint64 objectCount
+ *   Directory   (tileCount + 1) x uint64: first record of each tile,
+ *               then objectCount
+ *   Records     objectCount x Record, grouped by tile
+ *
+ * Tiles are the nested HEALPix pixels of tileOrder, so a tile's records are
+ * one contiguous range and a view loads only the tiles it overlaps. Within
+ * a tile, record order is up to the writer; sky::Store sorts rows itself.
+ */
+namespace tiles {
+
+constexpr uint32_t FILE_MAGIC = 0x4c495453;  // "STIL" little-endian
+constexpr uint32_t FILE_VERSION = 1;
+constexpr int MAX_TILE_ORDER = 8;
+
+struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t tileOrder;
+    uint32_t tileCount;
+    uint64_t objectCount;
+};
+
+/** One sky::Object as stored; explicit padding so files are byte-for-byte reproducible. */
+struct Record {
+    float x, y, z;
+    float magnitude;
+    uint8_t colorIndex;
+    uint8_t alpha;
+    uint16_t flags;
+    int32_t nameId;
+    uint8_t layer;
+    uint8_t reserved[3];
+};
+
+static_assert(sizeof(Header) == 24, "Header layout is part of the file format");
+static_assert(sizeof(Record) == 28, "Record layout is part of the file format");
+
+inline uint32_t tileCount(int tileOrder) {
+    return static_cast<uint32_t>(healpix::npix(tileOrder));
+}
+
+inline size_t directoryOffset() { return sizeof(Header); }
+
+inline size_t recordsOffset(int tileOrder) {
+    return directoryOffset() + (static_cast<size_t>(tileCount(tileOrder)) + 1) * sizeof(uint64_t);
+}
+
+inline size_t fileSize(int tileOrder, uint64_t objectCount) {
+    return recordsOffset(tileOrder) + static_cast<size_t>(objectCount) * sizeof(Record);
+}
+
+inline Record toRecord(const sky::Object& o) {
+    Record r = {};
+    r.x = o.x;
+    r.y = o.y;
+    r.z = o.z;
+    r.magnitude = o.magnitude;
+    r.colorIndex = o.colorIndex;
+    r.alpha = o.alpha;
+    r.flags = o.flags;
+    r.nameId = o.nameId;
+    r.layer = o.layer;
+    return r;
+}
+
+inline sky::Object toObject(const Record& r) {
+    return {r.x, r.y, r.z, r.magnitude, r.colorIndex, r.alpha, r.flags, r.nameId, r.layer};
+}
+
+/** Tile of a unit direction at the given order. */
+inline uint32_t tileOf(int tileOrder, float x, float y, float z) {
+    return static_cast<uint32_t>(healpix::vecToNest(tileOrder, x, y, z));
+}
+
+/**
+ * Write the header and directory to the start of a buffer of at least
+ * recordsOffset(tileOrder) bytes. tileStarts holds tileCount + 1 entries.
+ */
+inline void writeHeader(uint8_t* out, int tileOrder, const std::vector<uint64_t>& tileStarts) {
+    const Header header = {FILE_MAGIC, FILE_VERSION, static_cast<uint32_t>(tileOrder), tileCount(tileOrder),
+                           tileStarts.back()};
+    memcpy(out, &header, sizeof(header));
+    memcpy(out + directoryOffset(), tileStarts.data(), tileStarts.size() * sizeof(uint64_t));
+}
+
+/**
+ * Serialize objects to the tile format, in memory. For catalogs too large
+ * to hold twice, write records in place instead (see synthetic::writeTiles).
+ */
+inline std::vector<uint8_t> serialize(const std::vector<sky::Object>& objects, int tileOrder) {
+    const uint32_t count = tileCount(tileOrder);
+    std::vector<uint64_t> starts(count + 1, 0);
+    std::vector<uint32_t> tileOfObject(objects.size());
+    for (size_t i = 0; i < objects.size(); i++) {
+        tileOfObject[i] = tileOf(tileOrder, objects[i].x, objects[i].y, objects[i].z);
+        starts[tileOfObject[i] + 1]++;
+    }
+    for (uint32_t t = 0; t < count; t++) starts[t + 1] += starts[t];
+
+    std::vector<uint8_t> out(fileSize(tileOrder, objects.size()));
+    writeHeader(out.data(), tileOrder, starts);
+    std::vector<uint64_t> cursor(starts.begin(), starts.end() - 1);
+    uint8_t* records = out.data() + recordsOffset(tileOrder);
+    for (size_t i = 0; i < objects.size(); i++) {
+        const Record r = toRecord(objects[i]);
+        memcpy(records + cursor[tileOfObject[i]]++ * sizeof(Record), &r, sizeof(r));
+    }
+    return out;
+}
+
+/** Read-only view of a tile file in memory; the data must outlive the view. */
+class View {
+public:
+    /**
+     * Check the header and directory.
+     * @return false if the data is truncated or not a tile file
+     */
+    bool open(const uint8_t* data, size_t size) {
+        data_ = nullptr;
+        if (size < sizeof(Header)) return false;
+        memcpy(&header_, data, sizeof(header_));
+        if (header_.magic != FILE_MAGIC || header_.version != FILE_VERSION) return false;
+        const int order = static_cast<int>(header_.tileOrder);
+        if (order < 0 || order > MAX_TILE_ORDER || header_.tileCount != tiles::tileCount(order)) return false;
+        if (size < recordsOffset(order) || (size - recordsOffset(order)) / sizeof(Record) < header_.objectCount) {
+            return false;
+        }
+
+        starts_.resize(header_.tileCount + 1);
+        memcpy(starts_.data(), data + directoryOffset(), starts_.size() * sizeof(uint64_t));
+        if (starts_.front() != 0 || starts_.back() != header_.objectCount) return false;
+        for (uint32_t t = 0; t < header_.tileCount; t++) {
+            if (starts_[t + 1] < starts_[t]) return false;
+        }
+        data_ = data;
+        return true;
+    }
+
+    int tileOrder() const { return static_cast<int>(header_.tileOrder); }
+    uint32_t tileCount() const { return header_.tileCount; }
+    uint64_t objectCount() const { return header_.objectCount; }
+    uint64_t tileSize(uint32_t tile) const { return starts_[tile + 1] - starts_[tile]; }
+
+    Record record(uint64_t index) const {
+        Record r;
+        memcpy(&r, data_ + recordsOffset(tileOrder()) + index * sizeof(Record), sizeof(r));
+        return r;
+    }
+
+    /** Append a tile's objects, e.g. to gather the input of sky::Store::build. */
+    void appendTile(uint32_t tile, std::vector<sky::Object>& out) const {
+        out.reserve(out.size() + tileSize(tile));
+        for (uint64_t i = starts_[tile]; i < starts_[tile + 1]; i++) out.push_back(toObject(record(i)));
+    }
+
+private:
+    const uint8_t* data_ = nullptr;
+    Header header_ = {};
+    std::vector<uint64_t> starts_;
+};
+
+} // namespace tiles
+
+#endif // SKY_TILES_H
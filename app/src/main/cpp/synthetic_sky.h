@@ -0,0 +1,398 @@
+#ifndef SYNTHETIC_SKY_H
+#define SYNTHETIC_SKY_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "job_system.h"
+#include "sky_store.h"
+#include "sky_tiles.h"
+
+/**
+ * Deterministic synthetic star catalogs for benchmarks, from 10k to 1B rows.
+ *
+ * A uniform random field culls and thins nothing like the real sky, so
+ * the generator follows the real sky's structure:
+ *
+ *   - Magnitudes follow whole-sky star counts, log10 N(<m) = C0 + C1 m + C2 m^2.
+ *     A catalog of N stars holds the brightest N, so the limiting magnitude
+ *     grows with N (about 6.5 at 10k, 19 at 1B).
+ *   - Positions mix a uniform field, a disk concentrated toward the galactic
+ *     plane and a bulge around the galactic center. The disk and bulge
+ *     contrast grows with magnitude, as faint stars crowd the Milky Way.
+ *   - A share of the stars sit in clusters with a Plummer profile, their
+ *     centers near the plane.
+ *
+ * Star i is a pure function of (seed, i): every random draw comes from a
+ * counter-based stream keyed by the index. The output is the same whatever
+ * the thread count or chunk size, and any index range can be generated on
+ * its own.
+ *
+ * Catalogs are written straight to the tile format (sky_tiles.h) in two
+ * parallel passes over fixed chunks of indices. The first counts each
+ * chunk's stars per tile; prefix sums over (tile, chunk) give every chunk
+ * its own write cursor in every tile. The second regenerates the stars and
+ * writes them to their cursors. Within a tile, stars stay in index order.
+ * Regenerating costs less than keeping a tile per star at 1B rows.
+ */
+namespace synthetic {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr double DEG = PI / 180.0;
+
+// Whole-sky cumulative star counts by V magnitude
+constexpr double COUNT_C0 = 0.616;
+constexpr double COUNT_C1 = 0.55;
+constexpr double COUNT_C2 = -0.006;
+constexpr double BRIGHTEST_MAGNITUDE = -1.5;
+constexpr double FAINTEST_MAGNITUDE = 30.0;
+
+// Galactic frame (J2000): north galactic pole and galactic center
+constexpr double POLE_RA = 192.85948;
+constexpr double POLE_DEC = 27.12825;
+constexpr double CENTER_RA = 266.40499;
+constexpr double CENTER_DEC = -28.93617;
+
+// Disk: sin(b) is Laplace-distributed with this scale. Its density in the
+// plane, relative to the uniform field, is diskContrast(m)
+constexpr double DISK_SCALE = 0.12;
+// Bulge: sin(b) and l Laplace-distributed about the center; its peak adds
+// BULGE_CONTRAST times the disk contrast
+constexpr double BULGE_SCALE_B = 0.1;
+constexpr double BULGE_SCALE_L = 0.25;
+constexpr double BULGE_CONTRAST = 2.0;
+
+// Cluster radii (Plummer scale) are log-uniform in this range
+constexpr double MIN_CLUSTER_RADIUS = 0.02 * DEG;
+constexpr double MAX_CLUSTER_RADIUS = 0.5 * DEG;
+constexpr double MEMBERS_PER_CLUSTER = 100.0;
+constexpr uint32_t MAX_CLUSTERS = 5000;
+constexpr double MAX_PLUMMER_SHARE = 0.99;  // Caps member offsets at about 10 radii
+
+// Stars per chunk of the tiling passes
+constexpr uint64_t CHUNK_STARS = uint64_t(1) << 20;
+
+struct Config {
+    uint64_t count = 100000;
+    uint64_t seed = 1;
+    int tileOrder = 3;
+    double clusterFraction = 0.02;  // Share of stars in clusters
+    uint8_t layer = 0;              // Layer of every star
+};
+
+/** Stateless 64-bit finalizer (splitmix64). */
+inline uint64_t mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+/** Random stream keyed by (seed, stream). */
+class Random {
+public:
+    Random(uint64_t seed, uint64_t stream) : state_(mix(seed ^ mix(stream ^ 0x6a09e667f3bcc909ull))) {}
+
+    uint64_t next() {
+        state_ += 0x9e3779b97f4a7c15ull;
+        return mix(state_);
+    }
+
+    /** Uniform in [0, 1). */
+    double uniform() { return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0); }
+
+    double normal() {
+        const double u = 1.0 - uniform();
+        return std::sqrt(-2.0 * std::log(u)) * std::cos(2.0 * PI * uniform());
+    }
+
+    /** Laplace with the given scale, truncated to [-limit, limit]. */
+    double laplace(double scale, double limit) {
+        const double tail = 1.0 - std::exp(-limit / scale);
+        const double magnitude = -scale * std::log(1.0 - uniform() * tail);
+        return next() & 1 ? magnitude : -magnitude;
+    }
+
+private:
+    uint64_t state_;
+};
+
+/** Whole-sky count of stars brighter than m. */
+inline double cumulativeCount(double m) {
+    return std::pow(10.0, COUNT_C0 + COUNT_C1 * m + COUNT_C2 * m * m);
+}
+
+/** Magnitude at which the cumulative count reaches n (rising branch of the fit). */
+inline double magnitudeForCount(double n) {
+    const double c = COUNT_C0 - std::log10(n);
+    return (-COUNT_C1 + std::sqrt(COUNT_C1 * COUNT_C1 - 4.0 * COUNT_C2 * c)) / (2.0 * COUNT_C2);
+}
+
+/** Faintest magnitude of a catalog of the brightest `count` stars. */
+inline double limitingMagnitude(uint64_t count) {
+    const double n = cumulativeCount(BRIGHTEST_MAGNITUDE) + static_cast<double>(count);
+    return std::min(magnitudeForCount(n), FAINTEST_MAGNITUDE);
+}
+
+/** Density of the disk in the galactic plane relative to the uniform field. */
+inline double diskContrast(double m) {
+    return 0.1 * std::pow(std::max(m + 2.0, 0.0), 1.5);
+}
+
+struct Vec3 {
+    double x, y, z;
+};
+
+inline Vec3 unitVector(double raDeg, double decDeg) {
+    const double ra = raDeg * DEG, dec = decDeg * DEG;
+    return {std::cos(dec) * std::cos(ra), std::cos(dec) * std::sin(ra), std::sin(dec)};
+}
+
+struct Cluster {
+    Vec3 center;
+    Vec3 east, north;  // Tangent basis at the center
+    double radius;     // Plummer scale, radians
+};
+
+/** One catalog: star(i) is the i-th star of the configuration. */
+class Sky {
+public:
+    explicit Sky(const Config& config) : config_(config) {
+        limit_ = limitingMagnitude(config.count);
+        brightCount_ = cumulativeCount(BRIGHTEST_MAGNITUDE);
+        faintCount_ = cumulativeCount(limit_);
+
+        // Galactic basis: z toward the north pole, x toward the center
+        const Vec3 pole = unitVector(POLE_RA, POLE_DEC);
+        const Vec3 center = unitVector(CENTER_RA, CENTER_DEC);
+        const double d = center.x * pole.x + center.y * pole.y + center.z * pole.z;
+        gx_ = normalize({center.x - d * pole.x, center.y - d * pole.y, center.z - d * pole.z});
+        gz_ = pole;
+        gy_ = cross(gz_, gx_);
+
+        const double members = config.clusterFraction * static_cast<double>(config.count);
+        if (members >= 1.0) {
+            const uint32_t count = static_cast<uint32_t>(
+                std::clamp(members / MEMBERS_PER_CLUSTER, 1.0, static_cast<double>(MAX_CLUSTERS)));
+            clusters_.reserve(count);
+            for (uint32_t c = 0; c < count; c++) clusters_.push_back(makeCluster(c));
+        }
+    }
+
+    sky::Object star(uint64_t index) const {
+        Random random(config_.seed, index);
+        const double n = brightCount_ + random.uniform() * (faintCount_ - brightCount_);
+        const double m = std::min(magnitudeForCount(n), limit_);
+
+        Vec3 v;
+        if (!clusters_.empty() && random.uniform() < config_.clusterFraction) {
+            v = member(clusters_[random.next() % clusters_.size()], random);
+        } else {
+            v = field(m, random);
+        }
+
+        // B-V: main-sequence dwarfs, red giants and hot stars
+        const double population = random.uniform();
+        double bv;
+        if (population < 0.6) bv = 0.6 + 0.25 * random.normal();
+        else if (population < 0.85) bv = 1.2 + 0.25 * random.normal();
+        else bv = 0.0 + 0.15 * random.normal();
+        const double slot = (bv - MIN_BV) / (MAX_BV - MIN_BV) * 255.0 + 0.5;
+
+        sky::Object o;
+        o.x = static_cast<float>(v.x);
+        o.y = static_cast<float>(v.y);
+        o.z = static_cast<float>(v.z);
+        o.magnitude = static_cast<float>(m);
+        o.colorIndex = static_cast<uint8_t>(std::clamp(slot, 0.0, 255.0));
+        o.alpha = 255;
+        o.flags = sky::FLAG_STAR;
+        o.nameId = sky::NO_NAME;
+        o.layer = config_.layer;
+        return o;
+    }
+
+    /** Galactic latitude sine of a direction. */
+    double sinLatitude(const Vec3& v) const { return dot(v, gz_); }
+
+    const Config& config() const { return config_; }
+    double limit() const { return limit_; }
+    const std::vector<Cluster>& clusters() const { return clusters_; }
+
+private:
+    // StarPalette's B-V range over its 256 slots
+    static constexpr double MIN_BV = -0.4;
+    static constexpr double MAX_BV = 2.0;
+    // Cluster streams follow the star streams
+    static constexpr uint64_t CLUSTER_STREAM = uint64_t(1) << 63;
+
+    static double dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+    static Vec3 cross(const Vec3& a, const Vec3& b) {
+        return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+    }
+    static Vec3 normalize(const Vec3& v) {
+        const double inv = 1.0 / std::sqrt(dot(v, v));
+        return {v.x * inv, v.y * inv, v.z * inv};
+    }
+
+    Vec3 galactic(double sinB, double l) const {
+        const double cosB = std::sqrt(std::max(0.0, 1.0 - sinB * sinB));
+        const double cx = cosB * std::cos(l), cy = cosB * std::sin(l);
+        return {cx * gx_.x + cy * gy_.x + sinB * gz_.x, cx * gx_.y + cy * gy_.y + sinB * gz_.y,
+                cx * gx_.z + cy * gy_.z + sinB * gz_.z};
+    }
+
+    /**
+     * Field star of magnitude m. Component weights are set so the disk
+     * peaks at diskContrast(m) and the bulge at BULGE_CONTRAST times that,
+     * both relative to the uniform field's density.
+     */
+    Vec3 field(double m, Random& random) const {
+        const double contrast = diskContrast(m);
+        const double uniformWeight = 1.0;
+        const double diskWeight = contrast * DISK_SCALE;
+        const double bulgeWeight = BULGE_CONTRAST * contrast * BULGE_SCALE_B * BULGE_SCALE_L / PI;
+        const double pick = random.uniform() * (uniformWeight + diskWeight + bulgeWeight);
+
+        if (pick < uniformWeight) {
+            return galactic(2.0 * random.uniform() - 1.0, 2.0 * PI * random.uniform());
+        }
+        if (pick < uniformWeight + diskWeight) {
+            const double sinB = random.laplace(DISK_SCALE, 1.0);
+            return galactic(sinB, 2.0 * PI * random.uniform());
+        }
+        const double sinB = random.laplace(BULGE_SCALE_B, 1.0);
+        return galactic(sinB, random.laplace(BULGE_SCALE_L, PI));
+    }
+
+    Cluster makeCluster(uint32_t c) const {
+        Random random(config_.seed, CLUSTER_STREAM | c);
+        // Centers follow the faintest stars' field, so most lie near the plane
+        Cluster cluster;
+        cluster.center = field(limit_, random);
+        const Vec3 axis = std::abs(cluster.center.z) < 0.9 ? Vec3{0.0, 0.0, 1.0} : Vec3{1.0, 0.0, 0.0};
+        cluster.east = normalize(cross(axis, cluster.center));
+        cluster.north = cross(cluster.center, cluster.east);
+        cluster.radius = MIN_CLUSTER_RADIUS * std::pow(MAX_CLUSTER_RADIUS / MIN_CLUSTER_RADIUS, random.uniform());
+        return cluster;
+    }
+
+    /** Member offset: projected Plummer profile, enclosed share R^2 / (R^2 + a^2). */
+    static Vec3 member(const Cluster& cluster, Random& random) {
+        const double share = random.uniform() * MAX_PLUMMER_SHARE;
+        const double r = cluster.radius * std::sqrt(share / (1.0 - share));
+        const double angle = 2.0 * PI * random.uniform();
+        const double s = std::sin(r), c = std::cos(r);
+        const double e = s * std::cos(angle), n = s * std::sin(angle);
+        return {c * cluster.center.x + e * cluster.east.x + n * cluster.north.x,
+                c * cluster.center.y + e * cluster.east.y + n * cluster.north.y,
+                c * cluster.center.z + e * cluster.east.z + n * cluster.north.z};
+    }
+
+    Config config_;
+    double limit_;
+    double brightCount_, faintCount_;
+    Vec3 gx_, gy_, gz_;
+    std::vector<Cluster> clusters_;
+};
+
+/** Where each chunk writes in each tile. */
+struct Layout {
+    uint64_t chunkStars = CHUNK_STARS;
+    std::vector<uint64_t> tileStarts;  // tileCount + 1 entries, for the directory
+    std::vector<uint64_t> cursors;     // chunkCount x tileCount, chunk-major
+};
+
+inline uint64_t chunkCount(uint64_t count, uint64_t chunkStars) {
+    return (count + chunkStars - 1) / chunkStars;
+}
+
+/** Run body(chunk) for every chunk, in parallel if jobs is given. */
+template<typename F>
+inline void forEachChunk(uint64_t chunks, jobs::JobSystem* jobs, F&& body) {
+    auto range = [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; c++) body(static_cast<uint64_t>(c));
+    };
+    if (jobs != nullptr) {
+        jobs->parallelFor(0, static_cast<size_t>(chunks), 1, range, jobs::Priority::Background);
+    } else {
+        range(0, static_cast<size_t>(chunks));
+    }
+}
+
+/** First pass: count stars per (chunk, tile) and place every chunk's run in every tile. */
+inline Layout layout(const Sky& sky, jobs::JobSystem* jobs = nullptr, uint64_t chunkStars = CHUNK_STARS) {
+    const int order = sky.config().tileOrder;
+    const uint64_t count = sky.config().count;
+    const uint32_t tileCount = tiles::tileCount(order);
+    const uint64_t chunks = chunkCount(count, chunkStars);
+
+    Layout layout;
+    layout.chunkStars = chunkStars;
+    layout.cursors.assign(chunks * tileCount, 0);
+    forEachChunk(chunks, jobs, [&](uint64_t c) {
+        uint64_t* counts = layout.cursors.data() + c * tileCount;
+        const uint64_t end = std::min(count, (c + 1) * chunkStars);
+        for (uint64_t i = c * chunkStars; i < end; i++) {
+            const sky::Object o = sky.star(i);
+            counts[tiles::tileOf(order, o.x, o.y, o.z)]++;
+        }
+    });
+
+    // Tile-major prefix sum: tile t holds chunk 0's run, then chunk 1's, ...
+    layout.tileStarts.assign(tileCount + 1, 0);
+    uint64_t offset = 0;
+    for (uint32_t t = 0; t < tileCount; t++) {
+        layout.tileStarts[t] = offset;
+        for (uint64_t c = 0; c < chunks; c++) {
+            uint64_t& cursor = layout.cursors[c * tileCount + t];
+            const uint64_t n = cursor;
+            cursor = offset;
+            offset += n;
+        }
+    }
+    layout.tileStarts[tileCount] = offset;
+    return layout;
+}
+
+/** Second pass: write every star's record to its chunk's cursor in its tile. */
+inline void writeRecords(const Sky& sky, const Layout& layout, uint8_t* records, jobs::JobSystem* jobs = nullptr) {
+    const int order = sky.config().tileOrder;
+    const uint64_t count = sky.config().count;
+    const uint32_t tileCount = tiles::tileCount(order);
+    const uint64_t chunkStars = layout.chunkStars;
+
+    forEachChunk(chunkCount(count, chunkStars), jobs, [&](uint64_t c) {
+        std::vector<uint64_t> cursor(layout.cursors.begin() + c * tileCount, layout.cursors.begin() + (c + 1) * tileCount);
+        const uint64_t end = std::min(count, (c + 1) * chunkStars);
+        for (uint64_t i = c * chunkStars; i < end; i++) {
+            const tiles::Record r = tiles::toRecord(sky.star(i));
+            memcpy(records + cursor[tiles::tileOf(order, r.x, r.y, r.z)]++ * sizeof(tiles::Record), &r, sizeof(r));
+        }
+    });
+}
+
+/**
+ * Write a whole tile file to out, which holds tiles::fileSize(tileOrder,
+ * count) bytes (e.g. a mapped output file).
+ */
+inline void writeTiles(const Config& config, uint8_t* out, jobs::JobSystem* jobs = nullptr,
+                       uint64_t chunkStars = CHUNK_STARS) {
+    const Sky sky(config);
+    const Layout plan = layout(sky, jobs, chunkStars);
+    tiles::writeHeader(out, config.tileOrder, plan.tileStarts);
+    writeRecords(sky, plan, out + tiles::recordsOffset(config.tileOrder), jobs);
+}
+
+/** Generate a tile file in memory. */
+inline std::vector<uint8_t> generate(const Config& config, jobs::JobSystem* jobs = nullptr,
+                                     uint64_t chunkStars = CHUNK_STARS) {
+    std::vector<uint8_t> out(tiles::fileSize(config.tileOrder, config.count));
+    writeTiles(config, out.data(), jobs, chunkStars);
+    return out;
+}
+
+} // namespace synthetic
+
+#endif // SYNTHETIC_SKY_H
@@ -0,0 +1,226 @@
+#ifndef THERMAL_GOVERNOR_H
+#define THERMAL_GOVERNOR_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+/**
+ * Thermal-aware frame pacing.
+ *
+ * The Governor maps thermal readings (headroom and its forecast, plus the
+ * OS thermal status) to a tier. Each tier has a frame-rate target and a work
+ * fraction: the share of the frame period the renderer should plan to use.
+ * Rising pressure moves up a tier as soon as it is seen - the forecast lets
+ * this happen before the OS throttles - while cooling steps down one tier at
+ * a time after a sustained cool-down.
+ *
+ * The Controller drives a Governor from a Platform: it polls thermal state
+ * at the platform's rate limit (one headroom query per poll) and reports
+ * work durations to the
+ * performance hint session. Platforms are abstract so the logic runs on the
+ * host with a simulated thermal signal; see android_performance.h for the
+ * device implementation.
+ */
+namespace thermal {
+
+/** OS thermal status; values match AThermalStatus. */
+enum class Status : int {
+    Unknown = -1,
+    None = 0,
+    Light = 1,
+    Moderate = 2,
+    Severe = 3,
+    Critical = 4,
+    Emergency = 5,
+    Shutdown = 6,
+};
+
+struct Tier {
+    int targetFps;
+    float workFraction;  // Share of the frame period to plan for
+};
+
+constexpr int TIER_COUNT = 4;
+constexpr Tier TIERS[TIER_COUNT] = {
+    {60, 1.0f},   // Nominal
+    {60, 0.8f},   // Warm: same rate, lighter frames
+    {45, 0.75f},  // Hot
+    {30, 0.65f},  // Critical
+};
+
+struct Config {
+    // Headroom (1.0 = throttling threshold) at which tiers 1..3 are entered
+    float enterHeadroom[TIER_COUNT - 1] = {0.70f, 0.85f, 0.95f};
+    float exitMargin = 0.10f;         // Headroom must drop this far below the entry point to leave a tier
+    double coolDownSeconds = 10.0;    // Sustained cool time before stepping down a tier
+    double pollIntervalSeconds = 1.0; // Headroom queries are rate limited by the OS
+    int forecastSeconds = 10;         // How far ahead to ask for headroom
+};
+
+/** One thermal sample. NaN headroom means the platform cannot report it. */
+struct Reading {
+    float headroom = std::numeric_limits<float>::quiet_NaN();
+    float forecastHeadroom = std::numeric_limits<float>::quiet_NaN();
+    Status status = Status::Unknown;
+};
+
+class Governor {
+public:
+    explicit Governor(Config config = Config()) : config_(config) {}
+
+    /** Feed a reading taken at nowSeconds. Returns true if the tier changed. */
+    bool update(double nowSeconds, const Reading& reading) {
+        const float pressure = pressureOf(reading);
+        const int wanted = std::max(tierForHeadroom(pressure), tierForStatus(reading.status));
+
+        if (wanted > tier_) {
+            tier_ = wanted;
+            coolSince_ = NOT_COOLING;
+            return true;
+        }
+
+        // Below the current tier only once clear of its entry point by the margin
+        const bool cool = tier_ > 0 && tierForStatus(reading.status) < tier_ &&
+                          !(pressure >= config_.enterHeadroom[tier_ - 1] - config_.exitMargin);
+        if (!cool) {
+            coolSince_ = NOT_COOLING;
+            return false;
+        }
+        if (coolSince_ == NOT_COOLING) {
+            coolSince_ = nowSeconds;
+            return false;
+        }
+        if (nowSeconds - coolSince_ >= config_.coolDownSeconds) {
+            tier_--;
+            coolSince_ = tier_ > 0 ? nowSeconds : NOT_COOLING;
+            return true;
+        }
+        return false;
+    }
+
+    int tier() const { return tier_; }
+    int targetFps() const { return TIERS[tier_].targetFps; }
+    float workFraction() const { return TIERS[tier_].workFraction; }
+
+    /** Target frame period in nanoseconds (the hint session's target work duration). */
+    int64_t targetPeriodNanos() const { return 1000000000LL / targetFps(); }
+
+    /**
+     * Per-frame work budget: never more than the unthrottled budget, and only
+     * the tier's share of the frame period.
+     */
+    float frameBudgetMs(float baseBudgetMs) const {
+        return std::min(baseBudgetMs, 1000.0f / targetFps()) * workFraction();
+    }
+
+    const Config& config() const { return config_; }
+
+private:
+    static constexpr double NOT_COOLING = -1.0;
+
+    // Worse of current and forecast headroom; NaN if neither is known
+    static float pressureOf(const Reading& r) {
+        if (std::isnan(r.headroom)) return r.forecastHeadroom;
+        if (std::isnan(r.forecastHeadroom)) return r.headroom;
+        return std::max(r.headroom, r.forecastHeadroom);
+    }
+
+    int tierForHeadroom(float pressure) const {
+        int tier = 0;
+        while (tier < TIER_COUNT - 1 && pressure >= config_.enterHeadroom[tier]) tier++;
+        return tier;  // NaN compares false: tier 0
+    }
+
+    static int tierForStatus(Status status) {
+        switch (status) {
+            case Status::Moderate: return 1;
+            case Status::Severe: return 2;
+            case Status::Critical:
+            case Status::Emergency:
+            case Status::Shutdown: return 3;
+            default: return 0;
+        }
+    }
+
+    Config config_;
+    int tier_ = 0;
+    double coolSince_ = NOT_COOLING;
+};
+
+/** Source of thermal state and sink for performance hints. */
+class Platform {
+public:
+    virtual ~Platform() = default;
+
+    /** Headroom forecastSeconds ahead (0 = now); NaN if unsupported. */
+    virtual float thermalHeadroom(int forecastSeconds) = 0;
+    virtual Status thermalStatus() = 0;
+
+    /** Hint session calls; no-ops where sessions are unsupported. */
+    virtual void updateTargetWorkDuration(int64_t nanos) = 0;
+    virtual void reportActualWorkDuration(int64_t nanos) = 0;
+};
+
+class Controller {
+public:
+    explicit Controller(Platform* platform, Config config = Config())
+        : platform_(platform), governor_(config) {}
+
+    /**
+     * Call once per frame with the frame's CPU work duration. Polls thermal
+     * state when due and returns true if the tier changed.
+     */
+    bool onFrame(double nowSeconds, int64_t actualWorkNanos) {
+        if (platform_ == nullptr) return false;
+
+        if (!targetSent_) {
+            platform_->updateTargetWorkDuration(governor_.targetPeriodNanos());
+            targetSent_ = true;
+        }
+        if (actualWorkNanos > 0) {
+            platform_->reportActualWorkDuration(actualWorkNanos);
+        }
+
+        if (nowSeconds - lastPoll_ < governor_.config().pollIntervalSeconds) return false;
+        lastPoll_ = nowSeconds;
+
+        // The OS answers one headroom query per second and returns NaN for the
+        // rest, so each poll asks once: for the forecast, or for current
+        // headroom on the poll after a forecast came back NaN
+        Reading reading;
+        if (queryCurrent_) {
+            lastHeadroom_ = platform_->thermalHeadroom(0);
+            reading.headroom = lastHeadroom_;
+            queryCurrent_ = false;
+        } else {
+            reading.forecastHeadroom = platform_->thermalHeadroom(governor_.config().forecastSeconds);
+            if (std::isnan(reading.forecastHeadroom)) {
+                reading.headroom = lastHeadroom_;
+                queryCurrent_ = true;
+            } else {
+                lastHeadroom_ = std::numeric_limits<float>::quiet_NaN();
+            }
+        }
+        reading.status = platform_->thermalStatus();
+        if (!governor_.update(nowSeconds, reading)) return false;
+
+        platform_->updateTargetWorkDuration(governor_.targetPeriodNanos());
+        return true;
+    }
+
+    const Governor& governor() const { return governor_; }
+
+private:
+    Platform* platform_;
+    Governor governor_;
+    double lastPoll_ = -std::numeric_limits<double>::infinity();
+    bool targetSent_ = false;
+    bool queryCurrent_ = false;  // Last forecast was NaN: ask for current headroom next
+    float lastHeadroom_ = std::numeric_limits<float>::quiet_NaN();  // Since the last NaN forecast
+};
+
+} // namespace thermal
+
+#endif // THERMAL_GOVERNOR_H
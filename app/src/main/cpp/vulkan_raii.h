@@ -133,6 +133,13 @@ struct SwapchainDeleter {
     }
 };
 
+struct ImageDeleter {
+    VkDevice device = VK_NULL_HANDLE;
+    void operator()(VkImage image) const noexcept {
+        if (image && device) vkDestroyImage(device, image, nullptr);
+    }
+};
+
 struct ImageViewDeleter {
     VkDevice device = VK_NULL_HANDLE;
     void operator()(VkImageView imageView) const noexcept {
@@ -217,6 +224,13 @@ struct FenceDeleter {
     }
 };
 
+struct QueryPoolDeleter {
+    VkDevice device = VK_NULL_HANDLE;
+    void operator()(VkQueryPool pool) const noexcept {
+        if (pool && device) vkDestroyQueryPool(device, pool, nullptr);
+    }
+};
+
 // =============================================================================
 // Type Aliases for RAII Handles
 // =============================================================================
@@ -234,6 +248,7 @@ using UniqueDebugMessenger = VulkanHandle<VkDebugUtilsMessengerEXT, DebugMesseng
 // Device-level handles
 using UniqueDevice = VulkanHandle<VkDevice, DeviceDeleter>;
 using UniqueSwapchain = VulkanHandle<VkSwapchainKHR, SwapchainDeleter>;
+using UniqueImage = VulkanHandle<VkImage, ImageDeleter>;
 using UniqueImageView = VulkanHandle<VkImageView, ImageViewDeleter>;
 using UniqueRenderPass = VulkanHandle<VkRenderPass, RenderPassDeleter>;
 using UniqueFramebuffer = VulkanHandle<VkFramebuffer, FramebufferDeleter>;
@@ -246,3 +261,4 @@ using UniqueDescriptorPool = VulkanHandle<VkDescriptorPool, DescriptorPoolDelete
 using UniqueDescriptorSetLayout = VulkanHandle<VkDescriptorSetLayout, DescriptorSetLayoutDeleter>;
 using UniqueSemaphore = VulkanHandle<VkSemaphore, SemaphoreDeleter>;
 using UniqueFence = VulkanHandle<VkFence, FenceDeleter>;
+using UniqueQueryPool = VulkanHandle<VkQueryPool, QueryPoolDeleter>;
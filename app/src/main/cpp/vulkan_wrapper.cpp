@@ -2,19 +2,42 @@
 #include <android/log.h>
 #include <android/native_window.h>
 #include <android/native_window_jni.h>
+#include <android/asset_manager.h>
+#include <android/asset_manager_jni.h>
 #include <vulkan/vulkan.h>
 #include <vulkan/vulkan_android.h>
 
 #include <vector>
 #include <string>
+#include <cstddef>
 #include <cstring>
 #include <algorithm>
 #include <memory>
 #include <mutex>
 #include <atomic>
+#include <chrono>
+#include <thread>
+#include <unistd.h>
 #include "shaders.h"
 #include "math_utils.h"
+#include "light_map.h"
+#include "dso.h"
+#include "body_impostor.h"
+#include "meteor_shower.h"
+#include "orbit_cache.h"
+#include "sky_store.h"
+#include "light_curve.h"
+#include "horizon_profile.h"
+#include "observer_state.h"
+#include "cull_service.h"
+#include "label_placer.h"
+#include "frame_budget.h"
+#include "frame_arena.h"
+#include "asset_pipeline.h"
+#include "thermal_governor.h"
+#include "android_performance.h"
 #include "vulkan_raii.h"
+#include "log_ring.h"
 
 #define LOG_TAG "VulkanWrapper"
 
@@ -49,13 +72,142 @@ static const char* vkResultToString(VkResult result) {
         default: return "VK_UNKNOWN_ERROR";
     }
 }
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
-#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+// Logging goes through the shared log ring, so the render thread never
+// blocks in logcat. Each call site is rate-limited to this many messages
+// per second; LOGD compiles away in release builds. LOGE is written at once
+// and never rate-limited (see log_ring.h)
+constexpr uint32_t LOG_SITE_RATE = 20;
+#define LOGD(...) LOG_RING(logring::shared(), logring::Level::Debug, LOG_TAG, LOG_SITE_RATE, __VA_ARGS__)
+#define LOGI(...) LOG_RING(logring::shared(), logring::Level::Info, LOG_TAG, LOG_SITE_RATE, __VA_ARGS__)
+#define LOGW(...) LOG_RING(logring::shared(), logring::Level::Warn, LOG_TAG, LOG_SITE_RATE, __VA_ARGS__)
+#define LOGE(...) LOG_RING(logring::shared(), logring::Level::Error, LOG_TAG, LOG_SITE_RATE, __VA_ARGS__)
 
 // Maximum number of frames that can be in flight at once
 constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
 
+// Uniform buffer layout: view + projection matrices, the horizon plane (vec4:
+// world-space zenith and margin) and local north (vec4), the terrain skyline
+// table (horizon::BINS floats), the star color LUT (vec4 per entry,
+// indexed by the color byte of packed star vertices; see star.vert), then the
+// scintillation vec4 (observer zenith and the shader clock in seconds)
+constexpr uint32_t STAR_PALETTE_SIZE = 256;
+constexpr VkDeviceSize UNIFORM_MATRICES_SIZE = sizeof(float) * 32;  // 2 mat4
+constexpr VkDeviceSize UNIFORM_HORIZON_OFFSET = UNIFORM_MATRICES_SIZE;
+constexpr VkDeviceSize UNIFORM_TERRAIN_OFFSET = UNIFORM_HORIZON_OFFSET + sizeof(float) * 8;
+constexpr VkDeviceSize UNIFORM_PALETTE_OFFSET = UNIFORM_TERRAIN_OFFSET + sizeof(float) * horizon::BINS;
+constexpr VkDeviceSize UNIFORM_SCINTILLATION_OFFSET = UNIFORM_PALETTE_OFFSET + sizeof(float) * 4 * STAR_PALETTE_SIZE;
+constexpr VkDeviceSize UNIFORM_BUFFER_SIZE = UNIFORM_SCINTILLATION_OFFSET + sizeof(float) * 4;
+// The shader clock (scintillation w) wraps after this many seconds to keep float precision
+constexpr double SCINTILLATION_PERIOD = 3600.0;
+
+// Vertex formats accepted by the graphics pipelines
+enum class VertexLayout {
+    PositionColor,  // vec3 position + vec4 color (7 floats)
+    PackedStar,     // vec3 position + 4 x uint8 (color index, alpha, reserved) = 16 bytes
+    DsoInstance,    // Per-instance dso::Instance (32 bytes); quad corners come from gl_VertexIndex
+    BodyInstance,   // Per-instance bodies::Instance (40 bytes); likewise
+    MeteorStreak,   // Per-instance meteors::Streak (32 bytes), written by meteor.comp; likewise
+};
+
+// How a pipeline writes the framebuffer
+enum class BlendMode {
+    Opaque,         // Replaces the framebuffer
+    Additive,       // Premultiplied colors are added (glow, glyphs)
+    Premultiplied,  // Premultiplied "over": opaque parts hide what is behind
+};
+
+// How a pipeline uses the depth attachment (ignored when there is none)
+enum class DepthMode {
+    Test,   // Hidden behind nearer layers; writes nothing
+    Write,  // Opaque occluder: hides farther layers and, within a draw, later fragments
+};
+
+static uint32_t vertexStride(VertexLayout layout) {
+    switch (layout) {
+        case VertexLayout::PackedStar:
+            return sizeof(float) * 4;
+        case VertexLayout::DsoInstance:
+            return sizeof(dso::Instance);
+        case VertexLayout::BodyInstance:
+            return sizeof(bodies::Instance);
+        case VertexLayout::MeteorStreak:
+            return sizeof(meteors::Streak);
+        case VertexLayout::PositionColor:
+        default:
+            return sizeof(float) * 7;
+    }
+}
+
+// Push constants: model matrix and layer depth for every pipeline, plus
+// viewport and minimum glyph radius (pixels) read by dso.vert and body.vert
+struct PushConstants {
+    float model[16];
+    float viewport[2];
+    float minRadiusPixels;
+    float depth;  // Normalized depth every vertex of the draw is placed at
+    float anchor[4];     // Origin of anchor-relative positions (star.vert); w unused
+    float anchorEye[4];  // view * anchor, composed in double on the CPU; w unused
+};
+static_assert(sizeof(PushConstants) <= 128, "Vulkan only guarantees 128 bytes of push constants");
+
+// Depth order: all sky geometry lies on the unit sphere, so real depth says
+// nothing about what hides what. Each layer is drawn at a fixed depth instead,
+// by order: 0 is the sky itself (farthest), higher orders are nearer and hide
+// lower ones wherever they write depth.
+constexpr int DEPTH_ORDERS = 8;
+
+static float depthForOrder(int order) {
+    return 1.0f - static_cast<float>(std::clamp(order, 0, DEPTH_ORDERS - 1) + 1) / (DEPTH_ORDERS + 1);
+}
+
+// Depth formats in order of preference (D16 is small and enough for a few orders)
+constexpr VkFormat DEPTH_FORMATS[] = {VK_FORMAT_D16_UNORM, VK_FORMAT_X8_D24_UNORM_PACK32, VK_FORMAT_D32_SFLOAT};
+
+// Horizon plane that keeps everything (clipping off)
+constexpr float HORIZON_DISABLED[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+
+// Terrain table entry that hides nothing (sine of an altitude below the nadir)
+constexpr float TERRAIN_DISABLED = -1.0f;
+
+// Geometry this far below the horizon (sine of the angle) is still drawn, so
+// objects on the horizon line are not cut mid-glyph
+constexpr float HORIZON_MARGIN = 0.01f;
+
+// Frame budget timing: each frame slot owns TIMESTAMPS_PER_FRAME queries -
+// frame start, one per layer mark, and frame end
+constexpr uint32_t MAX_LAYER_MARKS = 32;
+constexpr uint32_t TIMESTAMPS_PER_FRAME = MAX_LAYER_MARKS + 2;
+
+// Labels accepted per frame once the governor lowers the label budget
+// (scaled by Quality::labelFraction; unlimited at full quality)
+constexpr size_t LABEL_BUDGET = 200;
+
+// Doubles written by nativeGetObserverFrame (ObserverFrame.COMPONENTS in Kotlin)
+constexpr jsize OBSERVER_FRAME_COMPONENTS = 18;
+
+// Bytes that asynchronous asset loads may hold at once (file data plus decoded form)
+constexpr size_t ASSET_MEMORY_BUDGET = 32 * 1024 * 1024;
+
+// Frames to wait before growing the orbit buffers again after a failed attempt
+// (each attempt waits for the device to go idle)
+constexpr uint32_t ORBIT_GROW_RETRY_FRAMES = 60;
+
+// Timing of one recorded frame; completed with GPU timestamps once its fence signals
+struct FrameTiming {
+    bool pending = false;  // Recorded but not yet fed to the governor
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point layerStart;
+    int openLayer = budget::NO_LAYER;
+    uint32_t markCount = 0;
+    int markLayers[MAX_LAYER_MARKS] = {};
+    float pixels = 0.0f;  // Render area, for fragments per pixel
+    budget::FrameSample sample;
+};
+
+// PrimitiveType enum (Kotlin): POINTS=0, LINES=1, TRIANGLES=2, TEXT=3, IMAGE=4, STARS=5
+constexpr int PRIMITIVE_STARS = 5;
+static_assert(cull::MAX_LAYERS == budget::MAX_LAYERS, "Culling counts are kept per budget layer");
+
 // Vulkan context holds all Vulkan objects
 // IMPORTANT: Member declaration order determines reverse destruction order.
 // Members declared FIRST are destroyed LAST. This order matches the required
@@ -90,6 +242,12 @@ struct VulkanContext {
     std::vector<VkImage> swapchainImages;  // Owned by swapchain, no explicit destroy
     std::vector<UniqueImageView> swapchainImageViews;
 
+    // Depth attachment, sized with the swapchain (absent if no depth format is supported)
+    VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+    UniqueImage depthImage;
+    UniqueDeviceMemory depthImageMemory;
+    UniqueImageView depthImageView;
+
     // Render pass
     UniqueRenderPass renderPass;
 
@@ -115,11 +273,76 @@ struct VulkanContext {
     size_t dynamicVertexBufferSize = 0;
     size_t dynamicVertexBufferOffset = 0;
 
+    // Integrated-light background patches (static, rebuilt only when the map changes)
+    UniqueBuffer lightMapBuffer;
+    UniqueDeviceMemory lightMapBufferMemory;
+    uint32_t lightMapVertexCount = 0;
+    // Parsed maps stay resident, so the map can be reselected when the star
+    // layer's limiting magnitude changes
+    std::shared_ptr<const std::vector<lightmap::LightMap>> lightMaps;
+    float lightMapLimit = 6.0f;  // Faint limit of the stars drawn as points
+    int lightMapOrder = 0;       // Preferred HEALPix order
+    float lightMapGain = 0.0f;
+    const lightmap::LightMap* lightMapSelected = nullptr;  // Being built or drawn
+    uint64_t lightMapGeneration = 0;  // Bumped per selection; builds of older ones are dropped
+
+    // Deep-sky object instances (static, one dso::Instance per object)
+    UniqueBuffer dsoInstanceBuffer;
+    UniqueDeviceMemory dsoInstanceBufferMemory;
+    uint32_t dsoInstanceCount = 0;
+
+    // Orbit tracks: polylines kept by orbitCache, copied into one device-local
+    // vertex + index buffer when they change (one staging slice per frame slot)
+    orbits::Cache orbitCache;
+    UniqueBuffer orbitBuffer;
+    UniqueDeviceMemory orbitMemory;
+    UniqueBuffer orbitStagingBuffer;
+    UniqueDeviceMemory orbitStagingMemory;
+    void* orbitStagingMapped = nullptr;
+    VkDeviceSize orbitCapacity = 0;  // Bytes of orbitBuffer and of each staging slice
+    VkDeviceSize orbitIndexOffset = 0;
+    uint32_t orbitIndexCount = 0;
+    uint32_t orbitGrowDelay = 0;  // Frames until a failed grow is retried
+
+    // Live meteors: a particle pool stepped by meteor.comp, which also writes the
+    // streak instances and their indirect draw arguments (device-local, never
+    // touched by the CPU); radiants are copied per frame slot
+    UniqueBuffer meteorParticleBuffer;
+    UniqueDeviceMemory meteorParticleMemory;
+    UniqueBuffer meteorStreakBuffer;
+    UniqueDeviceMemory meteorStreakMemory;
+    UniqueBuffer meteorArgsBuffer;
+    UniqueDeviceMemory meteorArgsMemory;
+    UniqueBuffer meteorRadiantBuffer;
+    UniqueDeviceMemory meteorRadiantMemory;
+    void* meteorRadiantMapped = nullptr;
+    VkDeviceSize meteorRadiantSlice = 0;  // Bytes per frame slot, aligned for dynamic offsets
+    UniqueDescriptorSetLayout meteorDescriptorSetLayout;
+    UniqueDescriptorPool meteorDescriptorPool;
+    VkDescriptorSet meteorDescriptorSet = VK_NULL_HANDLE;  // Freed with pool
+
     // Pipeline
     UniquePipelineLayout pipelineLayout;
     UniquePipeline trianglePipeline;
     UniquePipeline linePipeline;
     UniquePipeline pointPipeline;
+    UniquePipeline lightMapPipeline;  // Additive triangles
+    UniquePipeline starPipeline;      // Points with packed color-index vertices
+    UniquePipeline starScintillationPipeline;  // The same, twinkling with altitude (SCINTILLATION set)
+    UniquePipeline dsoPipeline;       // Instanced procedural DSO glyphs, additive
+    UniquePipeline bodyPipeline;      // Instanced sphere impostors for the Sun, Moon and planets
+    UniquePipeline meteorPipeline;    // Indirect meteor streaks, additive
+    UniquePipelineLayout meteorComputeLayout;
+    UniquePipeline meteorComputePipeline;  // Null if the graphics queue cannot run compute
+
+    // GPU timestamps for the frame budget (null if the graphics queue cannot write them)
+    UniqueQueryPool timestampPool;
+    float timestampPeriodNs = 0.0f;
+    uint64_t timestampMask = 0;
+
+    // Fragment shader invocations per frame slot, for overdraw (null without pipeline statistics)
+    UniqueQueryPool statisticsPool;
+    bool pipelineStatisticsEnabled = false;
 
     // Command resources
     UniqueCommandPool commandPool;
@@ -144,6 +367,72 @@ struct VulkanContext {
     // Background opacity (0.0 = transparent, 1.0 = opaque dark)
     float backgroundOpacity = 0.0f;
 
+    // Horizon plane mirrored in the uniform buffer; also rejects sky store cells on the CPU
+    float horizonPlane[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+    bool horizonClip = false;
+    horizon::Frame horizonFrame;  // Observer's local frame while clipping
+
+    // Observer location, time and the transforms derived from them. The
+    // horizon uniforms record the horizon version they were built from and
+    // are redone only when it changes (0: clipping off or no observer yet)
+    observer::State observer;
+    uint64_t horizonObserverVersion = 0;
+
+    // Site skyline; only in the uniform buffer while clipping
+    horizon::Profile terrainProfile;
+    bool terrainProfileSet = false;
+    bool terrainUniformsDirty = true;  // Table in the uniform buffer is stale
+    // Device supports gl_ClipDistance, so line/triangle pipelines clip at the horizon
+    bool clipDistanceEnabled = false;
+
+    // Depth order of each budget layer; the depth of the layer last marked applies to draws
+    int layerDepthOrder[budget::MAX_LAYERS] = {};
+    float drawDepth = depthForOrder(0);
+
+    // Meteor showers: radiant direction and zenithal hourly rate (x, y, z, ZHR);
+    // the simulation runs while there are radiants and until the last meteor fades
+    meteors::Radiant meteorShowers[meteors::MAX_RADIANTS] = {};
+    uint32_t meteorShowerCount = 0;
+    float meteorRateScale = 1.0f;
+    bool meteorParticlesCleared = false;
+    bool meteorStreaksReady = false;  // This frame's streaks and draw arguments were written
+    float meteorIdleSeconds = 0.0f;
+    uint32_t meteorStep = 0;
+    std::chrono::steady_clock::time_point lastMeteorStep;
+
+    // Star twinkling, done entirely in star.vert: the CPU only writes the clock each frame
+    bool scintillation = false;
+    std::chrono::steady_clock::time_point scintillationEpoch = std::chrono::steady_clock::now();
+
+    // Transient per-frame allocations, rewound when the frame slot's fence signals
+    arena::FrameArenas<MAX_FRAMES_IN_FLIGHT> frameArenas;
+
+    // Fixed sky objects (stars first); culled and packed into vertices natively each frame
+    sky::Store skyStore;
+    // Variable stars among them; their alphas are patched in the store before drawing
+    variability::Tracker variableStars;
+
+    // Label decluttering (grid sized to the swapchain, hysteresis across frames)
+    labels::Placer labelPlacer;
+
+    // Bounding-cap culling of line, point and triangle batches, and what it saved per layer
+    cull::Service culling;
+
+    // Frame budget governor, fed per-layer timings as each frame slot completes
+    budget::Governor budgetGovernor;
+    FrameTiming frameTimings[MAX_FRAMES_IN_FLIGHT];
+    float baseFrameBudgetMs = budget::Config().budgetMs;
+
+    // Thermal pacing and performance hints; created on the render thread's first frame
+    std::unique_ptr<thermal::AndroidPlatform> performancePlatform;
+    std::unique_ptr<thermal::Controller> thermalController;
+
+    // Asynchronous asset loads; the timeline counts frames the GPU has finished
+    assets::MemoryBudget assetBudget{ASSET_MEMORY_BUDGET};
+    assets::FrameTimeline frameTimeline;
+    assets::LoadGroup assetLoads;
+    uint64_t submittedFrames = 0;
+
     // Frame state
     bool inFrame = false;
     uint32_t currentImageIndex = 0;
@@ -448,7 +737,16 @@ static bool createLogicalDevice(VulkanContext* ctx) {
         queueCreateInfos.push_back(queueCreateInfo);
     }
 
+    // Horizon clipping in triangle_clip.vert needs gl_ClipDistance; without it
+    // only stars and deep-sky objects are culled below the horizon
+    VkPhysicalDeviceFeatures supportedFeatures{};
+    vkGetPhysicalDeviceFeatures(ctx->physicalDevice, &supportedFeatures);
     VkPhysicalDeviceFeatures deviceFeatures{};
+    deviceFeatures.shaderClipDistance = supportedFeatures.shaderClipDistance;
+    ctx->clipDistanceEnabled = supportedFeatures.shaderClipDistance == VK_TRUE;
+    // Overdraw telemetry counts fragment shader invocations
+    deviceFeatures.pipelineStatisticsQuery = supportedFeatures.pipelineStatisticsQuery;
+    ctx->pipelineStatisticsEnabled = supportedFeatures.pipelineStatisticsQuery == VK_TRUE;
 
     std::vector<const char*> deviceExtensions = {
         VK_KHR_SWAPCHAIN_EXTENSION_NAME
@@ -473,7 +771,9 @@ static bool createLogicalDevice(VulkanContext* ctx) {
     vkGetDeviceQueue(ctx->device.get(), ctx->graphicsQueueFamily, 0, &ctx->graphicsQueue);
     vkGetDeviceQueue(ctx->device.get(), ctx->presentQueueFamily, 0, &ctx->presentQueue);
 
-    LOGI("Logical device created successfully");
+    LOGI("Logical device created successfully (clip distance %s, pipeline statistics %s)",
+         ctx->clipDistanceEnabled ? "enabled" : "unsupported",
+         ctx->pipelineStatisticsEnabled ? "enabled" : "unsupported");
     return true;
 }
 
@@ -664,8 +964,23 @@ static bool createImageViews(VulkanContext* ctx) {
     return true;
 }
 
-// Create render pass
+// First depth format usable as an attachment, or VK_FORMAT_UNDEFINED
+static VkFormat findDepthFormat(VulkanContext* ctx) {
+    for (VkFormat format : DEPTH_FORMATS) {
+        VkFormatProperties properties;
+        vkGetPhysicalDeviceFormatProperties(ctx->physicalDevice, format, &properties);
+        if (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT) {
+            return format;
+        }
+    }
+    return VK_FORMAT_UNDEFINED;
+}
+
+// Create render pass (color, plus depth for layer ordering when supported)
 static bool createRenderPass(VulkanContext* ctx) {
+    ctx->depthFormat = findDepthFormat(ctx);
+    const bool depth = ctx->depthFormat != VK_FORMAT_UNDEFINED;
+
     VkAttachmentDescription colorAttachment{};
     colorAttachment.format = ctx->swapchainFormat;
     colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
@@ -676,15 +991,33 @@ static bool createRenderPass(VulkanContext* ctx) {
     colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
     colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
 
+    // Depth is only needed within the frame: cleared on load, never stored
+    VkAttachmentDescription depthAttachment{};
+    depthAttachment.format = ctx->depthFormat;
+    depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
     VkAttachmentReference colorAttachmentRef{};
     colorAttachmentRef.attachment = 0;
     colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
+    VkAttachmentReference depthAttachmentRef{};
+    depthAttachmentRef.attachment = 1;
+    depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
     VkSubpassDescription subpass{};
     subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
     subpass.colorAttachmentCount = 1;
     subpass.pColorAttachments = &colorAttachmentRef;
+    subpass.pDepthStencilAttachment = depth ? &depthAttachmentRef : nullptr;
 
+    // The depth image is shared by every frame in flight, so the previous
+    // frame's depth tests must finish before this frame clears it
     VkSubpassDependency dependency{};
     dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
     dependency.dstSubpass = 0;
@@ -692,11 +1025,18 @@ static bool createRenderPass(VulkanContext* ctx) {
     dependency.srcAccessMask = 0;
     dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
     dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    if (depth) {
+        dependency.srcStageMask |= VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        dependency.srcAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        dependency.dstStageMask |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+        dependency.dstAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    }
 
+    const VkAttachmentDescription attachments[] = {colorAttachment, depthAttachment};
     VkRenderPassCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-    createInfo.attachmentCount = 1;
-    createInfo.pAttachments = &colorAttachment;
+    createInfo.attachmentCount = depth ? 2 : 1;
+    createInfo.pAttachments = attachments;
     createInfo.subpassCount = 1;
     createInfo.pSubpasses = &subpass;
     createInfo.dependencyCount = 1;
@@ -710,7 +1050,84 @@ static bool createRenderPass(VulkanContext* ctx) {
     }
     ctx->renderPass = UniqueRenderPass(renderPass, RenderPassDeleter{ctx->device.get()});
 
-    LOGI("Render pass created");
+    LOGI("Render pass created (depth %s)", depth ? "attached" : "unsupported");
+    return true;
+}
+
+// Forward declaration (defined later in file)
+static uint32_t findMemoryType(VulkanContext* ctx, uint32_t typeFilter, VkMemoryPropertyFlags properties);
+
+// Create the depth image shared by all framebuffers (nothing to do without a depth format)
+static bool createDepthResources(VulkanContext* ctx) {
+    if (ctx->depthFormat == VK_FORMAT_UNDEFINED) {
+        return true;
+    }
+
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = ctx->depthFormat;
+    imageInfo.extent = {ctx->swapchainExtent.width, ctx->swapchainExtent.height, 1};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    // Never stored, so tilers can keep it on chip
+    imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    VkImage image;
+    VkResult result = vkCreateImage(ctx->device.get(), &imageInfo, nullptr, &image);
+    if (result != VK_SUCCESS) {
+        LOGE("Failed to create depth image: %s (%d)", vkResultToString(result), result);
+        return false;
+    }
+    ctx->depthImage = UniqueImage(image, ImageDeleter{ctx->device.get()});
+
+    VkMemoryRequirements memRequirements;
+    vkGetImageMemoryRequirements(ctx->device.get(), image, &memRequirements);
+
+    const uint32_t memoryType = findMemoryType(ctx, memRequirements.memoryTypeBits,
+                                               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    if (memoryType == UINT32_MAX) {
+        return false;
+    }
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = memRequirements.size;
+    allocInfo.memoryTypeIndex = memoryType;
+
+    VkDeviceMemory memory;
+    result = vkAllocateMemory(ctx->device.get(), &allocInfo, nullptr, &memory);
+    if (result != VK_SUCCESS) {
+        LOGE("Failed to allocate depth image memory: %s (%d)", vkResultToString(result), result);
+        return false;
+    }
+    ctx->depthImageMemory = UniqueDeviceMemory(memory, DeviceMemoryDeleter{ctx->device.get()});
+    vkBindImageMemory(ctx->device.get(), image, memory, 0);
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = ctx->depthFormat;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+    viewInfo.subresourceRange.baseMipLevel = 0;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount = 1;
+
+    VkImageView view;
+    result = vkCreateImageView(ctx->device.get(), &viewInfo, nullptr, &view);
+    if (result != VK_SUCCESS) {
+        LOGE("Failed to create depth image view: %s (%d)", vkResultToString(result), result);
+        return false;
+    }
+    ctx->depthImageView = UniqueImageView(view, ImageViewDeleter{ctx->device.get()});
+
+    LOGI("Depth attachment created (%ux%u)", ctx->swapchainExtent.width, ctx->swapchainExtent.height);
     return true;
 }
 
@@ -720,12 +1137,12 @@ static bool createFramebuffers(VulkanContext* ctx) {
     ctx->framebuffers.reserve(ctx->swapchainImageViews.size());
 
     for (size_t i = 0; i < ctx->swapchainImageViews.size(); i++) {
-        VkImageView attachments[] = {ctx->swapchainImageViews[i].get()};
+        VkImageView attachments[] = {ctx->swapchainImageViews[i].get(), ctx->depthImageView.get()};
 
         VkFramebufferCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
         createInfo.renderPass = ctx->renderPass.get();
-        createInfo.attachmentCount = 1;
+        createInfo.attachmentCount = ctx->depthImageView ? 2 : 1;
         createInfo.pAttachments = attachments;
         createInfo.width = ctx->swapchainExtent.width;
         createInfo.height = ctx->swapchainExtent.height;
@@ -817,8 +1234,67 @@ static bool createSyncObjects(VulkanContext* ctx) {
     return true;
 }
 
-// Forward declaration (defined later in file)
-static uint32_t findMemoryType(VulkanContext* ctx, uint32_t typeFilter, VkMemoryPropertyFlags properties);
+// Create the timestamp query pool used for per-layer GPU timing.
+// Without timestamp support the frame budget runs on CPU timings alone.
+static bool createTimestampQueryPool(VulkanContext* ctx) {
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(ctx->physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(ctx->physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(ctx->physicalDevice, &properties);
+
+    const uint32_t validBits = queueFamilies[ctx->graphicsQueueFamily].timestampValidBits;
+    if (validBits == 0 || properties.limits.timestampPeriod <= 0.0f) {
+        LOGW("GPU timestamps not supported; frame budget uses CPU timings only");
+        return true;
+    }
+
+    VkQueryPoolCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    createInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    createInfo.queryCount = MAX_FRAMES_IN_FLIGHT * TIMESTAMPS_PER_FRAME;
+
+    VkQueryPool queryPool;
+    VkResult result = vkCreateQueryPool(ctx->device.get(), &createInfo, nullptr, &queryPool);
+    if (result != VK_SUCCESS) {
+        LOGE("Failed to create timestamp query pool: %s (%d)", vkResultToString(result), result);
+        return false;
+    }
+    ctx->timestampPool = UniqueQueryPool(queryPool, QueryPoolDeleter{ctx->device.get()});
+    ctx->timestampPeriodNs = properties.limits.timestampPeriod;
+    ctx->timestampMask = validBits >= 64 ? ~uint64_t(0) : (uint64_t(1) << validBits) - 1;
+
+    LOGI("Timestamp query pool created (%u valid bits, %.2f ns/tick)", validBits, ctx->timestampPeriodNs);
+    return true;
+}
+
+// Create the pipeline statistics pool that measures overdraw, one query per frame slot.
+// Without the pipelineStatisticsQuery feature overdraw is simply not reported.
+static bool createStatisticsQueryPool(VulkanContext* ctx) {
+    if (!ctx->pipelineStatisticsEnabled) {
+        LOGW("Pipeline statistics not supported; overdraw is not measured");
+        return true;
+    }
+
+    VkQueryPoolCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    createInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+    createInfo.queryCount = MAX_FRAMES_IN_FLIGHT;
+    createInfo.pipelineStatistics = VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+
+    VkQueryPool queryPool;
+    VkResult result = vkCreateQueryPool(ctx->device.get(), &createInfo, nullptr, &queryPool);
+    if (result != VK_SUCCESS) {
+        LOGE("Failed to create pipeline statistics query pool: %s (%d)", vkResultToString(result), result);
+        return false;
+    }
+    ctx->statisticsPool = UniqueQueryPool(queryPool, QueryPoolDeleter{ctx->device.get()});
+
+    LOGI("Pipeline statistics query pool created");
+    return true;
+}
 
 // Create descriptor set layout for uniform buffer
 static bool createDescriptorSetLayout(VulkanContext* ctx) {
@@ -846,9 +1322,48 @@ static bool createDescriptorSetLayout(VulkanContext* ctx) {
     return true;
 }
 
-// Create uniform buffer for view/projection matrices
+// Write the scintillation vec4: the observer's zenith (zero, which turns
+// twinkling off in star.vert, until the observer is known) and the shader
+// clock, wrapped to keep float precision
+static void writeScintillationUniforms(VulkanContext* ctx) {
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - ctx->scintillationEpoch).count();
+    float values[4] = {0.0f, 0.0f, 0.0f, static_cast<float>(std::fmod(seconds, SCINTILLATION_PERIOD))};
+    if (ctx->observer.valid()) {
+        const double* zenith = ctx->observer.frame().zenith;
+        for (int i = 0; i < 3; i++) values[i] = static_cast<float>(zenith[i]);
+    }
+    memcpy(static_cast<char*>(ctx->uniformBufferMapped) + UNIFORM_SCINTILLATION_OFFSET, values, sizeof(values));
+}
+
+// Star pipeline for this frame: the twinkling variant only while scintillation is on
+static VkPipeline starPipelineFor(VulkanContext* ctx) {
+    return ctx->scintillation ? ctx->starScintillationPipeline.get() : ctx->starPipeline.get();
+}
+
+// Mirror the horizon plane and local north into the uniform buffer, and the
+// terrain table when it changed (1 KB, so not every frame)
+static void writeHorizonUniforms(VulkanContext* ctx) {
+    char* base = static_cast<char*>(ctx->uniformBufferMapped);
+    const float* north = ctx->horizonFrame.north;
+    const float horizonNorth[4] = {north[0], north[1], north[2], 0.0f};
+    memcpy(base + UNIFORM_HORIZON_OFFSET, ctx->horizonPlane, sizeof(ctx->horizonPlane));
+    memcpy(base + UNIFORM_HORIZON_OFFSET + sizeof(horizonNorth), horizonNorth, sizeof(horizonNorth));
+
+    if (ctx->terrainUniformsDirty) {
+        float* table = reinterpret_cast<float*>(base + UNIFORM_TERRAIN_OFFSET);
+        if (ctx->horizonClip && ctx->terrainProfileSet) {
+            std::copy(ctx->terrainProfile.sinAltitudes(), ctx->terrainProfile.sinAltitudes() + horizon::BINS, table);
+        } else {
+            std::fill(table, table + horizon::BINS, TERRAIN_DISABLED);
+        }
+        ctx->terrainUniformsDirty = false;
+    }
+}
+
+// Create uniform buffer for view/projection matrices, horizon and the star color LUT
 static bool createUniformBuffer(VulkanContext* ctx) {
-    VkDeviceSize bufferSize = sizeof(float) * 32; // 2 mat4 = 128 bytes
+    VkDeviceSize bufferSize = UNIFORM_BUFFER_SIZE;
 
     VkBufferCreateInfo bufferInfo{};
     bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -904,6 +1419,11 @@ static bool createUniformBuffer(VulkanContext* ctx) {
     math::identity(ctx->projectionMatrix);
     memcpy(ctx->uniformBufferMapped, ctx->viewMatrix, sizeof(float) * 16);
     memcpy(static_cast<char*>(ctx->uniformBufferMapped) + sizeof(float) * 16, ctx->projectionMatrix, sizeof(float) * 16);
+    writeHorizonUniforms(ctx);
+
+    // White palette until the app uploads one, so stars are visible either way
+    float* palette = reinterpret_cast<float*>(static_cast<char*>(ctx->uniformBufferMapped) + UNIFORM_PALETTE_OFFSET);
+    std::fill(palette, palette + STAR_PALETTE_SIZE * 4, 1.0f);
 
     LOGI("Uniform buffer created (%zu bytes, persistently mapped)", (size_t)bufferSize);
     return true;
@@ -947,7 +1467,7 @@ static bool createDescriptorPool(VulkanContext* ctx) {
     VkDescriptorBufferInfo bufferInfo{};
     bufferInfo.buffer = ctx->uniformBuffer.get();
     bufferInfo.offset = 0;
-    bufferInfo.range = sizeof(float) * 32; // 2 mat4
+    bufferInfo.range = UNIFORM_BUFFER_SIZE;  // Matrices + star palette
 
     VkWriteDescriptorSet descriptorWrite{};
     descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -1042,14 +1562,20 @@ static VkShaderModule createShaderModule(VulkanContext* ctx, const unsigned char
 
 // Create a single graphics pipeline for a specific topology
 // Assumes pipeline layout already exists
+// Blended pipelines draw premultiplied colors with culling off
 static UniquePipeline createPipelineForTopology(VulkanContext* ctx, VkPrimitiveTopology topology,
-                                                 VkShaderModule vertShaderModule, VkShaderModule fragShaderModule) {
+                                                 VkShaderModule vertShaderModule, VkShaderModule fragShaderModule,
+                                                 BlendMode blend = BlendMode::Opaque,
+                                                 VertexLayout layout = VertexLayout::PositionColor,
+                                                 DepthMode depth = DepthMode::Test,
+                                                 const VkSpecializationInfo* vertexSpecialization = nullptr) {
     // Shader stages
     VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
     vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
     vertShaderStageInfo.module = vertShaderModule;
     vertShaderStageInfo.pName = "main";
+    vertShaderStageInfo.pSpecializationInfo = vertexSpecialization;
 
     VkPipelineShaderStageCreateInfo fragShaderStageInfo{};
     fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -1059,29 +1585,73 @@ static UniquePipeline createPipelineForTopology(VulkanContext* ctx, VkPrimitiveT
 
     VkPipelineShaderStageCreateInfo shaderStages[] = {vertShaderStageInfo, fragShaderStageInfo};
 
-    // Vertex input: position (vec3) and color (vec4) = 7 floats per vertex
+    // Vertex input: position (vec3) followed by color (vec4) or packed star bytes (uvec4),
+    // or one dso::Instance / bodies::Instance / meteors::Streak per instance
+    const bool instanced = layout == VertexLayout::DsoInstance || layout == VertexLayout::BodyInstance ||
+                           layout == VertexLayout::MeteorStreak;
     VkVertexInputBindingDescription bindingDescription{};
     bindingDescription.binding = 0;
-    bindingDescription.stride = sizeof(float) * 7; // vec3 position + vec4 color
-    bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-
-    VkVertexInputAttributeDescription attributeDescriptions[2] = {};
-    // Position (vec3)
-    attributeDescriptions[0].binding = 0;
-    attributeDescriptions[0].location = 0;
-    attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
-    attributeDescriptions[0].offset = 0;
-    // Color (vec4)
-    attributeDescriptions[1].binding = 0;
-    attributeDescriptions[1].location = 1;
-    attributeDescriptions[1].format = VK_FORMAT_R32G32B32A32_SFLOAT;
-    attributeDescriptions[1].offset = sizeof(float) * 3;
+    bindingDescription.stride = vertexStride(layout);
+    bindingDescription.inputRate = instanced ? VK_VERTEX_INPUT_RATE_INSTANCE : VK_VERTEX_INPUT_RATE_VERTEX;
+
+    VkVertexInputAttributeDescription attributeDescriptions[4] = {};
+    uint32_t attributeCount;
+    if (layout == VertexLayout::DsoInstance) {
+        // Center + semi-major axis, axis ratio + position angle, RGBA8 color, glyph
+        const VkFormat formats[4] = {VK_FORMAT_R32G32B32A32_SFLOAT, VK_FORMAT_R32G32_SFLOAT,
+                                     VK_FORMAT_R8G8B8A8_UNORM, VK_FORMAT_R32_UINT};
+        const uint32_t offsets[4] = {offsetof(dso::Instance, x), offsetof(dso::Instance, axisRatio),
+                                     offsetof(dso::Instance, color), offsetof(dso::Instance, glyph)};
+        for (uint32_t i = 0; i < 4; i++) {
+            attributeDescriptions[i].binding = 0;
+            attributeDescriptions[i].location = i;
+            attributeDescriptions[i].format = formats[i];
+            attributeDescriptions[i].offset = offsets[i];
+        }
+        attributeCount = 4;
+    } else if (layout == VertexLayout::BodyInstance) {
+        // Center + angular radius, sunlight + limb darkening, RGBA8 color, flags
+        const VkFormat formats[4] = {VK_FORMAT_R32G32B32A32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT,
+                                     VK_FORMAT_R8G8B8A8_UNORM, VK_FORMAT_R32_UINT};
+        const uint32_t offsets[4] = {offsetof(bodies::Instance, x), offsetof(bodies::Instance, lightX),
+                                     offsetof(bodies::Instance, color), offsetof(bodies::Instance, flags)};
+        for (uint32_t i = 0; i < 4; i++) {
+            attributeDescriptions[i].binding = 0;
+            attributeDescriptions[i].location = i;
+            attributeDescriptions[i].format = formats[i];
+            attributeDescriptions[i].offset = offsets[i];
+        }
+        attributeCount = 4;
+    } else if (layout == VertexLayout::MeteorStreak) {
+        // Head + brightness, tail + width
+        const uint32_t offsets[2] = {offsetof(meteors::Streak, headX), offsetof(meteors::Streak, tailX)};
+        for (uint32_t i = 0; i < 2; i++) {
+            attributeDescriptions[i].binding = 0;
+            attributeDescriptions[i].location = i;
+            attributeDescriptions[i].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+            attributeDescriptions[i].offset = offsets[i];
+        }
+        attributeCount = 2;
+    } else {
+        // Position (vec3)
+        attributeDescriptions[0].binding = 0;
+        attributeDescriptions[0].location = 0;
+        attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+        attributeDescriptions[0].offset = 0;
+        // Color (vec4) or packed color index / alpha bytes
+        attributeDescriptions[1].binding = 0;
+        attributeDescriptions[1].location = 1;
+        attributeDescriptions[1].format = layout == VertexLayout::PackedStar ? VK_FORMAT_R8G8B8A8_UINT
+                                                                             : VK_FORMAT_R32G32B32A32_SFLOAT;
+        attributeDescriptions[1].offset = sizeof(float) * 3;
+        attributeCount = 2;
+    }
 
     VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
     vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
     vertexInputInfo.vertexBindingDescriptionCount = 1;
     vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
-    vertexInputInfo.vertexAttributeDescriptionCount = 2;
+    vertexInputInfo.vertexAttributeDescriptionCount = attributeCount;
     vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions;
 
     // Input assembly - use the topology parameter
@@ -1111,7 +1681,9 @@ static UniquePipeline createPipelineForTopology(VulkanContext* ctx, VkPrimitiveT
     rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
     rasterizer.lineWidth = 2.0f;  // Thicker lines for constellation visibility
     // Disable culling for points and lines (they have no front/back face)
-    if (topology == VK_PRIMITIVE_TOPOLOGY_POINT_LIST || topology == VK_PRIMITIVE_TOPOLOGY_LINE_LIST) {
+    // Blended patches and quads are seen from inside the sphere with mixed winding
+    if (topology == VK_PRIMITIVE_TOPOLOGY_POINT_LIST || topology == VK_PRIMITIVE_TOPOLOGY_LINE_LIST ||
+        blend != BlendMode::Opaque) {
         rasterizer.cullMode = VK_CULL_MODE_NONE;
     } else {
         rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
@@ -1129,7 +1701,28 @@ static UniquePipeline createPipelineForTopology(VulkanContext* ctx, VkPrimitiveT
     VkPipelineColorBlendAttachmentState colorBlendAttachment{};
     colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
                                           VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-    colorBlendAttachment.blendEnable = VK_FALSE;
+    colorBlendAttachment.blendEnable = blend != BlendMode::Opaque ? VK_TRUE : VK_FALSE;
+    if (blend != BlendMode::Opaque) {
+        const VkBlendFactor dst = blend == BlendMode::Additive ? VK_BLEND_FACTOR_ONE
+                                                                : VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+        colorBlendAttachment.dstColorBlendFactor = dst;
+        colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+        colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        colorBlendAttachment.dstAlphaBlendFactor = dst;
+        colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+    }
+
+    // Depth: occluders must be strictly nearer to win, so within an occluder's
+    // draw the first (nearest) fragment keeps the pixel; tested layers pass at
+    // equal depth and keep painter's order among themselves
+    VkPipelineDepthStencilStateCreateInfo depthStencil{};
+    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencil.depthTestEnable = VK_TRUE;
+    depthStencil.depthWriteEnable = depth == DepthMode::Write ? VK_TRUE : VK_FALSE;
+    depthStencil.depthCompareOp = depth == DepthMode::Write ? VK_COMPARE_OP_LESS : VK_COMPARE_OP_LESS_OR_EQUAL;
+    depthStencil.depthBoundsTestEnable = VK_FALSE;
+    depthStencil.stencilTestEnable = VK_FALSE;
 
     VkPipelineColorBlendStateCreateInfo colorBlending{};
     colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
@@ -1147,6 +1740,7 @@ static UniquePipeline createPipelineForTopology(VulkanContext* ctx, VkPrimitiveT
     pipelineInfo.pViewportState = &viewportState;
     pipelineInfo.pRasterizationState = &rasterizer;
     pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pDepthStencilState = ctx->depthFormat != VK_FORMAT_UNDEFINED ? &depthStencil : nullptr;
     pipelineInfo.pColorBlendState = &colorBlending;
     pipelineInfo.pDynamicState = &dynamicState;
     pipelineInfo.layout = ctx->pipelineLayout.get();
@@ -1167,17 +1761,37 @@ static UniquePipeline createPipelineForTopology(VulkanContext* ctx, VkPrimitiveT
 // Create all graphics pipelines (triangles, lines, points)
 static bool createGraphicsPipelines(VulkanContext* ctx) {
     // Create shader modules (shared by all pipelines)
-    VkShaderModule vertShaderModule = createShaderModule(ctx, triangle_vert_spv, triangle_vert_spv_len);
+    VkShaderModule vertShaderModule = ctx->clipDistanceEnabled
+        ? createShaderModule(ctx, triangle_clip_vert_spv, triangle_clip_vert_spv_len)
+        : createShaderModule(ctx, triangle_vert_spv, triangle_vert_spv_len);
     VkShaderModule fragShaderModule = createShaderModule(ctx, triangle_frag_spv, triangle_frag_spv_len);
+    VkShaderModule starVertShaderModule = createShaderModule(ctx, star_vert_spv, star_vert_spv_len);
+    VkShaderModule dsoVertShaderModule = createShaderModule(ctx, dso_vert_spv, dso_vert_spv_len);
+    VkShaderModule dsoFragShaderModule = createShaderModule(ctx, dso_frag_spv, dso_frag_spv_len);
+    VkShaderModule bodyVertShaderModule = createShaderModule(ctx, body_vert_spv, body_vert_spv_len);
+    VkShaderModule bodyFragShaderModule = createShaderModule(ctx, body_frag_spv, body_frag_spv_len);
+    VkShaderModule meteorVertShaderModule = createShaderModule(ctx, meteor_vert_spv, meteor_vert_spv_len);
+    VkShaderModule meteorFragShaderModule = createShaderModule(ctx, meteor_frag_spv, meteor_frag_spv_len);
+
+    // Modules are only needed until the pipelines exist
+    auto destroyShaderModules = [&]() {
+        for (VkShaderModule module : {vertShaderModule, fragShaderModule, starVertShaderModule,
+                                      dsoVertShaderModule, dsoFragShaderModule,
+                                      bodyVertShaderModule, bodyFragShaderModule,
+                                      meteorVertShaderModule, meteorFragShaderModule}) {
+            if (module != VK_NULL_HANDLE) {
+                vkDestroyShaderModule(ctx->device.get(), module, nullptr);
+            }
+        }
+    };
 
-    if (vertShaderModule == VK_NULL_HANDLE || fragShaderModule == VK_NULL_HANDLE) {
+    if (vertShaderModule == VK_NULL_HANDLE || fragShaderModule == VK_NULL_HANDLE ||
+        starVertShaderModule == VK_NULL_HANDLE || dsoVertShaderModule == VK_NULL_HANDLE ||
+        dsoFragShaderModule == VK_NULL_HANDLE || bodyVertShaderModule == VK_NULL_HANDLE ||
+        bodyFragShaderModule == VK_NULL_HANDLE || meteorVertShaderModule == VK_NULL_HANDLE ||
+        meteorFragShaderModule == VK_NULL_HANDLE) {
         LOGE("Failed to create shader modules");
-        if (vertShaderModule != VK_NULL_HANDLE) {
-            vkDestroyShaderModule(ctx->device.get(), vertShaderModule, nullptr);
-        }
-        if (fragShaderModule != VK_NULL_HANDLE) {
-            vkDestroyShaderModule(ctx->device.get(), fragShaderModule, nullptr);
-        }
+        destroyShaderModules();
         return false;
     }
 
@@ -1187,7 +1801,7 @@ static bool createGraphicsPipelines(VulkanContext* ctx) {
     VkPushConstantRange pushConstantRange{};
     pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
     pushConstantRange.offset = 0;
-    pushConstantRange.size = sizeof(float) * 16; // mat4
+    pushConstantRange.size = sizeof(PushConstants);
 
     VkDescriptorSetLayout descriptorSetLayout = ctx->descriptorSetLayout.get();
     VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
@@ -1201,8 +1815,7 @@ static bool createGraphicsPipelines(VulkanContext* ctx) {
     VkResult result = vkCreatePipelineLayout(ctx->device.get(), &pipelineLayoutInfo, nullptr, &pipelineLayout);
     if (result != VK_SUCCESS) {
         LOGE("Failed to create pipeline layout: %s (%d)", vkResultToString(result), result);
-        vkDestroyShaderModule(ctx->device.get(), vertShaderModule, nullptr);
-        vkDestroyShaderModule(ctx->device.get(), fragShaderModule, nullptr);
+        destroyShaderModules();
         return false;
     }
     ctx->pipelineLayout = UniquePipelineLayout(pipelineLayout, PipelineLayoutDeleter{ctx->device.get()});
@@ -1213,17 +1826,42 @@ static bool createGraphicsPipelines(VulkanContext* ctx) {
     ctx->trianglePipeline = createPipelineForTopology(ctx, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, vertShaderModule, fragShaderModule);
     ctx->linePipeline = createPipelineForTopology(ctx, VK_PRIMITIVE_TOPOLOGY_LINE_LIST, vertShaderModule, fragShaderModule);
     ctx->pointPipeline = createPipelineForTopology(ctx, VK_PRIMITIVE_TOPOLOGY_POINT_LIST, vertShaderModule, fragShaderModule);
+    ctx->lightMapPipeline = createPipelineForTopology(ctx, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, vertShaderModule, fragShaderModule,
+                                                     BlendMode::Additive);
+    ctx->starPipeline = createPipelineForTopology(ctx, VK_PRIMITIVE_TOPOLOGY_POINT_LIST, starVertShaderModule, fragShaderModule,
+                                                  BlendMode::Opaque, VertexLayout::PackedStar);
+    // constant_id 0 of star.vert compiles the twinkling in; the plain variant pays nothing for it
+    const VkBool32 scintillationOn = VK_TRUE;
+    const VkSpecializationMapEntry scintillationEntry{0, 0, sizeof(VkBool32)};
+    VkSpecializationInfo scintillationSpecialization{};
+    scintillationSpecialization.mapEntryCount = 1;
+    scintillationSpecialization.pMapEntries = &scintillationEntry;
+    scintillationSpecialization.dataSize = sizeof(scintillationOn);
+    scintillationSpecialization.pData = &scintillationOn;
+    ctx->starScintillationPipeline = createPipelineForTopology(ctx, VK_PRIMITIVE_TOPOLOGY_POINT_LIST,
+                                                               starVertShaderModule, fragShaderModule,
+                                                               BlendMode::Opaque, VertexLayout::PackedStar,
+                                                               DepthMode::Test, &scintillationSpecialization);
+    ctx->dsoPipeline = createPipelineForTopology(ctx, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP, dsoVertShaderModule,
+                                                 dsoFragShaderModule, BlendMode::Additive, VertexLayout::DsoInstance);
+    ctx->bodyPipeline = createPipelineForTopology(ctx, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP, bodyVertShaderModule,
+                                                  bodyFragShaderModule, BlendMode::Premultiplied,
+                                                  VertexLayout::BodyInstance, DepthMode::Write);
+    ctx->meteorPipeline = createPipelineForTopology(ctx, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP, meteorVertShaderModule,
+                                                    meteorFragShaderModule, BlendMode::Additive,
+                                                    VertexLayout::MeteorStreak);
 
     // Clean up shader modules (no longer needed after pipeline creation)
-    vkDestroyShaderModule(ctx->device.get(), vertShaderModule, nullptr);
-    vkDestroyShaderModule(ctx->device.get(), fragShaderModule, nullptr);
+    destroyShaderModules();
 
-    if (!ctx->trianglePipeline || !ctx->linePipeline || !ctx->pointPipeline) {
+    if (!ctx->trianglePipeline || !ctx->linePipeline || !ctx->pointPipeline || !ctx->lightMapPipeline ||
+        !ctx->starPipeline || !ctx->starScintillationPipeline || !ctx->dsoPipeline || !ctx->bodyPipeline || !ctx->meteorPipeline) {
         LOGE("Failed to create one or more graphics pipelines");
         return false;
     }
 
-    LOGI("All graphics pipelines created (triangles, lines, points)");
+    LOGI("All graphics pipelines created (triangles, lines, points, light map, stars, deep-sky objects, bodies, "
+         "meteors)");
     return true;
 }
 
@@ -1315,10 +1953,94 @@ static bool createVertexBuffer(VulkanContext* ctx) {
     return true;
 }
 
+// Create a host-visible vertex buffer holding a copy of data
+// Used for static geometry that is replaced rarely (light map, DSO instances)
+static bool createStaticVertexBuffer(VulkanContext* ctx, const void* data, VkDeviceSize bufferSize, const char* name,
+                                     UniqueBuffer& buffer, UniqueDeviceMemory& memory) {
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = bufferSize;
+    bufferInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VkBuffer rawBuffer;
+    VkResult result = vkCreateBuffer(ctx->device.get(), &bufferInfo, nullptr, &rawBuffer);
+    if (result != VK_SUCCESS) {
+        LOGE("Failed to create %s buffer: %s (%d)", name, vkResultToString(result), result);
+        return false;
+    }
+    buffer = UniqueBuffer(rawBuffer, BufferDeleter{ctx->device.get()});
+
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(ctx->device.get(), buffer.get(), &memRequirements);
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = memRequirements.size;
+    allocInfo.memoryTypeIndex = findMemoryType(ctx, memRequirements.memoryTypeBits,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+    if (allocInfo.memoryTypeIndex == UINT32_MAX) {
+        LOGE("Failed to find suitable memory type for %s buffer", name);
+        return false;
+    }
+
+    VkDeviceMemory rawMemory;
+    result = vkAllocateMemory(ctx->device.get(), &allocInfo, nullptr, &rawMemory);
+    if (result != VK_SUCCESS) {
+        LOGE("Failed to allocate %s buffer memory: %s (%d)", name, vkResultToString(result), result);
+        return false;
+    }
+    memory = UniqueDeviceMemory(rawMemory, DeviceMemoryDeleter{ctx->device.get()});
+
+    result = vkBindBufferMemory(ctx->device.get(), buffer.get(), memory.get(), 0);
+    if (result != VK_SUCCESS) {
+        LOGE("Failed to bind %s buffer memory: %s (%d)", name, vkResultToString(result), result);
+        return false;
+    }
+
+    void* mapped;
+    result = vkMapMemory(ctx->device.get(), memory.get(), 0, bufferSize, 0, &mapped);
+    if (result != VK_SUCCESS) {
+        LOGE("Failed to map %s buffer memory: %s (%d)", name, vkResultToString(result), result);
+        return false;
+    }
+    memcpy(mapped, data, bufferSize);
+    vkUnmapMemory(ctx->device.get(), memory.get());
+    return true;
+}
+
+// Upload deep-sky object instances, replacing any previous set
+static bool uploadDeepSkyObjects(VulkanContext* ctx, const std::vector<dso::Instance>& instances) {
+    vkDeviceWaitIdle(ctx->device.get());
+    ctx->dsoInstanceBuffer.reset();
+    ctx->dsoInstanceBufferMemory.reset();
+    ctx->dsoInstanceCount = 0;
+
+    if (instances.empty()) {
+        return true;
+    }
+
+    VkDeviceSize bufferSize = instances.size() * sizeof(dso::Instance);
+    if (!createStaticVertexBuffer(ctx, instances.data(), bufferSize, "DSO instance",
+                                  ctx->dsoInstanceBuffer, ctx->dsoInstanceBufferMemory)) {
+        ctx->dsoInstanceBuffer.reset();
+        ctx->dsoInstanceBufferMemory.reset();
+        return false;
+    }
+
+    ctx->dsoInstanceCount = static_cast<uint32_t>(instances.size());
+    LOGI("Deep-sky objects uploaded (%u instances, %zu bytes)", ctx->dsoInstanceCount, (size_t)bufferSize);
+    return true;
+}
+
 // Clean up swapchain-related resources (for resize)
 // With RAII, we simply clear the vectors and reset the unique_ptrs
 static void cleanupSwapchain(VulkanContext* ctx) {
     ctx->framebuffers.clear();
+    ctx->depthImageView.reset();
+    ctx->depthImage.reset();
+    ctx->depthImageMemory.reset();
     ctx->swapchainImageViews.clear();
     ctx->swapchain.reset();
 }
@@ -1335,6 +2057,7 @@ static bool recreateSwapchain(VulkanContext* ctx) {
 
     if (!createSwapchain(ctx)) return false;
     if (!createImageViews(ctx)) return false;
+    if (!createDepthResources(ctx)) return false;
     if (!createFramebuffers(ctx)) return false;
 
     LOGI("Swapchain recreated successfully");
@@ -1342,6 +2065,162 @@ static bool recreateSwapchain(VulkanContext* ctx) {
 }
 
 // Record command buffer for a frame with rotation angle
+static const char* knobName(budget::Knob knob) {
+    switch (knob) {
+        case budget::Knob::StarDensity: return "star density";
+        case budget::Knob::Tessellation: return "tessellation";
+        case budget::Knob::LabelCount: return "label count";
+        case budget::Knob::Glow: return "glow";
+        case budget::Knob::ResolutionScale: return "resolution scale";
+        default: return "unknown";
+    }
+}
+
+static float millisecondsSince(std::chrono::steady_clock::time_point start,
+                               std::chrono::steady_clock::time_point end) {
+    return std::chrono::duration<float, std::milli>(end - start).count();
+}
+
+// Complete the timing of the frame that last used the current slot (its fence
+// has signaled) and feed it to the budget governor
+static void collectFrameTiming(VulkanContext* ctx) {
+    FrameTiming& timing = ctx->frameTimings[ctx->currentFrame];
+    if (!timing.pending) return;
+    timing.pending = false;
+
+    if (ctx->timestampPool) {
+        const uint32_t count = timing.markCount + 2;
+        uint64_t ticks[TIMESTAMPS_PER_FRAME];
+        VkResult result = vkGetQueryPoolResults(ctx->device.get(), ctx->timestampPool.get(),
+                                                ctx->currentFrame * TIMESTAMPS_PER_FRAME, count,
+                                                sizeof(ticks), ticks, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+        if (result == VK_SUCCESS) {
+            auto elapsedMs = [ctx](uint64_t from, uint64_t to) {
+                return static_cast<float>(((to - from) & ctx->timestampMask) * ctx->timestampPeriodNs * 1e-6);
+            };
+            timing.sample.gpuMs = elapsedMs(ticks[0], ticks[count - 1]);
+            for (uint32_t i = 0; i < timing.markCount; i++) {
+                timing.sample.layerGpuMs[timing.markLayers[i]] += elapsedMs(ticks[i + 1], ticks[i + 2]);
+            }
+        }
+    }
+
+    if (ctx->statisticsPool && timing.pixels > 0.0f) {
+        uint64_t fragments = 0;
+        VkResult result = vkGetQueryPoolResults(ctx->device.get(), ctx->statisticsPool.get(), ctx->currentFrame, 1,
+                                                sizeof(fragments), &fragments, sizeof(uint64_t),
+                                                VK_QUERY_RESULT_64_BIT);
+        if (result == VK_SUCCESS) {
+            timing.sample.overdraw = static_cast<float>(fragments / timing.pixels);
+        }
+    }
+
+    if (ctx->budgetGovernor.update(timing.sample)) {
+        const budget::Decision& d = ctx->budgetGovernor.decisions().back();
+        LOGI("Frame budget: %s %s to step %d (%.2f ms of %.2f ms, layer %d)",
+             d.degraded ? "lowered" : "restored", knobName(d.knob), d.step,
+             d.frameMs, ctx->budgetGovernor.budgetMs(), d.layer);
+    }
+}
+
+// Start timing the frame being recorded; must precede the render pass (query reset)
+static void beginFrameTiming(VulkanContext* ctx, VkCommandBuffer commandBuffer) {
+    FrameTiming& timing = ctx->frameTimings[ctx->currentFrame];
+    timing = FrameTiming();
+    timing.start = std::chrono::steady_clock::now();
+    timing.pixels = static_cast<float>(ctx->swapchainExtent.width) * ctx->swapchainExtent.height;
+
+    // Fragment shader invocations over the whole render pass
+    if (ctx->statisticsPool) {
+        vkCmdResetQueryPool(commandBuffer, ctx->statisticsPool.get(), ctx->currentFrame, 1);
+        vkCmdBeginQuery(commandBuffer, ctx->statisticsPool.get(), ctx->currentFrame, 0);
+    }
+
+    if (ctx->timestampPool) {
+        const uint32_t first = ctx->currentFrame * TIMESTAMPS_PER_FRAME;
+        vkCmdResetQueryPool(commandBuffer, ctx->timestampPool.get(), first, TIMESTAMPS_PER_FRAME);
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, ctx->timestampPool.get(), first);
+    }
+}
+
+// Close the open layer's CPU interval
+static void closeLayerTiming(FrameTiming& timing, std::chrono::steady_clock::time_point now) {
+    if (timing.openLayer != budget::NO_LAYER) {
+        timing.sample.layerCpuMs[timing.openLayer] += millisecondsSince(timing.layerStart, now);
+        timing.openLayer = budget::NO_LAYER;
+    }
+}
+
+// Finish timing the frame; must follow the render pass (query end)
+static void endFrameTiming(VulkanContext* ctx, VkCommandBuffer commandBuffer) {
+    FrameTiming& timing = ctx->frameTimings[ctx->currentFrame];
+    const auto now = std::chrono::steady_clock::now();
+    closeLayerTiming(timing, now);
+    timing.sample.cpuMs = millisecondsSince(timing.start, now);
+
+    if (ctx->statisticsPool) {
+        vkCmdEndQuery(commandBuffer, ctx->statisticsPool.get(), ctx->currentFrame);
+    }
+
+    if (ctx->timestampPool) {
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, ctx->timestampPool.get(),
+                            ctx->currentFrame * TIMESTAMPS_PER_FRAME + timing.markCount + 1);
+    }
+    timing.pending = true;
+}
+
+// Budget handed to the frame governor: the app's budget, reduced by the thermal tier
+static void applyFrameBudget(VulkanContext* ctx) {
+    const float budgetMs = ctx->thermalController
+        ? ctx->thermalController->governor().frameBudgetMs(ctx->baseFrameBudgetMs)
+        : ctx->baseFrameBudgetMs;
+    ctx->budgetGovernor.setBudgetMs(budgetMs);
+}
+
+// Hint sessions are per thread, so this must run on the render thread
+static void startThermalPacing(VulkanContext* ctx) {
+    ctx->performancePlatform = std::make_unique<thermal::AndroidPlatform>(static_cast<int32_t>(gettid()));
+    ctx->thermalController = std::make_unique<thermal::Controller>(ctx->performancePlatform.get());
+    LOGI("Thermal pacing: thermal API %s, performance hint session %s",
+         ctx->performancePlatform->hasThermal() ? "available" : "unavailable",
+         ctx->performancePlatform->hasHintSession() ? "created" : "unavailable");
+}
+
+// Report the frame just submitted and follow any thermal tier change
+static void updateThermalPacing(VulkanContext* ctx, float cpuMs) {
+    const double now = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    if (!ctx->thermalController->onFrame(now, static_cast<int64_t>(cpuMs * 1e6f))) return;
+
+    const thermal::Governor& governor = ctx->thermalController->governor();
+    applyFrameBudget(ctx);
+    LOGI("Thermal tier %d: %d fps target, frame budget %.2f ms",
+         governor.tier(), governor.targetFps(), ctx->budgetGovernor.budgetMs());
+}
+
+// Push the constants shared by every pipeline, at the depth of the current layer.
+// Vertices written relative to an anchor (see sky::Store) pass it here.
+static void pushDrawConstants(VulkanContext* ctx, VkCommandBuffer commandBuffer, const float model[16],
+                              float minRadiusPixels = 0.0f, const double anchor[3] = nullptr) {
+    PushConstants constants{};
+    std::copy(model, model + 16, constants.model);
+    constants.viewport[0] = static_cast<float>(ctx->swapchainExtent.width);
+    constants.viewport[1] = static_cast<float>(ctx->swapchainExtent.height);
+    constants.minRadiusPixels = minRadiusPixels;
+    constants.depth = ctx->drawDepth;
+    if (anchor != nullptr) {
+        // Rotate the anchor into eye space in double so the large terms cancel
+        // before anything is rounded to float (column-major view matrix)
+        for (int i = 0; i < 3; i++) {
+            double eye = 0.0;
+            for (int j = 0; j < 3; j++) eye += static_cast<double>(ctx->viewMatrix[j * 4 + i]) * anchor[j];
+            constants.anchor[i] = static_cast<float>(anchor[i]);
+            constants.anchorEye[i] = static_cast<float>(eye);
+        }
+    }
+    vkCmdPushConstants(commandBuffer, ctx->pipelineLayout.get(),
+                      VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(constants), &constants);
+}
+
 static bool recordCommandBuffer(VulkanContext* ctx, VkCommandBuffer commandBuffer, uint32_t imageIndex, float angle) {
     VkCommandBufferBeginInfo beginInfo{};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -1360,9 +2239,12 @@ static bool recordCommandBuffer(VulkanContext* ctx, VkCommandBuffer commandBuffe
     renderPassInfo.renderArea.extent = ctx->swapchainExtent;
 
     // Clear with configurable opacity (0 = transparent for AR, 1 = dark background)
-    VkClearValue clearColor = {{{0.0f, 0.0f, 0.05f * ctx->backgroundOpacity, ctx->backgroundOpacity}}};
-    renderPassInfo.clearValueCount = 1;
-    renderPassInfo.pClearValues = &clearColor;
+    // Depth clears to the far plane, behind every depth order
+    VkClearValue clearValues[2] = {};
+    clearValues[0].color = {{0.0f, 0.0f, 0.05f * ctx->backgroundOpacity, ctx->backgroundOpacity}};
+    clearValues[1].depthStencil = {1.0f, 0};
+    renderPassInfo.clearValueCount = ctx->depthImageView ? 2 : 1;
+    renderPassInfo.pClearValues = clearValues;
 
     vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
 
@@ -1397,7 +2279,7 @@ static bool recordCommandBuffer(VulkanContext* ctx, VkCommandBuffer commandBuffe
     // Build rotation matrix from angle and push to shader
     float transform[16];
     math::rotateZ(angle, transform);
-    vkCmdPushConstants(commandBuffer, ctx->pipelineLayout.get(), VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(transform), transform);
+    pushDrawConstants(ctx, commandBuffer, transform);
 
     // Draw triangle (3 vertices, 1 instance)
     vkCmdDraw(commandBuffer, 3, 1, 0, 0);
@@ -1412,48 +2294,625 @@ static bool recordCommandBuffer(VulkanContext* ctx, VkCommandBuffer commandBuffe
     return true;
 }
 
-// Cleanup is now handled automatically by RAII - unique_ptr members are destroyed
-// in reverse declaration order when VulkanContext is deleted.
-
-extern "C" {
+// Read the whole asset on the calling thread; false on a short read
+static bool readAsset(AAsset* asset, std::vector<uint8_t>& bytes) {
+    bytes.resize(static_cast<size_t>(AAsset_getLength64(asset)));
+    size_t offset = 0;
+    while (offset < bytes.size()) {
+        const int n = AAsset_read(asset, bytes.data() + offset, bytes.size() - offset);
+        if (n <= 0) {
+            return false;
+        }
+        offset += static_cast<size_t>(n);
+    }
+    return true;
+}
 
-JNIEXPORT jlong JNICALL
-Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeInit(
-    JNIEnv* env, jobject obj, jobject surface) {
+// Light map build: tessellate a selected map on a worker, upload at the start
+// of a frame, and free the replaced buffer once no submitted frame can use it
+static assets::Load buildLightMapAsync(VulkanContext* ctx, std::shared_ptr<const std::vector<lightmap::LightMap>> maps,
+                                       const lightmap::LightMap* map, float gain, uint64_t generation) {
+    auto ticket = ctx->assetLoads.join();
 
-    LOGI("Initializing Vulkan...");
+    // Two triangles of 7-float vertices per pixel at most
+    auto memory = co_await ctx->assetBudget.reserve(map->pixels.size() * 6 * 7 * sizeof(float));
+    co_await assets::resumeOn(jobs::shared());
 
-    // Use unique_ptr for RAII - if any step fails, ctx is automatically cleaned up
-    auto ctx = std::make_unique<VulkanContext>();
+    std::vector<float> vertices;
+    lightmap::appendPatchVertices(*map, gain, vertices, &jobs::shared());
 
-    // Get native window from Android Surface
-    ctx->nativeWindow = UniqueNativeWindow(ANativeWindow_fromSurface(env, surface));
-    if (!ctx->nativeWindow) {
-        LOGE("Failed to get native window from surface");
-        return 0;  // ctx automatically cleaned up
+    co_await ctx->frameTimeline.nextFrame();
+    if (generation != ctx->lightMapGeneration) {
+        co_return;  // Reselected while building
     }
 
-    ctx->width = ANativeWindow_getWidth(ctx->nativeWindow.get());
-    ctx->height = ANativeWindow_getHeight(ctx->nativeWindow.get());
-    LOGI("Surface size: %dx%d", ctx->width, ctx->height);
+    UniqueBuffer buffer;
+    UniqueDeviceMemory bufferMemory;
+    const VkDeviceSize bufferSize = vertices.size() * sizeof(float);
+    if (!vertices.empty() &&
+        !createStaticVertexBuffer(ctx, vertices.data(), bufferSize, "light map", buffer, bufferMemory)) {
+        co_return;
+    }
+    std::swap(buffer, ctx->lightMapBuffer);
+    std::swap(bufferMemory, ctx->lightMapBufferMemory);
+    ctx->lightMapVertexCount = static_cast<uint32_t>(vertices.size() / 7);
+    LOGI("Light map uploaded: cutoff %.1f, order %d (%u vertices, %zu bytes)", map->cutoffMagnitude, map->order,
+         ctx->lightMapVertexCount, (size_t)bufferSize);
+
+    // Frames already submitted may still read the old buffer
+    vertices = std::vector<float>();
+    memory.release();
+    co_await ctx->frameTimeline.reached(ctx->submittedFrames);
+}
 
-    // Create Vulkan instance
-    if (!createInstance(ctx.get())) return 0;
+// Select the map for the current limiting magnitude and build it if the
+// selection changed. Render thread only
+static void selectLightMap(VulkanContext* ctx) {
+    if (!ctx->lightMaps) {
+        return;
+    }
+    const lightmap::LightMap* map = lightmap::select(*ctx->lightMaps, ctx->lightMapLimit, ctx->lightMapOrder);
+    if (map == ctx->lightMapSelected) {
+        return;
+    }
+    ctx->lightMapSelected = map;
+    const uint64_t generation = ++ctx->lightMapGeneration;
+    if (map == nullptr) {
+        // Stop drawing the old glow; its buffer is replaced by the next build
+        LOGW("No light map covers limiting magnitude %.1f", ctx->lightMapLimit);
+        ctx->lightMapVertexCount = 0;
+        return;
+    }
+    buildLightMapAsync(ctx, ctx->lightMaps, map, ctx->lightMapGain, generation);
+}
 
-    // Create Android surface
-    if (!createSurface(ctx.get())) return 0;
+// Light map load: read and parse on a worker, then hand the maps over at the
+// start of a frame and build the one matching the current limiting magnitude
+static assets::Load loadLightMapAsync(VulkanContext* ctx, AAsset* asset, int preferredOrder, float gain) {
+    auto ticket = ctx->assetLoads.join();
+    std::unique_ptr<AAsset, void (*)(AAsset*)> file(asset, AAsset_close);
 
-    // Pick physical device
-    if (!pickPhysicalDevice(ctx.get())) return 0;
+    // File bytes plus parsed maps, which are of similar size
+    auto memory = co_await ctx->assetBudget.reserve(2 * static_cast<size_t>(AAsset_getLength64(asset)));
+    co_await assets::resumeOn(jobs::shared());
 
-    // Create logical device
-    if (!createLogicalDevice(ctx.get())) return 0;
+    std::vector<uint8_t> bytes;
+    if (!readAsset(asset, bytes)) {
+        LOGE("Failed to read light map asset");
+        co_return;
+    }
+    file.reset();
 
-    // Create swapchain
-    if (!createSwapchain(ctx.get())) return 0;
+    auto maps = std::make_shared<std::vector<lightmap::LightMap>>();
+    if (!lightmap::deserialize(bytes.data(), bytes.size(), *maps)) {
+        LOGE("Invalid light map data (%zu bytes)", bytes.size());
+        co_return;
+    }
+    bytes = std::vector<uint8_t>();
+    LOGI("Loaded %zu light maps", maps->size());
+    memory.release();
+
+    co_await ctx->frameTimeline.nextFrame();
+    ctx->lightMaps = std::move(maps);
+    ctx->lightMapOrder = preferredOrder;
+    ctx->lightMapGain = gain;
+    ctx->lightMapSelected = nullptr;
+    ctx->lightMapVertexCount = 0;
+    selectLightMap(ctx);
+}
 
-    // Create image views
-    if (!createImageViews(ctx.get())) return 0;
+// Create a buffer with its own memory allocation
+// Used for buffers the GPU fills itself (meteor particles, streaks and draw arguments)
+static bool createBuffer(VulkanContext* ctx, VkDeviceSize bufferSize, VkBufferUsageFlags usage,
+                         VkMemoryPropertyFlags properties, const char* name,
+                         UniqueBuffer& buffer, UniqueDeviceMemory& memory) {
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = bufferSize;
+    bufferInfo.usage = usage;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VkBuffer rawBuffer;
+    VkResult result = vkCreateBuffer(ctx->device.get(), &bufferInfo, nullptr, &rawBuffer);
+    if (result != VK_SUCCESS) {
+        LOGE("Failed to create %s buffer: %s (%d)", name, vkResultToString(result), result);
+        return false;
+    }
+    buffer = UniqueBuffer(rawBuffer, BufferDeleter{ctx->device.get()});
+
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(ctx->device.get(), buffer.get(), &memRequirements);
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = memRequirements.size;
+    allocInfo.memoryTypeIndex = findMemoryType(ctx, memRequirements.memoryTypeBits, properties);
+
+    if (allocInfo.memoryTypeIndex == UINT32_MAX) {
+        LOGE("Failed to find suitable memory type for %s buffer", name);
+        return false;
+    }
+
+    VkDeviceMemory rawMemory;
+    result = vkAllocateMemory(ctx->device.get(), &allocInfo, nullptr, &rawMemory);
+    if (result != VK_SUCCESS) {
+        LOGE("Failed to allocate %s buffer memory: %s (%d)", name, vkResultToString(result), result);
+        return false;
+    }
+    memory = UniqueDeviceMemory(rawMemory, DeviceMemoryDeleter{ctx->device.get()});
+
+    result = vkBindBufferMemory(ctx->device.get(), buffer.get(), memory.get(), 0);
+    if (result != VK_SUCCESS) {
+        LOGE("Failed to bind %s buffer memory: %s (%d)", name, vkResultToString(result), result);
+        return false;
+    }
+    return true;
+}
+
+// Create the meteor particle system: device-local particle, streak and
+// indirect-argument buffers, a mapped radiant buffer with one slice per frame
+// slot, and the meteor.comp pipeline. Without compute on the graphics queue
+// meteors are simply not shown.
+static bool createMeteorSystem(VulkanContext* ctx) {
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(ctx->physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(ctx->physicalDevice, &queueFamilyCount, queueFamilies.data());
+    if (!(queueFamilies[ctx->graphicsQueueFamily].queueFlags & VK_QUEUE_COMPUTE_BIT)) {
+        LOGW("Graphics queue has no compute support; meteors are not shown");
+        return true;
+    }
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(ctx->physicalDevice, &properties);
+    const VkDeviceSize alignment = std::max<VkDeviceSize>(1, properties.limits.minStorageBufferOffsetAlignment);
+    const VkDeviceSize radiantBytes = sizeof(meteors::Radiant) * meteors::MAX_RADIANTS;
+    ctx->meteorRadiantSlice = (radiantBytes + alignment - 1) / alignment * alignment;
+
+    const VkDeviceSize particleBytes = sizeof(meteors::Particle) * meteors::MAX_PARTICLES;
+    const VkDeviceSize streakBytes = sizeof(meteors::Streak) * meteors::MAX_PARTICLES;
+    const VkDeviceSize argsBytes = sizeof(VkDrawIndirectCommand);
+    if (!createBuffer(ctx, particleBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, "meteor particle",
+                      ctx->meteorParticleBuffer, ctx->meteorParticleMemory) ||
+        !createBuffer(ctx, streakBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, "meteor streak",
+                      ctx->meteorStreakBuffer, ctx->meteorStreakMemory) ||
+        !createBuffer(ctx, argsBytes,
+                      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                          VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, "meteor draw argument",
+                      ctx->meteorArgsBuffer, ctx->meteorArgsMemory) ||
+        !createBuffer(ctx, ctx->meteorRadiantSlice * MAX_FRAMES_IN_FLIGHT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, "meteor radiant",
+                      ctx->meteorRadiantBuffer, ctx->meteorRadiantMemory)) {
+        return false;
+    }
+
+    VkResult result = vkMapMemory(ctx->device.get(), ctx->meteorRadiantMemory.get(), 0,
+                                  ctx->meteorRadiantSlice * MAX_FRAMES_IN_FLIGHT, 0, &ctx->meteorRadiantMapped);
+    if (result != VK_SUCCESS) {
+        LOGE("Failed to map meteor radiant buffer memory: %s (%d)", vkResultToString(result), result);
+        return false;
+    }
+
+    // Bindings as in meteor.comp: particles, streaks, draw arguments, radiants (per frame slot)
+    VkDescriptorSetLayoutBinding bindings[4]{};
+    for (uint32_t i = 0; i < 4; i++) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = i == 3 ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC
+                                            : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = 4;
+    layoutInfo.pBindings = bindings;
+
+    VkDescriptorSetLayout descriptorSetLayout;
+    result = vkCreateDescriptorSetLayout(ctx->device.get(), &layoutInfo, nullptr, &descriptorSetLayout);
+    if (result != VK_SUCCESS) {
+        LOGE("Failed to create meteor descriptor set layout: %s (%d)", vkResultToString(result), result);
+        return false;
+    }
+    ctx->meteorDescriptorSetLayout = UniqueDescriptorSetLayout(descriptorSetLayout,
+                                                               DescriptorSetLayoutDeleter{ctx->device.get()});
+
+    VkDescriptorPoolSize poolSizes[2]{};
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSizes[0].descriptorCount = 3;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    poolSizes[1].descriptorCount = 1;
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = 2;
+    poolInfo.pPoolSizes = poolSizes;
+    poolInfo.maxSets = 1;
+
+    VkDescriptorPool descriptorPool;
+    result = vkCreateDescriptorPool(ctx->device.get(), &poolInfo, nullptr, &descriptorPool);
+    if (result != VK_SUCCESS) {
+        LOGE("Failed to create meteor descriptor pool: %s (%d)", vkResultToString(result), result);
+        return false;
+    }
+    ctx->meteorDescriptorPool = UniqueDescriptorPool(descriptorPool, DescriptorPoolDeleter{ctx->device.get()});
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = ctx->meteorDescriptorPool.get();
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &descriptorSetLayout;
+
+    result = vkAllocateDescriptorSets(ctx->device.get(), &allocInfo, &ctx->meteorDescriptorSet);
+    if (result != VK_SUCCESS) {
+        LOGE("Failed to allocate meteor descriptor set: %s (%d)", vkResultToString(result), result);
+        return false;
+    }
+
+    const VkDescriptorBufferInfo bufferInfos[4] = {
+        {ctx->meteorParticleBuffer.get(), 0, particleBytes},
+        {ctx->meteorStreakBuffer.get(), 0, streakBytes},
+        {ctx->meteorArgsBuffer.get(), 0, argsBytes},
+        {ctx->meteorRadiantBuffer.get(), 0, radiantBytes},
+    };
+    VkWriteDescriptorSet writes[4]{};
+    for (uint32_t i = 0; i < 4; i++) {
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = ctx->meteorDescriptorSet;
+        writes[i].dstBinding = i;
+        writes[i].descriptorType = bindings[i].descriptorType;
+        writes[i].descriptorCount = 1;
+        writes[i].pBufferInfo = &bufferInfos[i];
+    }
+    vkUpdateDescriptorSets(ctx->device.get(), 4, writes, 0, nullptr);
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(meteors::SimulationConstants);
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    VkPipelineLayout pipelineLayout;
+    result = vkCreatePipelineLayout(ctx->device.get(), &pipelineLayoutInfo, nullptr, &pipelineLayout);
+    if (result != VK_SUCCESS) {
+        LOGE("Failed to create meteor pipeline layout: %s (%d)", vkResultToString(result), result);
+        return false;
+    }
+    ctx->meteorComputeLayout = UniquePipelineLayout(pipelineLayout, PipelineLayoutDeleter{ctx->device.get()});
+
+    VkShaderModule computeShaderModule = createShaderModule(ctx, meteor_comp_spv, meteor_comp_spv_len);
+    if (computeShaderModule == VK_NULL_HANDLE) {
+        LOGE("Failed to create meteor compute shader module");
+        return false;
+    }
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = computeShaderModule;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = pipelineLayout;
+
+    VkPipeline pipeline;
+    result = vkCreateComputePipelines(ctx->device.get(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline);
+    vkDestroyShaderModule(ctx->device.get(), computeShaderModule, nullptr);
+    if (result != VK_SUCCESS) {
+        LOGE("Failed to create meteor compute pipeline: %s (%d)", vkResultToString(result), result);
+        return false;
+    }
+    ctx->meteorComputePipeline = UniquePipeline(pipeline, PipelineDeleter{ctx->device.get()});
+
+    LOGI("Meteor system created (%u particles, %zu bytes)", meteors::MAX_PARTICLES,
+         (size_t)(particleBytes + streakBytes + argsBytes));
+    return true;
+}
+
+// Step the meteor particles on the GPU (outside the render pass, before any draw)
+// The CPU writes this slot's radiants and 16 bytes of draw arguments; meteor.comp
+// spawns, ages and emits streaks. Stops once the showers end and the last meteor faded.
+static void simulateMeteors(VulkanContext* ctx, VkCommandBuffer commandBuffer) {
+    ctx->meteorStreaksReady = false;
+    if (!ctx->meteorComputePipeline) {
+        return;
+    }
+
+    // Radiants below the horizon contribute nothing; without an observer all count as overhead
+    const observer::Frame& frame = ctx->observer.frame();
+    meteors::Radiant* radiants = reinterpret_cast<meteors::Radiant*>(
+        static_cast<char*>(ctx->meteorRadiantMapped) + ctx->currentFrame * ctx->meteorRadiantSlice);
+    uint32_t radiantCount = 0;
+    float totalRate = 0.0f;
+    for (uint32_t i = 0; i < ctx->meteorShowerCount; i++) {
+        const meteors::Radiant& shower = ctx->meteorShowers[i];
+        const float sinAltitude = ctx->observer.valid()
+            ? static_cast<float>(shower.x * frame.zenith[0] + shower.y * frame.zenith[1] + shower.z * frame.zenith[2])
+            : 1.0f;
+        const float rate = meteors::ratePerSecond(shower.rate * ctx->meteorRateScale, sinAltitude);
+        if (rate <= 0.0f) continue;
+        radiants[radiantCount++] = {shower.x, shower.y, shower.z, rate};
+        totalRate += rate;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    const bool running = ctx->lastMeteorStep != std::chrono::steady_clock::time_point{};
+    if (radiantCount == 0 && (!running || ctx->meteorIdleSeconds > meteors::MAX_LIFETIME)) {
+        ctx->lastMeteorStep = {};
+        return;
+    }
+    const float dt = running
+        ? std::min(meteors::MAX_STEP, millisecondsSince(ctx->lastMeteorStep, now) / 1000.0f) : 0.0f;
+    ctx->lastMeteorStep = now;
+    // Ages only grow by dt, so after MAX_LIFETIME of steps every slot is free
+    ctx->meteorIdleSeconds = radiantCount == 0 ? ctx->meteorIdleSeconds + dt : 0.0f;
+
+    // The previous frame's compute writes and streak reads finish before this step starts
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT |
+                             VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    // A zeroed particle is a free slot
+    if (!ctx->meteorParticlesCleared) {
+        vkCmdFillBuffer(commandBuffer, ctx->meteorParticleBuffer.get(), 0, VK_WHOLE_SIZE, 0);
+        ctx->meteorParticlesCleared = true;
+    }
+    const VkDrawIndirectCommand args = {4, 0, 0, 0};  // One quad per instance; compute counts instances
+    vkCmdUpdateBuffer(commandBuffer, ctx->meteorArgsBuffer.get(), 0, sizeof(args), &args);
+
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    const uint32_t seed = ctx->meteorStep++;
+    const meteors::SimulationConstants constants = {
+        dt, meteors::spawnThreshold(totalRate, dt, seed), totalRate, seed, radiantCount};
+    const uint32_t dynamicOffset = static_cast<uint32_t>(ctx->currentFrame * ctx->meteorRadiantSlice);
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, ctx->meteorComputePipeline.get());
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, ctx->meteorComputeLayout.get(),
+                            0, 1, &ctx->meteorDescriptorSet, 1, &dynamicOffset);
+    vkCmdPushConstants(commandBuffer, ctx->meteorComputeLayout.get(), VK_SHADER_STAGE_COMPUTE_BIT,
+                       0, sizeof(constants), &constants);
+    vkCmdDispatch(commandBuffer, meteors::MAX_PARTICLES / meteors::WORKGROUP_SIZE, 1, 1);
+
+    // Streaks and the instance count are read by the indirect draw
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+    ctx->meteorStreaksReady = true;
+}
+
+// Grow the orbit buffers to hold at least bytes (rare; waits for the device)
+static bool growOrbitBuffers(VulkanContext* ctx, VkDeviceSize bytes) {
+    vkDeviceWaitIdle(ctx->device.get());
+    ctx->orbitStagingMapped = nullptr;
+    ctx->orbitStagingBuffer.reset();
+    ctx->orbitStagingMemory.reset();
+    ctx->orbitBuffer.reset();
+    ctx->orbitMemory.reset();
+    ctx->orbitIndexCount = 0;
+
+    constexpr VkDeviceSize granularity = 64 * 1024;
+    const VkDeviceSize capacity = (std::max(bytes, 2 * ctx->orbitCapacity) + granularity - 1) / granularity * granularity;
+    ctx->orbitCapacity = 0;
+    if (!createBuffer(ctx, capacity,
+                      VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+                          VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, "orbit", ctx->orbitBuffer, ctx->orbitMemory) ||
+        !createBuffer(ctx, capacity * MAX_FRAMES_IN_FLIGHT, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, "orbit staging",
+                      ctx->orbitStagingBuffer, ctx->orbitStagingMemory)) {
+        return false;
+    }
+
+    VkResult result = vkMapMemory(ctx->device.get(), ctx->orbitStagingMemory.get(), 0,
+                                  capacity * MAX_FRAMES_IN_FLIGHT, 0, &ctx->orbitStagingMapped);
+    if (result != VK_SUCCESS) {
+        LOGE("Failed to map orbit staging buffer memory: %s (%d)", vkResultToString(result), result);
+        return false;
+    }
+    ctx->orbitCapacity = capacity;
+    LOGI("Orbit buffers grown to %zu bytes", (size_t)capacity);
+    return true;
+}
+
+// Copy changed orbit tracks into the device-local buffer (outside the render pass)
+// The staging slice belongs to this frame slot, whose previous copy finished with its fence
+static void uploadOrbits(VulkanContext* ctx, VkCommandBuffer commandBuffer) {
+    if (!ctx->orbitCache.dirty()) {
+        return;
+    }
+    ctx->orbitIndexCount = 0;
+    if (ctx->orbitGrowDelay > 0) {
+        ctx->orbitGrowDelay--;
+        return;
+    }
+
+    const VkDeviceSize vertexBytes = ctx->orbitCache.vertexCount() * vertexStride(VertexLayout::PositionColor);
+    const VkDeviceSize indexBytes = ctx->orbitCache.indexCount() * sizeof(uint32_t);
+    if (indexBytes == 0) {
+        ctx->orbitCache.markClean();
+        return;
+    }
+    // The cache stays dirty until the copy is recorded, so a failed grow is retried
+    if (vertexBytes + indexBytes > ctx->orbitCapacity && !growOrbitBuffers(ctx, vertexBytes + indexBytes)) {
+        LOGE("Orbit tracks not uploaded; retrying in %u frames", ORBIT_GROW_RETRY_FRAMES);
+        ctx->orbitGrowDelay = ORBIT_GROW_RETRY_FRAMES;
+        return;
+    }
+
+    const VkDeviceSize slice = ctx->currentFrame * ctx->orbitCapacity;
+    char* staging = static_cast<char*>(ctx->orbitStagingMapped) + slice;
+    ctx->orbitCache.write(reinterpret_cast<float*>(staging), reinterpret_cast<uint32_t*>(staging + vertexBytes));
+
+    // Frames still in flight read the old tracks; the copy waits for their vertex input
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    VkBufferCopy region{};
+    region.srcOffset = slice;
+    region.dstOffset = 0;
+    region.size = vertexBytes + indexBytes;
+    vkCmdCopyBuffer(commandBuffer, ctx->orbitStagingBuffer.get(), ctx->orbitBuffer.get(), 1, &region);
+
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    ctx->orbitIndexOffset = vertexBytes;
+    ctx->orbitIndexCount = static_cast<uint32_t>(ctx->orbitCache.indexCount());
+    ctx->orbitCache.markClean();
+}
+
+// Floats per vertex and vertices per primitive of a Kotlin PrimitiveType ordinal
+// (POINTS=0, LINES=1, TRIANGLES=2, STARS=5; anything else draws as triangles)
+static uint32_t floatsPerVertex(jint primitiveType) {
+    const VertexLayout layout = primitiveType == PRIMITIVE_STARS ? VertexLayout::PackedStar : VertexLayout::PositionColor;
+    return static_cast<uint32_t>(vertexStride(layout) / sizeof(float));
+}
+
+static uint32_t verticesPerPrimitive(jint primitiveType) {
+    switch (primitiveType) {
+        case PRIMITIVE_STARS:
+        case 0:  // POINTS
+            return 1;
+        case 1:  // LINES
+            return 2;
+        default:
+            return 3;
+    }
+}
+
+// Horizon plane batches of a primitive type may be culled against: stars are
+// always culled below it in star.vert, the rest only where the GPU clips them
+static const float* cullingHorizon(const VulkanContext* ctx, jint primitiveType) {
+    return primitiveType == PRIMITIVE_STARS || ctx->clipDistanceEnabled ? ctx->horizonPlane : nullptr;
+}
+
+// Copy the vertex runs a culling pass yields (forEachRun(emit) calls emit(cull::Range)
+// for each) into the dynamic vertex buffer, back to back, and draw them with one call.
+// Runs hold whole primitives, so the packed vertices draw the same primitives
+template<typename ForEachRun>
+static void drawRuns(VulkanContext* ctx, jint primitiveType, const float* vertices, const float transform[16],
+                     ForEachRun forEachRun) {
+    const size_t stride = floatsPerVertex(primitiveType) * sizeof(float);
+    char* out = static_cast<char*>(ctx->dynamicVertexBufferMapped) + ctx->dynamicVertexBufferOffset;
+    const size_t room = ctx->dynamicVertexBufferSize - ctx->dynamicVertexBufferOffset;
+    size_t written = 0, needed = 0;
+    forEachRun([&](cull::Range run) {
+        const size_t size = run.count * stride;
+        needed += size;
+        if (needed > room) return;
+        memcpy(out + written, vertices + static_cast<size_t>(run.first) * (stride / sizeof(float)), size);
+        written += size;
+    });
+
+    if (needed > room) {
+        LOGE("Dynamic vertex buffer overflow! Need %zu bytes, have %zu",
+             ctx->dynamicVertexBufferOffset + needed, ctx->dynamicVertexBufferSize);
+        return;
+    }
+    if (written == 0) {
+        return;
+    }
+
+    // Select pipeline based on primitive type
+    VkPipeline pipeline;
+    switch (primitiveType) {
+        case PRIMITIVE_STARS:
+            pipeline = starPipelineFor(ctx);
+            break;
+        case 0:  // POINTS
+            pipeline = ctx->pointPipeline.get();
+            break;
+        case 1:  // LINES
+            pipeline = ctx->linePipeline.get();
+            break;
+        case 2:  // TRIANGLES
+        default:
+            pipeline = ctx->trianglePipeline.get();
+            break;
+    }
+    vkCmdBindPipeline(ctx->commandBuffers[ctx->currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+
+    // Push model matrix
+    pushDrawConstants(ctx, ctx->commandBuffers[ctx->currentFrame], transform);
+
+    // Bind vertex buffer at current offset
+    VkBuffer buffers[] = {ctx->dynamicVertexBuffer.get()};
+    VkDeviceSize offsets[] = {ctx->dynamicVertexBufferOffset};
+    vkCmdBindVertexBuffers(ctx->commandBuffers[ctx->currentFrame], 0, 1, buffers, offsets);
+
+    vkCmdDraw(ctx->commandBuffers[ctx->currentFrame], static_cast<uint32_t>(written / stride), 1, 0, 0);
+
+    // Advance offset for next draw call
+    ctx->dynamicVertexBufferOffset += written;
+}
+
+// Cleanup is now handled automatically by RAII - unique_ptr members are destroyed
+// in reverse declaration order when VulkanContext is deleted.
+
+extern "C" {
+
+JNIEXPORT jlong JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeInit(
+    JNIEnv* env, jobject obj, jobject surface) {
+
+    LOGI("Initializing Vulkan...");
+
+    // Use unique_ptr for RAII - if any step fails, ctx is automatically cleaned up
+    auto ctx = std::make_unique<VulkanContext>();
+
+    // Get native window from Android Surface
+    ctx->nativeWindow = UniqueNativeWindow(ANativeWindow_fromSurface(env, surface));
+    if (!ctx->nativeWindow) {
+        LOGE("Failed to get native window from surface");
+        return 0;  // ctx automatically cleaned up
+    }
+
+    ctx->width = ANativeWindow_getWidth(ctx->nativeWindow.get());
+    ctx->height = ANativeWindow_getHeight(ctx->nativeWindow.get());
+    LOGI("Surface size: %dx%d", ctx->width, ctx->height);
+
+    // Create Vulkan instance
+    if (!createInstance(ctx.get())) return 0;
+
+    // Create Android surface
+    if (!createSurface(ctx.get())) return 0;
+
+    // Pick physical device
+    if (!pickPhysicalDevice(ctx.get())) return 0;
+
+    // Create logical device
+    if (!createLogicalDevice(ctx.get())) return 0;
+
+    // Create swapchain
+    if (!createSwapchain(ctx.get())) return 0;
+
+    // Create image views
+    if (!createImageViews(ctx.get())) return 0;
 
     // Create render pass
     if (!createRenderPass(ctx.get())) return 0;
@@ -1476,6 +2935,9 @@ Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeInit(
     // Create dynamic vertex buffer
     if (!createDynamicVertexBuffer(ctx.get())) return 0;
 
+    // Create depth attachment (before the framebuffers that use it)
+    if (!createDepthResources(ctx.get())) return 0;
+
     // Create framebuffers
     if (!createFramebuffers(ctx.get())) return 0;
 
@@ -1488,6 +2950,15 @@ Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeInit(
     // Create sync objects
     if (!createSyncObjects(ctx.get())) return 0;
 
+    // Create timestamp queries for the frame budget
+    if (!createTimestampQueryPool(ctx.get())) return 0;
+
+    // Create pipeline statistics queries for overdraw telemetry
+    if (!createStatisticsQueryPool(ctx.get())) return 0;
+
+    // Create the meteor particle system (optional: needs compute on the graphics queue)
+    if (!createMeteorSystem(ctx.get())) return 0;
+
     ctx->initialized = true;
     LOGI("Vulkan initialization complete!");
 
@@ -1551,6 +3022,7 @@ Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeRender(
         LOGE("Failed to submit draw command buffer: %s (%d)", vkResultToString(result), result);
         return;
     }
+    ctx->submittedFrames++;
 
     // Present
     VkPresentInfoKHR presentInfo{};
@@ -1614,6 +3086,16 @@ Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeDestroy(
     }
 
     LOGI("Destroying Vulkan context...");
+
+    // Let asset loads finish: once the device is idle every frame wait is satisfied
+    if (ctx->device) {
+        vkDeviceWaitIdle(ctx->device.get());
+    }
+    while (ctx->assetLoads.inFlight() > 0) {
+        ctx->frameTimeline.advance(UINT64_MAX);
+        std::this_thread::yield();
+    }
+
     // RAII handles all cleanup - just delete the context
     // The DeviceDeleter calls vkDeviceWaitIdle before destroying
     delete ctx;
@@ -1663,40 +3145,239 @@ Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeSetProjectionMatrix(
     env->ReleaseFloatArrayElements(matrixArray, matrix, JNI_ABORT);
 }
 
-// Set background opacity (0.0 = transparent, 1.0 = opaque dark)
+// Replace the star color LUT (STAR_PALETTE_SIZE RGBA entries); star vertices are untouched
 JNIEXPORT void JNICALL
-Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeSetBackgroundOpacity(
-    JNIEnv* env, jobject obj, jlong contextHandle, jfloat opacity) {
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeSetStarPalette(
+    JNIEnv* env, jobject obj, jlong contextHandle, jfloatArray paletteArray) {
 
     auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
-    if (ctx == nullptr) {
+    if (ctx == nullptr || !ctx->initialized || ctx->uniformBufferMapped == nullptr) {
         return;
     }
 
-    ctx->backgroundOpacity = opacity;
+    jsize length = env->GetArrayLength(paletteArray);
+    jsize count = std::min<jsize>(length, STAR_PALETTE_SIZE * 4);
+    env->GetFloatArrayRegion(paletteArray, 0, count,
+                             reinterpret_cast<jfloat*>(static_cast<char*>(ctx->uniformBufferMapped) + UNIFORM_PALETTE_OFFSET));
 }
 
-// Get current swapchain dimensions (for aspect ratio calculation)
-JNIEXPORT jintArray JNICALL
-Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeGetSwapchainDimensions(
-    JNIEnv* env, jobject obj, jlong contextHandle) {
+// Rebuild the horizon clip from the observer's horizon if its version moved
+// since the uniforms were written, or if clipping or the skyline changed
+// (those reset horizonObserverVersion)
+static void syncHorizonClip(VulkanContext* ctx) {
+    if (ctx->uniformBufferMapped == nullptr) {
+        return;
+    }
+    const bool clip = ctx->horizonClip && ctx->observer.valid();
+    const uint64_t version = clip ? ctx->observer.horizon().version : 0;
+    if (version == ctx->horizonObserverVersion && !ctx->terrainUniformsDirty) {
+        return;
+    }
+    ctx->horizonObserverVersion = version;
+
+    if (clip) {
+        const observer::Frame& frame = ctx->observer.frame();
+        const float zenith[3] = {static_cast<float>(frame.zenith[0]), static_cast<float>(frame.zenith[1]),
+                                 static_cast<float>(frame.zenith[2])};
+        const float north[3] = {static_cast<float>(frame.north[0]), static_cast<float>(frame.north[1]),
+                                static_cast<float>(frame.north[2])};
+        ctx->horizonFrame = horizon::Frame::fromZenithNorth(zenith, north);
+        std::copy(ctx->horizonFrame.zenith, ctx->horizonFrame.zenith + 3, ctx->horizonPlane);
+        // The plane sits at the visible horizon (dip and refraction), or rises to
+        // the lowest point of the skyline, since nothing under it can show
+        const float lowest = ctx->terrainProfileSet ? ctx->terrainProfile.minSinAltitude() : 0.0f;
+        ctx->horizonPlane[3] = HORIZON_MARGIN + ctx->observer.horizon().plane[3] - lowest;
+    } else {
+        std::copy(HORIZON_DISABLED, HORIZON_DISABLED + 4, ctx->horizonPlane);
+    }
+    writeHorizonUniforms(ctx);
+}
+
+// Hide everything below the horizon (and the terrain skyline, if one was
+// set) of the observer given to nativeSetObserver, or show the whole sky
+// again. Lines and triangles are clipped on the GPU when the device allows
+// it; stars and deep-sky objects are culled in their shaders, and sky store
+// cells below the horizon are skipped before any vertex is written. Cheap to
+// call every frame: the uniforms follow the observer's horizon version
+JNIEXPORT void JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_00024Critical_nativeSetHorizonClip(
+    jlong contextHandle, jboolean enabled) {
 
     auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
-    jintArray result = env->NewIntArray(2);
-    if (result == nullptr || ctx == nullptr || !ctx->initialized) {
-        jint dims[2] = {0, 0};
-        if (result != nullptr) {
-            env->SetIntArrayRegion(result, 0, 2, dims);
-        }
-        return result;
+    if (ctx == nullptr || !ctx->initialized || ctx->uniformBufferMapped == nullptr) {
+        return;
     }
 
-    jint dims[2] = {
-        static_cast<jint>(ctx->swapchainExtent.width),
-        static_cast<jint>(ctx->swapchainExtent.height)
-    };
-    env->SetIntArrayRegion(result, 0, 2, dims);
-    return result;
+    const bool clip = enabled == JNI_TRUE;
+    if (clip != ctx->horizonClip) {
+        ctx->horizonClip = clip;
+        ctx->terrainUniformsDirty = true;
+    }
+    syncHorizonClip(ctx);
+}
+
+// Move the observer (geodetic degrees, meters above the ellipsoid) and its
+// clock (Unix milliseconds). Only what moved past observer::Thresholds is
+// recomputed, and the horizon clip is redone only when its version changes
+JNIEXPORT void JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_00024Critical_nativeSetObserver(
+    jlong contextHandle, jdouble latitudeDeg, jdouble longitudeDeg, jdouble altitudeM, jlong unixMillis) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr || !ctx->initialized || ctx->uniformBufferMapped == nullptr) {
+        return;
+    }
+
+    observer::Location location;
+    location.latitudeDeg = latitudeDeg;
+    location.longitudeDeg = longitudeDeg;
+    location.altitudeM = altitudeM;
+    if (ctx->observer.update(location, static_cast<double>(unixMillis) / 1000.0)) {
+        syncHorizonClip(ctx);
+    }
+}
+
+// Version of the observer state from nativeSetObserver, 0 until it is set.
+// Kotlin reads the whole state (nativeGetObserverFrame) only when this changes
+JNIEXPORT jlong JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_00024Critical_nativeGetObserverVersion(
+    jlong contextHandle) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr || !ctx->initialized || !ctx->observer.valid()) {
+        return 0;
+    }
+    return static_cast<jlong>(ctx->observer.version());
+}
+
+// Copy the observer state into values (OBSERVER_FRAME_COMPONENTS doubles):
+// zenith, north and east, local sidereal time (radians), longitude (degrees),
+// the site's Earth-fixed position (meters) and the visible horizon plane
+// Returns the version copied, or 0 if the observer is unset or values too short
+JNIEXPORT jlong JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeGetObserverFrame(
+    JNIEnv* env, jobject obj, jlong contextHandle, jdoubleArray valuesArray) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr || !ctx->initialized || !ctx->observer.valid() ||
+        env->GetArrayLength(valuesArray) < OBSERVER_FRAME_COMPONENTS) {
+        return 0;
+    }
+
+    const observer::Frame& frame = ctx->observer.frame();
+    const observer::Site& site = ctx->observer.site();
+    const observer::Horizon& horizon = ctx->observer.horizon();
+    double values[OBSERVER_FRAME_COMPONENTS];
+    for (int i = 0; i < 3; i++) {
+        values[i] = frame.zenith[i];
+        values[3 + i] = frame.north[i];
+        values[6 + i] = frame.east[i];
+        values[11 + i] = site.ecef[i];
+    }
+    values[9] = frame.localSiderealRad;
+    values[10] = site.location.longitudeDeg;
+    for (int i = 0; i < 4; i++) values[14 + i] = horizon.plane[i];
+
+    env->SetDoubleArrayRegion(valuesArray, 0, OBSERVER_FRAME_COMPONENTS, values);
+    return static_cast<jlong>(ctx->observer.version());
+}
+
+// Turn star twinkling on or off. Stars twinkle more towards the horizon of
+// the observer given to nativeSetObserver, and stay steady until there is
+// one. star.vert animates them from the per-frame clock, so nothing is
+// re-uploaded
+JNIEXPORT void JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_00024Critical_nativeSetScintillation(
+    jlong contextHandle, jboolean enabled) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr || !ctx->initialized) {
+        return;
+    }
+
+    ctx->scintillation = enabled == JNI_TRUE;
+}
+
+// Replace the site's terrain skyline: altitude (degrees) at each azimuth
+// (degrees from north through east), interpolated between points. Empty arrays
+// restore the flat horizon. Takes effect at once while clipping
+// Returns false if the arrays differ in length or hold invalid altitudes
+JNIEXPORT jboolean JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeSetHorizonProfile(
+    JNIEnv* env, jobject obj, jlong contextHandle, jfloatArray azimuthArray, jfloatArray altitudeArray) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr || !ctx->initialized) {
+        return JNI_FALSE;
+    }
+
+    const jsize count = env->GetArrayLength(azimuthArray);
+    if (count != env->GetArrayLength(altitudeArray)) {
+        LOGE("Horizon profile: %d azimuths but %d altitudes", count, env->GetArrayLength(altitudeArray));
+        return JNI_FALSE;
+    }
+
+    if (count == 0) {
+        ctx->terrainProfile = horizon::Profile();
+        ctx->terrainProfileSet = false;
+        ctx->terrainUniformsDirty = true;
+        syncHorizonClip(ctx);
+        return JNI_TRUE;
+    }
+
+    std::vector<jfloat> azimuths(count), altitudes(count);
+    env->GetFloatArrayRegion(azimuthArray, 0, count, azimuths.data());
+    env->GetFloatArrayRegion(altitudeArray, 0, count, altitudes.data());
+    std::vector<horizon::Sample> samples(count);
+    for (jsize i = 0; i < count; i++) {
+        samples[i] = {azimuths[i], altitudes[i]};
+    }
+
+    if (!ctx->terrainProfile.build(std::move(samples))) {
+        LOGE("Horizon profile rejected: altitudes must be within [-90, 90] degrees");
+        return JNI_FALSE;
+    }
+    ctx->terrainProfileSet = true;
+    ctx->terrainUniformsDirty = true;
+    syncHorizonClip(ctx);
+    LOGI("Horizon profile set from %d points", count);
+    return JNI_TRUE;
+}
+
+// Set background opacity (0.0 = transparent, 1.0 = opaque dark)
+JNIEXPORT void JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_00024Critical_nativeSetBackgroundOpacity(
+    jlong contextHandle, jfloat opacity) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr) {
+        return;
+    }
+
+    ctx->backgroundOpacity = opacity;
+}
+
+// Get current swapchain dimensions (for aspect ratio calculation)
+JNIEXPORT jintArray JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeGetSwapchainDimensions(
+    JNIEnv* env, jobject obj, jlong contextHandle) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    jintArray result = env->NewIntArray(2);
+    if (result == nullptr || ctx == nullptr || !ctx->initialized) {
+        jint dims[2] = {0, 0};
+        if (result != nullptr) {
+            env->SetIntArrayRegion(result, 0, 2, dims);
+        }
+        return result;
+    }
+
+    jint dims[2] = {
+        static_cast<jint>(ctx->swapchainExtent.width),
+        static_cast<jint>(ctx->swapchainExtent.height)
+    };
+    env->SetIntArrayRegion(result, 0, 2, dims);
+    return result;
 }
 
 // New Phase 2 API: Begin frame
@@ -1709,6 +3390,10 @@ Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeBeginFrame(
         return JNI_FALSE;
     }
 
+    if (!ctx->thermalController) {
+        startThermalPacing(ctx);
+    }
+
     // Check for pending resize from main thread (orientation change)
     if (ctx->resizePending.load()) {
         std::lock_guard<std::mutex> lock(ctx->swapchainMutex);
@@ -1727,6 +3412,16 @@ Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeBeginFrame(
     VkFence inFlightFence = ctx->inFlightFences[ctx->currentFrame].get();
     vkWaitForFences(ctx->device.get(), 1, &inFlightFence, VK_TRUE, UINT64_MAX);
 
+    // The slot's previous frame has finished: its timings are complete and its
+    // transient allocations can be reused
+    collectFrameTiming(ctx);
+    ctx->frameArenas.retire(ctx->currentFrame);
+
+    // Every frame but the newest MAX_FRAMES_IN_FLIGHT - 1 has now completed;
+    // finished asset loads are handed over here, before recording starts
+    const uint64_t inFlight = MAX_FRAMES_IN_FLIGHT - 1;
+    ctx->frameTimeline.advance(ctx->submittedFrames > inFlight ? ctx->submittedFrames - inFlight : 0);
+
     // Acquire next swapchain image
     VkResult result = vkAcquireNextImageKHR(ctx->device.get(), ctx->swapchain.get(), UINT64_MAX,
                                             ctx->imageAvailableSemaphores[ctx->currentFrame].get(),
@@ -1755,6 +3450,14 @@ Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeBeginFrame(
         return JNI_FALSE;
     }
 
+    beginFrameTiming(ctx, ctx->commandBuffers[ctx->currentFrame]);
+
+    writeScintillationUniforms(ctx);
+
+    // Compute and transfer work goes before the render pass
+    simulateMeteors(ctx, ctx->commandBuffers[ctx->currentFrame]);
+    uploadOrbits(ctx, ctx->commandBuffers[ctx->currentFrame]);
+
     // Begin render pass
     VkRenderPassBeginInfo renderPassInfo{};
     renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
@@ -1764,9 +3467,12 @@ Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeBeginFrame(
     renderPassInfo.renderArea.extent = ctx->swapchainExtent;
 
     // Clear with configurable opacity (0 = transparent for AR, 1 = dark background)
-    VkClearValue clearColor = {{{0.0f, 0.0f, 0.05f * ctx->backgroundOpacity, ctx->backgroundOpacity}}};
-    renderPassInfo.clearValueCount = 1;
-    renderPassInfo.pClearValues = &clearColor;
+    // Depth clears to the far plane, behind every depth order
+    VkClearValue clearValues[2] = {};
+    clearValues[0].color = {{0.0f, 0.0f, 0.05f * ctx->backgroundOpacity, ctx->backgroundOpacity}};
+    clearValues[1].depthStencil = {1.0f, 0};
+    renderPassInfo.clearValueCount = ctx->depthImageView ? 2 : 1;
+    renderPassInfo.pClearValues = clearValues;
 
     vkCmdBeginRenderPass(ctx->commandBuffers[ctx->currentFrame], &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
 
@@ -1793,90 +3499,878 @@ Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeBeginFrame(
 
     // Reset dynamic vertex buffer offset for new frame
     ctx->dynamicVertexBufferOffset = 0;
+    ctx->drawDepth = depthForOrder(0);
     ctx->inFrame = true;
 
+    // Test the caps of every registered batch against this frame's view
+    ctx->culling.cull(ctx->viewMatrix, ctx->projectionMatrix, ctx->clipDistanceEnabled ? ctx->horizonPlane : nullptr);
+
     return JNI_TRUE;
 }
 
-// New Phase 2 API: Draw batch
+// Draw a batch built this frame. It is split into chunks bounded by caps on
+// the fly, and only the chunks in view (and above the ground) are copied
+// and drawn; the savings count towards the layer last marked
 JNIEXPORT void JNICALL
 Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeDraw(
     JNIEnv* env, jobject obj, jlong contextHandle,
     jint primitiveType, jfloatArray verticesArray, jint vertexCount, jfloatArray transformArray) {
 
     auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
-    if (ctx == nullptr || !ctx->initialized || !ctx->inFrame) {
+    if (ctx == nullptr || !ctx->initialized || !ctx->inFrame || vertexCount <= 0) {
         return;
     }
 
+    // Get transform matrix (or use identity)
+    float transform[16];
+    if (transformArray != nullptr) {
+        jfloat* transformData = env->GetFloatArrayElements(transformArray, nullptr);
+        if (transformData != nullptr) {
+            memcpy(transform, transformData, sizeof(float) * 16);
+            env->ReleaseFloatArrayElements(transformArray, transformData, JNI_ABORT);
+        } else {
+            math::identity(transform);
+        }
+    } else {
+        math::identity(transform);
+    }
+
     // Get vertex data
     jfloat* vertices = env->GetFloatArrayElements(verticesArray, nullptr);
     if (vertices == nullptr) {
         return;
     }
 
-    // Calculate size needed (7 floats per vertex)
-    size_t vertexDataSize = vertexCount * 7 * sizeof(float);
+    const cull::Frustum frustum = cull::Frustum::from(ctx->viewMatrix, ctx->projectionMatrix, transform,
+                                                      cullingHorizon(ctx, primitiveType));
+    const uint32_t count = static_cast<uint32_t>(vertexCount);
+    uint32_t drawn = 0;
+    drawRuns(ctx, primitiveType, vertices, transform, [&](auto emit) {
+        drawn = cull::cullVertices(frustum, vertices, count, floatsPerVertex(primitiveType),
+                                   verticesPerPrimitive(primitiveType), emit);
+    });
+    ctx->culling.account(ctx->frameTimings[ctx->currentFrame].openLayer, count, drawn);
 
-    // Check if we have room in the dynamic buffer
-    if (ctx->dynamicVertexBufferOffset + vertexDataSize > ctx->dynamicVertexBufferSize) {
-        LOGE("Dynamic vertex buffer overflow! Need %zu bytes, have %zu",
-             ctx->dynamicVertexBufferOffset + vertexDataSize, ctx->dynamicVertexBufferSize);
-        env->ReleaseFloatArrayElements(verticesArray, vertices, JNI_ABORT);
-        return;
+    env->ReleaseFloatArrayElements(verticesArray, vertices, JNI_ABORT);
+}
+
+// Register a batch whose vertices stay the same across frames (grid,
+// ecliptic, constellation lines) for culling: its vertices are kept
+// natively, split into chunks with bounding caps that beginFrame tests
+// together. Returns the batch id for nativeDrawRegistered, or -1
+JNIEXPORT jint JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeRegisterBatch(
+    JNIEnv* env, jobject obj, jlong contextHandle, jint layer,
+    jint primitiveType, jfloatArray verticesArray, jint vertexCount, jfloatArray transformArray) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr || !ctx->initialized || vertexCount < 0 ||
+        static_cast<size_t>(vertexCount) * floatsPerVertex(primitiveType) >
+            static_cast<size_t>(env->GetArrayLength(verticesArray))) {
+        return -1;
     }
 
-    // Copy vertex data to dynamic buffer
-    memcpy(static_cast<char*>(ctx->dynamicVertexBufferMapped) + ctx->dynamicVertexBufferOffset,
-           vertices, vertexDataSize);
+    float transform[16];
+    math::identity(transform);
+    if (transformArray != nullptr && env->GetArrayLength(transformArray) >= 16) {
+        env->GetFloatArrayRegion(transformArray, 0, 16, transform);
+    }
 
+    jfloat* vertices = env->GetFloatArrayElements(verticesArray, nullptr);
+    if (vertices == nullptr) {
+        return -1;
+    }
+    const int id = ctx->culling.add(layer, vertices, static_cast<uint32_t>(vertexCount), floatsPerVertex(primitiveType),
+                                    verticesPerPrimitive(primitiveType), transform);
     env->ReleaseFloatArrayElements(verticesArray, vertices, JNI_ABORT);
+    return id;
+}
+
+// Draw the chunks of a registered batch that this frame's cull found in view
+JNIEXPORT void JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_00024Critical_nativeDrawRegistered(
+    jlong contextHandle, jint id, jint primitiveType) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr || !ctx->initialized || !ctx->inFrame) {
+        return;
+    }
+    if (ctx->culling.floatsPerVertex(id) != floatsPerVertex(primitiveType)) {
+        LOGE("Batch %d was not registered with primitive type %d", id, primitiveType);
+        return;
+    }
+
+    drawRuns(ctx, primitiveType, ctx->culling.vertices(id), ctx->culling.model(id), [&](auto emit) {
+        ctx->culling.forEachVisible(id, emit);
+    });
+}
+
+// Forget a registered batch
+JNIEXPORT void JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_00024Critical_nativeUnregisterBatch(
+    jlong contextHandle, jint id) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx != nullptr) {
+        ctx->culling.remove(id);
+    }
+}
+
+// Culling counts of the last complete frame: per layer ordinal, vertices submitted
+// by its batches then vertices drawn after culling
+JNIEXPORT jintArray JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeGetCullStats(
+    JNIEnv* env, jobject obj, jlong contextHandle) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr) {
+        return env->NewIntArray(0);
+    }
+
+    jint values[2 * cull::MAX_LAYERS];
+    const cull::LayerStats* stats = ctx->culling.frameStats();
+    for (int i = 0; i < cull::MAX_LAYERS; i++) {
+        values[2 * i] = static_cast<jint>(stats[i].vertices);
+        values[2 * i + 1] = static_cast<jint>(stats[i].drawn);
+    }
+    jintArray result = env->NewIntArray(2 * cull::MAX_LAYERS);
+    if (result != nullptr) {
+        env->SetIntArrayRegion(result, 0, 2 * cull::MAX_LAYERS, values);
+    }
+    return result;
+}
+
+// Start loading lightmap.binary in the background; the map appears at the
+// start of a later frame. Returns false if the asset does not exist.
+JNIEXPORT jboolean JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeLoadLightMapAsync(
+    JNIEnv* env, jobject obj, jlong contextHandle, jobject assetManager,
+    jint preferredOrder, jfloat gain) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr || !ctx->initialized || assetManager == nullptr) {
+        return JNI_FALSE;
+    }
+
+    AAssetManager* manager = AAssetManager_fromJava(env, assetManager);
+    AAsset* asset = manager != nullptr ? AAssetManager_open(manager, "lightmap.binary", AASSET_MODE_STREAMING) : nullptr;
+    if (asset == nullptr) {
+        LOGI("No light map asset, faint star glow disabled");
+        return JNI_FALSE;
+    }
+
+    loadLightMapAsync(ctx, asset, preferredOrder, gain);
+    return JNI_TRUE;
+}
+
+// Faint limit of the stars drawn as points; the light map covering the stars
+// below it is reselected (and rebuilt in the background) when it changes
+JNIEXPORT void JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_00024Critical_nativeSetStarLimitingMagnitude(
+    jlong contextHandle, jfloat magnitude) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr || !ctx->initialized || !std::isfinite(magnitude) || magnitude == ctx->lightMapLimit) {
+        return;
+    }
+    ctx->lightMapLimit = magnitude;
+    selectLightMap(ctx);
+}
+
+// Draw the light map background; call right after beginFrame so stars draw on top
+JNIEXPORT void JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_00024Critical_nativeDrawLightMap(
+    jlong contextHandle) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr || !ctx->initialized || !ctx->inFrame || ctx->lightMapVertexCount == 0) {
+        return;
+    }
+
+    VkCommandBuffer commandBuffer = ctx->commandBuffers[ctx->currentFrame];
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, ctx->lightMapPipeline.get());
 
-    // Get transform matrix (or use identity)
     float transform[16];
-    if (transformArray != nullptr) {
-        jfloat* transformData = env->GetFloatArrayElements(transformArray, nullptr);
-        if (transformData != nullptr) {
-            memcpy(transform, transformData, sizeof(float) * 16);
-            env->ReleaseFloatArrayElements(transformArray, transformData, JNI_ABORT);
-        } else {
-            math::identity(transform);
+    math::identity(transform);
+    pushDrawConstants(ctx, commandBuffer, transform);
+
+    VkBuffer buffers[] = {ctx->lightMapBuffer.get()};
+    VkDeviceSize offsets[] = {0};
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, buffers, offsets);
+    vkCmdDraw(commandBuffer, ctx->lightMapVertexCount, 1, 0, 0);
+}
+
+// Build and upload deep-sky object instances
+// geometry: 5 floats per object (RA deg, Dec deg, major arcmin, minor arcmin, position angle deg)
+// styles: 2 ints per object (source.proto Shape, ARGB color)
+JNIEXPORT jboolean JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeSetDeepSkyObjects(
+    JNIEnv* env, jobject obj, jlong contextHandle, jfloatArray geometryArray, jintArray stylesArray, jint count) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr || !ctx->initialized || ctx->inFrame || count < 0) {
+        return JNI_FALSE;
+    }
+
+    if (env->GetArrayLength(geometryArray) < count * 5 || env->GetArrayLength(stylesArray) < count * 2) {
+        LOGE("Deep-sky object arrays too short for %d objects", count);
+        return JNI_FALSE;
+    }
+
+    jfloat* geometry = env->GetFloatArrayElements(geometryArray, nullptr);
+    jint* styles = env->GetIntArrayElements(stylesArray, nullptr);
+    if (geometry == nullptr || styles == nullptr) {
+        if (geometry != nullptr) env->ReleaseFloatArrayElements(geometryArray, geometry, JNI_ABORT);
+        if (styles != nullptr) env->ReleaseIntArrayElements(stylesArray, styles, JNI_ABORT);
+        return JNI_FALSE;
+    }
+
+    std::vector<dso::Instance> instances;
+    instances.reserve(static_cast<size_t>(count));
+    for (jint i = 0; i < count; i++) {
+        const jfloat* g = geometry + i * 5;
+        const jint* st = styles + i * 2;
+        instances.push_back(dso::makeInstance(g[0], g[1], g[2], g[3], g[4],
+                                              static_cast<uint32_t>(st[0]), static_cast<uint32_t>(st[1])));
+    }
+
+    env->ReleaseFloatArrayElements(geometryArray, geometry, JNI_ABORT);
+    env->ReleaseIntArrayElements(stylesArray, styles, JNI_ABORT);
+
+    return uploadDeepSkyObjects(ctx, instances) ? JNI_TRUE : JNI_FALSE;
+}
+
+// Draw every uploaded deep-sky object in one instanced draw
+// Objects behind the camera or off screen are culled in dso.vert
+JNIEXPORT void JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_00024Critical_nativeDrawDeepSkyObjects(
+    jlong contextHandle, jfloat minRadiusPixels) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr || !ctx->initialized || !ctx->inFrame || ctx->dsoInstanceCount == 0) {
+        return;
+    }
+
+    VkCommandBuffer commandBuffer = ctx->commandBuffers[ctx->currentFrame];
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, ctx->dsoPipeline.get());
+
+    float transform[16];
+    math::identity(transform);
+    pushDrawConstants(ctx, commandBuffer, transform, minRadiusPixels);
+
+    VkBuffer buffers[] = {ctx->dsoInstanceBuffer.get()};
+    VkDeviceSize offsets[] = {0};
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, buffers, offsets);
+    vkCmdDraw(commandBuffer, 4, ctx->dsoInstanceCount, 0, 0);
+}
+
+// Draw the Sun, Moon and planets as sphere impostors, one quad each, packed
+// into the dynamic vertex buffer (positions change every frame)
+// geometry: 6 floats per body (x, y, z unit direction, distance AU, radius km, limb darkening)
+// styles: 2 ints per body (ARGB color, bodies:: flags)
+// sun: x, y, z unit direction and distance (AU) of the Sun, for phases
+// Returns the number of bodies drawn
+JNIEXPORT jint JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeDrawBodies(
+    JNIEnv* env, jobject obj, jlong contextHandle, jfloatArray geometryArray, jintArray stylesArray, jint count,
+    jfloatArray sunArray, jfloat minRadiusPixels) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr || !ctx->initialized || !ctx->inFrame || count <= 0) {
+        return 0;
+    }
+
+    if (env->GetArrayLength(geometryArray) < count * 6 || env->GetArrayLength(stylesArray) < count * 2 ||
+        env->GetArrayLength(sunArray) < 4) {
+        LOGE("Body arrays too short for %d bodies", count);
+        return 0;
+    }
+
+    const size_t stride = vertexStride(VertexLayout::BodyInstance);
+    if (ctx->dynamicVertexBufferOffset + count * stride > ctx->dynamicVertexBufferSize) {
+        LOGW("Dynamic vertex buffer full, skipping %d bodies", count);
+        return 0;
+    }
+
+    jfloat sun[4];
+    env->GetFloatArrayRegion(sunArray, 0, 4, sun);
+    std::pmr::vector<jfloat> geometry(static_cast<size_t>(count) * 6, &ctx->frameArenas[ctx->currentFrame]);
+    std::pmr::vector<jint> styles(static_cast<size_t>(count) * 2, &ctx->frameArenas[ctx->currentFrame]);
+    env->GetFloatArrayRegion(geometryArray, 0, count * 6, geometry.data());
+    env->GetIntArrayRegion(stylesArray, 0, count * 2, styles.data());
+
+    // With depth, nearest first: a nearer body hides the ones behind it and
+    // their hidden fragments fail early-Z. Blending alone needs farthest first.
+    std::pmr::vector<uint32_t> order(static_cast<size_t>(count), &ctx->frameArenas[ctx->currentFrame]);
+    for (jint i = 0; i < count; i++) order[i] = static_cast<uint32_t>(i);
+    const bool nearestFirst = static_cast<bool>(ctx->depthImageView);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        const float da = geometry[a * 6 + 3], db = geometry[b * 6 + 3];
+        return nearestFirst ? da < db : da > db;
+    });
+
+    auto* instances = reinterpret_cast<bodies::Instance*>(
+        static_cast<char*>(ctx->dynamicVertexBufferMapped) + ctx->dynamicVertexBufferOffset);
+    for (jint i = 0; i < count; i++) {
+        const jfloat* g = geometry.data() + order[i] * 6;
+        const jint* st = styles.data() + order[i] * 2;
+        instances[i] = bodies::makeInstance(g, g[3], g[4], sun, sun[3], g[5],
+                                            static_cast<uint32_t>(st[0]), static_cast<uint32_t>(st[1]));
+    }
+
+    VkCommandBuffer commandBuffer = ctx->commandBuffers[ctx->currentFrame];
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, ctx->bodyPipeline.get());
+
+    float transform[16];
+    math::identity(transform);
+    pushDrawConstants(ctx, commandBuffer, transform, minRadiusPixels);
+
+    VkBuffer buffers[] = {ctx->dynamicVertexBuffer.get()};
+    VkDeviceSize offsets[] = {ctx->dynamicVertexBufferOffset};
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, buffers, offsets);
+    vkCmdDraw(commandBuffer, 4, static_cast<uint32_t>(count), 0, 0);
+
+    ctx->dynamicVertexBufferOffset += count * stride;
+    return count;
+}
+
+// Replace the tracked orbits (render thread); unchanged orbits keep their tracks
+// ids: 1 int per orbit, a stable key
+// elements: 7 doubles per orbit (pericenter distance AU, eccentricity, inclination,
+//           argument of pericenter and ascending node in degrees, pericenter JD, center)
+// colors: 1 ARGB int per orbit
+// Returns the number of orbits tracked
+JNIEXPORT jint JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeSetOrbits(
+    JNIEnv* env, jobject obj, jlong contextHandle, jintArray idsArray, jdoubleArray elementsArray,
+    jintArray colorsArray, jint count) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr || !ctx->initialized || count < 0) {
+        return 0;
+    }
+
+    if (env->GetArrayLength(idsArray) < count || env->GetArrayLength(elementsArray) < count * 7 ||
+        env->GetArrayLength(colorsArray) < count) {
+        LOGE("Orbit arrays too short for %d orbits", count);
+        return 0;
+    }
+
+    std::vector<jint> ids(count), colors(count);
+    std::vector<jdouble> elements(static_cast<size_t>(count) * 7);
+    env->GetIntArrayRegion(idsArray, 0, count, ids.data());
+    env->GetIntArrayRegion(colorsArray, 0, count, colors.data());
+    env->GetDoubleArrayRegion(elementsArray, 0, count * 7, elements.data());
+
+    constexpr double deg = orbits::PI / 180.0;
+    std::vector<orbits::Track> tracks;
+    tracks.reserve(count);
+    for (jint i = 0; i < count; i++) {
+        const jdouble* el = elements.data() + i * 7;
+        if (!(el[0] > 0.0) || !(el[1] >= 0.0)) {
+            LOGW("Skipping orbit %d with invalid elements", ids[i]);
+            continue;
         }
-    } else {
-        math::identity(transform);
+        const auto center = el[6] == 1.0 ? orbits::Center::Earth : orbits::Center::Sun;
+        tracks.push_back({static_cast<uint32_t>(ids[i]),
+                          {el[0], el[1], el[2] * deg, el[3] * deg, el[4] * deg, el[5], center},
+                          static_cast<uint32_t>(colors[i])});
     }
+    ctx->orbitCache.set(tracks);
+    return static_cast<jint>(ctx->orbitCache.size());
+}
 
-    // Select pipeline based on primitive type
-    // PrimitiveType enum: POINTS=0, LINES=1, TRIANGLES=2
-    VkPipeline pipeline;
-    switch (primitiveType) {
-        case 0:  // POINTS
-            pipeline = ctx->pointPipeline.get();
-            break;
-        case 1:  // LINES
-            pipeline = ctx->linePipeline.get();
-            break;
-        case 2:  // TRIANGLES
-        default:
-            pipeline = ctx->trianglePipeline.get();
-            break;
+// Bring the orbit tracks up to date for a time window and on-screen error
+// (render thread, before nativeBeginFrame uploads them)
+// Returns the number of tracks re-sampled; 0 when the cached ones still fit
+JNIEXPORT jint JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeUpdateOrbits(
+    JNIEnv* env, jobject obj, jlong contextHandle, jdouble startJd, jdouble endJd, jdouble toleranceRadians) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr || !ctx->initialized) {
+        return 0;
     }
-    vkCmdBindPipeline(ctx->commandBuffers[ctx->currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+    return static_cast<jint>(ctx->orbitCache.update(startJd, endJd, toleranceRadians));
+}
 
-    // Push model matrix
-    vkCmdPushConstants(ctx->commandBuffers[ctx->currentFrame], ctx->pipelineLayout.get(),
-                      VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(transform), transform);
+// Draw every orbit track with one indexed line-list draw
+JNIEXPORT void JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_00024Critical_nativeDrawOrbits(
+    jlong contextHandle) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr || !ctx->initialized || !ctx->inFrame || ctx->orbitIndexCount == 0) {
+        return;
+    }
+
+    VkCommandBuffer commandBuffer = ctx->commandBuffers[ctx->currentFrame];
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, ctx->linePipeline.get());
+
+    float transform[16];
+    math::identity(transform);
+    pushDrawConstants(ctx, commandBuffer, transform);
+
+    VkBuffer buffers[] = {ctx->orbitBuffer.get()};
+    VkDeviceSize offsets[] = {0};
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, buffers, offsets);
+    vkCmdBindIndexBuffer(commandBuffer, ctx->orbitBuffer.get(), ctx->orbitIndexOffset, VK_INDEX_TYPE_UINT32);
+    vkCmdDrawIndexed(commandBuffer, ctx->orbitIndexCount, 1, 0, 0, 0);
+}
+
+// Set the active meteor showers (render thread; used from the next frame on)
+// radiants: 4 floats per shower (x, y, z unit direction of the radiant, zenithal hourly rate)
+// rateScale multiplies every rate (1 = real rates)
+JNIEXPORT void JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeSetMeteorRadiants(
+    JNIEnv* env, jobject obj, jlong contextHandle, jfloatArray radiantsArray, jint count, jfloat rateScale) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr || !ctx->initialized || count < 0) {
+        return;
+    }
+
+    if (env->GetArrayLength(radiantsArray) < count * 4) {
+        LOGE("Meteor radiant array too short for %d showers", count);
+        return;
+    }
+    if (count > static_cast<jint>(meteors::MAX_RADIANTS)) {
+        LOGW("Only the first %u of %d meteor showers are simulated", meteors::MAX_RADIANTS, count);
+        count = meteors::MAX_RADIANTS;
+    }
+
+    jfloat radiants[meteors::MAX_RADIANTS * 4];
+    env->GetFloatArrayRegion(radiantsArray, 0, count * 4, radiants);
+    for (jint i = 0; i < count; i++) {
+        const jfloat* r = radiants + i * 4;
+        ctx->meteorShowers[i] = {r[0], r[1], r[2], r[3]};
+    }
+    ctx->meteorShowerCount = static_cast<uint32_t>(count);
+    ctx->meteorRateScale = std::max(0.0f, static_cast<float>(rateScale));
+}
+
+// Draw the meteors stepped at the start of this frame (one indirect draw; the
+// instance count never comes back to the CPU)
+JNIEXPORT void JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_00024Critical_nativeDrawMeteors(
+    jlong contextHandle) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr || !ctx->initialized || !ctx->inFrame || !ctx->meteorStreaksReady) {
+        return;
+    }
+
+    VkCommandBuffer commandBuffer = ctx->commandBuffers[ctx->currentFrame];
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, ctx->meteorPipeline.get());
+
+    float transform[16];
+    math::identity(transform);
+    pushDrawConstants(ctx, commandBuffer, transform);
+
+    VkBuffer buffers[] = {ctx->meteorStreakBuffer.get()};
+    VkDeviceSize offsets[] = {0};
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, buffers, offsets);
+    vkCmdDrawIndirect(commandBuffer, ctx->meteorArgsBuffer.get(), 0, 1, sizeof(VkDrawIndirectCommand));
+}
+
+// Replace the sky object store (render thread, between frames)
+// geometry: 4 floats per object (x, y, z unit direction, magnitude)
+// attributes: 3 ints per object (color index | alpha << 8 | flags << 16, name id, layer)
+JNIEXPORT jboolean JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeSetSkyObjects(
+    JNIEnv* env, jobject obj, jlong contextHandle, jfloatArray geometryArray, jintArray attributesArray, jint count) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr || !ctx->initialized || ctx->inFrame || count < 0) {
+        return JNI_FALSE;
+    }
+
+    if (env->GetArrayLength(geometryArray) < count * 4 || env->GetArrayLength(attributesArray) < count * 3) {
+        LOGE("Sky object arrays too short for %d objects", count);
+        return JNI_FALSE;
+    }
+
+    jfloat* geometry = env->GetFloatArrayElements(geometryArray, nullptr);
+    jint* attributes = env->GetIntArrayElements(attributesArray, nullptr);
+    if (geometry == nullptr || attributes == nullptr) {
+        if (geometry != nullptr) env->ReleaseFloatArrayElements(geometryArray, geometry, JNI_ABORT);
+        if (attributes != nullptr) env->ReleaseIntArrayElements(attributesArray, attributes, JNI_ABORT);
+        return JNI_FALSE;
+    }
+
+    std::vector<sky::Object> objects(static_cast<size_t>(count));
+    for (jint i = 0; i < count; i++) {
+        const jfloat* g = geometry + i * 4;
+        const uint32_t style = static_cast<uint32_t>(attributes[i * 3]);
+        objects[i] = {g[0], g[1], g[2], g[3],
+                      static_cast<uint8_t>(style & 0xff), static_cast<uint8_t>((style >> 8) & 0xff),
+                      static_cast<uint16_t>(style >> 16), attributes[i * 3 + 1],
+                      static_cast<uint8_t>(attributes[i * 3 + 2] & 31)};
+    }
+
+    env->ReleaseFloatArrayElements(geometryArray, geometry, JNI_ABORT);
+    env->ReleaseIntArrayElements(attributesArray, attributes, JNI_ABORT);
+
+    ctx->skyStore.build(objects);
+    LOGI("Sky store built: %zu objects in %zu cells (order %d)",
+         ctx->skyStore.size(), ctx->skyStore.cellCount(), ctx->skyStore.cellOrder());
+    if (ctx->variableStars.size() > 0) {
+        // Rows moved: bind the same curves to the new store
+        ctx->variableStars.build(ctx->variableStars.curves(), ctx->skyStore);
+    }
+    return JNI_TRUE;
+}
+
+// Replace the light curves of variable objects in the sky store (render thread, between frames)
+// ids: 2 ints per curve (index in the sky objects array, variability::Kind)
+// elements: 5 doubles per curve (epoch JD, period days, max magnitude, amplitude, shape)
+// Returns the number of curves bound to stored objects
+JNIEXPORT jint JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeSetLightCurves(
+    JNIEnv* env, jobject obj, jlong contextHandle, jintArray idsArray, jdoubleArray elementsArray, jint count) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr || !ctx->initialized || ctx->inFrame || count < 0) {
+        return 0;
+    }
+
+    if (env->GetArrayLength(idsArray) < count * 2 || env->GetArrayLength(elementsArray) < count * 5) {
+        LOGE("Light curve arrays too short for %d curves", count);
+        return 0;
+    }
+
+    jint* ids = env->GetIntArrayElements(idsArray, nullptr);
+    jdouble* elements = env->GetDoubleArrayElements(elementsArray, nullptr);
+    if (ids == nullptr || elements == nullptr) {
+        if (ids != nullptr) env->ReleaseIntArrayElements(idsArray, ids, JNI_ABORT);
+        if (elements != nullptr) env->ReleaseDoubleArrayElements(elementsArray, elements, JNI_ABORT);
+        return 0;
+    }
+
+    std::vector<variability::Curve> curves;
+    curves.reserve(static_cast<size_t>(count));
+    for (jint i = 0; i < count; i++) {
+        const jint kind = ids[i * 2 + 1];
+        if (ids[i * 2] < 0 || kind < 0 || kind > static_cast<jint>(variability::Kind::Eruptive)) {
+            continue;
+        }
+        const jdouble* e = elements + i * 5;
+        curves.push_back({static_cast<uint32_t>(ids[i * 2]), static_cast<variability::Kind>(kind), e[0], e[1],
+                          static_cast<float>(e[2]), static_cast<float>(e[3]), static_cast<float>(e[4])});
+    }
+
+    env->ReleaseIntArrayElements(idsArray, ids, JNI_ABORT);
+    env->ReleaseDoubleArrayElements(elementsArray, elements, JNI_ABORT);
+
+    // Undo the previous curves' patches before taking alphas as peaks again
+    ctx->variableStars.restore(ctx->skyStore);
+    const size_t bound = ctx->variableStars.build(std::move(curves), ctx->skyStore);
+    LOGI("Light curves: %zu of %d bound to sky objects", bound, count);
+    return static_cast<jint>(bound);
+}
+
+// Evaluate the light curves at a Julian date and write only the changed
+// alphas into the store; call in a frame, before drawing sky objects
+// Returns the number of objects updated
+JNIEXPORT jint JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeUpdateVariableStars(
+    JNIEnv* env, jobject obj, jlong contextHandle, jdouble julianDay) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr || !ctx->initialized || !ctx->inFrame || ctx->variableStars.size() == 0) {
+        return 0;
+    }
+
+    std::pmr::vector<variability::Update> updates(&ctx->frameArenas[ctx->currentFrame]);
+    ctx->variableStars.evaluate(julianDay, updates);
+    variability::apply(updates, ctx->skyStore);
+    return static_cast<jint>(updates.size());
+}
+
+// Draw the stars of one layer within fovDeg of the look direction, packing
+// vertices straight from the store into the dynamic vertex buffer
+// Returns the number of stars drawn
+JNIEXPORT jint JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeDrawSkyObjects(
+    JNIEnv* env, jobject obj, jlong contextHandle, jint layer,
+    jfloat lookX, jfloat lookY, jfloat lookZ, jfloat fovDeg, jfloat fraction) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr || !ctx->initialized || !ctx->inFrame || layer < 0 || layer >= 32 ||
+        ctx->skyStore.size() == 0) {
+        return 0;
+    }
+
+    sky::Filter filter;
+    filter.layerMask = 1u << layer;
+    filter.requiredFlags = sky::FLAG_STAR;
+    filter.fraction = fraction;
+    std::copy(ctx->horizonPlane, ctx->horizonPlane + 4, filter.horizon);
+    if (ctx->horizonClip && ctx->terrainProfileSet) {
+        filter.terrain = {&ctx->terrainProfile, ctx->horizonFrame};
+    }
+
+    const float dir[3] = {lookX, lookY, lookZ};
+    const float halfAngle = fovDeg * 0.5f * math::PI / 180.0f;
+    std::pmr::vector<uint32_t> rows(&ctx->frameArenas[ctx->currentFrame]);
+    ctx->skyStore.cull(dir, halfAngle, filter, rows);
+    if (rows.empty()) {
+        return 0;
+    }
+
+    // Clip to the space left in the dynamic buffer, keeping the first (brightest per cell) rows
+    const size_t stride = vertexStride(VertexLayout::PackedStar);
+    const size_t room = (ctx->dynamicVertexBufferSize - ctx->dynamicVertexBufferOffset) / stride;
+    if (rows.size() > room) {
+        LOGW("Dynamic vertex buffer full: drawing %zu of %zu sky objects", room, rows.size());
+        rows.resize(room);
+        if (rows.empty()) {
+            return 0;
+        }
+    }
+
+    // Positions relative to the tile under the view center keep their
+    // precision at eyepiece fields of view
+    double anchor[3];
+    sky::Store::anchorFor(dir, anchor);
+    ctx->skyStore.writeStarVertices(rows, reinterpret_cast<float*>(
+        static_cast<char*>(ctx->dynamicVertexBufferMapped) + ctx->dynamicVertexBufferOffset), anchor);
+
+    VkCommandBuffer commandBuffer = ctx->commandBuffers[ctx->currentFrame];
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, starPipelineFor(ctx));
+
+    float transform[16];
+    math::identity(transform);
+    pushDrawConstants(ctx, commandBuffer, transform, 0.0f, anchor);
 
-    // Bind vertex buffer at current offset
     VkBuffer buffers[] = {ctx->dynamicVertexBuffer.get()};
     VkDeviceSize offsets[] = {ctx->dynamicVertexBufferOffset};
-    vkCmdBindVertexBuffers(ctx->commandBuffers[ctx->currentFrame], 0, 1, buffers, offsets);
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, buffers, offsets);
+    vkCmdDraw(commandBuffer, static_cast<uint32_t>(rows.size()), 1, 0, 0);
+
+    ctx->dynamicVertexBufferOffset += rows.size() * stride;
+    return static_cast<jint>(rows.size());
+}
 
-    // Draw
-    vkCmdDraw(ctx->commandBuffers[ctx->currentFrame], vertexCount, 1, 0, 0);
+// Object nearest a direction within maxAngleDeg, as its index in the array
+// given to nativeSetSkyObjects; -1 if none
+JNIEXPORT jint JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_00024Critical_nativePickSkyObject(
+    jlong contextHandle, jfloat x, jfloat y, jfloat z, jfloat maxAngleDeg) {
 
-    // Advance offset for next draw call
-    ctx->dynamicVertexBufferOffset += vertexDataSize;
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr) {
+        return -1;
+    }
+
+    const float dir[3] = {x, y, z};
+    const int64_t row = ctx->skyStore.pick(dir, maxAngleDeg * math::PI / 180.0f);
+    return row >= 0 ? static_cast<jint>(ctx->skyStore.sourceIndex()[row]) : -1;
+}
+
+// Brightest object with a name id, as its index in the array given to
+// nativeSetSkyObjects; -1 if none
+JNIEXPORT jint JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_00024Critical_nativeFindSkyObject(
+    jlong contextHandle, jint nameId) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr) {
+        return -1;
+    }
+
+    const int64_t row = ctx->skyStore.findName(nameId);
+    return row >= 0 ? static_cast<jint>(ctx->skyStore.sourceIndex()[row]) : -1;
+}
+
+// Choose which labels to draw this frame (render thread: candidates use the frame arena)
+// boxes: 6 floats per candidate (x, y, width, height in pixels, magnitude, labels::Kind)
+// Returns the ids of accepted labels, highest priority first
+JNIEXPORT jintArray JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativePlaceLabels(
+    JNIEnv* env, jobject obj, jlong contextHandle, jintArray idsArray, jfloatArray boxesArray, jint count) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr || !ctx->initialized || count < 0 ||
+        env->GetArrayLength(idsArray) < count || env->GetArrayLength(boxesArray) < count * 6) {
+        return env->NewIntArray(0);
+    }
+
+    const int width = static_cast<int>(ctx->swapchainExtent.width);
+    const int height = static_cast<int>(ctx->swapchainExtent.height);
+    if (ctx->labelPlacer.width() != width || ctx->labelPlacer.height() != height) {
+        ctx->labelPlacer.resize(width, height);
+    }
+
+    jint* ids = env->GetIntArrayElements(idsArray, nullptr);
+    jfloat* boxes = env->GetFloatArrayElements(boxesArray, nullptr);
+    if (ids == nullptr || boxes == nullptr) {
+        if (ids != nullptr) env->ReleaseIntArrayElements(idsArray, ids, JNI_ABORT);
+        if (boxes != nullptr) env->ReleaseFloatArrayElements(boxesArray, boxes, JNI_ABORT);
+        return env->NewIntArray(0);
+    }
+
+    std::pmr::vector<labels::Candidate> candidates(static_cast<size_t>(count), &ctx->frameArenas[ctx->currentFrame]);
+    for (jint i = 0; i < count; i++) {
+        const jfloat* b = boxes + i * 6;
+        const auto kind = static_cast<labels::Kind>(static_cast<uint32_t>(b[5]));
+        candidates[i] = {static_cast<uint32_t>(ids[i]), b[0], b[1], b[2], b[3], labels::rankPriority(kind, b[4])};
+    }
+
+    env->ReleaseIntArrayElements(idsArray, ids, JNI_ABORT);
+    env->ReleaseFloatArrayElements(boxesArray, boxes, JNI_ABORT);
+
+    const float labelFraction = ctx->budgetGovernor.quality().labelFraction;
+    const size_t maxLabels = labelFraction < 1.0f ? static_cast<size_t>(LABEL_BUDGET * labelFraction) : SIZE_MAX;
+    const std::vector<uint32_t>& accepted = ctx->labelPlacer.place(candidates.data(), candidates.size(), maxLabels);
+
+    jintArray result = env->NewIntArray(static_cast<jsize>(accepted.size()));
+    if (result != nullptr && !accepted.empty()) {
+        env->SetIntArrayRegion(result, 0, static_cast<jsize>(accepted.size()),
+                               reinterpret_cast<const jint*>(accepted.data()));
+    }
+    return result;
+}
+
+// Start a layer: draws until the next mark use its depth order, and its CPU
+// and GPU time runs until the next mark or the end of the frame
+JNIEXPORT void JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_00024Critical_nativeMarkLayer(
+    jlong contextHandle, jint layer) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr || !ctx->initialized || !ctx->inFrame || layer < 0 || layer >= budget::MAX_LAYERS) {
+        return;
+    }
+
+    ctx->drawDepth = depthForOrder(ctx->layerDepthOrder[layer]);
+
+    FrameTiming& timing = ctx->frameTimings[ctx->currentFrame];
+    const auto now = std::chrono::steady_clock::now();
+    closeLayerTiming(timing, now);
+    timing.openLayer = layer;
+    timing.layerStart = now;
+
+    if (ctx->timestampPool && timing.markCount < MAX_LAYER_MARKS) {
+        timing.markLayers[timing.markCount] = layer;
+        timing.markCount++;
+        vkCmdWriteTimestamp(ctx->commandBuffers[ctx->currentFrame], VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                            ctx->timestampPool.get(), ctx->currentFrame * TIMESTAMPS_PER_FRAME + timing.markCount);
+    }
+}
+
+// Depth order of a layer (0 = sky, higher is nearer); applies from its next mark
+JNIEXPORT void JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_00024Critical_nativeSetLayerDepthOrder(
+    jlong contextHandle, jint layer, jint order) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr || layer < 0 || layer >= budget::MAX_LAYERS || order < 0 || order >= DEPTH_ORDERS) {
+        return;
+    }
+
+    ctx->layerDepthOrder[layer] = order;
+}
+
+// Frame budget in milliseconds (e.g. 1000 / display refresh rate)
+JNIEXPORT void JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_00024Critical_nativeSetFrameBudget(
+    jlong contextHandle, jfloat budgetMs) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr || budgetMs <= 0.0f) {
+        return;
+    }
+
+    ctx->baseFrameBudgetMs = budgetMs;
+    applyFrameBudget(ctx);
+}
+
+// Frame rate the render loop should pace to (lowered as the device heats up)
+JNIEXPORT jint JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_00024Critical_nativeGetTargetFps(
+    jlong contextHandle) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr || !ctx->thermalController) {
+        return thermal::TIERS[0].targetFps;
+    }
+
+    return ctx->thermalController->governor().targetFps();
+}
+
+// Declare the quality knob (budget::Knob) that trims a layer's cost
+JNIEXPORT void JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_00024Critical_nativeAssignBudgetLayer(
+    jlong contextHandle, jint layer, jint knob) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr || knob < 0 || knob >= budget::KNOB_COUNT) {
+        return;
+    }
+
+    ctx->budgetGovernor.assignLayer(layer, static_cast<budget::Knob>(knob));
+}
+
+// Current quality settings:
+// [star fraction, tessellation scale, label fraction, glow (0/1), resolution scale]
+JNIEXPORT jfloatArray JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeGetQuality(
+    JNIEnv* env, jobject obj, jlong contextHandle) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    const budget::Quality quality = ctx != nullptr ? ctx->budgetGovernor.quality() : budget::Quality();
+    const jfloat values[5] = {
+        quality.starFraction,
+        quality.tessellationScale,
+        quality.labelFraction,
+        quality.glow ? 1.0f : 0.0f,
+        quality.resolutionScale
+    };
+
+    jfloatArray result = env->NewFloatArray(5);
+    if (result != nullptr) {
+        env->SetFloatArrayRegion(result, 0, 5, values);
+    }
+    return result;
+}
+
+// Budget telemetry: [smoothed CPU ms, smoothed GPU ms, budget ms, frames, decision count,
+// smoothed overdraw (fragment shader invocations per pixel, 0 if not measured)],
+// then 6 values per decision, oldest first: frame, knob, step, degraded (0/1), layer, frame ms
+JNIEXPORT jdoubleArray JNICALL
+Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeGetBudgetTelemetry(
+    JNIEnv* env, jobject obj, jlong contextHandle) {
+
+    auto* ctx = reinterpret_cast<VulkanContext*>(contextHandle);
+    if (ctx == nullptr) {
+        return env->NewDoubleArray(0);
+    }
+
+    const budget::Governor& governor = ctx->budgetGovernor;
+    const std::vector<budget::Decision>& decisions = governor.decisions();
+    std::vector<jdouble> values = {
+        governor.smoothedCpuMs(),
+        governor.smoothedGpuMs(),
+        governor.budgetMs(),
+        static_cast<jdouble>(governor.frame()),
+        static_cast<jdouble>(decisions.size()),
+        governor.smoothedOverdraw()
+    };
+    for (const budget::Decision& d : decisions) {
+        values.push_back(static_cast<jdouble>(d.frame));
+        values.push_back(static_cast<jdouble>(d.knob));
+        values.push_back(d.step);
+        values.push_back(d.degraded ? 1.0 : 0.0);
+        values.push_back(d.layer);
+        values.push_back(d.frameMs);
+    }
+
+    jdoubleArray result = env->NewDoubleArray(static_cast<jsize>(values.size()));
+    if (result != nullptr) {
+        env->SetDoubleArrayRegion(result, 0, static_cast<jsize>(values.size()), values.data());
+    }
+    return result;
 }
 
 // New Phase 2 API: End frame
@@ -1894,6 +4388,8 @@ Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeEndFrame(
     // End render pass
     vkCmdEndRenderPass(ctx->commandBuffers[ctx->currentFrame]);
 
+    endFrameTiming(ctx, ctx->commandBuffers[ctx->currentFrame]);
+
     // End command buffer
     VkResult result = vkEndCommandBuffer(ctx->commandBuffers[ctx->currentFrame]);
     if (result != VK_SUCCESS) {
@@ -1944,6 +4440,8 @@ Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeEndFrame(
     }
     // Note: SUBOPTIMAL is OK - we can continue rendering, resize will be handled if needed
 
+    updateThermalPacing(ctx, ctx->frameTimings[ctx->currentFrame].sample.cpuMs);
+
     ctx->currentFrame = (ctx->currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
 
     // Log occasionally
@@ -1952,4 +4450,141 @@ Java_com_stardroid_awakening_vulkan_VulkanRenderer_nativeEndFrame(
     }
 }
 
+// JNI call benchmark (JniCallBenchmark.kt): the same trivial body behind each
+// kind of native call, so the timings differ only in the transition
+static jlong benchmarkBody(jlong value) {
+    return value + 1;
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_stardroid_awakening_vulkan_JniCallBenchmark_nativeRegular(JNIEnv* env, jclass clazz, jlong value) {
+    return benchmarkBody(value);
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_stardroid_awakening_vulkan_JniCallBenchmark_nativeFast(JNIEnv* env, jclass clazz, jlong value) {
+    return benchmarkBody(value);
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_stardroid_awakening_vulkan_JniCallBenchmark_nativeCritical(jlong value) {
+    return benchmarkBody(value);
+}
+
+// Native methods are bound once in JNI_OnLoad rather than looked up by symbol
+// name on first call. Methods of VulkanRenderer.Critical are @CriticalNative
+// (static, primitive arguments only: no JNIEnv or class is passed); ART
+// requires those to be registered before Android 12. The small per-frame
+// array calls are @FastNative and keep the regular signature. Neither kind
+// lets the thread be suspended for GC, so only short calls that never block
+// use them; beginFrame, endFrame and resize wait on fences, present or the
+// swapchain lock and stay regular calls
+#define NATIVE_METHOD(prefix, name, signature) {#name, signature, reinterpret_cast<void*>(prefix##name)}
+#define RENDERER_METHOD(name, signature) \
+    NATIVE_METHOD(Java_com_stardroid_awakening_vulkan_VulkanRenderer_, name, signature)
+#define CRITICAL_METHOD(name, signature) \
+    NATIVE_METHOD(Java_com_stardroid_awakening_vulkan_VulkanRenderer_00024Critical_, name, signature)
+#define BENCHMARK_METHOD(name, signature) \
+    NATIVE_METHOD(Java_com_stardroid_awakening_vulkan_JniCallBenchmark_, name, signature)
+
+static const JNINativeMethod RENDERER_METHODS[] = {
+    RENDERER_METHOD(nativeInit, "(Landroid/view/Surface;)J"),
+    RENDERER_METHOD(nativeRender, "(JF)V"),
+    RENDERER_METHOD(nativeResize, "(JII)V"),
+    RENDERER_METHOD(nativeDestroy, "(J)V"),
+    RENDERER_METHOD(nativeBeginFrame, "(J)Z"),
+    RENDERER_METHOD(nativeEndFrame, "(J)V"),
+    RENDERER_METHOD(nativeDraw, "(JI[FI[F)V"),
+    RENDERER_METHOD(nativeRegisterBatch, "(JII[FI[F)I"),
+    RENDERER_METHOD(nativeGetCullStats, "(J)[I"),
+    RENDERER_METHOD(nativeSetViewMatrix, "(J[F)V"),
+    RENDERER_METHOD(nativeSetProjectionMatrix, "(J[F)V"),
+    RENDERER_METHOD(nativeSetStarPalette, "(J[F)V"),
+    RENDERER_METHOD(nativeSetHorizonProfile, "(J[F[F)Z"),
+    RENDERER_METHOD(nativeGetSwapchainDimensions, "(J)[I"),
+    RENDERER_METHOD(nativeLoadLightMapAsync, "(JLandroid/content/res/AssetManager;IF)Z"),
+    RENDERER_METHOD(nativeSetDeepSkyObjects, "(J[F[II)Z"),
+    RENDERER_METHOD(nativeDrawBodies, "(J[F[II[FF)I"),
+    RENDERER_METHOD(nativeSetOrbits, "(J[I[D[II)I"),
+    RENDERER_METHOD(nativeUpdateOrbits, "(JDDD)I"),
+    RENDERER_METHOD(nativeSetMeteorRadiants, "(J[FIF)V"),
+    RENDERER_METHOD(nativeSetSkyObjects, "(J[F[II)Z"),
+    RENDERER_METHOD(nativeSetLightCurves, "(J[I[DI)I"),
+    RENDERER_METHOD(nativeUpdateVariableStars, "(JD)I"),
+    RENDERER_METHOD(nativeDrawSkyObjects, "(JIFFFFF)I"),
+    RENDERER_METHOD(nativePlaceLabels, "(J[I[FI)[I"),
+    RENDERER_METHOD(nativeGetQuality, "(J)[F"),
+    RENDERER_METHOD(nativeGetBudgetTelemetry, "(J)[D"),
+    RENDERER_METHOD(nativeGetObserverFrame, "(J[D)J"),
+};
+
+static const JNINativeMethod CRITICAL_METHODS[] = {
+    CRITICAL_METHOD(nativeSetBackgroundOpacity, "(JF)V"),
+    CRITICAL_METHOD(nativeSetScintillation, "(JZ)V"),
+    CRITICAL_METHOD(nativeSetHorizonClip, "(JZ)V"),
+    CRITICAL_METHOD(nativeSetObserver, "(JDDDJ)V"),
+    CRITICAL_METHOD(nativeGetObserverVersion, "(J)J"),
+    CRITICAL_METHOD(nativeSetStarLimitingMagnitude, "(JF)V"),
+    CRITICAL_METHOD(nativeDrawLightMap, "(J)V"),
+    CRITICAL_METHOD(nativeDrawDeepSkyObjects, "(JF)V"),
+    CRITICAL_METHOD(nativeDrawOrbits, "(J)V"),
+    CRITICAL_METHOD(nativeDrawMeteors, "(J)V"),
+    CRITICAL_METHOD(nativePickSkyObject, "(JFFFF)I"),
+    CRITICAL_METHOD(nativeFindSkyObject, "(JI)I"),
+    CRITICAL_METHOD(nativeMarkLayer, "(JI)V"),
+    CRITICAL_METHOD(nativeDrawRegistered, "(JII)V"),
+    CRITICAL_METHOD(nativeUnregisterBatch, "(JI)V"),
+    CRITICAL_METHOD(nativeSetLayerDepthOrder, "(JII)V"),
+    CRITICAL_METHOD(nativeSetFrameBudget, "(JF)V"),
+    CRITICAL_METHOD(nativeGetTargetFps, "(J)I"),
+    CRITICAL_METHOD(nativeAssignBudgetLayer, "(JII)V"),
+};
+
+static const JNINativeMethod BENCHMARK_METHODS[] = {
+    BENCHMARK_METHOD(nativeRegular, "(J)J"),
+    BENCHMARK_METHOD(nativeFast, "(J)J"),
+    BENCHMARK_METHOD(nativeCritical, "(J)J"),
+};
+
+#undef BENCHMARK_METHOD
+#undef CRITICAL_METHOD
+#undef RENDERER_METHOD
+#undef NATIVE_METHOD
+
+static bool registerMethods(JNIEnv* env, const char* className, const JNINativeMethod* methods, jint count) {
+    jclass clazz = env->FindClass(className);
+    if (clazz == nullptr) {
+        LOGE("Failed to find class %s for native registration", className);
+        return false;
+    }
+    const jint result = env->RegisterNatives(clazz, methods, count);
+    env->DeleteLocalRef(clazz);
+    if (result != JNI_OK) {
+        LOGE("Failed to register %d native methods of %s (%d)", count, className, result);
+        return false;
+    }
+    return true;
+}
+
+JNIEXPORT jint JNICALL
+JNI_OnLoad(JavaVM* vm, void* reserved) {
+    JNIEnv* env = nullptr;
+    if (vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6) != JNI_OK) {
+        return JNI_ERR;
+    }
+
+    constexpr jint rendererCount = sizeof(RENDERER_METHODS) / sizeof(RENDERER_METHODS[0]);
+    constexpr jint criticalCount = sizeof(CRITICAL_METHODS) / sizeof(CRITICAL_METHODS[0]);
+    constexpr jint benchmarkCount = sizeof(BENCHMARK_METHODS) / sizeof(BENCHMARK_METHODS[0]);
+    if (!registerMethods(env, "com/stardroid/awakening/vulkan/VulkanRenderer", RENDERER_METHODS, rendererCount) ||
+        !registerMethods(env, "com/stardroid/awakening/vulkan/VulkanRenderer$Critical", CRITICAL_METHODS,
+                         criticalCount) ||
+        !registerMethods(env, "com/stardroid/awakening/vulkan/JniCallBenchmark", BENCHMARK_METHODS, benchmarkCount)) {
+        return JNI_ERR;
+    }
+
+    LOGI("Registered %d native methods (%d critical)", rendererCount + criticalCount, criticalCount);
+    return JNI_VERSION_1_6;
+}
+
 } // extern "C"
@@ -17,6 +17,7 @@ import androidx.core.app.ActivityCompat
 import com.stardroid.awakening.control.AstronomerModel
 import com.stardroid.awakening.control.SensorOrientationController
 import com.stardroid.awakening.data.ConstellationCatalog
+import com.stardroid.awakening.data.HorizonProfileAsset
 import com.stardroid.awakening.data.MessierCatalog
 import com.stardroid.awakening.data.StarCatalog
 import com.stardroid.awakening.math.LatLong
@@ -25,6 +26,7 @@ import com.stardroid.awakening.layers.Layer
 import com.stardroid.awakening.layers.LayerManager
 import com.stardroid.awakening.ui.CompassOverlay
 import com.stardroid.awakening.ui.FpsOverlay
+import com.stardroid.awakening.ui.LabelOverlay
 import com.stardroid.awakening.ui.LayerToggleOverlay
 import com.stardroid.awakening.vulkan.VulkanSurfaceView
 
@@ -36,6 +38,7 @@ class MainActivity : AppCompatActivity(), LocationListener {
     private lateinit var layerManager: LayerManager
     private lateinit var starCatalog: StarCatalog
     private lateinit var messierCatalog: MessierCatalog
+    private lateinit var horizonProfile: HorizonProfileAsset
     private var cameraPreviewView: CameraSurfaceView? = null
     private lateinit var constellationCatalog: ConstellationCatalog
     private lateinit var astronomerModel: AstronomerModel
@@ -53,10 +56,12 @@ class MainActivity : AppCompatActivity(), LocationListener {
         starCatalog = StarCatalog(assets)
         constellationCatalog = ConstellationCatalog(assets)
         messierCatalog = MessierCatalog(assets)
+        horizonProfile = HorizonProfileAsset(assets)
         Thread {
             starCatalog.load()
             constellationCatalog.load()
             messierCatalog.load()
+            horizonProfile.load()
         }.start()
 
         // Create container layout
@@ -67,6 +72,7 @@ class MainActivity : AppCompatActivity(), LocationListener {
         vulkanSurfaceView.starCatalog = starCatalog
         vulkanSurfaceView.constellationCatalog = constellationCatalog
         vulkanSurfaceView.messierCatalog = messierCatalog
+        vulkanSurfaceView.horizonProfile = horizonProfile
         vulkanSurfaceView.astronomerModel = astronomerModel
         vulkanSurfaceView.layerManager = layerManager
         container.addView(vulkanSurfaceView, FrameLayout.LayoutParams(
@@ -74,6 +80,14 @@ class MainActivity : AppCompatActivity(), LocationListener {
             FrameLayout.LayoutParams.MATCH_PARENT
         ))
 
+        // Object names over the sky, placed by the renderer each frame
+        val labelOverlay = LabelOverlay(this)
+        vulkanSurfaceView.labelOverlay = labelOverlay
+        container.addView(labelOverlay, FrameLayout.LayoutParams(
+            FrameLayout.LayoutParams.MATCH_PARENT,
+            FrameLayout.LayoutParams.MATCH_PARENT
+        ))
+
         // Create compass overlay in bottom-left corner
         compassOverlay = CompassOverlay(this)
         compassOverlay.astronomerModel = astronomerModel
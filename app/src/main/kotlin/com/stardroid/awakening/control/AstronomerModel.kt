@@ -64,6 +64,10 @@ class AstronomerModel {
     private var celestialCoordsNeedUpdate = true
     private var lastCelestialUpdate = 0L
 
+    /** Renderer's observer frame, followed instead of this model's clock when set. */
+    @Volatile
+    private var observerFrame: ObserverFrame? = null
+
     /**
      * User's pointing direction and screen up vector.
      */
@@ -97,6 +101,19 @@ class AstronomerModel {
         useRotationVector = true
     }
 
+    /**
+     * Take the zenith and north from the renderer's observer frame (the one
+     * it clips, culls and twinkles against) instead of recomputing them from
+     * this model's own clock, so the pointing and the drawn horizon agree.
+     * Cheap to call every frame: the axes are only redone when a different
+     * frame (a new version) is given. Null goes back to the model's clock.
+     */
+    fun setObserverFrame(frame: ObserverFrame?) {
+        if (frame === observerFrame) return
+        observerFrame = frame
+        celestialCoordsNeedUpdate = true
+    }
+
     /**
      * Get current pointing direction.
      */
@@ -141,19 +158,26 @@ class AstronomerModel {
 
     private fun updateCelestialCoords() {
         val now = System.currentTimeMillis()
-        if (!celestialCoordsNeedUpdate && now - lastCelestialUpdate < 60000) return
+        val frame = observerFrame
+        // A given frame changes only through setObserverFrame; the own clock is refreshed every minute
+        if (!celestialCoordsNeedUpdate && (frame != null || now - lastCelestialUpdate < 60000)) return
 
         lastCelestialUpdate = now
         celestialCoordsNeedUpdate = false
 
-        // Calculate zenith
-        zenithCelestial = calculateZenith(Date(now), location)
-
-        // Calculate north: project celestial pole onto horizon
-        val celestialPole = Vector3.unitZ()
-        val zDotUp = zenithCelestial dot celestialPole
-        northCelestial = celestialPole - zenithCelestial * zDotUp
-        northCelestial.normalize()
+        if (frame != null) {
+            zenithCelestial = frame.zenith
+            northCelestial = frame.north
+        } else {
+            // Calculate zenith
+            zenithCelestial = calculateZenith(Date(now), location)
+
+            // Calculate north: project celestial pole onto horizon
+            val celestialPole = Vector3.unitZ()
+            val zDotUp = zenithCelestial dot celestialPole
+            northCelestial = celestialPole - zenithCelestial * zDotUp
+            northCelestial.normalize()
+        }
 
         // East is cross product
         eastCelestial = northCelestial cross zenithCelestial
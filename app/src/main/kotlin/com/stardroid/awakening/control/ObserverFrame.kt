@@ -0,0 +1,62 @@
+package com.stardroid.awakening.control
+
+import com.stardroid.awakening.math.Vector3
+
+/**
+ * The observer's local frame, site and visible horizon, as last computed
+ * natively from [com.stardroid.awakening.vulkan.VulkanRenderer.setObserver]
+ * (observer_state.h).
+ *
+ * The renderer clips, culls and twinkles against exactly this state, so
+ * everything drawn relative to the horizon reads it too. [version] changes
+ * exactly when any part changed; caches keep the version they were built
+ * from and rebuild when it differs.
+ */
+class ObserverFrame private constructor(private val values: DoubleArray, val version: Long) {
+
+    /** Zenith in celestial coordinates. */
+    val zenith: Vector3 get() = vector(ZENITH)
+
+    /** True north along the ground in celestial coordinates. */
+    val north: Vector3 get() = vector(NORTH)
+
+    /** True east in celestial coordinates. */
+    val east: Vector3 get() = vector(EAST)
+
+    /** Local mean sidereal time the frame was computed for, radians. */
+    val localSiderealRad: Double get() = values[LOCAL_SIDEREAL]
+
+    /** Greenwich mean sidereal time the frame was computed for, radians. */
+    val greenwichSiderealRad: Double get() = values[LOCAL_SIDEREAL] - Math.toRadians(values[LONGITUDE])
+
+    /** Site's Earth-fixed position on the WGS84 ellipsoid, meters. */
+    fun siteEcef(i: Int): Double = values[SITE_ECEF + i]
+
+    /**
+     * Visible horizon plane (x, y, z, w): a celestial direction v is above
+     * the horizon when dot(xyz, v) + w >= 0.
+     */
+    fun horizonPlane(i: Int): Float = values[HORIZON_PLANE + i].toFloat()
+
+    private fun vector(offset: Int) =
+        Vector3(values[offset].toFloat(), values[offset + 1].toFloat(), values[offset + 2].toFloat())
+
+    companion object {
+        /** Doubles written by nativeGetObserverFrame (OBSERVER_FRAME_COMPONENTS in vulkan_wrapper.cpp). */
+        const val COMPONENTS = 18
+
+        private const val ZENITH = 0
+        private const val NORTH = 3
+        private const val EAST = 6
+        private const val LOCAL_SIDEREAL = 9
+        private const val LONGITUDE = 10
+        private const val SITE_ECEF = 11
+        private const val HORIZON_PLANE = 14
+
+        /** Decode the layout written by nativeGetObserverFrame; [values] is copied. */
+        fun fromArray(values: DoubleArray, version: Long): ObserverFrame? {
+            if (values.size < COMPONENTS || version == 0L) return null
+            return ObserverFrame(values.copyOf(COMPONENTS), version)
+        }
+    }
+}
@@ -5,6 +5,7 @@ import android.util.Log
 import com.stardroid.awakening.renderer.DrawBatch
 import com.stardroid.awakening.renderer.Matrix
 import com.stardroid.awakening.renderer.PrimitiveType
+import com.stardroid.awakening.renderer.SkyLabel
 import java.nio.ByteBuffer
 import kotlin.math.cos
 import kotlin.math.sin
@@ -19,7 +20,10 @@ import kotlin.math.sin
 class ConstellationCatalog(private val assetManager: AssetManager) {
 
     private var lineSegments: List<LineSegment> = emptyList()
+    private var labels: List<SkyLabel> = emptyList()
     private var isLoaded = false
+    // Built once; the same vertex array lets the renderer keep it registered for culling
+    private var batch: DrawBatch? = null
 
     data class LineSegment(
         val x1: Float, val y1: Float, val z1: Float,
@@ -40,10 +44,27 @@ class ConstellationCatalog(private val assetManager: AssetManager) {
                 val sources = AstronomicalSources.getRootAsAstronomicalSources(buf)
 
                 val loadedSegments = mutableListOf<LineSegment>()
+                val loadedLabels = mutableListOf<SkyLabel>()
 
                 for (i in 0 until sources.sourcesLength) {
                     val source = sources.sources(i)!!
 
+                    for (j in 0 until source.labelsLength) {
+                        val label = source.labels(j)!!
+                        val text = label.text ?: continue
+                        val location = label.location ?: continue
+                        val raRad = Math.toRadians(location.rightAscension.toDouble())
+                        val decRad = Math.toRadians(location.declination.toDouble())
+                        // Constellations have no brightness; the placer keeps them in catalog order
+                        loadedLabels.add(SkyLabel(
+                            text,
+                            (cos(decRad) * cos(raRad)).toFloat(),
+                            (cos(decRad) * sin(raRad)).toFloat(),
+                            sin(decRad).toFloat(),
+                            0f
+                        ))
+                    }
+
                     for (j in 0 until source.linesLength) {
                         val line = source.lines(j)!!
 
@@ -84,6 +105,8 @@ class ConstellationCatalog(private val assetManager: AssetManager) {
                 }
 
                 lineSegments = loadedSegments
+                labels = loadedLabels
+                batch = null
                 isLoaded = true
 
                 val elapsed = System.currentTimeMillis() - startTime
@@ -105,6 +128,8 @@ class ConstellationCatalog(private val assetManager: AssetManager) {
             )
         }
 
+        batch?.let { return it }
+
         // Build vertex array: 2 vertices per segment, 7 floats per vertex (xyz + rgba)
         val vertices = FloatArray(lineSegments.size * 14)
         var offset = 0
@@ -132,9 +157,12 @@ class ConstellationCatalog(private val assetManager: AssetManager) {
             vertices = vertices,
             vertexCount = lineSegments.size * 2,
             transform = Matrix.identity()
-        )
+        ).also { batch = it }
     }
 
+    /** Constellation name labels, or null until loaded. */
+    fun getLabels(): List<SkyLabel>? = if (isLoaded) labels else null
+
     val lineCount: Int
         get() = lineSegments.size
 
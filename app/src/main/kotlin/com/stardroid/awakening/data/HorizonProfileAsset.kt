@@ -0,0 +1,59 @@
+package com.stardroid.awakening.data
+
+import android.content.res.AssetManager
+import android.util.Log
+
+/**
+ * Loads the optional terrain skyline of the observing site (horizon.txt).
+ *
+ * One point per line: azimuth and altitude in degrees, separated by
+ * whitespace or a comma, azimuth measured from north through east. Lines
+ * starting with '#' are comments. The renderer interpolates between points
+ * and hides everything below the skyline while the Ground layer is visible.
+ */
+class HorizonProfileAsset(private val assetManager: AssetManager) {
+
+    /** Point azimuths (degrees), or null if the asset is missing or not yet loaded. */
+    var azimuths: FloatArray? = null
+        private set
+
+    /** Point altitudes (degrees), parallel to [azimuths]. */
+    var altitudes: FloatArray? = null
+        private set
+
+    fun load() {
+        if (azimuths != null) return
+
+        val text = try {
+            assetManager.open(ASSET_NAME).bufferedReader().use { it.readText() }
+        } catch (e: Exception) {
+            Log.i(TAG, "No horizon profile asset, using the flat horizon")
+            return
+        }
+
+        val az = ArrayList<Float>()
+        val alt = ArrayList<Float>()
+        for (line in text.lineSequence()) {
+            val trimmed = line.trim()
+            if (trimmed.isEmpty() || trimmed.startsWith("#")) continue
+            val fields = trimmed.split(',', ' ', '\t').filter { it.isNotEmpty() }
+            val a = fields.getOrNull(0)?.toFloatOrNull()
+            val h = fields.getOrNull(1)?.toFloatOrNull()
+            if (a == null || h == null) {
+                Log.w(TAG, "Skipping malformed horizon line: $trimmed")
+                continue
+            }
+            az.add(a)
+            alt.add(h)
+        }
+
+        azimuths = az.toFloatArray()
+        altitudes = alt.toFloatArray()
+        Log.d(TAG, "Loaded horizon profile (${az.size} points)")
+    }
+
+    companion object {
+        private const val TAG = "HorizonProfileAsset"
+        private const val ASSET_NAME = "horizon.txt"
+    }
+}
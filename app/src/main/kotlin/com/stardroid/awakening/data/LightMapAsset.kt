@@ -0,0 +1,43 @@
+package com.stardroid.awakening.data
+
+import kotlin.math.log10
+
+/**
+ * Settings for the optional integrated-light map asset (lightmap.binary).
+ *
+ * The file is produced by tools/src/main/cpp/lightmap_tool and holds, per
+ * LOD cutoff magnitude and HEALPix order, the summed light of all stars
+ * fainter than the cutoff. The renderer reads, parses and tessellates it
+ * natively off the render thread (VulkanRenderer.loadLightMapAsync).
+ */
+object LightMapAsset {
+
+    /** Faint limit of the individually drawn star layer at full density. */
+    const val STAR_LIMITING_MAGNITUDE = 6.0f
+
+    /** Star counts grow about this many decades per magnitude (about 3x per magnitude). */
+    private const val STAR_COUNT_SLOPE = 0.5f
+
+    /** Below this share of stars the estimated limit stops getting brighter. */
+    private const val MIN_STAR_FRACTION = 0.01f
+
+    /** Order 5 pixels are ~1.8 degrees: smooth at any practical field of view. */
+    const val PREFERRED_ORDER = 5
+
+    /**
+     * Flux per steradian to tone-map input. Dense Milky Way fields below
+     * magnitude 6 sum to roughly 10 mag-0 stars per steradian; this keeps
+     * them a faint glow rather than a wash.
+     */
+    const val GAIN = 0.01f
+
+    /**
+     * Faint limit of the star layer when it draws [starFraction] of each
+     * cell's stars, brightest first (the frame budget's star density).
+     * Halving the stars drawn moves the limit about 0.6 magnitudes brighter.
+     */
+    fun limitingMagnitude(starFraction: Float): Float {
+        if (starFraction >= 1f) return STAR_LIMITING_MAGNITUDE
+        return STAR_LIMITING_MAGNITUDE + log10(starFraction.coerceAtLeast(MIN_STAR_FRACTION)) / STAR_COUNT_SLOPE
+    }
+}
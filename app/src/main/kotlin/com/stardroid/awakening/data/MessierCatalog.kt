@@ -3,21 +3,23 @@ package com.stardroid.awakening.data
 import android.content.res.AssetManager
 import android.util.Log
 import com.google.android.stardroid.source.proto.SourceProto
-import com.stardroid.awakening.renderer.DrawBatch
-import com.stardroid.awakening.renderer.Matrix
-import com.stardroid.awakening.renderer.PrimitiveType
+import com.stardroid.awakening.renderer.DeepSkyObjects
+import com.stardroid.awakening.renderer.SkyLabel
 import kotlin.math.cos
 import kotlin.math.sin
 
 /**
  * Loads and provides Messier object data from the binary protobuf catalog.
  *
- * ~110 deep-sky objects (galaxies, nebulae, clusters) rendered as colored points.
+ * ~110 deep-sky objects (galaxies, nebulae, clusters), each drawn as a
+ * shape-specific glyph by the instanced deep-sky object pipeline.
  */
 class MessierCatalog(private val assetManager: AssetManager) {
 
-    private var vertices: FloatArray = floatArrayOf()
-    private var vertexCount: Int = 0
+    private var objects: DeepSkyObjects? = null
+    private var labels: List<SkyLabel> = emptyList()
+
+    @Volatile
     private var isLoaded = false
 
     fun load() {
@@ -30,7 +32,9 @@ class MessierCatalog(private val assetManager: AssetManager) {
             assetManager.open("messier.binary").use { stream ->
                 val sources = SourceProto.AstronomicalSourcesProto.parseFrom(stream)
 
-                val verts = mutableListOf<Float>()
+                val geometry = mutableListOf<Float>()
+                val styles = mutableListOf<Int>()
+                val loadedLabels = mutableListOf<SkyLabel>()
 
                 for (i in 0 until sources.sourceCount) {
                     val source = sources.getSource(i)
@@ -39,55 +43,51 @@ class MessierCatalog(private val assetManager: AssetManager) {
                         val point = source.getPoint(j)
                         val location = point.location
 
-                        val raDeg = location.rightAscension.toDouble()
-                        val decDeg = location.declination.toDouble()
-                        val raRad = Math.toRadians(raDeg)
-                        val decRad = Math.toRadians(decDeg)
-
-                        val x = (cos(decRad) * cos(raRad)).toFloat()
-                        val y = (cos(decRad) * sin(raRad)).toFloat()
-                        val z = sin(decRad).toFloat()
-
-                        val color = point.color.toInt()
-                        val a = ((color shr 24) and 0xFF) / 255f
-                        val r = ((color shr 16) and 0xFF) / 255f
-                        val g = ((color shr 8) and 0xFF) / 255f
-                        val b = (color and 0xFF) / 255f
-
-                        verts.add(x); verts.add(y); verts.add(z)
-                        verts.add(r); verts.add(g); verts.add(b); verts.add(a)
+                        geometry.add(location.rightAscension)
+                        geometry.add(location.declination)
+                        geometry.add(point.majorAxis)
+                        geometry.add(point.minorAxis)
+                        geometry.add(point.positionAngle)
+
+                        styles.add(point.shape.number)
+                        styles.add(point.color.toInt())
+
+                        if (source.nameStrIdsCount > 0) {
+                            val ra = Math.toRadians(location.rightAscension.toDouble())
+                            val dec = Math.toRadians(location.declination.toDouble())
+                            // Point size stands in for brightness, as for stars
+                            loadedLabels.add(SkyLabel(
+                                SkyLabel.displayName(source.getNameStrIds(0)),
+                                (cos(dec) * cos(ra)).toFloat(),
+                                (cos(dec) * sin(ra)).toFloat(),
+                                sin(dec).toFloat(),
+                                -point.size.toFloat()
+                            ))
+                        }
                     }
                 }
 
-                vertices = verts.toFloatArray()
-                vertexCount = verts.size / 7
+                objects = DeepSkyObjects(
+                    geometry = geometry.toFloatArray(),
+                    styles = styles.toIntArray(),
+                    count = styles.size / DeepSkyObjects.STYLE_COMPONENTS
+                )
+                labels = loadedLabels
                 isLoaded = true
 
                 val elapsed = System.currentTimeMillis() - startTime
-                Log.d(TAG, "Loaded $vertexCount Messier objects in ${elapsed}ms")
+                Log.d(TAG, "Loaded ${objects?.count} Messier objects in ${elapsed}ms")
             }
         } catch (e: Exception) {
             Log.e(TAG, "Failed to load Messier catalog", e)
         }
     }
 
-    fun getMessierBatch(): DrawBatch {
-        if (!isLoaded) {
-            return DrawBatch(
-                type = PrimitiveType.POINTS,
-                vertices = floatArrayOf(),
-                vertexCount = 0,
-                transform = Matrix.identity()
-            )
-        }
+    /** Objects for [com.stardroid.awakening.vulkan.VulkanRenderer.setDeepSkyObjects], or null until loaded. */
+    fun getDeepSkyObjects(): DeepSkyObjects? = if (isLoaded) objects else null
 
-        return DrawBatch(
-            type = PrimitiveType.POINTS,
-            vertices = vertices,
-            vertexCount = vertexCount,
-            transform = Matrix.identity()
-        )
-    }
+    /** Labels of the named objects, or null until loaded. */
+    fun getLabels(): List<SkyLabel>? = if (isLoaded) labels else null
 
     companion object {
         private const val TAG = "MessierCatalog"
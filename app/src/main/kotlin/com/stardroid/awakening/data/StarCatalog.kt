@@ -4,8 +4,13 @@ import android.content.res.AssetManager
 import android.util.Log
 import com.google.android.stardroid.source.proto.SourceProto
 import com.stardroid.awakening.renderer.DrawBatch
+import com.stardroid.awakening.renderer.LightCurves
 import com.stardroid.awakening.renderer.Matrix
 import com.stardroid.awakening.renderer.PrimitiveType
+import com.stardroid.awakening.renderer.SkyLabel
+import com.stardroid.awakening.renderer.SkyObjects
+import com.stardroid.awakening.renderer.StarPalette
+import com.stardroid.awakening.renderer.StarVertex
 import com.stardroid.awakening.spatial.SpatialStarIndex
 import kotlin.math.cos
 import kotlin.math.sin
@@ -23,14 +28,14 @@ class StarCatalog(private val assetManager: AssetManager) {
     private var stars: List<Star> = emptyList()
     private var isLoaded = false
     private val spatialIndex = SpatialStarIndex()
+    private var starNames: List<String> = emptyList()
+    private var labels: List<SkyLabel>? = null
 
     data class Star(
         val x: Float,
         val y: Float,
         val z: Float,
-        val r: Float,
-        val g: Float,
-        val b: Float,
+        val colorIndex: Int,  // Slot in StarPalette
         val a: Float,
         val raDeg: Double,
         val decDeg: Double,
@@ -74,19 +79,20 @@ class StarCatalog(private val assetManager: AssetManager) {
                         val y = (cos(decRad) * sin(raRad)).toFloat()
                         val z = sin(decRad).toFloat()
 
-                        // Extract color (ARGB packed)
+                        // Reduce the ARGB color to a palette slot; only alpha is kept per star
                         val color = point.color.toInt()
                         val a = ((color shr 24) and 0xFF) / 255f
                         val r = ((color shr 16) and 0xFF) / 255f
                         val g = ((color shr 8) and 0xFF) / 255f
                         val b = (color and 0xFF) / 255f
+                        val colorIndex = StarPalette.indexForColor(r, g, b)
 
                         // Get name if available
                         val name = if (source.nameStrIdsCount > 0) {
                             source.getNameStrIds(0)
                         } else null
 
-                        loadedStars.add(Star(x, y, z, r, g, b, a, raDeg, decDeg, point.size, name))
+                        loadedStars.add(Star(x, y, z, colorIndex, a, raDeg, decDeg, point.size, name))
                     }
                 }
 
@@ -113,12 +119,10 @@ class StarCatalog(private val assetManager: AssetManager) {
                 x = star.x,
                 y = star.y,
                 z = star.z,
-                r = star.r,
-                g = star.g,
-                b = star.b,
-                a = star.a,
+                packedColor = StarVertex.pack(star.colorIndex, star.a),
                 raDeg = star.raDeg,
                 decDeg = star.decDeg,
+                size = star.size,
                 name = star.name
             )
         }
@@ -138,7 +142,7 @@ class StarCatalog(private val assetManager: AssetManager) {
         if (!isLoaded) {
             Log.w(TAG, "Star catalog not loaded, returning empty batch")
             return DrawBatch(
-                type = PrimitiveType.POINTS,
+                type = PrimitiveType.STARS,
                 vertices = floatArrayOf(),
                 vertexCount = 0,
                 transform = Matrix.identity()
@@ -155,19 +159,78 @@ class StarCatalog(private val assetManager: AssetManager) {
      * @param lookY View direction Y component
      * @param lookZ View direction Z component
      * @param fovDeg Field of view in degrees
+     * @param starFraction Fraction of stars to draw, brightest first (frame budget)
      */
-    fun getVisibleStarBatch(lookX: Float, lookY: Float, lookZ: Float, fovDeg: Float): DrawBatch {
+    fun getVisibleStarBatch(lookX: Float, lookY: Float, lookZ: Float, fovDeg: Float, starFraction: Float = 1f): DrawBatch {
         if (!isLoaded) {
             Log.w(TAG, "Star catalog not loaded, returning empty batch")
             return DrawBatch(
-                type = PrimitiveType.POINTS,
+                type = PrimitiveType.STARS,
                 vertices = floatArrayOf(),
                 vertexCount = 0,
                 transform = Matrix.identity()
             )
         }
 
-        return spatialIndex.getVisibleStarBatch(lookX, lookY, lookZ, fovDeg)
+        return spatialIndex.getVisibleStarBatch(lookX, lookY, lookZ, fovDeg, starFraction)
+    }
+
+    /**
+     * All stars as columns for the native sky object store, tagged with
+     * [layer]. Name ids index [nameForId].
+     *
+     * stars.binary keeps a point size (larger is brighter) rather than a
+     * magnitude; the store only needs brightness order, so the magnitude
+     * column holds -size.
+     */
+    fun getSkyObjects(layer: Int): SkyObjects? {
+        if (!isLoaded) return null
+
+        val geometry = FloatArray(stars.size * SkyObjects.GEOMETRY_COMPONENTS)
+        val attributes = IntArray(stars.size * SkyObjects.ATTRIBUTE_COMPONENTS)
+        val names = mutableListOf<String>()
+        for ((i, star) in stars.withIndex()) {
+            val g = i * SkyObjects.GEOMETRY_COMPONENTS
+            geometry[g] = star.x
+            geometry[g + 1] = star.y
+            geometry[g + 2] = star.z
+            geometry[g + 3] = -star.size.toFloat()
+
+            var flags = SkyObjects.FLAG_STAR
+            var nameId = SkyObjects.NO_NAME
+            if (star.name != null) {
+                flags = flags or SkyObjects.FLAG_NAMED
+                nameId = names.size
+                names.add(star.name)
+            }
+            val a = i * SkyObjects.ATTRIBUTE_COMPONENTS
+            attributes[a] = SkyObjects.style(star.colorIndex, star.a, flags)
+            attributes[a + 1] = nameId
+            attributes[a + 2] = layer
+        }
+        starNames = names
+        return SkyObjects(geometry, attributes, stars.size)
+    }
+
+    /** Name for a name id from [getSkyObjects]. */
+    fun nameForId(nameId: Int): String? = starNames.getOrNull(nameId)
+
+    /**
+     * Labels of the named stars, or null until loaded. The magnitude is
+     * -size, as in [getSkyObjects]; only the order matters to the placer.
+     */
+    fun getLabels(): List<SkyLabel>? {
+        if (!isLoaded) return null
+        labels?.let { return it }
+        return stars.mapNotNull { star ->
+            star.name?.let { SkyLabel(SkyLabel.displayName(it), star.x, star.y, star.z, -star.size.toFloat()) }
+        }.also { labels = it }
+    }
+
+    /** Light curves of the catalog's known variables, indexed as in [getSkyObjects]. */
+    fun getLightCurves(): LightCurves? {
+        if (!isLoaded) return null
+        return VariableStars.lightCurves { name -> stars.indexOfFirst { it.name == name } }
     }
 
     /**
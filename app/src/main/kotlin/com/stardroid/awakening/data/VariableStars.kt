@@ -0,0 +1,41 @@
+package com.stardroid.awakening.data
+
+import com.stardroid.awakening.renderer.LightCurves
+
+/**
+ * Light curves of the catalog's bright variable stars, by catalog name.
+ * Elements are from the GCVS where it gives them; the semiregular
+ * Betelgeuse is approximated by its dominant ~400 day cycle, phased to the
+ * 2020 minimum.
+ */
+object VariableStars {
+
+    class Elements(
+        val name: String,
+        val kind: Int,
+        val epoch: Double,
+        val period: Double,
+        val maxMagnitude: Double,
+        val amplitude: Double,
+        val shape: Double = 0.0
+    )
+
+    val known = listOf(
+        // Primary eclipses last about 9.6 hours of the 2.87 day period
+        Elements("algol", LightCurves.KIND_ECLIPSING, 2445641.5135, 2.8673043, 2.09, 1.21, 9.6 / 24.0 / 2.8673043),
+        Elements("betelgeuse", LightCurves.KIND_PULSATING, 2458690.0, 400.0, 0.4, 1.2)
+    )
+
+    /** Curves for the known variables found by [indexOf] (index in the uploaded sky objects, or -1). */
+    fun lightCurves(indexOf: (String) -> Int): LightCurves {
+        val ids = ArrayList<Int>()
+        val elements = ArrayList<Double>()
+        for (star in known) {
+            val index = indexOf(star.name)
+            if (index < 0) continue
+            ids += listOf(index, star.kind)
+            elements += listOf(star.epoch, star.period, star.maxMagnitude, star.amplitude, star.shape)
+        }
+        return LightCurves(ids.toIntArray(), elements.toDoubleArray(), ids.size / LightCurves.ID_COMPONENTS)
+    }
+}
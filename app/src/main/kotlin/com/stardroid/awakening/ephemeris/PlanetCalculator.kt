@@ -121,6 +121,33 @@ object PlanetCalculator {
         )
     }
 
+    /**
+     * Osculating elements of a planet's orbit at a Julian Date.
+     *
+     * @return Pericenter distance (AU), eccentricity, inclination, argument of
+     *         perihelion and ascending node (degrees, ecliptic), time of perihelion (JD)
+     */
+    fun orbitalElements(planet: Planet, jd: Double): DoubleArray {
+        val elements = ORBITAL_ELEMENTS[planet] ?: throw IllegalArgumentException("Unknown planet: $planet")
+        val t = JulianDate.toJulianCenturies(jd)
+        val a = elements[2]
+        val e = elements[4] + elements[5] * t
+        val perihelion = elements[8] + elements[9] * t  // Longitude of perihelion
+        val node = elements[10] + elements[11] * t
+        val meanAnomaly = Math.toRadians(elements[0] + elements[1] * t - perihelion).IEEErem(2 * PI)
+        val meanMotion = GAUSS_K / (a * sqrt(a))  // Radians per day
+        return doubleArrayOf(
+            a * (1 - e),
+            e,
+            elements[6] + elements[7] * t,
+            (perihelion - node).mod(360.0),
+            node.mod(360.0),
+            jd - meanAnomaly / meanMotion
+        )
+    }
+
+    private const val GAUSS_K = 0.01720209895
+
     /**
      * Calculate heliocentric position of a planet.
      */
@@ -190,15 +217,15 @@ object PlanetCalculator {
 }
 
 /**
- * Planets in the solar system.
+ * Planets in the solar system, with mean radii in km (for disc sizes).
  */
-enum class Planet(val displayName: String) {
-    MERCURY("Mercury"),
-    VENUS("Venus"),
-    EARTH("Earth"),
-    MARS("Mars"),
-    JUPITER("Jupiter"),
-    SATURN("Saturn"),
-    URANUS("Uranus"),
-    NEPTUNE("Neptune")
+enum class Planet(val displayName: String, val radiusKm: Double) {
+    MERCURY("Mercury", 2439.7),
+    VENUS("Venus", 6051.8),
+    EARTH("Earth", 6371.0),
+    MARS("Mars", 3389.5),
+    JUPITER("Jupiter", 69911.0),
+    SATURN("Saturn", 58232.0),
+    URANUS("Uranus", 25362.0),
+    NEPTUNE("Neptune", 24622.0)
 }
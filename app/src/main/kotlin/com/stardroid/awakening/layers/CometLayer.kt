@@ -150,6 +150,14 @@ class CometLayer {
         cachedCount = verts.size / 7
     }
 
+    /**
+     * Orbital elements of every comet, as for [com.stardroid.awakening.renderer.OrbitElements]
+     * without the center: q (AU), e, i, omega, Omega (degrees), perihelion JD.
+     */
+    fun getOrbitElements(): List<DoubleArray> = comets.map { comet ->
+        doubleArrayOf(comet.q, comet.e, comet.iDeg, comet.omegaDeg, comet.bigOmegaDeg, comet.epochJd)
+    }
+
     /**
      * Compute heliocentric ecliptic position of a comet at given JD.
      * Returns (x, y, z) in AU or null if computation fails.
@@ -1,6 +1,7 @@
 package com.stardroid.awakening.layers
 
-import com.stardroid.awakening.control.AstronomerModel
+import com.stardroid.awakening.control.ObserverFrame
+import com.stardroid.awakening.math.Vector3
 import com.stardroid.awakening.renderer.DrawBatch
 import com.stardroid.awakening.renderer.Matrix
 import com.stardroid.awakening.renderer.PrimitiveType
@@ -10,8 +11,10 @@ import kotlin.math.sin
 /**
  * Generates horizon line and cardinal direction markers.
  *
- * The horizon is computed based on the observer's location and
- * transforms with the phone orientation.
+ * Built in celestial coordinates from the renderer's observer frame, the
+ * same one it clips and culls against, so the line sits on the visible
+ * horizon. The batch is rebuilt only when the frame's version or the
+ * segment count changes, and can be kept registered for culling.
  */
 class HorizonLayer {
 
@@ -24,90 +27,84 @@ class HorizonLayer {
     private val eastColor = floatArrayOf(1.0f, 1.0f, 0.2f, 1.0f)   // Yellow for East
     private val westColor = floatArrayOf(0.2f, 1.0f, 0.2f, 1.0f)   // Green for West
 
+    private val empty = DrawBatch(
+        type = PrimitiveType.LINES,
+        vertices = floatArrayOf(),
+        vertexCount = 0,
+        transform = Matrix.identity()
+    )
+
+    // Last batch and what it was built from
+    private var batch = empty
+    private var builtVersion = 0L
+    private var builtSegments = 0
+
     /**
      * Get horizon geometry as a DrawBatch.
      *
-     * The horizon is drawn in the local horizontal coordinate system
-     * (altitude-azimuth), which needs to be transformed to celestial
-     * coordinates based on the observer's location and time.
-     *
-     * For simplicity, we draw the horizon as a circle at altitude 0
-     * in local coordinates. The AstronomerModel handles the transformation.
+     * @param frame Observer frame from the renderer; nothing is drawn until there is one
+     * @param tessellationScale Fraction of the full segment count to use (frame budget)
      */
-    fun getHorizonBatch(model: AstronomerModel?): DrawBatch {
-        val vertices = mutableListOf<Float>()
+    fun getHorizonBatch(frame: ObserverFrame?, tessellationScale: Float = 1f): DrawBatch {
+        if (frame == null) return empty
 
-        // Draw horizon circle (at altitude = 0)
-        // In local horizontal coords: x = cos(az), y = sin(az), z = 0
-        // We need to convert to celestial coords, but for now draw in local frame
-        // The view matrix from AstronomerModel will handle the transformation
+        // Horizon circle - 180 segments at full quality
+        val segments = (HORIZON_SEGMENTS * tessellationScale).toInt().coerceIn(MIN_HORIZON_SEGMENTS, HORIZON_SEGMENTS)
+        if (frame.version == builtVersion && segments == builtSegments) return batch
 
-        // Horizon circle - 360 segments
-        for (azStep in 0 until 360 step 2) {
-            val az1Rad = Math.toRadians(azStep.toDouble())
-            val az2Rad = Math.toRadians((azStep + 2).toDouble())
+        val zenith = frame.zenith
+        val north = frame.north
+        val east = frame.east
+        // The visible horizon lies below the astronomical one by the plane's w (dip plus refraction)
+        val horizonHeight = -frame.horizonPlane(3)
 
-            // Horizon is at altitude 0, so z component is 0
-            // We draw slightly below (negative z in local coords) to be visible
-            val alt = -0.02f  // Slightly below horizon
-
-            vertices.add(cos(az1Rad).toFloat())
-            vertices.add(sin(az1Rad).toFloat())
-            vertices.add(alt)
-            vertices.addAll(horizonColor.toList())
-
-            vertices.add(cos(az2Rad).toFloat())
-            vertices.add(sin(az2Rad).toFloat())
-            vertices.add(alt)
-            vertices.addAll(horizonColor.toList())
+        val vertices = mutableListOf<Float>()
+        val stepDeg = 360.0 / segments
+        for (i in 0 until segments) {
+            addPoint(vertices, north, east, zenith, i * stepDeg, horizonHeight, horizonColor)
+            addPoint(vertices, north, east, zenith, (i + 1) * stepDeg, horizonHeight, horizonColor)
         }
 
         // Cardinal direction markers (vertical lines at N/S/E/W)
         val markerHeight = 0.15f
-
-        // North (azimuth = 0)
-        addCardinalMarker(vertices, 0.0, northColor, markerHeight)
-
-        // East (azimuth = 90)
-        addCardinalMarker(vertices, 90.0, eastColor, markerHeight)
-
-        // South (azimuth = 180)
-        addCardinalMarker(vertices, 180.0, southColor, markerHeight)
-
-        // West (azimuth = 270)
-        addCardinalMarker(vertices, 270.0, westColor, markerHeight)
+        for ((azimuthDeg, color) in listOf(0.0 to northColor, 90.0 to eastColor, 180.0 to southColor, 270.0 to westColor)) {
+            addPoint(vertices, north, east, zenith, azimuthDeg, horizonHeight, color)
+            addPoint(vertices, north, east, zenith, azimuthDeg, markerHeight, color)
+        }
 
         val vertexArray = vertices.toFloatArray()
-        val vertexCount = vertexArray.size / 7
-
-        return DrawBatch(
+        batch = DrawBatch(
             type = PrimitiveType.LINES,
             vertices = vertexArray,
-            vertexCount = vertexCount,
+            vertexCount = vertexArray.size / 7,
             transform = Matrix.identity()
         )
+        builtVersion = frame.version
+        builtSegments = segments
+        return batch
     }
 
-    private fun addCardinalMarker(
+    /** Point at an azimuth (degrees from north through east) and a height along the zenith. */
+    private fun addPoint(
         vertices: MutableList<Float>,
+        north: Vector3,
+        east: Vector3,
+        zenith: Vector3,
         azimuthDeg: Double,
-        color: FloatArray,
-        height: Float
+        height: Float,
+        color: FloatArray
     ) {
         val azRad = Math.toRadians(azimuthDeg)
-        val x = cos(azRad).toFloat()
-        val y = sin(azRad).toFloat()
-
-        // Bottom of marker (at horizon)
-        vertices.add(x)
-        vertices.add(y)
-        vertices.add(-0.02f)
+        val n = cos(azRad).toFloat()
+        val e = sin(azRad).toFloat()
+        vertices.add(n * north.x + e * east.x + height * zenith.x)
+        vertices.add(n * north.y + e * east.y + height * zenith.y)
+        vertices.add(n * north.z + e * east.z + height * zenith.z)
         vertices.addAll(color.toList())
+    }
 
-        // Top of marker
-        vertices.add(x)
-        vertices.add(y)
-        vertices.add(height)
-        vertices.addAll(color.toList())
+    companion object {
+        private const val HORIZON_SEGMENTS = 180
+        private const val MIN_HORIZON_SEGMENTS = 36
     }
 }
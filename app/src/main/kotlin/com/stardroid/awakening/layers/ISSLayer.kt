@@ -1,7 +1,7 @@
 package com.stardroid.awakening.layers
 
 import android.util.Log
-import com.stardroid.awakening.control.AstronomerModel
+import com.stardroid.awakening.control.ObserverFrame
 import com.stardroid.awakening.renderer.DrawBatch
 import com.stardroid.awakening.renderer.Matrix
 import com.stardroid.awakening.renderer.PrimitiveType
@@ -16,7 +16,7 @@ import kotlin.math.*
  *
  * Fetches lat/lon/alt from https://api.wheretheiss.at/v1/satellites/25544 every 10 seconds
  * on a background thread. Converts geodetic satellite position to a celestial direction
- * relative to the observer. Only shows when ISS is above the observer's horizon.
+ * relative to the observer. Only shows when ISS is above the observer's visible horizon.
  */
 class ISSLayer {
 
@@ -33,7 +33,18 @@ class ISSLayer {
     @Volatile private var running = false
 
     private val FETCH_INTERVAL_MS = 10_000L
-    private val EARTH_RADIUS_KM = 6371.0
+
+    private val empty = DrawBatch(
+        type = PrimitiveType.POINTS,
+        vertices = floatArrayOf(),
+        vertexCount = 0,
+        transform = Matrix.identity()
+    )
+
+    // Last batch and what it was built from
+    private var batch = empty
+    private var builtPosition: ISSPosition? = null
+    private var builtVersion = 0L
 
     fun start() {
         if (running) return
@@ -67,70 +78,56 @@ class ISSLayer {
     /**
      * Get ISS position as a DrawBatch.
      *
-     * @param model AstronomerModel for observer location and zenith
+     * The observer's site, sidereal time and visible horizon come from the
+     * renderer's observer frame, so the ISS hides at the same horizon the
+     * sky is clipped at. Rebuilt only when a new position arrives or the
+     * frame's version changes.
+     *
+     * @param frame Observer frame from the renderer
      * @return DrawBatch with 0 or 1 point
      */
-    fun getBatch(model: AstronomerModel?): DrawBatch {
-        val empty = DrawBatch(
-            type = PrimitiveType.POINTS,
-            vertices = floatArrayOf(),
-            vertexCount = 0,
-            transform = Matrix.identity()
-        )
-
-        val pos = cachedPosition.get() ?: return empty
-        if (model == null) return empty
-
-        val observerLat = model.location.latitude.toDouble()
-        val observerLon = model.location.longitude.toDouble()
-
-        // Convert ISS geodetic (lat/lon/alt) to ECEF
-        val issEcef = geodeticToEcef(pos.latDeg, pos.lonDeg, pos.altKm)
-
-        // Convert observer geodetic to ECEF (altitude ~0)
-        val obsEcef = geodeticToEcef(observerLat, observerLon, 0.0)
-
-        // Topocentric vector (ISS relative to observer in ECEF)
-        val dx = issEcef.first - obsEcef.first
-        val dy = issEcef.second - obsEcef.second
-        val dz = issEcef.third - obsEcef.third
-
-        // Check if above horizon: dot product with observer's "up" (outward from Earth center)
-        val obsLen = sqrt(obsEcef.first * obsEcef.first + obsEcef.second * obsEcef.second + obsEcef.third * obsEcef.third)
-        val upX = obsEcef.first / obsLen
-        val upY = obsEcef.second / obsLen
-        val upZ = obsEcef.third / obsLen
+    fun getBatch(frame: ObserverFrame?): DrawBatch {
+        val pos = cachedPosition.get()
+        if (pos == null || frame == null) return empty
+        if (pos === builtPosition && frame.version == builtVersion) return batch
+        batch = computeBatch(pos, frame)
+        builtPosition = pos
+        builtVersion = frame.version
+        return batch
+    }
 
-        val elevation = dx * upX + dy * upY + dz * upZ
-        if (elevation <= 0) return empty // Below horizon
+    private fun computeBatch(pos: ISSPosition, frame: ObserverFrame): DrawBatch {
+        // Topocentric vector (ISS relative to the observer's site) in ECEF
+        val issEcef = geodeticToEcef(pos.latDeg, pos.lonDeg, pos.altKm * 1000.0)
+        val dx = issEcef[0] - frame.siteEcef(0)
+        val dy = issEcef[1] - frame.siteEcef(1)
+        val dz = issEcef[2] - frame.siteEcef(2)
 
-        // Convert ECEF topocentric to ECI using GMST rotation
-        // GMST rotates around Z axis
-        val gmst = computeGMST(pos.timestamp)
+        // ECEF to celestial: rotate by the frame's Greenwich sidereal time around Z
+        val gmst = frame.greenwichSiderealRad
         val cosG = cos(gmst)
         val sinG = sin(gmst)
-
-        // ECI direction (rotate ECEF by -GMST around Z)
-        // Actually, ECEF to ECI: x_eci = x_ecef * cos(gmst) - y_ecef * sin(gmst)
         val eciX = dx * cosG - dy * sinG
         val eciY = dx * sinG + dy * cosG
         val eciZ = dz
 
         // Normalize to unit vector (celestial direction)
         val len = sqrt(eciX * eciX + eciY * eciY + eciZ * eciZ)
-        if (len < 0.001) return empty
+        if (len < 1.0) return empty
 
         val nx = (eciX / len).toFloat()
         val ny = (eciY / len).toFloat()
         val nz = (eciZ / len).toFloat()
 
-        val vertices = floatArrayOf(
-            nx, ny, nz, color[0], color[1], color[2], color[3]
-        )
+        // Below the visible horizon
+        if (nx * frame.horizonPlane(0) + ny * frame.horizonPlane(1) + nz * frame.horizonPlane(2) +
+            frame.horizonPlane(3) < 0f) {
+            return empty
+        }
 
         return DrawBatch(
             type = PrimitiveType.POINTS,
-            vertices = vertices,
+            vertices = floatArrayOf(nx, ny, nz, color[0], color[1], color[2], color[3]),
             vertexCount = 1,
             transform = Matrix.identity()
         )
@@ -161,33 +158,27 @@ class ISSLayer {
     }
 
     /**
-     * Convert geodetic coordinates to ECEF (Earth-Centered, Earth-Fixed).
-     * Simplified spherical Earth model.
+     * Geodetic coordinates to Earth-fixed ones (meters) on the WGS84
+     * ellipsoid, as observer_state.h places the site.
      */
-    private fun geodeticToEcef(latDeg: Double, lonDeg: Double, altKm: Double): Triple<Double, Double, Double> {
+    private fun geodeticToEcef(latDeg: Double, lonDeg: Double, altM: Double): DoubleArray {
         val latRad = Math.toRadians(latDeg)
         val lonRad = Math.toRadians(lonDeg)
-        val r = EARTH_RADIUS_KM + altKm
-
-        val x = r * cos(latRad) * cos(lonRad)
-        val y = r * cos(latRad) * sin(lonRad)
-        val z = r * sin(latRad)
-
-        return Triple(x, y, z)
-    }
-
-    /**
-     * Compute Greenwich Mean Sidereal Time in radians.
-     */
-    private fun computeGMST(timeMillis: Long): Double {
-        val jd = 2440587.5 + timeMillis / 86400000.0
-        val t = (jd - 2451545.0) / 36525.0
-        val gmstDeg = (280.46061837 + 360.98564736629 * (jd - 2451545.0) +
-                0.000387933 * t * t - t * t * t / 38710000.0).mod(360.0)
-        return Math.toRadians(gmstDeg)
+        val sinLat = sin(latRad)
+        val n = EARTH_A / sqrt(1.0 - EARTH_E2 * sinLat * sinLat)
+        return doubleArrayOf(
+            (n + altM) * cos(latRad) * cos(lonRad),
+            (n + altM) * cos(latRad) * sin(lonRad),
+            (n * (1.0 - EARTH_E2) + altM) * sinLat
+        )
     }
 
     companion object {
         private const val TAG = "ISSLayer"
+
+        // WGS84 ellipsoid (observer_state.h)
+        private const val EARTH_A = 6378137.0
+        private const val EARTH_F = 1.0 / 298.257223563
+        private const val EARTH_E2 = EARTH_F * (2.0 - EARTH_F)
     }
 }
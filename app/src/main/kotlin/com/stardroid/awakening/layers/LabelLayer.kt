@@ -0,0 +1,138 @@
+package com.stardroid.awakening.layers
+
+import android.graphics.Paint
+import com.stardroid.awakening.renderer.LabelCandidates
+import com.stardroid.awakening.renderer.LabelKind
+import com.stardroid.awakening.renderer.Matrix
+import com.stardroid.awakening.renderer.SkyLabel
+
+/** Labels accepted for one frame, in view pixels, highest priority first. */
+class PlacedLabels(
+    val texts: Array<String>,
+    /** Left edge and baseline of each label. */
+    val positions: FloatArray,
+    val count: Int,
+    /** Draw in the night palette's dim red. */
+    val nightMode: Boolean
+) {
+    companion object {
+        val EMPTY = PlacedLabels(emptyArray(), FloatArray(0), 0, false)
+    }
+}
+
+/**
+ * Object names, decluttered each frame by the native label placer.
+ *
+ * Catalogs and layers hand over their labels per kind with [setLabels].
+ * Each frame [collect] projects those in view to pixel boxes for
+ * [com.stardroid.awakening.vulkan.VulkanRenderer.placeLabels], and [place]
+ * turns the accepted ids into positioned text for the label overlay.
+ *
+ * Boxes are in swapchain pixels (the placer's grid); text is measured and
+ * drawn in view pixels, which differ when the resolution scale is below 1.
+ *
+ * Render thread only.
+ */
+class LabelLayer(textSizePixels: Float) {
+    private val paint = Paint(Paint.ANTI_ALIAS_FLAG).apply { textSize = textSizePixels }
+    private val textHeight = paint.fontMetrics.let { it.descent - it.ascent }
+    private val ascent = -paint.fontMetrics.ascent
+
+    private class LabelSet(val labels: List<SkyLabel>, val widths: FloatArray)
+
+    private val sets = arrayOfNulls<LabelSet>(LabelKind.entries.size)
+    private val visible = BooleanArray(LabelKind.entries.size)
+    private val candidates = LabelCandidates()
+    private val viewProjection = FloatArray(16)
+    private val clip = FloatArray(4)
+    private var pixelScale = 1f
+
+    /**
+     * Replace the labels of [kind]. Pass the same list again to keep them;
+     * text is only re-measured when the list changes.
+     */
+    fun setLabels(kind: LabelKind, labels: List<SkyLabel>) {
+        if (sets[kind.ordinal]?.labels === labels) return
+        require(labels.size <= ID_INDEX_MASK) { "Too many ${kind.name} labels: ${labels.size}" }
+        sets[kind.ordinal] = LabelSet(labels, FloatArray(labels.size) { paint.measureText(labels[it].text) })
+    }
+
+    fun setVisible(kind: LabelKind, show: Boolean) {
+        visible[kind.ordinal] = show
+    }
+
+    /**
+     * Project the visible labels in front of the camera and on screen.
+     *
+     * @param viewPixelScale Swapchain pixels per view pixel
+     * @param zenith Unit zenith; labels below the horizon are skipped. Null keeps them.
+     * @return Candidates for this frame, valid until the next call
+     */
+    fun collect(
+        view: FloatArray,
+        projection: FloatArray,
+        width: Int,
+        height: Int,
+        viewPixelScale: Float,
+        zenith: FloatArray?
+    ): LabelCandidates {
+        candidates.clear()
+        pixelScale = viewPixelScale
+        System.arraycopy(Matrix.multiply(projection, view), 0, viewProjection, 0, 16)
+        val m = viewProjection
+        for (kind in LabelKind.entries) {
+            if (!visible[kind.ordinal]) continue
+            val set = sets[kind.ordinal] ?: continue
+            for ((index, label) in set.labels.withIndex()) {
+                if (zenith != null && label.x * zenith[0] + label.y * zenith[1] + label.z * zenith[2] < 0f) continue
+                for (row in 0..3) {
+                    clip[row] = m[row] * label.x + m[row + 4] * label.y + m[row + 8] * label.z + m[row + 12]
+                }
+                val w = clip[3]
+                if (w <= 0f) continue
+                // Vulkan's clip space has y down, so NDC maps straight to pixel rows
+                val px = (clip[0] / w * 0.5f + 0.5f) * width
+                val py = (clip[1] / w * 0.5f + 0.5f) * height
+                if (px < 0f || px > width || py < 0f || py > height) continue
+
+                val boxWidth = set.widths[index] * viewPixelScale
+                val boxHeight = textHeight * viewPixelScale
+                val x = px + LABEL_OFFSET_PIXELS * viewPixelScale
+                val y = py - boxHeight * 0.5f
+                candidates.add(id(kind, index), x, y, boxWidth, boxHeight, label.magnitude, kind)
+            }
+        }
+        return candidates
+    }
+
+    /** Positioned text for the [accepted] ids of the last [collect]. */
+    fun place(accepted: IntArray, nightMode: Boolean): PlacedLabels {
+        if (accepted.isEmpty()) return PlacedLabels.EMPTY
+        val slots = HashMap<Int, Int>(candidates.count * 2)
+        for (slot in 0 until candidates.count) slots[candidates.ids[slot]] = slot
+
+        val texts = ArrayList<String>(accepted.size)
+        val positions = FloatArray(accepted.size * 2)
+        for (id in accepted) {
+            val slot = slots[id] ?: continue
+            val set = sets[id ushr ID_KIND_SHIFT] ?: continue
+            val label = set.labels.getOrNull(id and ID_INDEX_MASK) ?: continue
+            val box = slot * LabelCandidates.BOX_COMPONENTS
+            positions[texts.size * 2] = candidates.boxes[box] / pixelScale
+            positions[texts.size * 2 + 1] = candidates.boxes[box + 1] / pixelScale + ascent
+            texts.add(label.text)
+        }
+        return PlacedLabels(texts.toTypedArray(), positions, texts.size, nightMode)
+    }
+
+    companion object {
+        /** Ids are the kind in the top byte and the label's index below it, stable across frames. */
+        private const val ID_KIND_SHIFT = 24
+        private const val ID_INDEX_MASK = (1 shl ID_KIND_SHIFT) - 1
+
+        /** Gap between an object and the left edge of its label, in view pixels. */
+        private const val LABEL_OFFSET_PIXELS = 6f
+
+        private fun id(kind: LabelKind, index: Int): Int = (kind.ordinal shl ID_KIND_SHIFT) or index
+    }
+}
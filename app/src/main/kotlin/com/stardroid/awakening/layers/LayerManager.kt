@@ -16,7 +16,11 @@ enum class Layer(val displayName: String, val defaultVisible: Boolean) {
     ISS("ISS", false),
     COMETS("Comets", false),
     SKY_GRADIENT("Sky Gradient", true),
-    STAR_OF_BETHLEHEM("Star of Bethlehem", false)
+    STAR_OF_BETHLEHEM("Star of Bethlehem", false),
+    NIGHT_MODE("Night Mode", false),
+    GROUND("Ground", false),
+    ORBITS("Orbits", false),
+    LABELS("Labels", true)
 }
 
 /**
@@ -12,7 +12,8 @@ import kotlin.math.sin
  * Displays radiant points of major meteor showers.
  *
  * Active showers appear bright cyan, inactive ones are dim.
- * Positions are cached and refreshed every 60 seconds.
+ * Positions are cached and refreshed every 60 seconds, together with the
+ * radiants of the active showers that feed the live meteor simulation.
  */
 class MeteorShowerLayer {
 
@@ -48,6 +49,7 @@ class MeteorShowerLayer {
 
     private var cachedVertices: FloatArray = floatArrayOf()
     private var cachedCount: Int = 0
+    private var cachedRadiants: FloatArray = floatArrayOf()
     private var lastUpdateTime = 0L
     private val UPDATE_INTERVAL_MS = 60_000L
 
@@ -65,14 +67,24 @@ class MeteorShowerLayer {
         )
     }
 
+    /**
+     * Radiants of the showers active today, 4 floats each: x, y, z unit
+     * direction and the zenithal hourly rate, falling off linearly from the
+     * peak to the ends of the activity window.
+     */
+    fun getActiveRadiants(): FloatArray {
+        if (cachedCount == 0) getBatch()
+        return cachedRadiants
+    }
+
     private fun update() {
         val cal = Calendar.getInstance(TimeZone.getTimeZone("UTC"))
         val month = cal.get(Calendar.MONTH) + 1
         val day = cal.get(Calendar.DAY_OF_MONTH)
-        val dayOfYear = cal.get(Calendar.DAY_OF_YEAR)
 
         val verts = FloatArray(showers.size * 7)
         var offset = 0
+        val radiants = ArrayList<Float>()
 
         for (shower in showers) {
             val raRad = Math.toRadians(shower.raDeg)
@@ -92,12 +104,37 @@ class MeteorShowerLayer {
             verts[offset++] = color[1]
             verts[offset++] = color[2]
             verts[offset++] = color[3]
+
+            if (active) {
+                radiants += listOf(x, y, z, currentZhr(shower, month, day))
+            }
         }
 
         cachedVertices = verts
         cachedCount = showers.size
+        cachedRadiants = radiants.toFloatArray()
     }
 
+    private fun currentZhr(shower: Shower, month: Int, day: Int): Float {
+        val today = dayOfYear(month, day)
+        val peak = dayOfYear(shower.peakMonth, shower.peakDay)
+        val sinceStart = daysBetween(dayOfYear(shower.activeStartMonth, shower.activeStartDay), today)
+        val rising = daysBetween(dayOfYear(shower.activeStartMonth, shower.activeStartDay), peak)
+        val fraction = if (sinceStart <= rising) {
+            (sinceStart + 1f) / (rising + 1f)
+        } else {
+            val falling = daysBetween(peak, dayOfYear(shower.activeEndMonth, shower.activeEndDay))
+            (falling - daysBetween(peak, today) + 1f) / (falling + 1f)
+        }
+        return shower.zhr * fraction.coerceIn(0f, 1f)
+    }
+
+    /** Day of a non-leap year, 0-364 (a day more or less does not matter here). */
+    private fun dayOfYear(month: Int, day: Int): Int = MONTH_START[month - 1] + day - 1
+
+    /** Days from [from] forward to [to], wrapping around the year end. */
+    private fun daysBetween(from: Int, to: Int): Int = Math.floorMod(to - from, 365)
+
     private fun isActive(shower: Shower, month: Int, day: Int): Boolean {
         val current = month * 100 + day
         val start = shower.activeStartMonth * 100 + shower.activeStartDay
@@ -110,4 +147,8 @@ class MeteorShowerLayer {
             current >= start || current <= end
         }
     }
+
+    private companion object {
+        val MONTH_START = intArrayOf(0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334)
+    }
 }
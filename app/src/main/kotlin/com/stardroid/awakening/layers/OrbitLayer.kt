@@ -0,0 +1,42 @@
+package com.stardroid.awakening.layers
+
+import com.stardroid.awakening.ephemeris.Planet
+import com.stardroid.awakening.ephemeris.PlanetCalculator
+import com.stardroid.awakening.renderer.OrbitElements
+
+/**
+ * Orbit tracks of the planets and periodic comets: the paths they trace on
+ * the sky over time. Only the elements are gathered here; the tracks are
+ * sampled, cached and drawn natively (see orbit_cache.h).
+ */
+class OrbitLayer(private val cometLayer: CometLayer) {
+
+    private val planetColor = 0x80E0C060.toInt()
+    private val cometColor = 0x804DFFB3.toInt()
+
+    /** Elements of every orbit at Julian Date [jd]; planets' ids are their ordinals. */
+    fun getOrbits(jd: Double): OrbitElements {
+        val planets = Planet.entries.filter { it != Planet.EARTH }
+        val comets = cometLayer.getOrbitElements()
+        val count = planets.size + comets.size
+
+        val ids = IntArray(count)
+        val colors = IntArray(count)
+        val elements = DoubleArray(count * OrbitElements.ELEMENT_COMPONENTS)
+        var i = 0
+        fun add(id: Int, orbit: DoubleArray, color: Int) {
+            ids[i] = id
+            colors[i] = color
+            orbit.copyInto(elements, i * OrbitElements.ELEMENT_COMPONENTS)
+            elements[i * OrbitElements.ELEMENT_COMPONENTS + 6] = OrbitElements.CENTER_SUN.toDouble()
+            i++
+        }
+        for (planet in planets) add(planet.ordinal, PlanetCalculator.orbitalElements(planet, jd), planetColor)
+        comets.forEachIndexed { index, orbit -> add(COMET_ID_BASE + index, orbit, cometColor) }
+        return OrbitElements(ids, elements, colors, count)
+    }
+
+    private companion object {
+        const val COMET_ID_BASE = 100
+    }
+}
@@ -5,11 +5,15 @@ import com.stardroid.awakening.ephemeris.*
 import com.stardroid.awakening.renderer.DrawBatch
 import com.stardroid.awakening.renderer.Matrix
 import com.stardroid.awakening.renderer.PrimitiveType
+import com.stardroid.awakening.renderer.SkyLabel
+import com.stardroid.awakening.renderer.SolarSystemBodies
 
 /**
  * Layer showing Sun, Moon, and planets.
  *
  * Positions are calculated using ephemeris algorithms and updated per frame.
+ * Bodies are drawn as shaded discs ([getBodies]) where the renderer supports
+ * sphere impostors, and as points ([getSolarSystemBatch]) otherwise.
  */
 class SolarSystemLayer {
 
@@ -27,6 +31,7 @@ class SolarSystemLayer {
     // Cache positions to avoid recalculating every frame
     private var lastUpdateTime = 0L
     private var cachedPositions: List<SolarSystemObject> = emptyList()
+    private var cachedLabels: List<SkyLabel> = emptyList()
     private val UPDATE_INTERVAL_MS = 60_000L  // Update positions every minute
 
     data class SolarSystemObject(
@@ -38,20 +43,18 @@ class SolarSystemLayer {
         val g: Float,
         val b: Float,
         val a: Float,
-        val apparentSize: Float  // For future use with scaled rendering
+        val apparentSize: Float,  // For future use with scaled rendering
+        val distanceAu: Double,
+        val radiusKm: Double,
+        val limbDarkening: Float,
+        val emissive: Boolean = false
     )
 
     /**
      * Get current solar system objects as a DrawBatch.
      */
     fun getSolarSystemBatch(): DrawBatch {
-        val now = System.currentTimeMillis()
-
-        // Update positions if cache is stale
-        if (now - lastUpdateTime > UPDATE_INTERVAL_MS || cachedPositions.isEmpty()) {
-            updatePositions()
-            lastUpdateTime = now
-        }
+        refreshIfStale()
 
         if (cachedPositions.isEmpty()) {
             return DrawBatch(
@@ -84,6 +87,62 @@ class SolarSystemLayer {
         )
     }
 
+    /**
+     * Get current solar system objects as sphere impostors, with disc sizes
+     * and phases from the ephemeris.
+     */
+    fun getBodies(): SolarSystemBodies {
+        refreshIfStale()
+
+        val objects = cachedPositions
+        val sun = objects.firstOrNull { it.emissive }
+        if (sun == null) {
+            return SolarSystemBodies(floatArrayOf(), intArrayOf(), 0, floatArrayOf(0f, 0f, 0f, 1f))
+        }
+
+        val geometry = FloatArray(objects.size * SolarSystemBodies.GEOMETRY_COMPONENTS)
+        val styles = IntArray(objects.size * SolarSystemBodies.STYLE_COMPONENTS)
+        var g = 0
+        var s = 0
+        for (obj in objects) {
+            geometry[g++] = obj.x
+            geometry[g++] = obj.y
+            geometry[g++] = obj.z
+            geometry[g++] = obj.distanceAu.toFloat()
+            geometry[g++] = obj.radiusKm.toFloat()
+            geometry[g++] = obj.limbDarkening
+            styles[s++] = argb(obj)
+            styles[s++] = if (obj.emissive) SolarSystemBodies.FLAG_EMISSIVE else 0
+        }
+
+        return SolarSystemBodies(
+            geometry, styles, objects.size,
+            floatArrayOf(sun.x, sun.y, sun.z, sun.distanceAu.toFloat())
+        )
+    }
+
+    /**
+     * Names of the Sun, Moon and planets. The list only changes when the
+     * positions are refreshed, so the label layer re-measures rarely.
+     */
+    fun getLabels(): List<SkyLabel> {
+        refreshIfStale()
+        return cachedLabels
+    }
+
+    private fun argb(obj: SolarSystemObject): Int {
+        fun channel(v: Float) = (v * 255f + 0.5f).toInt().coerceIn(0, 255)
+        return (channel(obj.a) shl 24) or (channel(obj.r) shl 16) or (channel(obj.g) shl 8) or channel(obj.b)
+    }
+
+    private fun refreshIfStale() {
+        val now = System.currentTimeMillis()
+        if (now - lastUpdateTime > UPDATE_INTERVAL_MS || cachedPositions.isEmpty()) {
+            updatePositions()
+            lastUpdateTime = now
+        }
+    }
+
     private fun updatePositions() {
         try {
             val jd = JulianDate.now()
@@ -96,7 +155,11 @@ class SolarSystemLayer {
                 name = "Sun",
                 x = sunX, y = sunY, z = sunZ,
                 r = sunColor[0], g = sunColor[1], b = sunColor[2], a = sunColor[3],
-                apparentSize = 0.5f  // Sun is visually large
+                apparentSize = 0.5f,  // Sun is visually large
+                distanceAu = sunPos.distanceAu,
+                radiusKm = SUN_RADIUS_KM,
+                limbDarkening = SUN_LIMB_DARKENING,
+                emissive = true
             ))
 
             // Moon
@@ -106,7 +169,10 @@ class SolarSystemLayer {
                 name = "Moon",
                 x = moonX, y = moonY, z = moonZ,
                 r = moonColor[0], g = moonColor[1], b = moonColor[2], a = moonColor[3],
-                apparentSize = 0.5f  // Moon is visually large
+                apparentSize = 0.5f,  // Moon is visually large
+                distanceAu = moonPos.distanceAu,
+                radiusKm = MOON_RADIUS_KM,
+                limbDarkening = 0f
             ))
 
             // Planets
@@ -119,6 +185,8 @@ class SolarSystemLayer {
             addPlanet(objects, Planet.NEPTUNE, jd, neptuneColor)
 
             cachedPositions = objects
+            // Sun, Moon, then planets by distance from the Sun: the placer ranks by this "magnitude"
+            cachedLabels = objects.mapIndexed { i, obj -> SkyLabel(obj.name, obj.x, obj.y, obj.z, i.toFloat()) }
 
             Log.i(TAG, "Updated solar system positions: ${objects.size} objects")
             objects.take(3).forEach { obj ->
@@ -152,13 +220,23 @@ class SolarSystemLayer {
                 name = planet.displayName,
                 x = x, y = y, z = z,
                 r = color[0], g = color[1], b = color[2], a = color[3],
-                apparentSize = apparentSize
+                apparentSize = apparentSize,
+                distanceAu = pos.distanceAu,
+                radiusKm = planet.radiusKm,
+                limbDarkening = limbDarkening(planet)
             ))
         } catch (e: Exception) {
             Log.e(TAG, "Failed to calculate position for $planet", e)
         }
     }
 
+    // Gas giants darken toward the limb; rocky bodies follow their phase alone
+    private fun limbDarkening(planet: Planet): Float = when (planet) {
+        Planet.JUPITER, Planet.SATURN -> 0.3f
+        Planet.URANUS, Planet.NEPTUNE -> 0.2f
+        else -> 0f
+    }
+
     /**
      * Force position update (e.g., when time changes significantly).
      */
@@ -168,5 +246,11 @@ class SolarSystemLayer {
 
     companion object {
         private const val TAG = "SolarSystemLayer"
+
+        private const val SUN_RADIUS_KM = 695700.0
+        private const val MOON_RADIUS_KM = 1737.4
+
+        /** Linear limb darkening of the visible solar disc. */
+        private const val SUN_LIMB_DARKENING = 0.6f
     }
 }
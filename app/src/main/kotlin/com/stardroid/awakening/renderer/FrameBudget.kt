@@ -0,0 +1,127 @@
+package com.stardroid.awakening.renderer
+
+/** Quality knobs the frame budget governor can lower; ordinals match budget::Knob in frame_budget.h. */
+enum class QualityKnob {
+    STAR_DENSITY,
+    TESSELLATION,
+    LABEL_COUNT,
+    GLOW,
+    RESOLUTION_SCALE
+}
+
+/**
+ * Quality settings chosen by the native frame budget governor.
+ * Layers read these each frame and scale their work accordingly.
+ */
+data class RenderQuality(
+    /** Fraction of stars drawn, brightest first. */
+    val starFraction: Float = 1f,
+    /** Multiplier on segment counts of procedural lines. */
+    val tessellationScale: Float = 1f,
+    /** Label budget fraction (applied natively by placeLabels). */
+    val labelFraction: Float = 1f,
+    /** Whether additive glow passes (the integrated-light map) are drawn. */
+    val glow: Boolean = true,
+    /** Render resolution relative to the view size. */
+    val resolutionScale: Float = 1f
+) {
+    companion object {
+        val FULL = RenderQuality()
+
+        fun fromArray(values: FloatArray): RenderQuality {
+            if (values.size < 5) return FULL
+            return RenderQuality(values[0], values[1], values[2], values[3] != 0f, values[4])
+        }
+    }
+}
+
+/** One quality change made by the governor. */
+data class BudgetDecision(
+    val frame: Long,
+    val knob: QualityKnob,
+    /** Knob step after the change; 0 is full quality. */
+    val step: Int,
+    /** True if quality was lowered, false if restored. */
+    val degraded: Boolean,
+    /** Ordinal of the layer that triggered it, or -1 if none was attributable. */
+    val layer: Int,
+    /** Smoothed frame time (ms) when the decision was made. */
+    val frameMs: Float
+)
+
+/** Governor state for telemetry. */
+data class BudgetTelemetry(
+    val cpuMs: Float,
+    val gpuMs: Float,
+    val budgetMs: Float,
+    val frames: Long,
+    /** Fragment shader invocations per pixel (smoothed); 0 if the device cannot measure it. */
+    val overdraw: Float,
+    /** Most recent decisions, oldest first. */
+    val decisions: List<BudgetDecision>
+) {
+    companion object {
+        private const val HEADER_SIZE = 6
+        private const val DECISION_COMPONENTS = 6
+
+        /** Decode the layout written by nativeGetBudgetTelemetry. */
+        fun fromArray(values: DoubleArray): BudgetTelemetry? {
+            if (values.size < HEADER_SIZE) return null
+            val count = values[4].toInt()
+            val knobs = QualityKnob.values()
+            val decisions = (0 until count).mapNotNull { i ->
+                val o = HEADER_SIZE + i * DECISION_COMPONENTS
+                if (o + DECISION_COMPONENTS > values.size) return@mapNotNull null
+                BudgetDecision(
+                    frame = values[o].toLong(),
+                    knob = knobs.getOrNull(values[o + 1].toInt()) ?: return@mapNotNull null,
+                    step = values[o + 2].toInt(),
+                    degraded = values[o + 3] != 0.0,
+                    layer = values[o + 4].toInt(),
+                    frameMs = values[o + 5].toFloat()
+                )
+            }
+            return BudgetTelemetry(
+                cpuMs = values[0].toFloat(),
+                gpuMs = values[1].toFloat(),
+                budgetMs = values[2].toFloat(),
+                frames = values[3].toLong(),
+                overdraw = values[5].toFloat(),
+                decisions = decisions
+            )
+        }
+    }
+}
+
+/**
+ * Geometry saved by bounding-cap culling over the last frame, indexed by
+ * layer ordinal: vertices the layer's batches submitted and vertices drawn
+ * after chunks out of view (or below the ground) were skipped.
+ */
+class CullStats(
+    private val vertices: IntArray,
+    private val drawn: IntArray
+) {
+    /** Vertices the layer's batches held. */
+    fun submitted(layer: Int): Int = vertices.getOrElse(layer) { 0 }
+
+    /** Vertices of the layer actually drawn. */
+    fun drawn(layer: Int): Int = drawn.getOrElse(layer) { 0 }
+
+    /** Share of the layer's vertices culled, 0 if it drew nothing. */
+    fun savedFraction(layer: Int): Float {
+        val total = submitted(layer)
+        return if (total > 0) 1f - drawn(layer).toFloat() / total else 0f
+    }
+
+    companion object {
+        /** Decode the layout written by nativeGetCullStats: submitted then drawn, per layer. */
+        fun fromArray(values: IntArray): CullStats {
+            val layers = values.size / 2
+            return CullStats(
+                IntArray(layers) { values[2 * it] },
+                IntArray(layers) { values[2 * it + 1] }
+            )
+        }
+    }
+}
@@ -0,0 +1,76 @@
+package com.stardroid.awakening.renderer
+
+/** Label categories in placement priority order; ordinals match labels::Kind in label_placer.h. */
+enum class LabelKind {
+    PLANET,
+    CONSTELLATION,
+    DEEP_SKY,
+    STAR
+}
+
+/** A name drawn next to an object on the celestial sphere. */
+data class SkyLabel(
+    val text: String,
+    /** Unit vector toward the object. */
+    val x: Float,
+    val y: Float,
+    val z: Float,
+    /** Brightness; brighter labels win within a kind. */
+    val magnitude: Float
+) {
+    companion object {
+        /** Display form of a snake-cased catalog string id, e.g. "big_dipper" -> "Big Dipper". */
+        fun displayName(stringId: String): String =
+            stringId.split('_').filter { it.isNotEmpty() }.joinToString(" ") { word ->
+                word.replaceFirstChar { it.uppercaseChar() }
+            }
+    }
+}
+
+/**
+ * One frame's label candidates for native decluttering.
+ *
+ * Reused across frames: call [clear], [add] every label that could be shown,
+ * then pass it to [com.stardroid.awakening.vulkan.VulkanRenderer.placeLabels].
+ * Ids must be stable across frames so accepted labels stay put (hysteresis).
+ */
+class LabelCandidates(initialCapacity: Int = 256) {
+    var ids = IntArray(initialCapacity)
+        private set
+    var boxes = FloatArray(initialCapacity * BOX_COMPONENTS)
+        private set
+    var count = 0
+        private set
+
+    fun clear() {
+        count = 0
+    }
+
+    /**
+     * @param x Left edge of the label box in pixels
+     * @param y Top edge of the label box in pixels
+     * @param magnitude Brightness; brighter labels win within a [kind]
+     */
+    fun add(id: Int, x: Float, y: Float, width: Float, height: Float, magnitude: Float, kind: LabelKind) {
+        if (count == ids.size) {
+            // Doubling alone never grows an empty array
+            val capacity = maxOf(count * 2, MIN_GROWTH)
+            ids = ids.copyOf(capacity)
+            boxes = boxes.copyOf(capacity * BOX_COMPONENTS)
+        }
+        ids[count] = id
+        val offset = count * BOX_COMPONENTS
+        boxes[offset] = x
+        boxes[offset + 1] = y
+        boxes[offset + 2] = width
+        boxes[offset + 3] = height
+        boxes[offset + 4] = magnitude
+        boxes[offset + 5] = kind.ordinal.toFloat()
+        count++
+    }
+
+    companion object {
+        const val BOX_COMPONENTS = 6
+        private const val MIN_GROWTH = 16
+    }
+}
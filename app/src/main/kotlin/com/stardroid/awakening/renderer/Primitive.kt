@@ -6,7 +6,8 @@ enum class PrimitiveType {
     LINES,       // Constellation lines, grids
     TRIANGLES,   // Filled shapes
     TEXT,        // Labels (future)
-    IMAGE        // Textures (future)
+    IMAGE,       // Textures (future)
+    STARS        // Stars with packed color-index vertices (see StarVertex)
 }
 
 /**
@@ -29,10 +30,145 @@ data class Vertex(
     }
 }
 
+/**
+ * Packed star vertex for [PrimitiveType.STARS].
+ *
+ * Layout: x, y, z, packed (4 floats per vertex). The packed word holds four
+ * bytes: color index into [StarPalette], alpha, and two reserved bytes. The
+ * top byte stays below 0x7f so the word is never a NaN bit pattern.
+ */
+object StarVertex {
+    const val COMPONENTS = 4
+    const val STRIDE_BYTES = COMPONENTS * 4
+
+    fun pack(colorIndex: Int, alpha: Float): Float {
+        val alphaByte = (alpha * 255f + 0.5f).toInt().coerceIn(0, 255)
+        return Float.fromBits((colorIndex and 0xFF) or (alphaByte shl 8))
+    }
+}
+
+/**
+ * Deep-sky objects for the instanced DSO pipeline, uploaded once and drawn in a
+ * single call. Per object, [geometry] holds [GEOMETRY_COMPONENTS] floats
+ * (RA deg, Dec deg, major axis arcmin, minor axis arcmin, position angle deg)
+ * and [styles] holds [STYLE_COMPONENTS] ints (source.proto Shape, ARGB color).
+ * Axes of 0 draw the object at the renderer's minimum glyph size.
+ */
+class DeepSkyObjects(
+    val geometry: FloatArray,
+    val styles: IntArray,
+    val count: Int
+) {
+    companion object {
+        const val GEOMETRY_COMPONENTS = 5
+        const val STYLE_COMPONENTS = 2
+    }
+}
+
+/**
+ * Sun, Moon and planets for the sphere impostor pipeline, rebuilt whenever
+ * positions change and drawn as one quad each. Per body, [geometry] holds
+ * [GEOMETRY_COMPONENTS] floats (x, y, z unit direction, distance AU, radius
+ * km, limb darkening coefficient) and [styles] holds [STYLE_COMPONENTS] ints
+ * (ARGB color, flags). [sun] is the Sun's unit direction and distance (AU),
+ * which sets every body's phase.
+ */
+class SolarSystemBodies(
+    val geometry: FloatArray,
+    val styles: IntArray,
+    val count: Int,
+    val sun: FloatArray
+) {
+    companion object {
+        const val GEOMETRY_COMPONENTS = 6
+        const val STYLE_COMPONENTS = 2
+
+        // Flags; keep in sync with body_impostor.h
+        const val FLAG_EMISSIVE = 1 shl 0
+    }
+}
+
+/**
+ * Fixed sky objects for the native object store, uploaded once; culling,
+ * picking, search and vertex packing then run natively. Per object,
+ * [geometry] holds [GEOMETRY_COMPONENTS] floats (x, y, z unit direction,
+ * magnitude) and [attributes] holds [ATTRIBUTE_COMPONENTS] ints (see
+ * [style], name id or [NO_NAME], layer ordinal).
+ */
+class SkyObjects(
+    val geometry: FloatArray,
+    val attributes: IntArray,
+    val count: Int
+) {
+    companion object {
+        const val GEOMETRY_COMPONENTS = 4
+        const val ATTRIBUTE_COMPONENTS = 3
+        const val NO_NAME = -1
+
+        // Type flags; keep in sync with sky_store.h
+        const val FLAG_STAR = 1 shl 0
+        const val FLAG_DEEP_SKY = 1 shl 1
+        const val FLAG_SOLAR_SYSTEM = 1 shl 2
+        const val FLAG_NAMED = 1 shl 8
+
+        /** Pack palette color index, alpha and type flags into the style attribute. */
+        fun style(colorIndex: Int, alpha: Float, flags: Int): Int {
+            val alphaByte = (alpha * 255f + 0.5f).toInt().coerceIn(0, 255)
+            return (colorIndex and 0xFF) or (alphaByte shl 8) or ((flags and 0xFFFF) shl 16)
+        }
+    }
+}
+
+/**
+ * Light curves of variable objects in the uploaded [SkyObjects], evaluated
+ * natively each frame. Per curve, [ids] holds [ID_COMPONENTS] ints (index in
+ * the [SkyObjects], kind) and [elements] holds [ELEMENT_COMPONENTS] doubles
+ * (epoch JD, period days, maximum magnitude, amplitude, shape); see
+ * light_curve.h for what epoch, period and shape mean for each kind.
+ */
+class LightCurves(
+    val ids: IntArray,
+    val elements: DoubleArray,
+    val count: Int
+) {
+    companion object {
+        const val ID_COMPONENTS = 2
+        const val ELEMENT_COMPONENTS = 5
+
+        // Kinds; keep in sync with variability::Kind in light_curve.h
+        const val KIND_PULSATING = 0
+        const val KIND_ECLIPSING = 1
+        const val KIND_ERUPTIVE = 2
+    }
+}
+
+/**
+ * Orbits whose sky tracks are sampled, cached and drawn natively. Per
+ * orbit, [ids] holds a stable key, [colors] an ARGB line color and
+ * [elements] holds [ELEMENT_COMPONENTS] doubles: pericenter distance (AU),
+ * eccentricity, inclination, argument of pericenter and ascending node
+ * (degrees, ecliptic J2000), time of pericenter (JD) and center.
+ */
+class OrbitElements(
+    val ids: IntArray,
+    val elements: DoubleArray,
+    val colors: IntArray,
+    val count: Int
+) {
+    companion object {
+        const val ELEMENT_COMPONENTS = 7
+
+        // Centers; keep in sync with orbits::Center in orbit_cache.h
+        const val CENTER_SUN = 0
+        const val CENTER_EARTH = 1
+    }
+}
+
 /**
  * A batch of primitives to draw.
  *
- * Vertices are packed as [x,y,z,r,g,b,a, x,y,z,r,g,b,a, ...]
+ * Vertices are packed as [x,y,z,r,g,b,a, x,y,z,r,g,b,a, ...], except for
+ * [PrimitiveType.STARS] which uses the 4-float [StarVertex] layout.
  */
 data class DrawBatch(
     val type: PrimitiveType,
@@ -0,0 +1,106 @@
+package com.stardroid.awakening.renderer
+
+import kotlin.math.ln
+import kotlin.math.pow
+
+/**
+ * Star color lookup table.
+ *
+ * Star color is a function of a single color index, so star vertices carry
+ * one byte indexing this table instead of four color floats. Entry i covers
+ * B-V = MIN_BV + i * BV_STEP; the table is uploaded to the renderer's uniform
+ * buffer and evaluated in star.vert, so switching palettes (e.g. night mode)
+ * never touches the star vertex data.
+ */
+object StarPalette {
+    const val SIZE = 256
+    const val MIN_BV = -0.4f
+    const val MAX_BV = 2.0f
+    private const val BV_STEP = (MAX_BV - MIN_BV) / (SIZE - 1)
+
+    /** Natural star colors, RGBA packed as SIZE * 4 floats. */
+    val natural: FloatArray by lazy { build { bv -> bvToRgb(bv) } }
+
+    /** Dark-adapted palette: luminance of the natural color in the red channel only. */
+    val nightRed: FloatArray by lazy {
+        val source = natural
+        FloatArray(SIZE * 4).also { out ->
+            for (i in 0 until SIZE) {
+                val luminance = 0.2126f * source[i * 4] + 0.7152f * source[i * 4 + 1] + 0.0722f * source[i * 4 + 2]
+                out[i * 4] = luminance
+                out[i * 4 + 3] = 1f
+            }
+        }
+    }
+
+    /** Color-index slot for a B-V value, clamped to the table range. */
+    fun indexForBv(bv: Float): Int {
+        return ((bv - MIN_BV) / BV_STEP + 0.5f).toInt().coerceIn(0, SIZE - 1)
+    }
+
+    // Catalogs usually contain only a handful of distinct colors
+    private val colorCache = HashMap<Int, Int>()
+
+    /**
+     * Nearest natural-palette slot for an RGB color, for catalogs that store
+     * colors rather than B-V. Compares chromaticity, so brightness is ignored.
+     */
+    @Synchronized
+    fun indexForColor(r: Float, g: Float, b: Float): Int {
+        val key = ((r * 255f).toInt() shl 16) or ((g * 255f).toInt() shl 8) or (b * 255f).toInt()
+        return colorCache.getOrPut(key) {
+            val scale = 1f / maxOf(r, g, b, 1e-6f)
+            val nr = r * scale
+            val ng = g * scale
+            val nb = b * scale
+            val palette = natural
+            var best = 0
+            var bestDistance = Float.MAX_VALUE
+            for (i in 0 until SIZE) {
+                val dr = palette[i * 4] - nr
+                val dg = palette[i * 4 + 1] - ng
+                val db = palette[i * 4 + 2] - nb
+                val distance = dr * dr + dg * dg + db * db
+                if (distance < bestDistance) {
+                    bestDistance = distance
+                    best = i
+                }
+            }
+            best
+        }
+    }
+
+    private fun build(color: (Float) -> FloatArray): FloatArray {
+        val out = FloatArray(SIZE * 4)
+        for (i in 0 until SIZE) {
+            val rgb = color(MIN_BV + i * BV_STEP)
+            out[i * 4] = rgb[0]
+            out[i * 4 + 1] = rgb[1]
+            out[i * 4 + 2] = rgb[2]
+            out[i * 4 + 3] = 1f
+        }
+        return out
+    }
+
+    /**
+     * B-V to RGB via effective temperature (Ballesteros 2012) and a blackbody
+     * RGB fit, normalized so the brightest channel is 1.
+     */
+    private fun bvToRgb(bv: Float): FloatArray {
+        val t = 4600.0 * (1.0 / (0.92 * bv + 1.7) + 1.0 / (0.92 * bv + 0.62))
+        val t100 = t / 100.0
+
+        val r = if (t100 <= 66.0) 255.0 else 329.698727446 * (t100 - 60.0).pow(-0.1332047592)
+        val g = if (t100 <= 66.0) 99.4708025861 * ln(t100) - 161.1195681661
+                else 288.1221695283 * (t100 - 60.0).pow(-0.0755148492)
+        val b = when {
+            t100 >= 66.0 -> 255.0
+            t100 <= 19.0 -> 0.0
+            else -> 138.5177312231 * ln(t100 - 10.0) - 305.0447927307
+        }
+
+        val rgb = doubleArrayOf(r, g, b).map { it.coerceIn(0.0, 255.0) }
+        val max = rgb.max().coerceAtLeast(1.0)
+        return FloatArray(3) { (rgb[it] / max).toFloat() }
+    }
+}
@@ -4,6 +4,7 @@ import android.util.Log
 import com.stardroid.awakening.renderer.DrawBatch
 import com.stardroid.awakening.renderer.Matrix
 import com.stardroid.awakening.renderer.PrimitiveType
+import com.stardroid.awakening.renderer.StarVertex
 import kotlin.math.*
 
 /**
@@ -11,6 +12,8 @@ import kotlin.math.*
  *
  * Stars are organized into HEALPix pixels for efficient frustum culling.
  * Only stars in pixels that overlap the current field of view are rendered.
+ * Each pixel keeps its stars brightest first, so a reduced star density
+ * (frame budget) draws the brightest part of every pixel.
  */
 class SpatialStarIndex {
 
@@ -18,12 +21,10 @@ class SpatialStarIndex {
         val x: Float,
         val y: Float,
         val z: Float,
-        val r: Float,
-        val g: Float,
-        val b: Float,
-        val a: Float,
+        val packedColor: Float,  // StarVertex.pack(colorIndex, alpha)
         val raDeg: Double,
         val decDeg: Double,
+        val size: Int,  // Catalog point size; larger is brighter
         val name: String?
     )
 
@@ -61,6 +62,10 @@ class SpatialStarIndex {
             pixelMap.getOrPut(pixel) { mutableListOf() }.add(star)
         }
 
+        for (pixelStars in pixelMap.values) {
+            pixelStars.sortByDescending { it.size }
+        }
+
         pixelToStars = pixelMap
         isIndexed = true
 
@@ -74,9 +79,10 @@ class SpatialStarIndex {
      * @param lookRaDeg RA of view center in degrees
      * @param lookDecDeg Dec of view center in degrees
      * @param fovDeg Field of view diameter in degrees
+     * @param starFraction Fraction of each pixel's stars to return, brightest first
      * @return List of stars within the field of view
      */
-    fun getVisibleStars(lookRaDeg: Double, lookDecDeg: Double, fovDeg: Double): List<Star> {
+    fun getVisibleStars(lookRaDeg: Double, lookDecDeg: Double, fovDeg: Double, starFraction: Float = 1f): List<Star> {
         if (!isIndexed) return allStars
 
         val hp = healpix ?: return allStars
@@ -98,7 +104,14 @@ class SpatialStarIndex {
         // Collect stars from visible pixels
         val result = mutableListOf<Star>()
         for (pixel in visiblePixels) {
-            pixelToStars[pixel]?.let { result.addAll(it) }
+            pixelToStars[pixel]?.let { pixelStars ->
+                if (starFraction >= 1f) {
+                    result.addAll(pixelStars)
+                } else {
+                    val count = ceil(pixelStars.size * starFraction).toInt()
+                    result.addAll(pixelStars.subList(0, count.coerceIn(0, pixelStars.size)))
+                }
+            }
         }
 
         return result
@@ -111,8 +124,9 @@ class SpatialStarIndex {
      * @param lookY View direction Y component
      * @param lookZ View direction Z component
      * @param fovDeg Field of view in degrees
+     * @param starFraction Fraction of stars to draw, brightest first
      */
-    fun getVisibleStarBatch(lookX: Float, lookY: Float, lookZ: Float, fovDeg: Float): DrawBatch {
+    fun getVisibleStarBatch(lookX: Float, lookY: Float, lookZ: Float, fovDeg: Float, starFraction: Float = 1f): DrawBatch {
         if (!isIndexed) {
             return getAllStarsBatch()
         }
@@ -123,7 +137,7 @@ class SpatialStarIndex {
             if (it < 0) it + 360.0 else it
         }
 
-        val visibleStars = getVisibleStars(lookRa, lookDec, fovDeg.toDouble())
+        val visibleStars = getVisibleStars(lookRa, lookDec, fovDeg.toDouble(), starFraction)
 
         return createBatch(visibleStars)
     }
@@ -138,28 +152,25 @@ class SpatialStarIndex {
     private fun createBatch(stars: List<Star>): DrawBatch {
         if (stars.isEmpty()) {
             return DrawBatch(
-                type = PrimitiveType.POINTS,
+                type = PrimitiveType.STARS,
                 vertices = floatArrayOf(),
                 vertexCount = 0,
                 transform = Matrix.identity()
             )
         }
 
-        val vertices = FloatArray(stars.size * 7)
+        val vertices = FloatArray(stars.size * StarVertex.COMPONENTS)
         var offset = 0
 
         for (star in stars) {
             vertices[offset++] = star.x
             vertices[offset++] = star.y
             vertices[offset++] = star.z
-            vertices[offset++] = star.r
-            vertices[offset++] = star.g
-            vertices[offset++] = star.b
-            vertices[offset++] = star.a
+            vertices[offset++] = star.packedColor
         }
 
         return DrawBatch(
-            type = PrimitiveType.POINTS,
+            type = PrimitiveType.STARS,
             vertices = vertices,
             vertexCount = stars.size,
             transform = Matrix.identity()
@@ -0,0 +1,60 @@
+package com.stardroid.awakening.ui
+
+import android.content.Context
+import android.graphics.Canvas
+import android.graphics.Color
+import android.graphics.Paint
+import android.util.TypedValue
+import android.view.View
+import com.stardroid.awakening.layers.PlacedLabels
+
+/**
+ * Draws the object names the native label placer accepted, over the sky.
+ *
+ * The render thread places them each frame (see
+ * [com.stardroid.awakening.layers.LabelLayer]); this view only draws the
+ * latest result.
+ */
+class LabelOverlay(context: Context) : View(context) {
+
+    /** Text size in pixels; the label layer measures boxes with the same size. */
+    val textSizePixels = TypedValue.applyDimension(
+        TypedValue.COMPLEX_UNIT_SP, TEXT_SIZE_SP, resources.displayMetrics
+    )
+
+    private val paint = Paint(Paint.ANTI_ALIAS_FLAG).apply { textSize = textSizePixels }
+
+    private var labels = PlacedLabels.EMPTY
+
+    init {
+        // Labels never take touches from the sky view below
+        isClickable = false
+        isFocusable = false
+    }
+
+    /** Show [placed]; safe to call from any thread. */
+    fun update(placed: PlacedLabels) {
+        post {
+            labels = placed
+            invalidate()
+        }
+    }
+
+    override fun onDraw(canvas: Canvas) {
+        super.onDraw(canvas)
+        val placed = labels
+        paint.color = if (placed.nightMode) NIGHT_COLOR else DAY_COLOR
+        for (i in 0 until placed.count) {
+            canvas.drawText(placed.texts[i], placed.positions[i * 2], placed.positions[i * 2 + 1], paint)
+        }
+    }
+
+    companion object {
+        private const val TEXT_SIZE_SP = 12f
+
+        private val DAY_COLOR = Color.argb(200, 200, 210, 230)
+
+        /** Dim red, like the night star palette. */
+        private val NIGHT_COLOR = Color.argb(200, 170, 30, 20)
+    }
+}
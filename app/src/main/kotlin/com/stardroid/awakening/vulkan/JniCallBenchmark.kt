@@ -0,0 +1,52 @@
+package com.stardroid.awakening.vulkan
+
+import dalvik.annotation.optimization.CriticalNative
+import dalvik.annotation.optimization.FastNative
+
+/**
+ * Microbenchmark of the JNI call kinds used by [VulkanRenderer]: a regular
+ * call, @FastNative and @CriticalNative, each reaching the same trivial
+ * native body, so the timings differ only in the transition.
+ *
+ * Not run by the app; enable VulkanSurfaceView.BENCHMARK_JNI_CALLS to log
+ * it once the native library is loaded.
+ */
+object JniCallBenchmark {
+    /** Nanoseconds per call of each kind. */
+    data class Result(val regularNs: Double, val fastNs: Double, val criticalNs: Double) {
+        override fun toString(): String =
+            "JNI call: regular %.1f ns, @FastNative %.1f ns (%.1fx), @CriticalNative %.1f ns (%.1fx)".format(
+                regularNs, fastNs, regularNs / fastNs, criticalNs, regularNs / criticalNs
+            )
+    }
+
+    /**
+     * Time [calls] calls of each kind, after as many warm-up calls (so the
+     * loops are compiled). Runs on the calling thread.
+     */
+    fun run(calls: Int = 1_000_000): Result {
+        time(calls, ::nativeRegular)
+        time(calls, ::nativeFast)
+        time(calls, ::nativeCritical)
+        return Result(
+            regularNs = time(calls, ::nativeRegular),
+            fastNs = time(calls, ::nativeFast),
+            criticalNs = time(calls, ::nativeCritical)
+        )
+    }
+
+    private inline fun time(calls: Int, call: (Long) -> Long): Double {
+        var value = 0L
+        val start = System.nanoTime()
+        for (i in 0 until calls) {
+            value = call(value)
+        }
+        val elapsed = System.nanoTime() - start
+        check(value == calls.toLong())  // Keeps the calls from being optimized away
+        return elapsed.toDouble() / calls
+    }
+
+    @JvmStatic private external fun nativeRegular(value: Long): Long
+    @JvmStatic @FastNative private external fun nativeFast(value: Long): Long
+    @JvmStatic @CriticalNative private external fun nativeCritical(value: Long): Long
+}
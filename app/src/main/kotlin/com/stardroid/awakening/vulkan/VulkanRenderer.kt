@@ -1,9 +1,24 @@
 package com.stardroid.awakening.vulkan
 
+import android.content.res.AssetManager
 import android.view.Surface
+import com.stardroid.awakening.control.ObserverFrame
+import com.stardroid.awakening.math.LatLong
+import com.stardroid.awakening.renderer.BudgetTelemetry
+import com.stardroid.awakening.renderer.CullStats
+import com.stardroid.awakening.renderer.DeepSkyObjects
 import com.stardroid.awakening.renderer.DrawBatch
+import com.stardroid.awakening.renderer.LabelCandidates
+import com.stardroid.awakening.renderer.LightCurves
 import com.stardroid.awakening.renderer.Matrix
+import com.stardroid.awakening.renderer.OrbitElements
+import com.stardroid.awakening.renderer.QualityKnob
+import com.stardroid.awakening.renderer.RenderQuality
 import com.stardroid.awakening.renderer.RendererInterface
+import com.stardroid.awakening.renderer.SkyObjects
+import com.stardroid.awakening.renderer.SolarSystemBodies
+import dalvik.annotation.optimization.CriticalNative
+import dalvik.annotation.optimization.FastNative
 
 /**
  * Vulkan implementation of RendererInterface.
@@ -21,6 +36,14 @@ class VulkanRenderer : RendererInterface {
     private var projectionMatrix: FloatArray = Matrix.identity()
     private var matricesDirty: Boolean = true
 
+    // Batches registered for culling by drawRegistered, by layer
+    private class RegisteredBatch(val batch: DrawBatch, val id: Int)
+    private val registeredBatches = HashMap<Int, RegisteredBatch>()
+
+    // Observer state from the native side, re-read when its version changes
+    private val observerValues = DoubleArray(ObserverFrame.COMPONENTS)
+    private var observerFrame: ObserverFrame? = null
+
     // RendererInterface implementation
 
     override fun initialize(surface: Surface, width: Int, height: Int): Boolean {
@@ -47,6 +70,9 @@ class VulkanRenderer : RendererInterface {
             nativeDestroy(nativeContext)
             nativeContext = 0
         }
+        registeredBatches.clear()
+        // Versions restart with a new context
+        observerFrame = null
     }
 
     override fun beginFrame(): Boolean {
@@ -82,6 +108,41 @@ class VulkanRenderer : RendererInterface {
         )
     }
 
+    /**
+     * Draw a layer's batch whose vertices stay the same from frame to frame
+     * (grid, ecliptic, constellation lines). The first call registers it
+     * natively, split into chunks with bounding caps; after that only the
+     * chunks in view are drawn, and nothing is copied across JNI. A batch
+     * with a different vertex array or transform replaces the layer's
+     * previous one. Batches rebuilt every frame go through [draw], which
+     * culls them as they come.
+     */
+    fun drawRegistered(layer: Int, batch: DrawBatch) {
+        if (!inFrame || batch.vertexCount == 0) return
+        var registered = registeredBatches[layer]
+        if (registered == null || registered.batch.vertices !== batch.vertices ||
+            registered.batch.vertexCount != batch.vertexCount || registered.batch.type != batch.type ||
+            !registered.batch.transform.contentEquals(batch.transform)) {
+            registered?.let { Critical.nativeUnregisterBatch(nativeContext, it.id) }
+            val id = nativeRegisterBatch(
+                nativeContext,
+                layer,
+                batch.type.ordinal,
+                batch.vertices,
+                batch.vertexCount,
+                batch.transform
+            )
+            if (id < 0) {
+                registeredBatches.remove(layer)
+                draw(batch)
+                return
+            }
+            registered = RegisteredBatch(batch, id)
+            registeredBatches[layer] = registered
+        }
+        Critical.nativeDrawRegistered(nativeContext, registered.id, batch.type.ordinal)
+    }
+
     override fun setViewMatrix(matrix: FloatArray) {
         viewMatrix = matrix.copyOf()
         matricesDirty = true
@@ -97,10 +158,353 @@ class VulkanRenderer : RendererInterface {
      */
     fun setBackgroundOpacity(opacity: Float) {
         if (nativeContext != 0L) {
-            nativeSetBackgroundOpacity(nativeContext, opacity.coerceIn(0f, 1f))
+            Critical.nativeSetBackgroundOpacity(nativeContext, opacity.coerceIn(0f, 1f))
+        }
+    }
+
+    /**
+     * Set the observer's location and clock. The local frame, refraction
+     * and visible horizon used by horizon clipping, scintillation and meteor
+     * rates are derived natively and recomputed only when the location or
+     * time moves past small thresholds, so this is cheap to call every frame.
+     * [getObserverFrame] returns the result for anything drawn against it.
+     *
+     * @param location Geodetic latitude and longitude
+     * @param timeMillis Unix time in milliseconds
+     * @param altitudeMeters Height above the ellipsoid (raises the horizon dip)
+     */
+    fun setObserver(location: LatLong, timeMillis: Long, altitudeMeters: Double = 0.0) {
+        if (nativeContext != 0L) {
+            Critical.nativeSetObserver(
+                nativeContext,
+                location.latitude.toDouble(),
+                location.longitude.toDouble(),
+                altitudeMeters,
+                timeMillis
+            )
+        }
+    }
+
+    /**
+     * The observer state derived from [setObserver], or null until it is
+     * set. The same instance is returned until its version changes, so it is
+     * cheap to call every frame.
+     */
+    fun getObserverFrame(): ObserverFrame? {
+        if (nativeContext == 0L) return null
+        val version = Critical.nativeGetObserverVersion(nativeContext)
+        if (version == 0L) return null
+        observerFrame?.let { if (it.version == version) return it }
+        val copied = nativeGetObserverFrame(nativeContext, observerValues)
+        return ObserverFrame.fromArray(observerValues, copied).also { observerFrame = it }
+    }
+
+    /**
+     * Hide the sky below the visible horizon of the observer from
+     * [setObserver] (and the terrain skyline from [setHorizonProfile]), or
+     * show all of it again. Nothing is clipped until the observer is set.
+     * Lines and triangles are clipped on the GPU where supported; stars and
+     * deep-sky objects below the horizon are culled before they are drawn.
+     */
+    fun setHorizonClip(enabled: Boolean) {
+        if (nativeContext != 0L) {
+            Critical.nativeSetHorizonClip(nativeContext, enabled)
+        }
+    }
+
+    /**
+     * Make stars twinkle, more strongly the nearer they are to the horizon
+     * of the observer from [setObserver]. The animation runs in the star
+     * shader; stars stay steady until the observer is set.
+     */
+    fun setScintillation(enabled: Boolean) {
+        if (nativeContext != 0L) {
+            Critical.nativeSetScintillation(nativeContext, enabled)
+        }
+    }
+
+    /**
+     * Set the site's terrain skyline, used while horizon clipping is on.
+     * Points are interpolated linearly in azimuth; empty arrays restore the
+     * flat horizon.
+     *
+     * @param azimuthsDeg Azimuth of each point, degrees from north through east
+     * @param altitudesDeg Skyline altitude at each point, degrees
+     * @return false if the arrays differ in length or an altitude is out of range
+     */
+    fun setHorizonProfile(azimuthsDeg: FloatArray, altitudesDeg: FloatArray): Boolean {
+        if (nativeContext == 0L) return false
+        return nativeSetHorizonProfile(nativeContext, azimuthsDeg, altitudesDeg)
+    }
+
+    /**
+     * Replace the star color LUT used by [com.stardroid.awakening.renderer.PrimitiveType.STARS]
+     * batches. Takes effect on the next frame without re-uploading star vertices.
+     *
+     * @param palette StarPalette.SIZE RGBA entries (e.g. StarPalette.natural)
+     */
+    fun setStarPalette(palette: FloatArray) {
+        if (nativeContext != 0L) {
+            nativeSetStarPalette(nativeContext, palette)
         }
     }
 
+    /**
+     * Load the lightmap.binary asset natively without blocking: reading,
+     * parsing and patch generation run on worker threads and the map for
+     * the limit from [setStarLimitingMagnitude] is uploaded at the start of
+     * a later frame, replacing any current map.
+     *
+     * @param preferredOrder HEALPix order to draw at when several are available
+     * @param gain Surface brightness scale applied before tone mapping
+     * @return false if the asset is missing or the renderer is not initialized
+     */
+    fun loadLightMapAsync(assets: AssetManager, preferredOrder: Int, gain: Float): Boolean {
+        if (nativeContext == 0L) return false
+        return nativeLoadLightMapAsync(nativeContext, assets, preferredOrder, gain)
+    }
+
+    /**
+     * Set the faint limit of the stars drawn as points. The light map glow
+     * covers the stars fainter than it; when the limit selects a different
+     * map, that map is rebuilt in the background and replaces the current
+     * one a few frames later. Cheap to call every frame.
+     */
+    fun setStarLimitingMagnitude(magnitude: Float) {
+        if (nativeContext != 0L) {
+            Critical.nativeSetStarLimitingMagnitude(nativeContext, magnitude)
+        }
+    }
+
+    /**
+     * Draw the uploaded light map as an additive background pass.
+     * Call first in a frame so individual stars draw on top.
+     */
+    fun drawLightMap() {
+        if (!inFrame) return
+        Critical.nativeDrawLightMap(nativeContext)
+    }
+
+    /**
+     * Upload deep-sky objects for [drawDeepSkyObjects]. Call between frames;
+     * the instances stay resident until replaced.
+     *
+     * @return false if the upload failed
+     */
+    fun setDeepSkyObjects(objects: DeepSkyObjects): Boolean {
+        if (nativeContext == 0L || inFrame) return false
+        return nativeSetDeepSkyObjects(nativeContext, objects.geometry, objects.styles, objects.count)
+    }
+
+    /**
+     * Draw all uploaded deep-sky objects as shape glyphs in one instanced draw.
+     *
+     * @param minRadiusPixels Objects smaller than this on screen (or without a
+     *        known size) are enlarged so their glyph stays legible
+     */
+    fun drawDeepSkyObjects(minRadiusPixels: Float) {
+        if (!inFrame) return
+        Critical.nativeDrawDeepSkyObjects(nativeContext, minRadiusPixels)
+    }
+
+    /**
+     * Draw the Sun, Moon and planets as shaded discs, one quad each.
+     *
+     * @param minRadiusPixels Discs smaller than this on screen are enlarged so
+     *        bodies stay visible and their phase readable
+     * @return Number of bodies drawn; 0 if nothing could be drawn
+     */
+    fun drawBodies(bodies: SolarSystemBodies, minRadiusPixels: Float): Int {
+        if (!inFrame || bodies.count == 0) return 0
+        return nativeDrawBodies(nativeContext, bodies.geometry, bodies.styles, bodies.count, bodies.sun, minRadiusPixels)
+    }
+
+    /**
+     * Replace the orbits whose tracks are drawn. Orbits with the same id and
+     * elements as before keep their cached tracks.
+     *
+     * @return Number of orbits tracked
+     */
+    fun setOrbits(orbits: OrbitElements): Int {
+        if (nativeContext == 0L) return 0
+        return nativeSetOrbits(nativeContext, orbits.ids, orbits.elements, orbits.colors, orbits.count)
+    }
+
+    /**
+     * Bring the orbit tracks up to date for a time window, sampled so the
+     * drawn lines stay within [toleranceRadians] of the true path. Tracks
+     * are only re-sampled when the window or tolerance changed markedly.
+     * Call before [beginFrame], which uploads changed tracks.
+     *
+     * @return Number of tracks re-sampled
+     */
+    fun updateOrbits(startJulianDay: Double, endJulianDay: Double, toleranceRadians: Double): Int {
+        if (nativeContext == 0L || inFrame) return 0
+        return nativeUpdateOrbits(nativeContext, startJulianDay, endJulianDay, toleranceRadians)
+    }
+
+    /** Draw every orbit track with one indexed line draw. */
+    fun drawOrbits() {
+        if (!inFrame) return
+        Critical.nativeDrawOrbits(nativeContext)
+    }
+
+    /**
+     * Set the meteor showers whose meteors are simulated, from the next frame on.
+     * An empty array stops new meteors; those in flight fade out.
+     *
+     * @param radiants 4 floats per shower: x, y, z unit direction of the radiant
+     *        and its current zenithal hourly rate
+     * @param rateScale Multiplies every rate (1 = real rates)
+     */
+    fun setMeteorRadiants(radiants: FloatArray, count: Int, rateScale: Float) {
+        if (nativeContext == 0L) return
+        nativeSetMeteorRadiants(nativeContext, radiants, count, rateScale)
+    }
+
+    /**
+     * Draw the live meteors, simulated on the GPU when the frame began. One
+     * indirect draw; nothing is read back.
+     */
+    fun drawMeteors() {
+        if (!inFrame) return
+        Critical.nativeDrawMeteors(nativeContext)
+    }
+
+    /**
+     * Replace the native sky object store. Call between frames.
+     *
+     * @return false if the arrays are inconsistent or the renderer is not ready
+     */
+    fun setSkyObjects(objects: SkyObjects): Boolean {
+        if (nativeContext == 0L || inFrame) return false
+        return nativeSetSkyObjects(nativeContext, objects.geometry, objects.attributes, objects.count)
+    }
+
+    /**
+     * Attach light curves to objects of the sky object store; they survive
+     * later [setSkyObjects] calls. Call between frames.
+     *
+     * @return Number of curves whose object is in the store
+     */
+    fun setLightCurves(curves: LightCurves): Int {
+        if (nativeContext == 0L || inFrame) return 0
+        return nativeSetLightCurves(nativeContext, curves.ids, curves.elements, curves.count)
+    }
+
+    /**
+     * Bring variable objects to their brightness at [julianDay]. Only the
+     * objects that changed are written; call in a frame before [drawSkyObjects].
+     *
+     * @return Number of objects updated
+     */
+    fun updateVariableStars(julianDay: Double): Int {
+        if (!inFrame) return 0
+        return nativeUpdateVariableStars(nativeContext, julianDay)
+    }
+
+    /**
+     * Draw the stars of [layer] from the sky object store that lie within
+     * [fovDeg] of the look direction; culling and vertex packing are native.
+     *
+     * @param fraction Share of stars to draw, brightest first (frame budget)
+     * @return Number of stars drawn
+     */
+    fun drawSkyObjects(layer: Int, lookX: Float, lookY: Float, lookZ: Float, fovDeg: Float, fraction: Float): Int {
+        if (!inFrame) return 0
+        return nativeDrawSkyObjects(nativeContext, layer, lookX, lookY, lookZ, fovDeg, fraction)
+    }
+
+    /** Index (in the uploaded [SkyObjects]) of the object nearest a direction, or -1. */
+    fun pickSkyObject(x: Float, y: Float, z: Float, maxAngleDeg: Float): Int {
+        if (nativeContext == 0L) return -1
+        return Critical.nativePickSkyObject(nativeContext, x, y, z, maxAngleDeg)
+    }
+
+    /** Index (in the uploaded [SkyObjects]) of the brightest object with [nameId], or -1. */
+    fun findSkyObject(nameId: Int): Int {
+        if (nativeContext == 0L) return -1
+        return Critical.nativeFindSkyObject(nativeContext, nameId)
+    }
+
+    /**
+     * Declutter labels against a screen-space occupancy grid.
+     * Only the returned labels are drawn (see [com.stardroid.awakening.layers.LabelLayer]).
+     *
+     * @return Ids of accepted candidates, highest priority first
+     */
+    fun placeLabels(candidates: LabelCandidates): IntArray {
+        if (nativeContext == 0L || candidates.count == 0) return IntArray(0)
+        return nativePlaceLabels(nativeContext, candidates.ids, candidates.boxes, candidates.count)
+    }
+
+    /**
+     * Mark the start of a layer's draws. They use the layer's depth order, and
+     * the layer's CPU and GPU time for the frame budget runs until the next
+     * mark or the end of the frame.
+     *
+     * @param layer Layer ordinal, below 32
+     */
+    fun markLayer(layer: Int) {
+        if (!inFrame) return
+        Critical.nativeMarkLayer(nativeContext, layer)
+    }
+
+    /**
+     * Set how near a layer is drawn. Layers default to [DEPTH_ORDER_SKY]; the
+     * opaque parts of nearer layers (such as planet discs) hide farther ones,
+     * which are then rejected before shading. Draw nearer layers first.
+     *
+     * @param layer Layer ordinal, below 32
+     * @param order 0 to [MAX_DEPTH_ORDER], higher is nearer
+     */
+    fun setLayerDepthOrder(layer: Int, order: Int) {
+        if (nativeContext != 0L) {
+            Critical.nativeSetLayerDepthOrder(nativeContext, layer, order)
+        }
+    }
+
+    /** Target frame time in milliseconds, e.g. 1000 / refresh rate. */
+    fun setFrameBudget(budgetMs: Float) {
+        if (nativeContext != 0L) {
+            Critical.nativeSetFrameBudget(nativeContext, budgetMs)
+        }
+    }
+
+    /**
+     * Frame rate the render loop should pace to. Drops below 60 as the device
+     * heats up (thermal headroom), before the OS starts throttling.
+     */
+    fun getTargetFps(): Int {
+        if (nativeContext == 0L) return DEFAULT_TARGET_FPS
+        return Critical.nativeGetTargetFps(nativeContext)
+    }
+
+    /** Tell the governor which knob to lower when [layer] is the most expensive one. */
+    fun assignBudgetLayer(layer: Int, knob: QualityKnob) {
+        if (nativeContext != 0L) {
+            Critical.nativeAssignBudgetLayer(nativeContext, layer, knob.ordinal)
+        }
+    }
+
+    /** Quality the governor currently allows. */
+    fun getQuality(): RenderQuality {
+        if (nativeContext == 0L) return RenderQuality.FULL
+        return RenderQuality.fromArray(nativeGetQuality(nativeContext))
+    }
+
+    /** Smoothed timings and recent quality decisions, or null if not initialized. */
+    fun getBudgetTelemetry(): BudgetTelemetry? {
+        if (nativeContext == 0L) return null
+        return BudgetTelemetry.fromArray(nativeGetBudgetTelemetry(nativeContext))
+    }
+
+    /** Vertices each layer submitted and drew in the last frame, or null if not initialized. */
+    fun getCullStats(): CullStats? {
+        if (nativeContext == 0L) return null
+        return CullStats.fromArray(nativeGetCullStats(nativeContext))
+    }
+
     /**
      * Get current swapchain dimensions (width, height).
      * Returns [0, 0] if not initialized.
@@ -166,12 +570,126 @@ class VulkanRenderer : RendererInterface {
         vertexCount: Int,
         transform: FloatArray
     )
+    @FastNative
     private external fun nativeSetViewMatrix(context: Long, matrix: FloatArray)
+    @FastNative
     private external fun nativeSetProjectionMatrix(context: Long, matrix: FloatArray)
-    private external fun nativeSetBackgroundOpacity(context: Long, opacity: Float)
+    private external fun nativeSetStarPalette(context: Long, palette: FloatArray)
+    private external fun nativeSetHorizonProfile(
+        context: Long,
+        azimuthsDeg: FloatArray,
+        altitudesDeg: FloatArray
+    ): Boolean
+    @FastNative
     private external fun nativeGetSwapchainDimensions(context: Long): IntArray
+    private external fun nativeLoadLightMapAsync(
+        context: Long,
+        assets: AssetManager,
+        preferredOrder: Int,
+        gain: Float
+    ): Boolean
+    private external fun nativeSetDeepSkyObjects(
+        context: Long,
+        geometry: FloatArray,
+        styles: IntArray,
+        count: Int
+    ): Boolean
+    private external fun nativeDrawBodies(
+        context: Long,
+        geometry: FloatArray,
+        styles: IntArray,
+        count: Int,
+        sun: FloatArray,
+        minRadiusPixels: Float
+    ): Int
+    private external fun nativeSetOrbits(
+        context: Long,
+        ids: IntArray,
+        elements: DoubleArray,
+        colors: IntArray,
+        count: Int
+    ): Int
+    private external fun nativeUpdateOrbits(context: Long, startJd: Double, endJd: Double, tolerance: Double): Int
+    private external fun nativeSetMeteorRadiants(context: Long, radiants: FloatArray, count: Int, rateScale: Float)
+    private external fun nativeSetSkyObjects(
+        context: Long,
+        geometry: FloatArray,
+        attributes: IntArray,
+        count: Int
+    ): Boolean
+    private external fun nativeSetLightCurves(context: Long, ids: IntArray, elements: DoubleArray, count: Int): Int
+    private external fun nativeUpdateVariableStars(context: Long, julianDay: Double): Int
+    private external fun nativeDrawSkyObjects(
+        context: Long,
+        layer: Int,
+        lookX: Float,
+        lookY: Float,
+        lookZ: Float,
+        fovDeg: Float,
+        fraction: Float
+    ): Int
+    private external fun nativePlaceLabels(context: Long, ids: IntArray, boxes: FloatArray, count: Int): IntArray
+    @FastNative
+    private external fun nativeGetQuality(context: Long): FloatArray
+    private external fun nativeGetBudgetTelemetry(context: Long): DoubleArray
+    private external fun nativeRegisterBatch(
+        context: Long,
+        layer: Int,
+        primitiveType: Int,
+        vertices: FloatArray,
+        vertexCount: Int,
+        transform: FloatArray?
+    ): Int
+    private external fun nativeGetCullStats(context: Long): IntArray
+    private external fun nativeGetObserverFrame(context: Long, values: DoubleArray): Long
+
+    /**
+     * Short calls with primitive arguments only, bound as @CriticalNative:
+     * no JNIEnv, class or object is passed and the call skips the full JNI
+     * transition. They must be static, and must not block (see JNI_OnLoad
+     * in vulkan_wrapper.cpp).
+     */
+    private object Critical {
+        @JvmStatic @CriticalNative external fun nativeSetBackgroundOpacity(context: Long, opacity: Float)
+        @JvmStatic @CriticalNative external fun nativeSetScintillation(context: Long, enabled: Boolean)
+        @JvmStatic @CriticalNative external fun nativeSetHorizonClip(context: Long, enabled: Boolean)
+        @JvmStatic @CriticalNative external fun nativeSetObserver(
+            context: Long,
+            latitudeDeg: Double,
+            longitudeDeg: Double,
+            altitudeM: Double,
+            unixMillis: Long
+        )
+        @JvmStatic @CriticalNative external fun nativeGetObserverVersion(context: Long): Long
+        @JvmStatic @CriticalNative external fun nativeSetStarLimitingMagnitude(context: Long, magnitude: Float)
+        @JvmStatic @CriticalNative external fun nativeDrawLightMap(context: Long)
+        @JvmStatic @CriticalNative external fun nativeDrawDeepSkyObjects(context: Long, minRadiusPixels: Float)
+        @JvmStatic @CriticalNative external fun nativeDrawOrbits(context: Long)
+        @JvmStatic @CriticalNative external fun nativeDrawMeteors(context: Long)
+        @JvmStatic @CriticalNative external fun nativePickSkyObject(
+            context: Long,
+            x: Float,
+            y: Float,
+            z: Float,
+            maxAngleDeg: Float
+        ): Int
+        @JvmStatic @CriticalNative external fun nativeFindSkyObject(context: Long, nameId: Int): Int
+        @JvmStatic @CriticalNative external fun nativeMarkLayer(context: Long, layer: Int)
+        @JvmStatic @CriticalNative external fun nativeDrawRegistered(context: Long, id: Int, primitiveType: Int)
+        @JvmStatic @CriticalNative external fun nativeUnregisterBatch(context: Long, id: Int)
+        @JvmStatic @CriticalNative external fun nativeSetLayerDepthOrder(context: Long, layer: Int, order: Int)
+        @JvmStatic @CriticalNative external fun nativeSetFrameBudget(context: Long, budgetMs: Float)
+        @JvmStatic @CriticalNative external fun nativeGetTargetFps(context: Long): Int
+        @JvmStatic @CriticalNative external fun nativeAssignBudgetLayer(context: Long, layer: Int, knob: Int)
+    }
 
     companion object {
+        const val DEFAULT_TARGET_FPS = 60
+
+        /** Depth order of the sky itself, the farthest. */
+        const val DEPTH_ORDER_SKY = 0
+        const val MAX_DEPTH_ORDER = 7  // DEPTH_ORDERS - 1 in vulkan_wrapper.cpp
+
         private var libraryLoaded = false
         private var loadError: String? = null
 
@@ -5,10 +5,19 @@ import android.view.SurfaceHolder
 import android.view.SurfaceView
 import com.stardroid.awakening.control.AstronomerModel
 import com.stardroid.awakening.data.ConstellationCatalog
+import com.stardroid.awakening.data.HorizonProfileAsset
+import com.stardroid.awakening.data.LightMapAsset
 import com.stardroid.awakening.data.MessierCatalog
 import com.stardroid.awakening.data.StarCatalog
+import com.stardroid.awakening.ephemeris.JulianDate
 import com.stardroid.awakening.layers.*
+import com.stardroid.awakening.renderer.BudgetTelemetry
+import com.stardroid.awakening.renderer.CullStats
+import com.stardroid.awakening.renderer.LabelKind
 import com.stardroid.awakening.renderer.Matrix
+import com.stardroid.awakening.renderer.QualityKnob
+import com.stardroid.awakening.renderer.StarPalette
+import com.stardroid.awakening.ui.LabelOverlay
 
 /**
  * Android Surface view that hosts Vulkan rendering.
@@ -18,6 +27,10 @@ import com.stardroid.awakening.renderer.Matrix
  * - Starts/stops render loop thread
  * - Handles surface resizing
  * - Cleans up on destruction
+ *
+ * Each layer's draws are timed for the native frame budget governor, and
+ * the quality it allows (star density, horizon tessellation, label count,
+ * glow, resolution scale) is applied every frame.
  */
 class VulkanSurfaceView(context: Context) : SurfaceView(context), SurfaceHolder.Callback {
     private val renderer = VulkanRenderer()
@@ -27,6 +40,10 @@ class VulkanSurfaceView(context: Context) : SurfaceView(context), SurfaceHolder.
     private var surfaceWidth = 0
     private var surfaceHeight = 0
 
+    /** Render resolution scale currently applied via the surface's fixed size. */
+    @Volatile
+    private var appliedResolutionScale = 1f
+
     /** Star catalog for rendering. Set before surface is created. */
     var starCatalog: StarCatalog? = null
 
@@ -36,12 +53,18 @@ class VulkanSurfaceView(context: Context) : SurfaceView(context), SurfaceHolder.
     /** Messier catalog for rendering. Set before surface is created. */
     var messierCatalog: MessierCatalog? = null
 
+    /** Terrain skyline of the site, if the app ships one. Set before surface is created. */
+    var horizonProfile: HorizonProfileAsset? = null
+
     /** Astronomer model for sensor-based orientation. Set before surface is created. */
     var astronomerModel: AstronomerModel? = null
 
     /** Layer manager for visibility control. Set before surface is created. */
     var layerManager: LayerManager? = null
 
+    /** Draws the object names accepted by the label placer. Set before surface is created. */
+    var labelOverlay: LabelOverlay? = null
+
     /** Grid layer for RA/Dec coordinate lines. */
     private val gridLayer = GridLayer()
 
@@ -54,6 +77,7 @@ class VulkanSurfaceView(context: Context) : SurfaceView(context), SurfaceHolder.
     private val eclipticLayer = EclipticLayer()
     private val meteorShowerLayer = MeteorShowerLayer()
     private val cometLayer = CometLayer()
+    private val orbitLayer = OrbitLayer(cometLayer)
     private val skyGradientLayer = SkyGradientLayer()
     private val issLayer = ISSLayer()
     private val starOfBethlehemLayer = StarOfBethlehemLayer()
@@ -84,6 +108,11 @@ class VulkanSurfaceView(context: Context) : SurfaceView(context), SurfaceHolder.
         surfaceHeight = rect.height()
         val success = renderer.initialize(holder.surface, surfaceWidth, surfaceHeight)
         if (success) {
+            if (BENCHMARK_JNI_CALLS) {
+                android.util.Log.i(TAG, JniCallBenchmark.run().toString())
+            }
+            configureFrameBudget()
+            configureDepthOrder()
             startRenderLoop()
         } else {
             android.util.Log.e(TAG, "Failed to initialize Vulkan renderer")
@@ -106,6 +135,68 @@ class VulkanSurfaceView(context: Context) : SurfaceView(context), SurfaceHolder.
         renderer.release()
     }
 
+    /** Frame budget timings and recent quality decisions, or null if not rendering. */
+    fun getBudgetTelemetry(): BudgetTelemetry? = renderer.getBudgetTelemetry()
+
+    /** Vertices each layer submitted and drew after culling in the last frame, or null if not rendering. */
+    fun getCullStats(): CullStats? = renderer.getCullStats()
+
+    /**
+     * Planet discs hide the stars and lines behind them; the ISS passes in
+     * front of the discs. Everything else stays at sky depth.
+     */
+    private fun configureDepthOrder() {
+        renderer.setLayerDepthOrder(Layer.SOLAR_SYSTEM.ordinal, DEPTH_ORDER_BODIES)
+        renderer.setLayerDepthOrder(Layer.ISS.ordinal, DEPTH_ORDER_SATELLITES)
+    }
+
+    /** Map layers to the quality knob that reduces their cost. */
+    private fun configureFrameBudget() {
+        renderer.setFrameBudget(1000f / VulkanRenderer.DEFAULT_TARGET_FPS)
+        renderer.assignBudgetLayer(Layer.STARS.ordinal, QualityKnob.STAR_DENSITY)
+        renderer.assignBudgetLayer(Layer.HORIZON.ordinal, QualityKnob.TESSELLATION)
+        renderer.assignBudgetLayer(GLOW_BUDGET_LAYER, QualityKnob.GLOW)
+        renderer.assignBudgetLayer(Layer.LABELS.ordinal, QualityKnob.LABEL_COUNT)
+    }
+
+    /**
+     * Hand the label layer the names of the layers that are shown. Catalogs
+     * return the same list once loaded, so text is measured once.
+     */
+    private fun updateLabelSources(labelLayer: LabelLayer, layers: LayerManager?) {
+        val planets = layers?.isVisible(Layer.SOLAR_SYSTEM) != false
+        labelLayer.setVisible(LabelKind.PLANET, planets)
+        if (planets) labelLayer.setLabels(LabelKind.PLANET, solarSystemLayer.getLabels())
+
+        val constellations = layers?.isVisible(Layer.CONSTELLATIONS) != false
+        labelLayer.setVisible(LabelKind.CONSTELLATION, constellations)
+        if (constellations) constellationCatalog?.getLabels()?.let { labelLayer.setLabels(LabelKind.CONSTELLATION, it) }
+
+        val deepSky = layers?.isVisible(Layer.MESSIER) == true
+        labelLayer.setVisible(LabelKind.DEEP_SKY, deepSky)
+        if (deepSky) messierCatalog?.getLabels()?.let { labelLayer.setLabels(LabelKind.DEEP_SKY, it) }
+
+        val stars = layers?.isVisible(Layer.STARS) != false
+        labelLayer.setVisible(LabelKind.STAR, stars)
+        if (stars) starCatalog?.getLabels()?.let { labelLayer.setLabels(LabelKind.STAR, it) }
+    }
+
+    /**
+     * Render at a fraction of the view size; the hardware scaler stretches the
+     * surface to fit. The resulting surfaceChanged resizes the swapchain.
+     */
+    private fun applyResolutionScale(scale: Float) {
+        if (scale == appliedResolutionScale) return
+        appliedResolutionScale = scale
+        post {
+            if (scale >= 1f || width == 0 || height == 0) {
+                holder.setSizeFromLayout()
+            } else {
+                holder.setFixedSize((width * scale).toInt(), (height * scale).toInt())
+            }
+        }
+    }
+
     fun onResume() {
         // Start ISS background fetch
         issLayer.start()
@@ -126,9 +217,6 @@ class VulkanSurfaceView(context: Context) : SurfaceView(context), SurfaceHolder.
 
         renderThread = Thread {
             try {
-                val targetFps = 60
-                val frameTimeMs = 1000L / targetFps
-
                 // FPS tracking
                 var frameCount = 0
                 var fpsStartTime = System.nanoTime()
@@ -138,6 +226,22 @@ class VulkanSurfaceView(context: Context) : SurfaceView(context), SurfaceHolder.
                 // Fallback rotation when no sensor data
                 var fallbackAngle = 0f
 
+                // Light map is (re)uploaded once per render loop, as soon as its asset has loaded
+                var lightMapUploaded = false
+
+                // Deep-sky object instances are likewise uploaded once, after the catalog loads
+                var deepSkyObjectsUploaded = false
+                var orbitsUploaded = false
+                var skyObjectsUploaded = false
+                var horizonProfileUploaded = false
+
+                // Star palette is a uniform upload, so night mode switches without touching vertices
+                var nightPaletteActive: Boolean? = null
+
+                // Names are measured at the overlay's text size; the overlay is cleared once when labels hide
+                val labelLayer = labelOverlay?.let { LabelLayer(it.textSizePixels) }
+                var labelsShown = false
+
                 var lastLoggedWidth = 0
                 var lastLoggedHeight = 0
 
@@ -177,6 +281,14 @@ class VulkanSurfaceView(context: Context) : SurfaceView(context), SurfaceHolder.
                     )
                     renderer.setProjectionMatrix(projection)
 
+                    // The observer's frame and horizon are kept natively and only redone when they move.
+                    // The pointing, the horizon line and the ISS follow that same versioned frame, so
+                    // they agree with the GPU clip, culling and scintillation
+                    val observer = astronomerModel
+                    observer?.let { renderer.setObserver(it.location, System.currentTimeMillis()) }
+                    val observerFrame = renderer.getObserverFrame()
+                    observer?.setObserverFrame(observerFrame)
+
                     // Build view matrix from astronomer model or use fallback
                     val viewMatrix = astronomerModel?.let { model ->
                         val pointing = model.getPointing()
@@ -209,94 +321,193 @@ class VulkanSurfaceView(context: Context) : SurfaceView(context), SurfaceHolder.
                         renderer.setBackgroundOpacity(opacity)
                     }
 
+                    if (!lightMapUploaded) {
+                        // Read and decoded natively in the background; drawn once uploaded
+                        renderer.loadLightMapAsync(context.assets, LightMapAsset.PREFERRED_ORDER, LightMapAsset.GAIN)
+                        lightMapUploaded = true
+                    }
+
+                    if (!skyObjectsUploaded) {
+                        starCatalog?.getSkyObjects(Layer.STARS.ordinal)?.let { objects ->
+                            skyObjectsUploaded = renderer.setSkyObjects(objects)
+                            if (skyObjectsUploaded) {
+                                starCatalog?.getLightCurves()?.let { renderer.setLightCurves(it) }
+                            }
+                        }
+                    }
+
+                    if (!deepSkyObjectsUploaded) {
+                        messierCatalog?.getDeepSkyObjects()?.let { objects ->
+                            renderer.setDeepSkyObjects(objects)
+                            deepSkyObjectsUploaded = true
+                        }
+                    }
+
+                    if (!horizonProfileUploaded) {
+                        val profile = horizonProfile
+                        val azimuths = profile?.azimuths
+                        val altitudes = profile?.altitudes
+                        if (azimuths != null && altitudes != null) {
+                            renderer.setHorizonProfile(azimuths, altitudes)
+                            horizonProfileUploaded = true
+                        }
+                    }
+
+                    val nightMode = layers?.isVisible(Layer.NIGHT_MODE) == true
+                    if (nightMode != nightPaletteActive) {
+                        renderer.setStarPalette(if (nightMode) StarPalette.nightRed else StarPalette.natural)
+                        nightPaletteActive = nightMode
+                    }
+
+                    // The ground (and the site's skyline) hides the sky below the horizon; skip drawing it
+                    val horizonClip = observer != null && layers?.isVisible(Layer.GROUND) == true
+                    renderer.setHorizonClip(horizonClip)
+
+                    // Stars twinkle towards the observer's horizon; animated in the star shader
+                    renderer.setScintillation(SCINTILLATION && observer != null)
+
+                    // Quality allowed by the frame budget governor
+                    val quality = renderer.getQuality()
+                    applyResolutionScale(quality.resolutionScale)
+
+                    // The glow covers the stars the point layer no longer draws at this density
+                    renderer.setStarLimitingMagnitude(LightMapAsset.limitingMagnitude(quality.starFraction))
+
+                    // Orbit tracks are re-sampled only when the window or zoom moved enough;
+                    // beginFrame uploads them
+                    if (layers?.isVisible(Layer.ORBITS) == true) {
+                        val jd = JulianDate.fromUnixMillis(System.currentTimeMillis())
+                        if (!orbitsUploaded) {
+                            renderer.setOrbits(orbitLayer.getOrbits(jd))
+                            orbitsUploaded = true
+                        }
+                        val tolerance = ORBIT_ERROR_PIXELS * Math.toRadians(fov.toDouble()) / swapHeight.coerceAtLeast(1)
+                        renderer.updateOrbits(jd - ORBIT_WINDOW_DAYS / 2, jd + ORBIT_WINDOW_DAYS / 2, tolerance)
+                    }
+
+                    // Meteors are stepped when the frame begins; a hidden layer lets them fade out
+                    if (layers?.isVisible(Layer.METEOR_SHOWERS) == true) {
+                        val radiants = meteorShowerLayer.getActiveRadiants()
+                        renderer.setMeteorRadiants(radiants, radiants.size / 4, METEOR_RATE_SCALE)
+                    } else {
+                        renderer.setMeteorRadiants(FloatArray(0), 0, METEOR_RATE_SCALE)
+                    }
+
                     // Begin frame
                     if (renderer.beginFrame()) {
 
-                        // Draw grid lines first (background layer)
-                        if (layers?.isVisible(Layer.GRID) == true) {
-                            val gridBatch = gridLayer.getGridBatch()
-                            if (gridBatch.vertexCount > 0) {
-                                renderer.draw(gridBatch)
+                        // Solar system objects (Sun, Moon, planets) first: their discs
+                        // write depth, so the sky layers behind them fail early-Z
+                        if (layers?.isVisible(Layer.SOLAR_SYSTEM) != false) {
+                            renderer.markLayer(Layer.SOLAR_SYSTEM.ordinal)
+                            val bodies = solarSystemLayer.getBodies()
+                            if (renderer.drawBodies(bodies, BODY_MIN_RADIUS_PIXELS) == 0) {
+                                val solarSystemBatch = solarSystemLayer.getSolarSystemBatch()
+                                if (solarSystemBatch.vertexCount > 0) {
+                                    renderer.draw(solarSystemBatch)
+                                }
                             }
                         }
 
+                        // Faint star glow goes under the rest of the sky
+                        if (layers?.isVisible(Layer.STARS) != false && quality.glow) {
+                            renderer.markLayer(GLOW_BUDGET_LAYER)
+                            renderer.drawLightMap()
+                        }
+
+                        // Draw grid lines first (background layer); fixed lines stay
+                        // registered natively and only the chunks in view are drawn
+                        if (layers?.isVisible(Layer.GRID) == true) {
+                            renderer.markLayer(Layer.GRID.ordinal)
+                            renderer.drawRegistered(Layer.GRID.ordinal, gridLayer.getGridBatch())
+                        }
+
                         // Draw ecliptic
                         if (layers?.isVisible(Layer.ECLIPTIC) == true) {
-                            val eclipticBatch = eclipticLayer.getBatch()
-                            if (eclipticBatch.vertexCount > 0) {
-                                renderer.draw(eclipticBatch)
-                            }
+                            renderer.markLayer(Layer.ECLIPTIC.ordinal)
+                            renderer.drawRegistered(Layer.ECLIPTIC.ordinal, eclipticLayer.getBatch())
                         }
 
                         // Draw horizon line
                         if (layers?.isVisible(Layer.HORIZON) == true) {
-                            val horizonBatch = horizonLayer.getHorizonBatch(astronomerModel)
-                            if (horizonBatch.vertexCount > 0) {
-                                renderer.draw(horizonBatch)
-                            }
+                            renderer.markLayer(Layer.HORIZON.ordinal)
+                            // Rebuilt only when the observer frame or tessellation changes
+                            renderer.drawRegistered(
+                                Layer.HORIZON.ordinal,
+                                horizonLayer.getHorizonBatch(observerFrame, quality.tessellationScale)
+                            )
                         }
 
                         // Draw constellation lines (behind stars)
                         if (layers?.isVisible(Layer.CONSTELLATIONS) != false) {
+                            renderer.markLayer(Layer.CONSTELLATIONS.ordinal)
                             constellationCatalog?.let { catalog ->
-                                val constellationBatch = catalog.getConstellationBatch()
-                                if (constellationBatch.vertexCount > 0) {
-                                    renderer.draw(constellationBatch)
-                                }
+                                renderer.drawRegistered(Layer.CONSTELLATIONS.ordinal, catalog.getConstellationBatch())
                             }
                         }
 
                         // Draw stars from catalog with frustum culling
                         if (layers?.isVisible(Layer.STARS) != false) {
+                            renderer.markLayer(Layer.STARS.ordinal)
                             starCatalog?.let { catalog ->
                                 // Get look direction for frustum culling
                                 val lookDir = astronomerModel?.getPointing()?.lineOfSight
                                 val currentFov = fov
 
-                                val starBatch = if (lookDir != null) {
-                                    // Use frustum culling
-                                    catalog.getVisibleStarBatch(
+                                if (skyObjectsUploaded && lookDir != null) {
+                                    // Culled and packed natively from the sky object store,
+                                    // after variable stars are brought up to date
+                                    renderer.updateVariableStars(JulianDate.fromUnixMillis(System.currentTimeMillis()))
+                                    renderer.drawSkyObjects(
+                                        Layer.STARS.ordinal,
                                         -lookDir.x, -lookDir.y, -lookDir.z,  // Negate because we look toward negative direction
-                                        currentFov * 1.5f  // Add margin for safety
+                                        currentFov * 1.5f,  // Add margin for safety
+                                        quality.starFraction
                                     )
                                 } else {
-                                    // Fall back to all stars
-                                    catalog.getStarBatch()
-                                }
-                                if (starBatch.vertexCount > 0) {
-                                    renderer.draw(starBatch)
+                                    val starBatch = if (lookDir != null) {
+                                        // Use frustum culling
+                                        catalog.getVisibleStarBatch(
+                                            -lookDir.x, -lookDir.y, -lookDir.z,
+                                            currentFov * 1.5f,
+                                            quality.starFraction
+                                        )
+                                    } else {
+                                        // Fall back to all stars
+                                        catalog.getStarBatch()
+                                    }
+                                    if (starBatch.vertexCount > 0) {
+                                        renderer.draw(starBatch)
+                                    }
                                 }
                             }
                         }
 
-                        // Draw Messier objects
+                        // Draw Messier objects (one instanced draw, culled on the GPU)
                         if (layers?.isVisible(Layer.MESSIER) == true) {
-                            messierCatalog?.let { catalog ->
-                                val messierBatch = catalog.getMessierBatch()
-                                if (messierBatch.vertexCount > 0) {
-                                    renderer.draw(messierBatch)
-                                }
-                            }
+                            renderer.markLayer(Layer.MESSIER.ordinal)
+                            renderer.drawDeepSkyObjects(DSO_MIN_RADIUS_PIXELS)
                         }
 
-                        // Draw solar system objects (Sun, Moon, planets)
-                        if (layers?.isVisible(Layer.SOLAR_SYSTEM) != false) {
-                            val solarSystemBatch = solarSystemLayer.getSolarSystemBatch()
-                            if (solarSystemBatch.vertexCount > 0) {
-                                renderer.draw(solarSystemBatch)
-                            }
+                        // Draw orbit tracks (one indexed line draw of the cached polylines)
+                        if (layers?.isVisible(Layer.ORBITS) == true) {
+                            renderer.markLayer(Layer.ORBITS.ordinal)
+                            renderer.drawOrbits()
                         }
 
                         // Draw meteor shower radiants
                         if (layers?.isVisible(Layer.METEOR_SHOWERS) == true) {
+                            renderer.markLayer(Layer.METEOR_SHOWERS.ordinal)
                             val meteorBatch = meteorShowerLayer.getBatch()
                             if (meteorBatch.vertexCount > 0) {
                                 renderer.draw(meteorBatch)
                             }
+                            renderer.drawMeteors()
                         }
 
                         // Draw comets
                         if (layers?.isVisible(Layer.COMETS) == true) {
+                            renderer.markLayer(Layer.COMETS.ordinal)
                             val cometBatch = cometLayer.getBatch()
                             if (cometBatch.vertexCount > 0) {
                                 renderer.draw(cometBatch)
@@ -305,7 +516,8 @@ class VulkanSurfaceView(context: Context) : SurfaceView(context), SurfaceHolder.
 
                         // Draw ISS
                         if (layers?.isVisible(Layer.ISS) == true) {
-                            val issBatch = issLayer.getBatch(astronomerModel)
+                            renderer.markLayer(Layer.ISS.ordinal)
+                            val issBatch = issLayer.getBatch(observerFrame)
                             if (issBatch.vertexCount > 0) {
                                 renderer.draw(issBatch)
                             }
@@ -313,12 +525,34 @@ class VulkanSurfaceView(context: Context) : SurfaceView(context), SurfaceHolder.
 
                         // Draw Star of Bethlehem
                         if (layers?.isVisible(Layer.STAR_OF_BETHLEHEM) == true) {
+                            renderer.markLayer(Layer.STAR_OF_BETHLEHEM.ordinal)
                             val bethBatch = starOfBethlehemLayer.getBatch()
                             if (bethBatch.vertexCount > 0) {
                                 renderer.draw(bethBatch)
                             }
                         }
 
+                        // Names of what is in view, decluttered natively against the
+                        // swapchain; the overlay draws the accepted ones
+                        val overlay = labelOverlay
+                        if (overlay != null && labelLayer != null && width > 0) {
+                            if (layers?.isVisible(Layer.LABELS) != false) {
+                                renderer.markLayer(Layer.LABELS.ordinal)
+                                updateLabelSources(labelLayer, layers)
+                                val zenith = if (horizonClip) observerFrame?.zenith else null
+                                val candidates = labelLayer.collect(
+                                    viewMatrix, projection, swapWidth, swapHeight,
+                                    swapWidth.toFloat() / width,
+                                    zenith?.let { floatArrayOf(it.x, it.y, it.z) }
+                                )
+                                overlay.update(labelLayer.place(renderer.placeLabels(candidates), nightMode))
+                                labelsShown = true
+                            } else if (labelsShown) {
+                                overlay.update(PlacedLabels.EMPTY)
+                                labelsShown = false
+                            }
+                        }
+
                         // End frame
                         renderer.endFrame()
                     }
@@ -337,7 +571,8 @@ class VulkanSurfaceView(context: Context) : SurfaceView(context), SurfaceHolder.
                         onFpsUpdate?.invoke(currentFps)
                     }
 
-                    // Frame rate limiting - aim for 60 FPS
+                    // Frame rate limiting - 60 FPS unless the device is running hot
+                    val frameTimeMs = 1000L / renderer.getTargetFps()
                     val frameEnd = System.currentTimeMillis()
                     val frameTime = frameEnd - frameStart
                     if (frameTime < frameTimeMs) {
@@ -374,5 +609,33 @@ class VulkanSurfaceView(context: Context) : SurfaceView(context), SurfaceHolder.
 
     companion object {
         private const val TAG = "VulkanSurfaceView"
+
+        /** Budget timing slot for the light-map glow pass (after the Layer ordinals). */
+        private val GLOW_BUDGET_LAYER = Layer.values().size
+
+        /** Smallest on-screen radius of a deep-sky object glyph. */
+        private const val DSO_MIN_RADIUS_PIXELS = 6f
+
+        /** Smallest on-screen radius of a Sun, Moon or planet disc (as large as the old points). */
+        private const val BODY_MIN_RADIUS_PIXELS = 4f
+
+        /** Orbit tracks span this many days, centered on now. */
+        private const val ORBIT_WINDOW_DAYS = 365.0
+
+        /** Largest on-screen error of a drawn orbit track. */
+        private const val ORBIT_ERROR_PIXELS = 0.5
+
+        /** Multiplies shower rates for the live meteors (1 = real zenithal hourly rates). */
+        private const val METEOR_RATE_SCALE = 1f
+
+        /** Stars twinkle, more strongly near the horizon. */
+        private const val SCINTILLATION = true
+
+        /** Log the cost of each JNI call kind once the renderer starts (JniCallBenchmark). */
+        private const val BENCHMARK_JNI_CALLS = false
+
+        /** Depth orders above the sky (VulkanRenderer.DEPTH_ORDER_SKY). */
+        private const val DEPTH_ORDER_BODIES = 1
+        private const val DEPTH_ORDER_SATELLITES = 2
     }
 }
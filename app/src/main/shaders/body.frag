@@ -0,0 +1,43 @@
+#version 450
+
+layout(location = 0) in vec2 fragLocal;
+layout(location = 1) in vec4 fragColor;
+layout(location = 2) flat in vec4 fragLight;
+layout(location = 3) flat in uint fragFlags;
+
+layout(location = 0) out vec4 outColor;
+
+// Must match bodies::FLAG_EMISSIVE in body_impostor.h
+const uint FLAG_EMISSIVE = 1u;
+
+// Faint light on the night side (earthshine), so the dark limb still reads
+const float NIGHT_SIDE = 0.03;
+
+void main() {
+    // Ray from the observer through this pixel meets the sphere at depth mu;
+    // (fragLocal, mu) is then the unit surface normal in glyph space
+    float r2 = dot(fragLocal, fragLocal);
+    float r = sqrt(r2);
+    float coverage = clamp(0.5 - (r - 1.0) / max(fwidth(r), 1e-6), 0.0, 1.0);
+    if (coverage <= 0.0) {
+        discard;
+    }
+    float mu = sqrt(max(1.0 - r2, 0.0));
+    float limb = 1.0 - fragLight.w * (1.0 - mu);
+
+    float brightness;
+    if ((fragFlags & FLAG_EMISSIVE) != 0u) {
+        brightness = limb;
+    } else {
+        // Lommel-Seeliger: flat at full phase, falling to zero at the terminator
+        float mu0 = dot(vec3(fragLocal, mu), fragLight.xyz);
+        float lit = mu0 > 0.0 ? min(1.0, 2.0 * mu0 / (mu0 + mu)) : 0.0;
+        // Soften the terminator over about a pixel
+        lit *= clamp(0.5 + mu0 / max(fwidth(mu0), 1e-6), 0.0, 1.0);
+        brightness = max(lit, NIGHT_SIDE) * limb;
+    }
+
+    // Premultiplied; the night side stays opaque and hides the stars behind it
+    float alpha = fragColor.a * coverage;
+    outColor = vec4(fragColor.rgb * brightness * alpha, alpha);
+}
@@ -0,0 +1,102 @@
+#version 450
+
+// One instance per Sun, Moon or planet (40 bytes, see bodies::Instance in
+// body_impostor.h); the four corners of its quad come from gl_VertexIndex
+// (triangle strip) and body.frag ray-casts the sphere inside it
+layout(location = 0) in vec4 inCenter;  // xyz unit direction, w angular radius (radians)
+layout(location = 1) in vec4 inLight;   // xyz unit direction toward the Sun, w limb darkening
+layout(location = 2) in vec4 inColor;   // RGBA8 unorm
+layout(location = 3) in uint inFlags;
+
+layout(location = 0) out vec2 fragLocal;  // Glyph space: the limb is the unit circle
+layout(location = 1) out vec4 fragColor;
+layout(location = 2) flat out vec4 fragLight;  // Sunlight in glyph space, w limb darkening
+layout(location = 3) flat out uint fragFlags;
+
+// Must match horizon::BINS in horizon_profile.h
+const int TERRAIN_BINS = 256;
+
+layout(set = 0, binding = 0) uniform Matrices {
+    mat4 view;
+    mat4 projection;
+    vec4 horizon;  // World-space plane: xyz zenith, w margin; (0, 0, 0, 1) keeps everything
+    vec4 horizonNorth;  // xyz north along the ground, for terrain azimuths
+    vec4 terrain[TERRAIN_BINS / 4];  // Skyline sin(altitude) per azimuth bin, 4 per entry
+} ubo;
+
+layout(push_constant) uniform PushConstants {
+    mat4 model;
+    vec2 viewport;         // Pixels
+    float minRadiusPixels; // Bodies smaller than this on screen are enlarged to it
+    float depth;           // Depth of the draw's layer (depth order)
+} pc;
+
+// Height above the terrain skyline (sine of altitude); negative when hidden
+float aboveTerrain(vec3 world) {
+    vec3 east = cross(ubo.horizonNorth.xyz, ubo.horizon.xyz);
+    float azimuth = atan(dot(world, east), dot(world, ubo.horizonNorth.xyz));
+    int bin = int(floor(fract(azimuth / 6.28318531) * float(TERRAIN_BINS))) & (TERRAIN_BINS - 1);
+    return dot(world, ubo.horizon.xyz) - ubo.terrain[bin >> 2][bin & 3];
+}
+
+// Quad half-size in glyph space; leaves room for the antialiased limb
+const float QUAD_EXTENT = 1.25;
+
+const vec2 CORNERS[4] = vec2[](vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(-1.0, 1.0), vec2(1.0, 1.0));
+
+// Same frame as tangentFrame() in dso.vert and dso.h
+void tangentFrame(vec3 d, out vec3 north, out vec3 east) {
+    vec3 e = vec3(-d.y, d.x, 0.0);
+    float len = length(e);
+    east = len < 1e-6 ? vec3(0.0, 1.0, 0.0) : e / len;
+    north = cross(d, east);
+}
+
+void culled() {
+    // Outside the clip volume on every corner, so the quad is dropped before rasterization
+    gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+    fragLocal = vec2(0.0);
+    fragColor = vec4(0.0);
+    fragLight = vec4(0.0);
+    fragFlags = 0u;
+}
+
+void main() {
+    mat4 viewModel = ubo.view * pc.model;
+    vec4 centerClip = ubo.projection * viewModel * vec4(inCenter.xyz, 1.0);
+    if (centerClip.w <= 0.0) {
+        culled();  // Behind the camera
+        return;
+    }
+    vec3 worldCenter = (pc.model * vec4(inCenter.xyz, 1.0)).xyz;
+    float extent = tan(inCenter.w);
+    if (dot(worldCenter, ubo.horizon.xyz) + ubo.horizon.w < -extent || aboveTerrain(worldCenter) < -extent) {
+        culled();  // Entirely below the horizon or terrain
+        return;
+    }
+
+    // World units per pixel at the body's distance; directions are on the unit sphere
+    float pixelsPerUnit = ubo.projection[1][1] * 0.5 * pc.viewport.y / centerClip.w;
+    float radius = max(extent, pc.minRadiusPixels / pixelsPerUnit);
+
+    vec2 radiusNdc = vec2(2.0 / pc.viewport.x, 2.0 / pc.viewport.y) * radius * pixelsPerUnit * QUAD_EXTENT;
+    vec2 centerNdc = centerClip.xy / centerClip.w;
+    if (any(greaterThan(abs(centerNdc), vec2(1.0) + radiusNdc))) {
+        culled();
+        return;
+    }
+
+    vec3 north, east;
+    tangentFrame(inCenter.xyz, north, east);
+
+    vec2 local = CORNERS[gl_VertexIndex] * QUAD_EXTENT;
+    vec3 position = inCenter.xyz + radius * (local.x * east + local.y * north);
+
+    gl_Position = ubo.projection * viewModel * vec4(position, 1.0);
+    gl_Position.z = pc.depth * gl_Position.w;
+    fragLocal = local;
+    fragColor = inColor;
+    // Glyph z points at the observer, against the center direction
+    fragLight = vec4(dot(inLight.xyz, east), dot(inLight.xyz, north), -dot(inLight.xyz, inCenter.xyz), inLight.w);
+    fragFlags = inFlags;
+}
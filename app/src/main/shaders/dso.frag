@@ -0,0 +1,55 @@
+#version 450
+
+layout(location = 0) in vec2 fragLocal;
+layout(location = 1) in vec4 fragColor;
+layout(location = 2) flat in uint fragGlyph;
+
+layout(location = 0) out vec4 outColor;
+
+// Must match dso::Glyph in dso.h
+const uint GLYPH_DISC = 0u;
+const uint GLYPH_ELLIPSE = 1u;
+const uint GLYPH_SPIRAL = 2u;
+const uint GLYPH_GLOBULAR = 3u;
+const uint GLYPH_OPEN = 4u;
+const uint GLYPH_NEBULA = 5u;
+
+const float LINE_WIDTH_PIXELS = 1.5;
+const float PI = 3.14159265;
+
+// Coverage of a line where d is the signed distance from it in glyph units
+float stroke(float d) {
+    float pixels = abs(d) / max(fwidth(d), 1e-6);
+    return clamp(0.5 * LINE_WIDTH_PIXELS + 0.5 - pixels, 0.0, 1.0);
+}
+
+// Coverage of the region d < 0
+float fill(float d) {
+    return clamp(0.5 - d / max(fwidth(d), 1e-6), 0.0, 1.0);
+}
+
+void main() {
+    float r = length(fragLocal);
+    float coverage;
+
+    if (fragGlyph == GLYPH_ELLIPSE) {
+        coverage = stroke(r - 1.0);
+    } else if (fragGlyph == GLYPH_SPIRAL) {
+        coverage = max(stroke(r - 1.0), fill(r - 0.3));
+    } else if (fragGlyph == GLYPH_GLOBULAR) {
+        float arms = max(stroke(fragLocal.x), stroke(fragLocal.y)) * fill(r - 1.0);
+        coverage = max(stroke(r - 1.0), arms);
+    } else if (fragGlyph == GLYPH_OPEN) {
+        // Twelve dashes around the circle
+        float dash = step(0.5, fract(atan(fragLocal.y, fragLocal.x) * 6.0 / PI));
+        coverage = stroke(r - 1.0) * dash;
+    } else if (fragGlyph == GLYPH_NEBULA) {
+        coverage = stroke(max(abs(fragLocal.x), abs(fragLocal.y)) - 0.9);
+    } else {
+        coverage = fill(r - 1.0);
+    }
+
+    // Premultiplied for the additive DSO pipeline
+    float alpha = fragColor.a * coverage;
+    outColor = vec4(fragColor.rgb * alpha, alpha);
+}
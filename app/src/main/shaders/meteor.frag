@@ -0,0 +1,16 @@
+#version 450
+
+layout(location = 0) in vec2 fragStreak;  // x: 0 at the tail to 1 at the head, y: -1..1 across
+layout(location = 1) in float fragBrightness;
+layout(location = 0) out vec4 outColor;
+
+// Warm white head fading into a greenish trail; premultiplied for additive blending
+const vec3 HEAD_COLOR = vec3(1.0, 0.97, 0.9);
+const vec3 TRAIL_COLOR = vec3(0.55, 0.9, 0.7);
+
+void main() {
+    float across = 1.0 - fragStreak.y * fragStreak.y;
+    float along = fragStreak.x * fragStreak.x;
+    float alpha = fragBrightness * along * across;
+    outColor = vec4(mix(TRAIL_COLOR, HEAD_COLOR, along) * alpha, alpha);
+}
@@ -0,0 +1,61 @@
+#version 450
+
+// One instance per live meteor (32 bytes, see meteors::Streak in
+// meteor_shower.h), written by meteor.comp and drawn indirectly; the four
+// corners of its screen-space quad come from gl_VertexIndex (triangle strip)
+layout(location = 0) in vec4 inHead;  // xyz direction, w brightness
+layout(location = 1) in vec4 inTail;  // xyz direction, w width (pixels)
+
+layout(location = 0) out vec2 fragStreak;  // x: 0 at the tail to 1 at the head, y: -1..1 across
+layout(location = 1) out float fragBrightness;
+
+layout(set = 0, binding = 0) uniform Matrices {
+    mat4 view;
+    mat4 projection;
+    vec4 horizon;  // World-space plane: xyz zenith, w margin; (0, 0, 0, 1) keeps everything
+} ubo;
+
+layout(push_constant) uniform PushConstants {
+    mat4 model;
+    vec2 viewport;         // Pixels
+    float minRadiusPixels; // Unused
+    float depth;           // Depth of the draw's layer (depth order)
+} pc;
+
+const vec2 CORNERS[4] = vec2[](vec2(0.0, -1.0), vec2(1.0, -1.0), vec2(0.0, 1.0), vec2(1.0, 1.0));
+
+void culled() {
+    gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+    fragStreak = vec2(0.0);
+    fragBrightness = 0.0;
+}
+
+void main() {
+    vec3 head = (pc.model * vec4(inHead.xyz, 1.0)).xyz;
+    vec3 tail = (pc.model * vec4(inTail.xyz, 1.0)).xyz;
+    if (dot(head, ubo.horizon.xyz) + ubo.horizon.w < 0.0) {
+        culled();  // Below the horizon
+        return;
+    }
+    vec4 headClip = ubo.projection * ubo.view * vec4(head, 1.0);
+    vec4 tailClip = ubo.projection * ubo.view * vec4(tail, 1.0);
+    if (headClip.w <= 0.0 || tailClip.w <= 0.0) {
+        culled();  // Behind the camera
+        return;
+    }
+
+    // Quad along the streak in pixels (NDC scaled to half the viewport)
+    vec2 headPixels = headClip.xy / headClip.w * 0.5 * pc.viewport;
+    vec2 tailPixels = tailClip.xy / tailClip.w * 0.5 * pc.viewport;
+    vec2 along = headPixels - tailPixels;
+    float extent = max(length(along), 1e-3);
+    vec2 direction = along / extent;
+    vec2 across = vec2(-direction.y, direction.x) * inTail.w * 0.5;
+
+    vec2 corner = CORNERS[gl_VertexIndex];
+    vec2 pixels = mix(tailPixels, headPixels, corner.x) + across * corner.y;
+    float w = mix(tailClip.w, headClip.w, corner.x);
+    gl_Position = vec4(pixels / (0.5 * pc.viewport) * w, pc.depth * w, w);
+    fragStreak = corner;
+    fragBrightness = inHead.w;
+}
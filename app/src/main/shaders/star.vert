@@ -0,0 +1,98 @@
+#version 450
+
+// Packed star vertex (16 bytes): position + color index, alpha and a 16-bit twinkle seed.
+// Positions are relative to pc.anchor; stars are drawn with an identity model.
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in uvec4 inPacked;
+
+layout(location = 0) out vec4 fragColor;
+
+// Must match STAR_PALETTE_SIZE in vulkan_wrapper.cpp
+const int PALETTE_SIZE = 256;
+
+// Must match horizon::BINS in horizon_profile.h
+const int TERRAIN_BINS = 256;
+
+// Twinkling near the horizon; the starScintillationPipeline variant sets it,
+// so the plain pipeline carries none of the cost
+layout(constant_id = 0) const bool SCINTILLATION = false;
+const float TWINKLE_AT_ZENITH = 0.015;  // Relative flicker amplitude at airmass 1
+const float MAX_TWINKLE = 0.6;
+
+layout(set = 0, binding = 0) uniform Matrices {
+    mat4 view;
+    mat4 projection;
+    vec4 horizon;  // World-space plane: xyz zenith, w margin; (0, 0, 0, 1) keeps everything
+    vec4 horizonNorth;  // xyz north along the ground, for terrain azimuths
+    vec4 terrain[TERRAIN_BINS / 4];  // Skyline sin(altitude) per azimuth bin, 4 per entry
+    vec4 starPalette[PALETTE_SIZE];  // Color LUT indexed by inPacked.x
+    vec4 scintillation;  // xyz observer zenith (zero when unknown), w seconds, wrapping hourly
+} ubo;
+
+layout(push_constant) uniform PushConstants {
+    mat4 model;
+    vec2 viewport;         // Pixels
+    float minRadiusPixels; // Read by dso.vert and body.vert
+    float depth;           // Depth of the draw's layer (depth order)
+    vec4 anchor;           // xyz: world origin of inPosition
+    vec4 anchorEye;        // xyz: view * anchor, composed in double on the CPU
+} pc;
+
+// Height above the terrain skyline (sine of altitude); negative when hidden
+float aboveTerrain(vec3 world) {
+    vec3 east = cross(ubo.horizonNorth.xyz, ubo.horizon.xyz);
+    float azimuth = atan(dot(world, east), dot(world, ubo.horizonNorth.xyz));
+    int bin = int(floor(fract(azimuth / 6.28318531) * float(TERRAIN_BINS))) & (TERRAIN_BINS - 1);
+    return dot(world, ubo.horizon.xyz) - ubo.terrain[bin >> 2][bin & 3];
+}
+
+uint hash(uint v) {
+    uint state = v * 747796405u + 2891336453u;
+    uint word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    return (word >> 22u) ^ word;
+}
+
+// Brightness factor of a twinkling star. The amplitude follows airmass
+// (Young: sigma ~ X^1.75, X from Rozenberg's formula); each star flickers
+// at its own rate and phase, from its seed.
+float twinkle(vec3 world, uint seed) {
+    float sinAltitude = dot(world, ubo.scintillation.xyz);
+    if (sinAltitude <= 0.0) {
+        return 1.0;  // No observer, or below the horizon
+    }
+    float airmass = 1.0 / (sinAltitude + 0.025 * exp(-11.0 * sinAltitude));
+    float amplitude = min(MAX_TWINKLE, TWINKLE_AT_ZENITH * pow(airmass, 1.75));
+
+    uint h = hash(seed);
+    float phase = float(h & 0xffffu) * (6.28318531 / 65536.0);
+    float rate = 6.28318531 * (3.0 + float(h >> 16u) * (4.0 / 65536.0));  // 3-7 Hz
+    float t = ubo.scintillation.w;
+    float flicker = 0.6 * sin(rate * t + phase) + 0.4 * sin(1.618 * rate * t + 2.0 * phase);
+    return max(0.0, 1.0 + amplitude * flicker);
+}
+
+void main() {
+    vec4 world = pc.model * vec4(inPosition + pc.anchor.xyz, 1.0);
+    if (dot(world.xyz, ubo.horizon.xyz) + ubo.horizon.w < 0.0 || aboveTerrain(world.xyz) < 0.0) {
+        // Below the horizon or terrain: outside the clip volume, dropped before rasterization
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        gl_PointSize = 1.0;
+        fragColor = vec4(0.0);
+        return;
+    }
+    // Only the small offset goes through the float view rotation
+    vec4 eye = ubo.view * vec4(inPosition, 1.0) + vec4(pc.anchorEye.xyz, 0.0);
+    gl_Position = ubo.projection * eye;
+    gl_Position.z = pc.depth * gl_Position.w;
+    gl_PointSize = 8.0;
+    vec4 color = ubo.starPalette[inPacked.x];
+    fragColor = vec4(color.rgb, color.a * float(inPacked.y) / 255.0);
+    if (SCINTILLATION) {
+        // Batches packed in Kotlin carry no seed; their positions are stable
+        uint seed = inPacked.z | (inPacked.w << 8u);
+        if (seed == 0u) {
+            seed = floatBitsToUint(inPosition.x) ^ floatBitsToUint(inPosition.z);
+        }
+        fragColor *= twinkle(world.xyz, seed);
+    }
+}
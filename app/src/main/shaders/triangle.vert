@@ -12,10 +12,15 @@ layout(set = 0, binding = 0) uniform Matrices {
 
 layout(push_constant) uniform PushConstants {
     mat4 model;
+    vec2 viewport;         // Pixels
+    float minRadiusPixels; // Read by dso.vert and body.vert
+    float depth;           // Depth of the draw's layer (depth order)
 } pc;
 
 void main() {
     gl_Position = ubo.projection * ubo.view * pc.model * vec4(inPosition, 1.0);
+    // Everything on the sky sphere is at one distance; the layer decides what hides what
+    gl_Position.z = pc.depth * gl_Position.w;
     gl_PointSize = 8.0;
     fragColor = inColor;
 }
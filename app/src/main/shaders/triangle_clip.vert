@@ -0,0 +1,49 @@
+#version 450
+
+// triangle.vert plus horizon clipping; used when the device has shaderClipDistance
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec4 inColor;
+
+layout(location = 0) out vec4 fragColor;
+
+// Must match horizon::BINS in horizon_profile.h
+const int TERRAIN_BINS = 256;
+
+layout(set = 0, binding = 0) uniform Matrices {
+    mat4 view;
+    mat4 projection;
+    vec4 horizon;  // World-space plane: xyz zenith, w margin; (0, 0, 0, 1) keeps everything
+    vec4 horizonNorth;  // xyz north along the ground, for terrain azimuths
+    vec4 terrain[TERRAIN_BINS / 4];  // Skyline sin(altitude) per azimuth bin, 4 per entry
+} ubo;
+
+layout(push_constant) uniform PushConstants {
+    mat4 model;
+    vec2 viewport;         // Pixels
+    float minRadiusPixels; // Read by dso.vert and body.vert
+    float depth;           // Depth of the draw's layer (depth order)
+} pc;
+
+// Height above the terrain skyline (sine of altitude); negative when hidden
+float aboveTerrain(vec3 world) {
+    vec3 east = cross(ubo.horizonNorth.xyz, ubo.horizon.xyz);
+    float azimuth = atan(dot(world, east), dot(world, ubo.horizonNorth.xyz));
+    int bin = int(floor(fract(azimuth / 6.28318531) * float(TERRAIN_BINS))) & (TERRAIN_BINS - 1);
+    return dot(world, ubo.horizon.xyz) - ubo.terrain[bin >> 2][bin & 3];
+}
+
+out gl_PerVertex {
+    vec4 gl_Position;
+    float gl_PointSize;
+    float gl_ClipDistance[1];
+};
+
+void main() {
+    vec4 world = pc.model * vec4(inPosition, 1.0);
+    gl_Position = ubo.projection * ubo.view * world;
+    gl_Position.z = pc.depth * gl_Position.w;
+    gl_PointSize = 8.0;
+    gl_ClipDistance[0] = min(dot(world.xyz, ubo.horizon.xyz) + ubo.horizon.w, aboveTerrain(world.xyz));
+    fragColor = inColor;
+}
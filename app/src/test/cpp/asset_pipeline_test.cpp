@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "asset_pipeline.h"
+
+namespace {
+
+jobs::Config testConfig(unsigned workers) {
+    jobs::Config config;
+    config.workerCount = workers;
+    config.pinWorkers = false;
+    return config;
+}
+
+assets::Load hopToWorker(assets::LoadGroup& group, jobs::JobSystem& system, std::thread::id& ranOn) {
+    auto ticket = group.join();
+    co_await assets::resumeOn(system);
+    ranOn = std::this_thread::get_id();
+}
+
+TEST(AssetPipelineTest, ResumeOnContinuesOnWorker) {
+    jobs::JobSystem system(testConfig(1));
+    assets::LoadGroup group;
+    std::thread::id ranOn;
+
+    hopToWorker(group, system, ranOn);
+    while (group.inFlight() > 0) std::this_thread::yield();
+
+    EXPECT_NE(std::thread::id(), ranOn);
+    EXPECT_NE(std::this_thread::get_id(), ranOn);
+}
+
+assets::Load waitForFrames(assets::FrameTimeline& timeline, uint64_t frames, int& stage) {
+    stage = 1;
+    co_await timeline.reached(frames);
+    stage = 2;
+    co_await timeline.nextFrame();
+    stage = 3;
+}
+
+TEST(AssetPipelineTest, TimelineResumesWhenFramesComplete) {
+    assets::FrameTimeline timeline;
+    int stage = 0;
+    waitForFrames(timeline, 3, stage);
+    EXPECT_EQ(1, stage);
+
+    timeline.advance(2);
+    EXPECT_EQ(1, stage);
+    timeline.advance(3);
+    EXPECT_EQ(2, stage);  // nextFrame waits for the following advance
+    timeline.advance(3);
+    EXPECT_EQ(3, stage);
+    EXPECT_EQ(0u, timeline.waiting());
+}
+
+TEST(AssetPipelineTest, ReachedFrameDoesNotSuspend) {
+    assets::FrameTimeline timeline;
+    timeline.advance(10);
+    int stage = 0;
+    waitForFrames(timeline, 4, stage);
+    EXPECT_EQ(2, stage);
+    timeline.advance(5);
+    EXPECT_EQ(3, stage);
+}
+
+assets::Load holdBytes(assets::MemoryBudget& budget, assets::FrameTimeline& timeline, size_t bytes,
+                       std::vector<int>& order, int id) {
+    auto memory = co_await budget.reserve(bytes);
+    order.push_back(id);
+    co_await timeline.nextFrame();
+}
+
+TEST(AssetPipelineTest, BudgetQueuesUntilReleased) {
+    assets::MemoryBudget budget(100);
+    assets::FrameTimeline timeline;
+    std::vector<int> order;
+
+    holdBytes(budget, timeline, 60, order, 1);
+    holdBytes(budget, timeline, 60, order, 2);  // Would exceed the budget
+    holdBytes(budget, timeline, 10, order, 3);  // Fits, but stays behind 2
+    EXPECT_EQ((std::vector<int>{1}), order);
+    EXPECT_EQ(60u, budget.inUse());
+    EXPECT_EQ(2u, budget.waiting());
+
+    timeline.advance(1);  // 1 finishes; 2 and 3 fit together
+    EXPECT_EQ((std::vector<int>{1, 2, 3}), order);
+    EXPECT_EQ(70u, budget.inUse());
+
+    timeline.advance(2);
+    EXPECT_EQ(0u, budget.inUse());
+}
+
+TEST(AssetPipelineTest, OversizeReservationGrantedAlone) {
+    assets::MemoryBudget budget(100);
+    assets::FrameTimeline timeline;
+    std::vector<int> order;
+
+    holdBytes(budget, timeline, 10, order, 1);
+    holdBytes(budget, timeline, 500, order, 2);
+    EXPECT_EQ((std::vector<int>{1}), order);
+
+    timeline.advance(1);
+    EXPECT_EQ((std::vector<int>{1, 2}), order);
+    EXPECT_EQ(500u, budget.inUse());
+    timeline.advance(2);
+    EXPECT_EQ(0u, budget.inUse());
+}
+
+struct Renderer {
+    assets::MemoryBudget budget{4096};
+    assets::FrameTimeline timeline;
+    assets::LoadGroup loads;
+    std::thread::id renderThread = std::this_thread::get_id();
+    std::atomic<size_t> peakBytes{0};
+    std::vector<long> uploaded;  // Render thread only
+    bool uploadsOnRenderThread = true;
+};
+
+assets::Load loadAsset(Renderer& r, jobs::JobSystem& system, int id) {
+    auto ticket = r.loads.join();
+    auto memory = co_await r.budget.reserve(1024);
+    size_t inUse = r.budget.inUse();
+    size_t peak = r.peakBytes.load();
+    while (inUse > peak && !r.peakBytes.compare_exchange_weak(peak, inUse)) {}
+
+    // "Decode" on a worker
+    co_await assets::resumeOn(system);
+    long decoded = 0;
+    for (int i = 0; i <= id * 1000; i++) decoded += i % 7;
+
+    co_await r.timeline.nextFrame();
+    r.uploadsOnRenderThread &= std::this_thread::get_id() == r.renderThread;
+    r.uploaded.push_back(decoded);
+}
+
+TEST(AssetPipelineTest, ManyLoadsStayWithinBudget) {
+    jobs::JobSystem system(testConfig(3));
+    Renderer renderer;
+    constexpr int LOADS = 32;
+
+    for (int i = 0; i < LOADS; i++) loadAsset(renderer, system, i);
+
+    uint64_t frame = 0;
+    while (renderer.loads.inFlight() > 0) {
+        renderer.timeline.advance(++frame);
+        std::this_thread::yield();
+    }
+
+    EXPECT_EQ(static_cast<size_t>(LOADS), renderer.uploaded.size());
+    EXPECT_TRUE(renderer.uploadsOnRenderThread);
+    EXPECT_LE(renderer.peakBytes.load(), renderer.budget.limit());
+    EXPECT_EQ(0u, renderer.budget.inUse());
+}
+
+} // namespace
@@ -0,0 +1,35 @@
+#ifndef BENCHMARK_SKY_H
+#define BENCHMARK_SKY_H
+
+// Standard star field of the benchmarks: a synthetic catalog (synthetic_sky.h)
+// written to the runtime tile format and read back through tiles::View, as
+// the renderer would read a shipped catalog.
+
+#include <cstdint>
+#include <vector>
+#include "job_system.h"
+#include "sky_tiles.h"
+#include "synthetic_sky.h"
+
+namespace bench {
+
+constexpr uint64_t SKY_SEED = 42;
+
+/** The brightest `count` stars of the synthetic sky, in tile order. */
+inline std::vector<sky::Object> syntheticSky(uint64_t count, jobs::JobSystem* jobs = nullptr) {
+    synthetic::Config config;
+    config.count = count;
+    config.seed = SKY_SEED;
+    const std::vector<uint8_t> file = synthetic::generate(config, jobs);
+
+    tiles::View view;
+    std::vector<sky::Object> objects;
+    if (!view.open(file.data(), file.size())) return objects;
+    objects.reserve(view.objectCount());
+    for (uint32_t t = 0; t < view.tileCount(); t++) view.appendTile(t, objects);
+    return objects;
+}
+
+} // namespace bench
+
+#endif // BENCHMARK_SKY_H
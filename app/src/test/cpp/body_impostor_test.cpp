@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include "body_impostor.h"
+
+namespace {
+
+constexpr double MOON_RADIUS_KM = 1737.4;
+constexpr double MOON_DISTANCE_AU = 384400.0 / bodies::AU_KM;
+
+TEST(BodyImpostorTest, AngularRadiusOfMoon) {
+    const double degrees = bodies::angularRadius(MOON_RADIUS_KM, MOON_DISTANCE_AU) * 180.0 / dso::PI;
+    EXPECT_NEAR(0.259, degrees, 0.001);
+    // Inside the sphere the disc fills the sky
+    EXPECT_FLOAT_EQ(static_cast<float>(dso::PI / 2), bodies::angularRadius(10.0, 1e-9));
+}
+
+TEST(BodyImpostorTest, OppositionIsFullyLit) {
+    const float dir[3] = {1.0f, 0.0f, 0.0f};
+    const float sun[3] = {-1.0f, 0.0f, 0.0f};
+    const auto inst = bodies::makeInstance(dir, 5.0, 69911.0, sun, 1.0, 0.0f, 0xffffffff, 0);
+
+    EXPECT_FLOAT_EQ(1.0f, bodies::illuminatedFraction(inst));
+    EXPECT_FLOAT_EQ(1.0f, bodies::shade(inst, 0.0f, 0.0f));
+    EXPECT_NEAR(1.0f, bodies::shade(inst, 0.7f, -0.3f), 1e-5f);  // Flat disc at full phase
+    EXPECT_FLOAT_EQ(0.0f, bodies::shade(inst, 0.8f, 0.8f));      // Off the disc
+}
+
+TEST(BodyImpostorTest, NewMoonIsDark) {
+    const float dir[3] = {0.0f, 0.6f, 0.8f};
+    const auto inst = bodies::makeInstance(dir, MOON_DISTANCE_AU, MOON_RADIUS_KM, dir, 1.0, 0.0f, 0xffffffff, 0);
+
+    EXPECT_NEAR(0.0f, bodies::illuminatedFraction(inst), 1e-5f);
+    EXPECT_FLOAT_EQ(0.0f, bodies::shade(inst, 0.0f, 0.0f));
+}
+
+TEST(BodyImpostorTest, QuarterPhaseLightsTheSunwardHalf) {
+    // Sun 90 degrees east of the Moon: first quarter
+    const float dir[3] = {1.0f, 0.0f, 0.0f};
+    const float sun[3] = {0.0f, 1.0f, 0.0f};
+    const auto inst = bodies::makeInstance(dir, MOON_DISTANCE_AU, MOON_RADIUS_KM, sun, 1.0, 0.0f, 0xffffffff, 0);
+    EXPECT_NEAR(0.5f, bodies::illuminatedFraction(inst), 0.01f);
+
+    float light[3];
+    bodies::localLight(inst, light);
+    EXPECT_GT(light[0], 0.99f);  // Toward glyph east
+
+    EXPECT_GT(bodies::shade(inst, 0.5f, 0.0f), 0.0f);
+    EXPECT_FLOAT_EQ(0.0f, bodies::shade(inst, -0.5f, 0.0f));
+
+    // Lit share of the disc matches the phase
+    int inside = 0, lit = 0;
+    for (int i = 0; i < 200; i++) {
+        for (int j = 0; j < 200; j++) {
+            const float u = (i + 0.5f) / 100.0f - 1.0f, v = (j + 0.5f) / 100.0f - 1.0f;
+            if (u * u + v * v > 1.0f) continue;
+            inside++;
+            if (bodies::shade(inst, u, v) > 0.0f) lit++;
+        }
+    }
+    EXPECT_NEAR(bodies::illuminatedFraction(inst), static_cast<float>(lit) / inside, 0.02f);
+}
+
+TEST(BodyImpostorTest, EmissiveDiscDarkensTowardLimb) {
+    const float dir[3] = {0.0f, 0.0f, 1.0f};
+    const auto inst = bodies::makeInstance(dir, 1.0, 695700.0, dir, 1.0, 0.6f, 0xffffee99,
+                                           bodies::FLAG_EMISSIVE);
+
+    EXPECT_FLOAT_EQ(1.0f, bodies::illuminatedFraction(inst));
+    EXPECT_FLOAT_EQ(1.0f, bodies::shade(inst, 0.0f, 0.0f));
+    const float mu = std::sqrt(1.0f - 0.8f * 0.8f);
+    EXPECT_NEAR(1.0f - 0.6f * (1.0f - mu), bodies::shade(inst, 0.8f, 0.0f), 1e-5f);
+    EXPECT_EQ(0xff99eeffu, inst.color);  // RGBA8, R in the low byte
+}
+
+} // namespace
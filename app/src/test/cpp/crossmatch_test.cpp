@@ -0,0 +1,218 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <vector>
+#include "crossmatch.h"
+
+namespace {
+
+using crossmatch::Source;
+
+Source sourceAt(uint64_t id, double ra, double dec, float magnitude, std::string name = "") {
+    Source s;
+    s.id = id;
+    s.ra = ra;
+    s.dec = dec;
+    s.magnitude = magnitude;
+    s.name = std::move(name);
+    return s;
+}
+
+// Random stars, a third of them crowded around a pole and a base face corner
+std::vector<Source> randomSources(size_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> ra(0.0, 360.0), sinDec(-1.0, 1.0), near(-0.02, 0.02);
+    std::uniform_real_distribution<float> magnitude(2.0f, 12.0f);
+    std::vector<Source> sources;
+    for (size_t i = 0; i < count; i++) {
+        double r, d;
+        switch (i % 3) {
+        case 0: r = ra(rng); d = std::asin(sinDec(rng)) * 180.0 / crossmatch::PI; break;
+        case 1: r = ra(rng); d = 89.98 + near(rng); break;        // North pole
+        default: r = 45.0 + near(rng); d = 41.8103 + near(rng); break;  // Where faces 0, 4 and 5 meet
+        }
+        sources.push_back(sourceAt(i + 1, r, std::min(90.0, d), magnitude(rng)));
+    }
+    return sources;
+}
+
+// The same source moved by up to `arcsec` in a random direction
+Source jitter(const Source& s, double arcsec, std::mt19937& rng, uint64_t id) {
+    std::uniform_real_distribution<double> u(-1.0, 1.0);
+    Source moved = s;
+    moved.id = id;
+    moved.dec = std::clamp(s.dec + u(rng) * arcsec / 3600.0, -90.0, 90.0);
+    moved.ra = s.ra + u(rng) * arcsec / 3600.0 / std::max(1e-3, std::cos(moved.dec * crossmatch::PI / 180.0));
+    return moved;
+}
+
+std::vector<crossmatch::Star> catalogOf(const std::vector<Source>& sources) {
+    std::vector<crossmatch::Star> stars;
+    for (const Source& s : sources) stars.push_back({s, 0, 0});
+    return stars;
+}
+
+crossmatch::Match bruteForce(const std::vector<crossmatch::Star>& stars, const double v[3], float magnitude,
+                             double radiusRad, float maxDm) {
+    const double chord = 2.0 * std::sin(0.5 * radiusRad);
+    crossmatch::Match best;
+    for (uint32_t r = 0; r < stars.size(); r++) {
+        double w[3];
+        crossmatch::unitVector(stars[r].source.ra, stars[r].source.dec, w);
+        const double d2 = (w[0] - v[0]) * (w[0] - v[0]) + (w[1] - v[1]) * (w[1] - v[1]) + (w[2] - v[2]) * (w[2] - v[2]);
+        const float dm = std::abs(stars[r].source.magnitude - magnitude);
+        if (d2 > chord * chord || dm > maxDm) continue;
+        const float score = static_cast<float>(d2 / (chord * chord)) + (dm / maxDm) * (dm / maxDm);
+        if (score < best.score) best = {r, score};
+    }
+    return best;
+}
+
+TEST(CrossmatchTest, BucketOrderKeepsPixelsWiderThanRadius) {
+    for (double arcsec : {0.5, 1.0, 5.0, 60.0, 3600.0}) {
+        const double radius = arcsec * crossmatch::ARCSEC;
+        const int order = crossmatch::bucketOrder(radius);
+        EXPECT_GE(healpix::resolution(order), crossmatch::PIXEL_RADII * radius);
+        if (order < crossmatch::MAX_BUCKET_ORDER) {
+            EXPECT_LT(healpix::resolution(order + 1), crossmatch::PIXEL_RADII * radius);
+        }
+    }
+}
+
+TEST(CrossmatchTest, IndexMatchesBruteForce) {
+    // Large radius against a dense field, so buckets hold many stars and edges are crossed often
+    const double radius = 60.0 * crossmatch::ARCSEC;
+    const auto stars = catalogOf(randomSources(3000, 3));
+    crossmatch::Index index;
+    index.build(stars, radius);
+    EXPECT_EQ(stars.size(), index.size());
+
+    std::mt19937 rng(4);
+    int found = 0;
+    for (size_t i = 0; i < stars.size(); i++) {
+        const Source probe = jitter(stars[i].source, 90.0, rng, 0);
+        double v[3];
+        crossmatch::unitVector(probe.ra, probe.dec, v);
+        const crossmatch::Match expected = bruteForce(stars, v, probe.magnitude + 0.3f, radius, 1.0f);
+        const crossmatch::Match actual = index.best(v, probe.magnitude + 0.3f, 1.0f);
+        EXPECT_EQ(expected.row, actual.row) << "probe " << i;
+        if (actual.row != crossmatch::NO_MATCH) found++;
+    }
+    EXPECT_GT(found, 1000);
+}
+
+TEST(CrossmatchTest, MergeKeepsPriorityPositionAndFillsNames) {
+    crossmatch::Options options;
+    options.radiusArcsec = 2.0;
+    crossmatch::Merger merger(options);
+
+    merger.beginCatalog();
+    std::vector<Source> first = {sourceAt(1, 10.0, 20.0, 5.0f), sourceAt(2, 200.0, -30.0, 6.0f, "Named")};
+    merger.addChunk(first);
+    merger.endCatalog();
+
+    merger.beginCatalog();
+    std::vector<Source> second = {sourceAt(11, 10.0 + 0.5 / 3600.0, 20.0, 5.1f, "Filled"),
+                                  sourceAt(12, 200.0, -30.0 + 1.0 / 3600.0, 6.2f, "Ignored"),
+                                  sourceAt(13, 50.0, 50.0, 9.0f)};
+    merger.addChunk(second);
+    merger.endCatalog();
+
+    const auto& stars = merger.stars();
+    ASSERT_EQ(3u, stars.size());
+    EXPECT_EQ(2u, merger.matched());
+    EXPECT_EQ(1u, stars[0].source.id);
+    EXPECT_EQ(10.0, stars[0].source.ra);
+    EXPECT_EQ(5.0f, stars[0].source.magnitude);
+    EXPECT_EQ("Filled", stars[0].source.name);
+    EXPECT_EQ(1u, stars[0].matches);
+    EXPECT_EQ("Named", stars[1].source.name);
+    EXPECT_EQ(13u, stars[2].source.id);
+    EXPECT_EQ(1u, stars[2].catalog);
+    EXPECT_EQ(0u, stars[2].matches);
+}
+
+TEST(CrossmatchTest, OneSourcePerStarPerCatalog) {
+    crossmatch::Options options;
+    options.radiusArcsec = 2.0;
+    crossmatch::Merger merger(options);
+
+    merger.beginCatalog();
+    std::vector<Source> first = {sourceAt(1, 100.0, 0.0, 8.0f)};
+    merger.addChunk(first);
+    merger.endCatalog();
+
+    // Both are within the radius; the nearer one with the closer magnitude wins
+    merger.beginCatalog();
+    std::vector<Source> second = {sourceAt(11, 100.0 + 1.5 / 3600.0, 0.0, 8.5f),
+                                  sourceAt(12, 100.0 + 0.2 / 3600.0, 0.0, 8.1f)};
+    merger.addChunk(second);
+    merger.endCatalog();
+
+    const auto& stars = merger.stars();
+    ASSERT_EQ(2u, stars.size());
+    EXPECT_EQ(1u, stars[0].matches);
+    EXPECT_EQ(11u, stars[1].source.id);  // The loser is kept as a star of its own
+}
+
+TEST(CrossmatchTest, MagnitudeToleranceRejectsOpticalCompanions) {
+    crossmatch::Options options;
+    options.radiusArcsec = 5.0;
+    options.maxMagnitudeDifference = 1.0f;
+    crossmatch::Merger merger(options);
+
+    merger.beginCatalog();
+    std::vector<Source> first = {sourceAt(1, 0.0, 0.0, 4.0f)};
+    merger.addChunk(first);
+    merger.endCatalog();
+
+    merger.beginCatalog();
+    std::vector<Source> second = {sourceAt(2, 1.0 / 3600.0, 0.0, 11.0f)};
+    merger.addChunk(second);
+    merger.endCatalog();
+
+    EXPECT_EQ(2u, merger.stars().size());
+    EXPECT_EQ(0u, merger.matched());
+}
+
+TEST(CrossmatchTest, ChunksAndThreadsDoNotChangeTheResult) {
+    const auto base = randomSources(4000, 7);
+    std::mt19937 rng(8);
+    std::vector<Source> deeper;
+    for (size_t i = 0; i < base.size(); i += 2) deeper.push_back(jitter(base[i], 1.5, rng, 100000 + i));
+    const auto extra = randomSources(2000, 9);
+    deeper.insert(deeper.end(), extra.begin(), extra.end());
+
+    auto merge = [&](size_t chunkSize, jobs::JobSystem* jobs) {
+        crossmatch::Options options;
+        options.radiusArcsec = 2.0;
+        options.maxMagnitudeDifference = 20.0f;
+        options.grain = 256;
+        crossmatch::Merger merger(options, jobs);
+        for (const std::vector<Source>& catalog : {std::cref(base), std::cref(deeper)}) {
+            merger.beginCatalog();
+            for (size_t b = 0; b < catalog.size(); b += chunkSize) {
+                std::vector<Source> chunk(catalog.begin() + b, catalog.begin() + std::min(catalog.size(), b + chunkSize));
+                merger.addChunk(chunk);
+            }
+            merger.endCatalog();
+        }
+        std::vector<std::pair<uint64_t, uint32_t>> result;
+        for (const auto& star : merger.stars()) result.push_back({star.source.id, star.matches});
+        return std::make_pair(result, merger.matched());
+    };
+
+    const auto reference = merge(1u << 20, nullptr);
+    EXPECT_GE(reference.second, base.size() / 2);
+
+    jobs::Config config;
+    config.workerCount = 3;
+    config.pinWorkers = false;
+    jobs::JobSystem jobs(config);
+    EXPECT_EQ(reference, merge(500, nullptr));
+    EXPECT_EQ(reference, merge(1u << 20, &jobs));
+    EXPECT_EQ(reference, merge(777, &jobs));
+}
+
+} // namespace
@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "cull_service.h"
+
+namespace {
+
+constexpr float DEG = static_cast<float>(cull::PI / 180.0);
+
+// Perspective projection (column-major, camera looking down -z) with a
+// square 60 degree field
+void perspective(float m[16]) {
+    const float f = 1.0f / std::tan(30.0f * DEG);
+    const float n = 0.1f, far = 100.0f;
+    std::fill(m, m + 16, 0.0f);
+    m[0] = f;
+    m[5] = f;
+    m[10] = far / (n - far);
+    m[11] = -1.0f;
+    m[14] = n * far / (n - far);
+}
+
+struct View {
+    float view[16], projection[16], model[16];
+    View() {
+        math::identity(view);
+        math::identity(model);
+        perspective(projection);
+    }
+    cull::Frustum frustum(const float* horizon = nullptr) const {
+        return cull::Frustum::from(view, projection, model, horizon);
+    }
+};
+
+bool ballVisible(const cull::Frustum& f, float x, float y, float z, float r) {
+    uint8_t visible;
+    f.test(&x, &y, &z, &r, 1, &visible);
+    return visible != 0;
+}
+
+// Line segments (x, y, z, r, g, b, a) along a great circle in the x/z plane
+// at 5 degree steps, starting straight ahead (-z)
+std::vector<float> circleSegments() {
+    std::vector<float> vertices;
+    for (int step = 0; step < 72; step++) {
+        for (int end = 0; end < 2; end++) {
+            const float angle = (step + end) * 5.0f * DEG;
+            const float v[7] = {std::sin(angle), 0.0f, -std::cos(angle), 1.0f, 1.0f, 1.0f, 1.0f};
+            vertices.insert(vertices.end(), v, v + 7);
+        }
+    }
+    return vertices;
+}
+
+TEST(CullServiceTest, BallsAgainstTheFrustumSides) {
+    View v;
+    const cull::Frustum f = v.frustum();
+    EXPECT_TRUE(ballVisible(f, 0.0f, 0.0f, -1.0f, 0.0f));
+    EXPECT_FALSE(ballVisible(f, 0.0f, 0.0f, 1.0f, 0.1f));  // Behind
+    // 40 degrees off axis is outside the 30 degree half field...
+    const float s = std::sin(40.0f * DEG), c = std::cos(40.0f * DEG);
+    EXPECT_FALSE(ballVisible(f, s, 0.0f, -c, cull::chordRadius(5.0f * DEG)));
+    EXPECT_FALSE(ballVisible(f, 0.0f, -s, -c, cull::chordRadius(5.0f * DEG)));
+    // ...unless its cap reaches back over the edge
+    EXPECT_TRUE(ballVisible(f, s, 0.0f, -c, cull::chordRadius(12.0f * DEG)));
+    EXPECT_TRUE(ballVisible(f, 0.0f, 0.0f, 1.0f, cull::chordRadius(180.0f * DEG)));
+}
+
+TEST(CullServiceTest, HorizonPlaneHidesTheGround) {
+    View v;
+    // Zenith along +y, a small margin; the disabled plane keeps everything
+    const float horizon[4] = {0.0f, 1.0f, 0.0f, 0.01f};
+    const float disabled[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+    const float s = std::sin(20.0f * DEG), c = std::cos(20.0f * DEG);
+    EXPECT_FALSE(ballVisible(v.frustum(horizon), 0.0f, -s, -c, cull::chordRadius(5.0f * DEG)));
+    EXPECT_TRUE(ballVisible(v.frustum(horizon), 0.0f, -s, -c, cull::chordRadius(25.0f * DEG)));
+    EXPECT_TRUE(ballVisible(v.frustum(horizon), 0.0f, s, -c, cull::chordRadius(5.0f * DEG)));
+    EXPECT_TRUE(ballVisible(v.frustum(disabled), 0.0f, -s, -c, cull::chordRadius(5.0f * DEG)));
+}
+
+TEST(CullServiceTest, ModelMatrixMovesBatchesIntoView) {
+    View v;
+    // Half a turn about y: model +z lands straight ahead
+    v.model[0] = -1.0f;
+    v.model[10] = -1.0f;
+    EXPECT_TRUE(ballVisible(v.frustum(), 0.0f, 0.0f, 1.0f, 0.0f));
+    EXPECT_FALSE(ballVisible(v.frustum(), 0.0f, 0.0f, -1.0f, 0.1f));
+
+    // The world horizon comes along: world -y is model -y
+    const float horizon[4] = {0.0f, 1.0f, 0.0f, 0.0f};
+    const float s = std::sin(20.0f * DEG), c = std::cos(20.0f * DEG);
+    EXPECT_FALSE(ballVisible(v.frustum(horizon), 0.0f, -s, c, 0.01f));
+}
+
+TEST(CullServiceTest, BoundingBallHoldsEveryVertex) {
+    const std::vector<float> vertices = circleSegments();
+    float ball[4];
+    cull::boundingBall(vertices.data(), 24, 7, ball);
+    EXPECT_NEAR(ball[0] * ball[0] + ball[1] * ball[1] + ball[2] * ball[2], 1.0f, 1e-5f);
+    // 12 segments span 60 degrees: a 30 degree cap
+    EXPECT_NEAR(ball[3], cull::chordRadius(30.0f * DEG), 1e-4f);
+
+    // A whole great circle has no mean direction but is still bounded
+    cull::boundingBall(vertices.data(), 144, 7, ball);
+    EXPECT_GE(ball[3], 2.0f);
+}
+
+TEST(CullServiceTest, PixelCapCoversThePixel) {
+    for (uint64_t pix : {0ull, 17ull, 100ull, 191ull}) {
+        const cull::Cap cap = cull::pixelCap(2, pix);
+        double corners[4][3];
+        healpix::nestCorners(2, pix, corners);
+        for (const double* corner : corners) {
+            const double dot = cap.x * corner[0] + cap.y * corner[1] + cap.z * corner[2];
+            EXPECT_LE(std::acos(std::min(1.0, dot)), cap.radius) << pix;
+        }
+    }
+}
+
+TEST(CullServiceTest, TransientBatchesDrawOnlyVisibleRuns) {
+    View v;
+    const std::vector<float> vertices = circleSegments();
+    std::vector<cull::Range> runs;
+    const uint32_t drawn = cull::cullVertices(v.frustum(), vertices.data(), 144, 7, 2,
+                                              [&runs](cull::Range r) { runs.push_back(r); });
+
+    // The view spans +/-30 degrees of the circle's first and last chunks,
+    // which are not adjacent: two runs of whole chunks
+    ASSERT_EQ(runs.size(), 2u);
+    EXPECT_EQ(runs[0].first, 0u);
+    EXPECT_EQ(runs[0].count % 2, 0u);
+    EXPECT_EQ(runs[1].first + runs[1].count, 144u);
+    EXPECT_EQ(drawn, runs[0].count + runs[1].count);
+    EXPECT_LT(drawn, 144u / 2);
+}
+
+TEST(CullServiceTest, RegisteredBatchesAreCulledOncePerFrame) {
+    View v;
+    const std::vector<float> vertices = circleSegments();
+    cull::Service service;
+    const int id = service.add(3, vertices.data(), 144, 7, 2, v.model);
+    ASSERT_TRUE(service.live(id));
+
+    // Untested chunks are all drawn
+    uint32_t drawn = service.forEachVisible(id, [](cull::Range) {});
+    EXPECT_EQ(drawn, 144u);
+
+    service.cull(v.view, v.projection, nullptr);
+    EXPECT_EQ(service.frameStats()[3].vertices, 144u);
+    EXPECT_EQ(service.frameStats()[3].drawn, 144u);
+
+    std::vector<cull::Range> runs;
+    drawn = service.forEachVisible(id, [&runs](cull::Range r) { runs.push_back(r); });
+    EXPECT_EQ(runs.size(), 2u);
+    EXPECT_LT(drawn, 144u / 2);
+
+    // Turn around: the far side of the circle comes into view
+    v.view[0] = -1.0f;
+    v.view[10] = -1.0f;
+    service.cull(v.view, v.projection, nullptr);
+    EXPECT_EQ(service.frameStats()[3].drawn, drawn);
+    runs.clear();
+    service.forEachVisible(id, [&runs](cull::Range r) { runs.push_back(r); });
+    ASSERT_EQ(runs.size(), 1u);
+    EXPECT_LT(runs[0].first, 72u);
+    EXPECT_GT(runs[0].first + runs[0].count, 72u);
+
+    EXPECT_TRUE(service.remove(id));
+    EXPECT_FALSE(service.live(id));
+    EXPECT_EQ(service.forEachVisible(id, [](cull::Range) {}), 0u);
+    EXPECT_EQ(service.add(0, vertices.data(), 2, 7, 2, nullptr), id);  // Ids are reused
+}
+
+TEST(CullServiceTest, CoverageChunksAreVisibleIfAnyPixelIs) {
+    View v;
+    const std::vector<float> vertices = circleSegments();
+    // Pixels straight ahead (-z) and straight behind (+z)
+    const uint64_t ahead = healpix::vecToNest(3, 0.0, 0.0, -1.0);
+    const uint64_t behind = healpix::vecToNest(3, 0.0, 0.0, 1.0);
+    std::vector<cull::Chunk> chunks(3);
+    chunks[0] = {0, 10, cull::coverageCaps(3, {behind})};
+    chunks[1] = {10, 10, cull::coverageCaps(3, {behind, ahead})};
+    chunks[2] = {20, 10, cull::coverageCaps(3, {behind})};
+
+    cull::Service service;
+    const int id = service.add(1, vertices.data(), 30, 7, chunks, nullptr);
+    service.cull(v.view, v.projection, nullptr);
+    std::vector<cull::Range> runs;
+    EXPECT_EQ(service.forEachVisible(id, [&runs](cull::Range r) { runs.push_back(r); }), 10u);
+    ASSERT_EQ(runs.size(), 1u);
+    EXPECT_EQ(runs[0].first, 10u);
+
+    chunks[2].firstVertex = 25;
+    EXPECT_EQ(service.add(1, vertices.data(), 30, 7, chunks, nullptr), -1);
+}
+
+} // namespace
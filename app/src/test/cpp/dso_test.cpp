@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include "dso.h"
+
+namespace {
+
+uint32_t shapeValue(dso::Shape shape) { return static_cast<uint32_t>(shape); }
+
+TEST(DsoTest, ShapesMapToGlyphs) {
+    EXPECT_EQ(dso::Glyph::Disc, dso::glyphFor(dso::Shape::Circle));
+    EXPECT_EQ(dso::Glyph::Ellipse, dso::glyphFor(dso::Shape::EllipticalGalaxy));
+    EXPECT_EQ(dso::Glyph::Ellipse, dso::glyphFor(dso::Shape::LenticularGalaxy));
+    EXPECT_EQ(dso::Glyph::Spiral, dso::glyphFor(dso::Shape::SpiralGalaxy));
+    EXPECT_EQ(dso::Glyph::GlobularCluster, dso::glyphFor(dso::Shape::GlobularCluster));
+    EXPECT_EQ(dso::Glyph::OpenCluster, dso::glyphFor(dso::Shape::OpenCluster));
+    EXPECT_EQ(dso::Glyph::Nebula, dso::glyphFor(dso::Shape::Nebula));
+
+    // Values outside source.proto's enum fall back to a disc
+    auto inst = dso::makeInstance(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 42u, 0xffffffffu);
+    EXPECT_EQ(static_cast<uint32_t>(dso::Glyph::Disc), inst.glyph);
+}
+
+TEST(DsoTest, PackColorSwizzlesAndDefaultsAlpha) {
+    EXPECT_EQ(0x80332211u, dso::packColor(0x80112233u));
+    // Catalog colors without alpha are opaque
+    EXPECT_EQ(0xff41a848u, dso::packColor(0x0048a841u));
+}
+
+TEST(DsoTest, InstanceGeometry) {
+    auto inst = dso::makeInstance(90.0f, 30.0f, 20.0f, 10.0f, 45.0f,
+                                  shapeValue(dso::Shape::SpiralGalaxy), 0xffffffffu);
+    EXPECT_NEAR(0.0f, inst.x, 1e-6f);
+    EXPECT_NEAR(std::cos(dso::PI / 6.0), inst.y, 1e-6);
+    EXPECT_NEAR(0.5f, inst.z, 1e-6f);
+    EXPECT_NEAR(10.0 * dso::ARCMIN_TO_RAD, inst.semiMajor, 1e-9);
+    EXPECT_FLOAT_EQ(0.5f, inst.axisRatio);
+    EXPECT_NEAR(dso::PI / 4.0, inst.positionAngle, 1e-6);
+}
+
+TEST(DsoTest, MissingOrSwappedAxes) {
+    auto unsized = dso::makeInstance(0.0f, 0.0f, 0.0f, 0.0f, 30.0f, 0u, 0u);
+    EXPECT_FLOAT_EQ(0.0f, unsized.semiMajor);
+    EXPECT_FLOAT_EQ(1.0f, unsized.axisRatio);
+
+    auto round = dso::makeInstance(0.0f, 0.0f, 8.0f, 0.0f, 0.0f, 0u, 0u);
+    EXPECT_FLOAT_EQ(1.0f, round.axisRatio);
+
+    // Minor > major: the long axis is rotated a quarter turn
+    auto swapped = dso::makeInstance(0.0f, 0.0f, 4.0f, 8.0f, 10.0f, 0u, 0u);
+    EXPECT_NEAR(4.0 * dso::ARCMIN_TO_RAD, swapped.semiMajor, 1e-9);
+    EXPECT_FLOAT_EQ(0.5f, swapped.axisRatio);
+    EXPECT_NEAR(100.0 * dso::PI / 180.0, swapped.positionAngle, 1e-6);
+
+    auto edgeOn = dso::makeInstance(0.0f, 0.0f, 100.0f, 1.0f, 0.0f, 0u, 0u);
+    EXPECT_FLOAT_EQ(dso::MIN_AXIS_RATIO, edgeOn.axisRatio);
+}
+
+TEST(DsoTest, PositionAngleRunsNorthThroughEast) {
+    // At RA 0 Dec 0, north is +z and east (increasing RA) is +y
+    float axis[3];
+    dso::majorAxis(dso::makeInstance(0.0f, 0.0f, 10.0f, 5.0f, 0.0f, 0u, 0u), axis);
+    EXPECT_NEAR(0.0f, axis[0], 1e-6f);
+    EXPECT_NEAR(0.0f, axis[1], 1e-6f);
+    EXPECT_NEAR(1.0f, axis[2], 1e-6f);
+
+    dso::majorAxis(dso::makeInstance(0.0f, 0.0f, 10.0f, 5.0f, 90.0f, 0u, 0u), axis);
+    EXPECT_NEAR(0.0f, axis[0], 1e-6f);
+    EXPECT_NEAR(1.0f, axis[1], 1e-6f);
+    EXPECT_NEAR(0.0f, axis[2], 1e-6f);
+}
+
+TEST(DsoTest, TangentFrameIsOrthonormalIncludingPoles) {
+    const float dirs[][3] = {{1.0f, 0.0f, 0.0f}, {0.6f, 0.0f, 0.8f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, -1.0f}};
+    for (const auto& d : dirs) {
+        float north[3], east[3];
+        dso::tangentFrame(d[0], d[1], d[2], north, east);
+        auto dot = [](const float* a, const float* b) { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; };
+        EXPECT_NEAR(1.0f, dot(north, north), 1e-5f);
+        EXPECT_NEAR(1.0f, dot(east, east), 1e-5f);
+        EXPECT_NEAR(0.0f, dot(north, east), 1e-5f);
+        EXPECT_NEAR(0.0f, dot(north, d), 1e-5f);
+        EXPECT_NEAR(0.0f, dot(east, d), 1e-5f);
+    }
+}
+
+} // namespace
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include "frame_arena.h"
+
+// Count every general-heap allocation made by this test binary
+static std::atomic<size_t> g_heapAllocations{0};
+
+void* operator new(size_t size) {
+    g_heapAllocations++;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) { return operator new(size); }
+void* operator new(size_t size, std::align_val_t alignment) {
+    g_heapAllocations++;
+    const size_t a = static_cast<size_t>(alignment);
+    if (void* p = std::aligned_alloc(a, (size + a - 1) / a * a)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace {
+
+// One simulated frame of transient work: a few containers of varying size
+void simulateFrame(std::pmr::memory_resource* resource, int frame) {
+    std::pmr::vector<float> visible(resource);
+    for (int i = 0; i < 2000 + (frame % 7) * 100; i++) visible.push_back(static_cast<float>(i));
+
+    std::pmr::vector<uint32_t> sortKeys(500, 0u, resource);
+    std::pmr::vector<std::pmr::vector<int>> buckets(resource);
+    for (int b = 0; b < 16; b++) {
+        buckets.emplace_back();
+        buckets.back().resize(32 + b);
+    }
+}
+
+TEST(FrameArenaTest, AllocationsAreAlignedAndDistinct) {
+    arena::LinearArena a(1024);
+    void* p1 = a.allocate(3, 1);
+    void* p2 = a.allocate(16, 16);
+    void* p3 = a.allocate(8, 64);
+    EXPECT_NE(p1, p2);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(p2) % 16);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(p3) % 64);
+    EXPECT_GE(a.used(), 3u + 16u + 8u);
+}
+
+TEST(FrameArenaTest, ResetRewinds) {
+    arena::LinearArena a(1024);
+    void* first = a.allocate(100, 8);
+    a.reset();
+    EXPECT_EQ(0u, a.used());
+    EXPECT_EQ(first, a.allocate(100, 8));
+}
+
+TEST(FrameArenaTest, OverflowGrowsOnReset) {
+    arena::LinearArena a(4096);
+    for (int i = 0; i < 10; i++) (void)a.allocate(1024, 8);
+    EXPECT_GT(a.overflowCount(), 0u);
+    const size_t needed = a.used();
+
+    a.reset();
+    EXPECT_GE(a.capacity(), needed);
+
+    const size_t overflows = a.overflowCount();
+    for (int i = 0; i < 10; i++) (void)a.allocate(1024, 8);
+    EXPECT_EQ(overflows, a.overflowCount());
+}
+
+TEST(FrameArenaTest, SteadyStateMakesNoHeapAllocations) {
+    arena::FrameArenas<2> arenas(1024);  // Deliberately small: must grow during warm-up
+
+    // Warm-up frames may overflow and grow
+    for (int frame = 0; frame < 8; frame++) {
+        const size_t slot = frame % 2;
+        arenas.retire(slot);
+        simulateFrame(&arenas[slot], frame);
+    }
+
+    const size_t before = g_heapAllocations.load();
+    for (int frame = 8; frame < 500; frame++) {
+        const size_t slot = frame % 2;
+        arenas.retire(slot);
+        simulateFrame(&arenas[slot], frame);
+    }
+    EXPECT_EQ(before, g_heapAllocations.load());
+}
+
+TEST(FrameArenaTest, WorkerArenasArePerThreadAndPerSlot) {
+    arena::WorkerArenas<2> workers(4096);
+    arena::LinearArena* mainSlot0 = &workers.local(0);
+    EXPECT_NE(mainSlot0, &workers.local(1));
+    EXPECT_EQ(mainSlot0, &workers.local(0));
+
+    arena::LinearArena* otherSlot0 = nullptr;
+    std::thread t([&] {
+        otherSlot0 = &workers.local(0);
+        (void)otherSlot0->allocate(256, 8);
+    });
+    t.join();
+
+    EXPECT_NE(mainSlot0, otherSlot0);
+    EXPECT_EQ(2u, workers.workerCount());
+    EXPECT_GE(otherSlot0->used(), 256u);
+
+    workers.retire(0);
+    EXPECT_EQ(0u, otherSlot0->used());
+}
+
+TEST(FrameArenaTest, WorkerSteadyStateMakesNoHeapAllocations) {
+    arena::WorkerArenas<2> workers(1024);
+    for (int frame = 0; frame < 8; frame++) {
+        workers.retire(frame % 2);
+        simulateFrame(&workers.local(frame % 2), frame);
+    }
+
+    const size_t before = g_heapAllocations.load();
+    for (int frame = 8; frame < 200; frame++) {
+        workers.retire(frame % 2);
+        simulateFrame(&workers.local(frame % 2), frame);
+    }
+    EXPECT_EQ(before, g_heapAllocations.load());
+}
+
+} // namespace
@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+#include "frame_budget.h"
+
+namespace {
+
+budget::Config testConfig() {
+    budget::Config config;
+    config.budgetMs = 10.0f;
+    config.degradeFrames = 3;
+    config.restoreFrames = 10;
+    config.settleFrames = 2;
+    config.smoothing = 1.0f;  // No smoothing: each sample is the estimate
+    return config;
+}
+
+budget::FrameSample frame(float cpuMs, float gpuMs) {
+    budget::FrameSample s;
+    s.cpuMs = cpuMs;
+    s.gpuMs = gpuMs;
+    return s;
+}
+
+// Feed n identical frames; returns how many changed quality
+int feed(budget::Governor& governor, const budget::FrameSample& s, int n) {
+    int changes = 0;
+    for (int i = 0; i < n; i++) changes += governor.update(s) ? 1 : 0;
+    return changes;
+}
+
+TEST(FrameBudgetTest, WithinBudgetKeepsFullQuality) {
+    budget::Governor governor(testConfig());
+    EXPECT_EQ(0, feed(governor, frame(8.0f, 9.0f), 100));
+    EXPECT_FLOAT_EQ(1.0f, governor.quality().starFraction);
+    EXPECT_TRUE(governor.quality().glow);
+    EXPECT_TRUE(governor.decisions().empty());
+}
+
+TEST(FrameBudgetTest, SustainedOverrunRequiredToDegrade) {
+    budget::Governor governor(testConfig());
+    // Isolated spikes do not change anything
+    for (int i = 0; i < 20; i++) {
+        EXPECT_FALSE(governor.update(frame(20.0f, 0.0f)));
+        EXPECT_FALSE(governor.update(frame(5.0f, 0.0f)));
+    }
+    EXPECT_EQ(1, feed(governor, frame(20.0f, 0.0f), 3));
+}
+
+TEST(FrameBudgetTest, DegradesKnobOfMostExpensiveLayer) {
+    budget::Governor governor(testConfig());
+    governor.assignLayer(0, budget::Knob::StarDensity);
+    governor.assignLayer(1, budget::Knob::Tessellation);
+
+    budget::FrameSample s = frame(6.0f, 14.0f);
+    s.layerGpuMs[0] = 3.0f;
+    s.layerGpuMs[1] = 9.0f;
+    ASSERT_EQ(1, feed(governor, s, 3));
+
+    ASSERT_EQ(1u, governor.decisions().size());
+    const budget::Decision& d = governor.decisions().back();
+    EXPECT_EQ(budget::Knob::Tessellation, d.knob);
+    EXPECT_EQ(1, d.layer);
+    EXPECT_TRUE(d.degraded);
+    EXPECT_FLOAT_EQ(0.5f, governor.quality().tessellationScale);
+}
+
+TEST(FrameBudgetTest, UnattributedCostFallsBackByBottleneck) {
+    budget::Governor gpuBound(testConfig());
+    feed(gpuBound, frame(4.0f, 15.0f), 3);
+    EXPECT_EQ(budget::Knob::ResolutionScale, gpuBound.decisions().back().knob);
+    EXPECT_LT(gpuBound.quality().resolutionScale, 1.0f);
+
+    budget::Governor cpuBound(testConfig());
+    feed(cpuBound, frame(15.0f, 4.0f), 3);
+    EXPECT_EQ(budget::Knob::StarDensity, cpuBound.decisions().back().knob);
+    EXPECT_LT(cpuBound.quality().starFraction, 1.0f);
+}
+
+TEST(FrameBudgetTest, ExhaustedLayerKnobMovesOn) {
+    budget::Governor governor(testConfig());
+    governor.assignLayer(0, budget::Knob::Glow);
+    budget::FrameSample s = frame(4.0f, 20.0f);
+    s.layerGpuMs[0] = 10.0f;
+
+    // Glow has a single step; afterwards the GPU fallback takes over
+    feed(governor, s, 3 + 2 + 3);
+    ASSERT_EQ(2u, governor.decisions().size());
+    EXPECT_EQ(budget::Knob::Glow, governor.decisions()[0].knob);
+    EXPECT_EQ(budget::Knob::ResolutionScale, governor.decisions()[1].knob);
+    EXPECT_EQ(budget::NO_LAYER, governor.decisions()[1].layer);
+}
+
+TEST(FrameBudgetTest, StopsAtQualityFloor) {
+    budget::Governor governor(testConfig());
+    int steps = 0;
+    for (int k = 0; k < budget::KNOB_COUNT; k++) steps += budget::KNOB_MAX_STEP[k];
+
+    EXPECT_EQ(steps, feed(governor, frame(50.0f, 50.0f), 1000));
+    EXPECT_FLOAT_EQ(0.2f, governor.quality().starFraction);
+    EXPECT_FLOAT_EQ(0.7f, governor.quality().resolutionScale);
+    EXPECT_FALSE(governor.quality().glow);
+}
+
+TEST(FrameBudgetTest, RestoresGraduallyInReverseOrder) {
+    budget::Governor governor(testConfig());
+    feed(governor, frame(15.0f, 0.0f), 3);      // StarDensity
+    feed(governor, frame(0.0f, 15.0f), 2 + 3);  // then ResolutionScale
+    ASSERT_EQ(2u, governor.decisions().size());
+
+    // Between the restore threshold and the budget nothing moves
+    EXPECT_EQ(0, feed(governor, frame(9.0f, 9.0f), 100));
+
+    // Headroom: one step back per restore period, last change first
+    EXPECT_EQ(0, feed(governor, frame(2.0f, 2.0f), 9));
+    EXPECT_EQ(1, feed(governor, frame(2.0f, 2.0f), 1));
+    EXPECT_EQ(budget::Knob::ResolutionScale, governor.decisions().back().knob);
+    EXPECT_FALSE(governor.decisions().back().degraded);
+
+    EXPECT_EQ(1, feed(governor, frame(2.0f, 2.0f), 12));
+    EXPECT_EQ(budget::Knob::StarDensity, governor.decisions().back().knob);
+    EXPECT_FLOAT_EQ(1.0f, governor.quality().starFraction);
+    EXPECT_FLOAT_EQ(1.0f, governor.quality().resolutionScale);
+
+    // Nothing left to restore
+    EXPECT_EQ(0, feed(governor, frame(2.0f, 2.0f), 100));
+}
+
+TEST(FrameBudgetTest, DecisionLogIsBounded) {
+    budget::Governor governor(testConfig());
+    for (int i = 0; i < 40; i++) {
+        feed(governor, frame(50.0f, 0.0f), 20);
+        feed(governor, frame(1.0f, 1.0f), 20);
+    }
+    EXPECT_EQ(budget::Governor::MAX_DECISIONS, governor.decisions().size());
+    EXPECT_EQ(governor.frame(), 1600u);
+}
+
+TEST(FrameBudgetTest, SmoothingDampsSingleFrame) {
+    budget::Config config = testConfig();
+    config.smoothing = 0.1f;
+    budget::Governor governor(config);
+    feed(governor, frame(5.0f, 5.0f), 10);
+    governor.update(frame(105.0f, 0.0f));
+    EXPECT_NEAR(15.0f, governor.smoothedCpuMs(), 1e-3f);
+}
+
+TEST(FrameBudgetTest, OverdrawIsSmoothedButNeverDegrades) {
+    budget::Config config = testConfig();
+    config.smoothing = 0.5f;
+    budget::Governor governor(config);
+    budget::FrameSample s = frame(5.0f, 5.0f);
+    s.overdraw = 4.0f;
+    EXPECT_EQ(0, feed(governor, s, 1));
+    EXPECT_FLOAT_EQ(4.0f, governor.smoothedOverdraw());
+    s.overdraw = 2.0f;
+    EXPECT_EQ(0, feed(governor, s, 20));
+    EXPECT_NEAR(2.0f, governor.smoothedOverdraw(), 1e-3f);
+    EXPECT_TRUE(governor.decisions().empty());
+}
+
+} // namespace
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include "healpix.h"
+
+namespace {
+
+double dot(const double a[3], const double b[3]) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+void cross(const double a[3], const double b[3], double out[3]) {
+    out[0] = a[1] * b[2] - a[2] * b[1];
+    out[1] = a[2] * b[0] - a[0] * b[2];
+    out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+TEST(HealpixTest, PixelCountsMatchOrder) {
+    EXPECT_EQ(12u, healpix::npix(0));
+    EXPECT_EQ(48u, healpix::npix(1));
+    EXPECT_EQ(12ull << 58, healpix::npix(healpix::MAX_ORDER));
+}
+
+TEST(HealpixTest, SpreadAndCompressAreInverse) {
+    const uint64_t values[] = {0u, 1u, 0x5au, 0xffffu, 0x12345678u, 0xffffffffu};
+    for (uint64_t v : values) {
+        EXPECT_EQ(v, healpix::compressBits(healpix::spreadBits(v)));
+    }
+    EXPECT_EQ(0x5u, healpix::spreadBits(0x3u));
+}
+
+TEST(HealpixTest, PixelCentersRoundTrip) {
+    for (int order = 0; order <= 4; order++) {
+        for (uint64_t pix = 0; pix < healpix::npix(order); pix++) {
+            double x, y, z;
+            healpix::nestToVec(order, pix, x, y, z);
+            EXPECT_NEAR(1.0, x * x + y * y + z * z, 1e-12);
+            EXPECT_EQ(pix, healpix::vecToNest(order, x, y, z)) << "order " << order;
+        }
+    }
+}
+
+TEST(HealpixTest, ChildrenAreContainedInParent) {
+    const int order = 6;
+    for (uint64_t pix = 0; pix < healpix::npix(order); pix += 97) {
+        double x, y, z;
+        healpix::nestToVec(order, pix, x, y, z);
+        EXPECT_EQ(pix >> 4, healpix::vecToNest(order - 2, x, y, z));
+        EXPECT_EQ(pix >> 4, healpix::parent(pix, 2));
+    }
+}
+
+TEST(HealpixTest, PolesAndEquatorLandOnExpectedFaces) {
+    // North pole on faces 0-3, south pole on 8-11, equator at phi=0 on face 4
+    EXPECT_LT(healpix::vecToNest(0, 0.0, 0.0, 1.0), 4u);
+    EXPECT_GE(healpix::vecToNest(0, 0.0, 0.0, -1.0), 8u);
+    EXPECT_EQ(4u, healpix::vecToNest(0, 1.0, 0.0, 0.0));
+    EXPECT_EQ(healpix::vecToNest(8, 1.0, 0.0, 0.0), healpix::raDecToNest(8, 0.0, 0.0));
+}
+
+TEST(HealpixTest, CornersAreCounterClockwiseFromOutside) {
+    const int order = 3;
+    for (uint64_t pix = 0; pix < healpix::npix(order); pix++) {
+        double corners[4][3];
+        healpix::nestCorners(order, pix, corners);
+        double center[3];
+        healpix::nestToVec(order, pix, center[0], center[1], center[2]);
+
+        for (int i = 0; i < 4; i++) {
+            const double* a = corners[i];
+            const double* b = corners[(i + 1) % 4];
+            const double edge[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+            const double toCenter[3] = {center[0] - a[0], center[1] - a[1], center[2] - a[2]};
+            double n[3];
+            cross(edge, toCenter, n);
+            EXPECT_GT(dot(n, center), 0.0) << "pixel " << pix << " edge " << i;
+        }
+    }
+}
+
+TEST(HealpixTest, PixelAreaSumsToSphere) {
+    EXPECT_NEAR(4.0 * healpix::PI, healpix::pixelArea(5) * healpix::npix(5), 1e-9);
+    EXPECT_NEAR(std::sqrt(healpix::pixelArea(5)), healpix::resolution(5), 1e-12);
+}
+
+TEST(HealpixTest, NeighborsShareACornerBothWays) {
+    for (int order = 0; order <= 3; order++) {
+        int missing = 0;
+        for (uint64_t pix = 0; pix < healpix::npix(order); pix++) {
+            uint64_t around[8];
+            healpix::neighbors(order, pix, around);
+            double corners[4][3];
+            healpix::nestCorners(order, pix, corners);
+            for (uint64_t other : around) {
+                if (other == healpix::NO_NEIGHBOR) {
+                    missing++;
+                    continue;
+                }
+                uint64_t back[8];
+                healpix::neighbors(order, other, back);
+                EXPECT_NE(back + 8, std::find(back, back + 8, pix)) << "order " << order << " pixel " << pix;
+
+                double otherCorners[4][3];
+                healpix::nestCorners(order, other, otherCorners);
+                double closest = 1.0;
+                for (const auto& a : corners) {
+                    for (const auto& b : otherCorners) {
+                        closest = std::min(closest, std::hypot(a[0] - b[0], a[1] - b[1], a[2] - b[2]));
+                    }
+                }
+                EXPECT_LT(closest, 1e-9) << "order " << order << " pixels " << pix << ", " << other;
+            }
+        }
+        // Three pixels meet at each of the 8 corners shared by three base faces
+        EXPECT_EQ(24, missing) << "order " << order;
+    }
+}
+
+TEST(HealpixTest, NeighborsOfInteriorPixelStayOnFace) {
+    const int order = 4;
+    const uint64_t pix = healpix::xyfToNest(order, 5, 7, 6);
+    uint64_t around[8];
+    healpix::neighbors(order, pix, around);
+    // x grows to the NE, y to the NW
+    EXPECT_EQ(healpix::xyfToNest(order, 4, 7, 6), around[0]);  // SW
+    EXPECT_EQ(healpix::xyfToNest(order, 6, 8, 6), around[3]);  // N
+    EXPECT_EQ(healpix::xyfToNest(order, 6, 7, 6), around[4]);  // NE
+    EXPECT_EQ(healpix::xyfToNest(order, 4, 6, 6), around[7]);  // S
+}
+
+} // namespace
@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "horizon_profile.h"
+
+namespace {
+
+constexpr float DEG = static_cast<float>(horizon::DEG_TO_RAD);
+
+// Observer frame with zenith +z and north +x, so east is -y
+horizon::Frame testFrame() {
+    const float zenith[3] = {0.0f, 0.0f, 1.0f};
+    const float north[3] = {1.0f, 0.0f, 0.0f};
+    return horizon::Frame::fromZenithNorth(zenith, north);
+}
+
+void direction(const horizon::Frame& f, float azimuthDeg, float altitudeDeg, float out[3]) {
+    const float az = azimuthDeg * DEG, alt = altitudeDeg * DEG;
+    for (int i = 0; i < 3; i++) {
+        out[i] = std::cos(alt) * (std::cos(az) * f.north[i] + std::sin(az) * f.east[i]) + std::sin(alt) * f.zenith[i];
+    }
+}
+
+TEST(HorizonProfileTest, DefaultIsFlat) {
+    horizon::Profile profile;
+    EXPECT_FLOAT_EQ(0.0f, profile.minSinAltitude());
+    EXPECT_TRUE(profile.clears(1.0f, 0.001f));
+    EXPECT_FALSE(profile.clears(1.0f, -0.001f));
+}
+
+TEST(HorizonProfileTest, InterpolatesAndWraps) {
+    horizon::Profile profile;
+    ASSERT_TRUE(profile.build({{90, 30}, {0, 10}, {270, 0}}));
+
+    // Bins are sampled at their centers, ~0.7 degrees from these azimuths
+    EXPECT_NEAR(std::sin(20 * DEG), profile.sinAltitudeAt(45 * DEG), 0.01f);
+    EXPECT_NEAR(std::sin(15 * DEG), profile.sinAltitudeAt(180 * DEG), 0.01f);
+    EXPECT_NEAR(std::sin(5 * DEG), profile.sinAltitudeAt(315 * DEG), 0.01f);
+    EXPECT_NEAR(std::sin(5 * DEG), profile.sinAltitudeAt(-45 * DEG), 0.01f);  // Negative azimuths wrap
+    EXPECT_NEAR(0.0f, profile.minSinAltitude(), 0.01f);
+}
+
+TEST(HorizonProfileTest, SinglePointIsConstant) {
+    horizon::Profile profile;
+    ASSERT_TRUE(profile.build({{123, 5}}));
+    for (int bin = 0; bin < horizon::BINS; bin++) {
+        EXPECT_FLOAT_EQ(std::sin(5 * DEG), profile.sinAltitudes()[bin]);
+    }
+}
+
+TEST(HorizonProfileTest, RejectsInvalidPoints) {
+    horizon::Profile profile;
+    ASSERT_TRUE(profile.build({{0, 10}}));
+    EXPECT_FALSE(profile.build({}));
+    EXPECT_FALSE(profile.build({{0, 95}}));
+    EXPECT_FALSE(profile.build({{NAN, 5}}));
+    EXPECT_FLOAT_EQ(std::sin(10 * DEG), profile.sinAltitudeAt(0.0f));  // Unchanged
+}
+
+TEST(HorizonProfileTest, FrameAzimuthRunsNorthThroughEast) {
+    const horizon::Frame frame = testFrame();
+    float d[3];
+    direction(frame, 90, 0, d);
+    EXPECT_NEAR(0.0f, d[0], 1e-6f);
+    EXPECT_NEAR(-1.0f, d[1], 1e-6f);  // East of +x north under +z zenith
+    EXPECT_NEAR(90 * DEG, frame.azimuth(d[0], d[1], d[2]), 1e-5f);
+
+    direction(frame, 200, 35, d);
+    EXPECT_NEAR(std::sin(35 * DEG), frame.sinAltitude(d[0], d[1], d[2]), 1e-6f);
+    EXPECT_NEAR((200 - 360) * DEG, frame.azimuth(d[0], d[1], d[2]), 1e-5f);
+}
+
+TEST(HorizonProfileTest, OccluderHidesBehindRidge) {
+    horizon::Profile profile;
+    ASSERT_TRUE(profile.build({{0, 0}, {70, 0}, {80, 20}, {100, 20}, {110, 0}}));
+    horizon::Occluder occluder{&profile, testFrame()};
+
+    float d[3];
+    direction(occluder.frame, 90, 10, d);
+    EXPECT_FALSE(occluder.visible(d[0], d[1], d[2]));
+    direction(occluder.frame, 90, 25, d);
+    EXPECT_TRUE(occluder.visible(d[0], d[1], d[2]));
+    direction(occluder.frame, 180, 10, d);
+    EXPECT_TRUE(occluder.visible(d[0], d[1], d[2]));
+    direction(occluder.frame, 180, -1, d);
+    EXPECT_FALSE(occluder.visible(d[0], d[1], d[2]));
+
+    horizon::Occluder none;
+    EXPECT_TRUE(none.visible(d[0], d[1], d[2]));
+}
+
+TEST(HorizonProfileTest, FirstClearFindsRidgeCrossing) {
+    horizon::Profile profile;
+    ASSERT_TRUE(profile.build({{0, 0}, {70, 0}, {80, 20}, {100, 20}, {110, 0}}));
+
+    // Rises at one degree per unit of time behind the ridge
+    auto behindRidge = [](double t, double& azimuth, double& altitude) {
+        azimuth = 90 * horizon::DEG_TO_RAD;
+        altitude = (t - 5.0) * horizon::DEG_TO_RAD;
+    };
+    const double t = horizon::firstClear(profile, 0.0, 60.0, 1.0, 1e-4, behindRidge);
+    EXPECT_NEAR(25.0, t, 0.01);
+
+    // Already up at the start
+    EXPECT_DOUBLE_EQ(30.0, horizon::firstClear(profile, 30.0, 60.0, 1.0, 1e-4, behindRidge));
+    // Never clears within the window
+    EXPECT_TRUE(std::isnan(horizon::firstClear(profile, 0.0, 20.0, 1.0, 1e-4, behindRidge)));
+}
+
+TEST(HorizonProfileTest, FirstClearRejectsStepsThatNeverFinish) {
+    horizon::Profile profile;
+    ASSERT_TRUE(profile.build({{0, 10}}));
+    auto rising = [](double t, double& azimuth, double& altitude) {
+        azimuth = 0.0;
+        altitude = t * horizon::DEG_TO_RAD;
+    };
+    EXPECT_TRUE(std::isnan(horizon::firstClear(profile, 0.0, 60.0, 0.0, 1e-4, rising)));
+    EXPECT_TRUE(std::isnan(horizon::firstClear(profile, 0.0, 60.0, -1.0, 1e-4, rising)));
+    EXPECT_TRUE(std::isnan(horizon::firstClear(profile, 0.0, 60.0, NAN, 1e-4, rising)));
+    EXPECT_TRUE(std::isnan(horizon::firstClear(profile, 0.0, 60.0, 1.0, 0.0, rising)));
+    EXPECT_TRUE(std::isnan(horizon::firstClear(profile, 0.0, 60.0, 1.0, NAN, rising)));
+    // Sub-microsecond steps at Unix-time magnitudes do not advance a double
+    auto risingLate = [](double t, double& azimuth, double& altitude) {
+        azimuth = 0.0;
+        altitude = (t - 1.7e9) * horizon::DEG_TO_RAD;
+    };
+    EXPECT_TRUE(std::isnan(horizon::firstClear(profile, 1.7e9, 1.7e9 + 60.0, 1e-8, 1e-4, risingLate)));
+    EXPECT_NEAR(1.7e9 + 10.0, horizon::firstClear(profile, 1.7e9, 1.7e9 + 60.0, 0.1, 1e-4, risingLate), 1e-3);
+    // A tolerance below what doubles resolve still ends, at the crossing
+    EXPECT_NEAR(10.0, horizon::firstClear(profile, 0.0, 60.0, 1.0, 1e-300, rising), 1e-5);
+}
+
+TEST(HorizonProfileTest, DegenerateFrameInputsStayFinite) {
+    const float zero[3] = {0.0f, 0.0f, 0.0f};
+    const float zenith[3] = {0.0f, 0.0f, 2.0f};
+    const float tilted[3] = {1.0f, 0.0f, 0.0f};
+
+    // No zenith: the default frame
+    const horizon::Frame none = horizon::Frame::fromZenithNorth(zero, tilted);
+    EXPECT_FLOAT_EQ(1.0f, none.zenith[2]);
+
+    // North along the zenith, or zero: a north is still found, orthogonal to it
+    for (const float* north : {zenith, static_cast<const float*>(zero)}) {
+        for (const float* z : {zenith, tilted}) {
+            const horizon::Frame f = horizon::Frame::fromZenithNorth(z, north == zenith ? z : north);
+            const float dot = f.north[0] * f.zenith[0] + f.north[1] * f.zenith[1] + f.north[2] * f.zenith[2];
+            const float length = std::hypot(f.north[0], f.north[1], f.north[2]);
+            EXPECT_NEAR(0.0f, dot, 1e-6f);
+            EXPECT_NEAR(1.0f, length, 1e-6f);
+            EXPECT_TRUE(std::isfinite(f.azimuth(0.3f, 0.4f, 0.5f)));
+        }
+    }
+
+    // NaN azimuths land in a valid bin
+    horizon::Profile profile;
+    EXPECT_GE(horizon::Profile::binFor(NAN), 0);
+    EXPECT_LT(horizon::Profile::binFor(INFINITY), horizon::BINS);
+    EXPECT_TRUE(profile.clears(NAN, 0.5f));
+}
+
+} // namespace
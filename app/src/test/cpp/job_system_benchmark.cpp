@@ -0,0 +1,85 @@
+// Scaling benchmark for jobs::JobSystem (not a test; run by hand).
+//
+// Builds a light map patch mesh and a per-star workload over the synthetic
+// sky (benchmark_sky.h) with 0..N workers and prints time and speedup
+// against the serial path.
+//
+//   ./job_system_benchmark [maxWorkers] [repeats]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "benchmark_sky.h"
+#include "job_system.h"
+#include "light_map.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::vector<lightmap::StarSample> lightMapSamples(const std::vector<sky::Object>& objects) {
+    std::vector<lightmap::StarSample> samples(objects.size());
+    for (size_t i = 0; i < objects.size(); i++) {
+        const sky::Object& o = objects[i];
+        samples[i] = {o.x, o.y, o.z, o.magnitude, 1.0f, 0.9f, 0.8f};
+    }
+    return samples;
+}
+
+template<typename F>
+double bestMs(int repeats, F&& f) {
+    double best = 1e30;
+    for (int r = 0; r < repeats; r++) {
+        const auto start = Clock::now();
+        f();
+        best = std::min(best, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const unsigned cpus = std::max(1u, std::thread::hardware_concurrency());
+    const unsigned maxWorkers = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1])) : cpus * 2;
+    const int repeats = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    const auto maps = lightmap::build(lightMapSamples(bench::syntheticSky(200000)), {6.0f}, {7});
+    const auto stars = bench::syntheticSky(1000000);
+    std::vector<float> projected(stars.size());
+    auto project = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            const auto& s = stars[i];
+            projected[i] = std::atan2(s.y, s.x) * std::acos(s.z) + std::pow(10.0f, -0.4f * s.magnitude);
+        }
+    };
+
+    std::printf("%u hardware threads\n", cpus);
+    std::printf("%8s %14s %8s %14s %8s\n", "workers", "lightmap ms", "speedup", "stars ms", "speedup");
+
+    std::vector<float> vertices;
+    const double serialMap = bestMs(repeats, [&] {
+        vertices.clear();
+        lightmap::appendPatchVertices(maps[0], 1000.0f, vertices);
+    });
+    const double serialStars = bestMs(repeats, [&] { project(0, stars.size()); });
+    std::printf("%8s %14.2f %8.2f %14.2f %8.2f\n", "serial", serialMap, 1.0, serialStars, 1.0);
+
+    for (unsigned workers = 1; workers <= maxWorkers; workers *= 2) {
+        jobs::Config config;
+        config.workerCount = workers;
+        jobs::JobSystem system(config);
+
+        const double mapMs = bestMs(repeats, [&] {
+            vertices.clear();
+            lightmap::appendPatchVertices(maps[0], 1000.0f, vertices, &system);
+        });
+        const double starsMs = bestMs(repeats, [&] { system.parallelFor(0, stars.size(), 8192, project); });
+        std::printf("%8u %14.2f %8.2f %14.2f %8.2f\n", workers, mapMs, serialMap / mapMs, starsMs,
+                    serialStars / starsMs);
+    }
+    return 0;
+}
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "job_system.h"
+
+namespace {
+
+jobs::Config testConfig(unsigned workers) {
+    jobs::Config config;
+    config.workerCount = workers;
+    config.pinWorkers = false;
+    return config;
+}
+
+struct Tree {
+    jobs::JobSystem* system;
+    jobs::Counter* counter;
+    std::atomic<int> leaves{0};
+};
+
+// Below depth 4 each node spawns two children into the same counter
+void treeNode(void* data, size_t depth, size_t) {
+    auto* tree = static_cast<Tree*>(data);
+    if (depth == 4) {
+        tree->leaves++;
+        return;
+    }
+    for (int i = 0; i < 2; i++) {
+        tree->system->run(*tree->counter, jobs::Priority::Frame, treeNode, data, depth + 1);
+    }
+}
+
+TEST(JobSystemTest, RunsSubmittedJobs) {
+    jobs::JobSystem system(testConfig(2));
+    std::atomic<int> ran{0};
+    auto job = [&] { ran++; };
+
+    jobs::Counter counter;
+    for (int i = 0; i < 100; i++) system.run(counter, jobs::Priority::Frame, job);
+    system.wait(counter);
+
+    EXPECT_TRUE(counter.done());
+    EXPECT_EQ(100, ran.load());
+}
+
+TEST(JobSystemTest, WaitCoversChildJobs) {
+    jobs::JobSystem system(testConfig(3));
+    jobs::Counter counter;
+    Tree tree{&system, &counter};
+
+    system.run(counter, jobs::Priority::Frame, treeNode, &tree, 0);
+    system.wait(counter);
+
+    EXPECT_EQ(16, tree.leaves.load());
+    EXPECT_EQ(0, counter.pending());
+}
+
+TEST(JobSystemTest, ParallelForVisitsEachIndexOnce) {
+    jobs::JobSystem system(testConfig(4));
+    std::vector<std::atomic<int>> visits(10007);
+    for (auto& v : visits) v = 0;
+
+    system.parallelFor(3, visits.size(), 64, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) visits[i]++;
+    });
+
+    for (size_t i = 0; i < visits.size(); i++) {
+        EXPECT_EQ(i < 3 ? 0 : 1, visits[i].load()) << "index " << i;
+    }
+}
+
+TEST(JobSystemTest, ParallelForSmallRangeRunsInline) {
+    jobs::JobSystem system(testConfig(2));
+    const std::thread::id caller = std::this_thread::get_id();
+    bool inline_ = false;
+
+    system.parallelFor(0, 10, 64, [&](size_t begin, size_t end) {
+        inline_ = std::this_thread::get_id() == caller && begin == 0 && end == 10;
+    });
+    EXPECT_TRUE(inline_);
+}
+
+TEST(JobSystemTest, NestedParallelForFromJobs) {
+    jobs::JobSystem system(testConfig(3));
+    std::atomic<long> sum{0};
+
+    system.parallelFor(0, 8, 1, [&](size_t begin, size_t end) {
+        for (size_t outer = begin; outer < end; outer++) {
+            system.parallelFor(0, 1000, 100, [&](size_t b, size_t e) {
+                long local = 0;
+                for (size_t i = b; i < e; i++) local += static_cast<long>(i);
+                sum += local;
+            });
+        }
+    });
+    EXPECT_EQ(8L * 999 * 1000 / 2, sum.load());
+}
+
+TEST(JobSystemTest, FrameJobsRunBeforeBackgroundJobs) {
+    jobs::JobSystem system(testConfig(1));
+
+    // Hold the only worker until both classes are queued
+    std::atomic<bool> release{false};
+    std::atomic<bool> blocked{false};
+    auto gate = [&] {
+        blocked = true;
+        while (!release) std::this_thread::yield();
+    };
+    jobs::Counter gateCounter;
+    system.run(gateCounter, jobs::Priority::Frame, gate);
+    while (!blocked) std::this_thread::yield();
+
+    std::mutex mutex;
+    std::vector<char> order;
+    auto background = [&] { std::lock_guard<std::mutex> l(mutex); order.push_back('b'); };
+    auto frame = [&] { std::lock_guard<std::mutex> l(mutex); order.push_back('f'); };
+
+    jobs::Counter counter;
+    for (int i = 0; i < 3; i++) system.run(counter, jobs::Priority::Background, background);
+    for (int i = 0; i < 3; i++) system.run(counter, jobs::Priority::Frame, frame);
+
+    // Let the worker drain the queues on its own; wait() here would join in
+    release = true;
+    while (!gateCounter.done() || !counter.done()) std::this_thread::yield();
+
+    EXPECT_EQ((std::vector<char>{'f', 'f', 'f', 'b', 'b', 'b'}), order);
+}
+
+TEST(JobSystemTest, FullQueueRunsJobsInline) {
+    jobs::Config config = testConfig(1);
+    config.queueCapacity = 2;  // Injection queue holds 8
+    jobs::JobSystem system(config);
+
+    std::atomic<bool> release{false};
+    std::atomic<bool> blocked{false};
+    auto gate = [&] {
+        blocked = true;
+        while (!release) std::this_thread::yield();
+    };
+    jobs::Counter gateCounter;
+    system.run(gateCounter, jobs::Priority::Frame, gate);
+    while (!blocked) std::this_thread::yield();
+
+    std::atomic<int> ran{0};
+    auto job = [&] { ran++; };
+    jobs::Counter counter;
+    for (int i = 0; i < 20; i++) system.run(counter, jobs::Priority::Frame, job);
+    EXPECT_EQ(12, ran.load());  // Everything past the 8 queued ran on the caller
+
+    release = true;
+    system.wait(counter);
+    system.wait(gateCounter);
+    EXPECT_EQ(20, ran.load());
+}
+
+TEST(JobSystemTest, CoresByCapacityListsEveryCpu) {
+    std::vector<int> cores = jobs::coresByCapacity();
+    EXPECT_EQ(std::max(1u, std::thread::hardware_concurrency()), cores.size());
+    std::sort(cores.begin(), cores.end());
+    for (size_t i = 0; i < cores.size(); i++) EXPECT_EQ(static_cast<int>(i), cores[i]);
+}
+
+} // namespace
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <random>
+#include "label_placer.h"
+
+namespace {
+
+labels::Candidate box(uint32_t id, float x, float y, float priority, float w = 40.0f, float h = 12.0f) {
+    return {id, x, y, w, h, priority};
+}
+
+TEST(LabelPlacerTest, HigherPriorityWinsOverlap) {
+    labels::Placer placer;
+    placer.resize(320, 240);
+    labels::Candidate c[] = {box(1, 100, 100, 1.0f), box(2, 110, 104, 5.0f), box(3, 200, 200, 0.0f)};
+
+    const auto& accepted = placer.place(c, 3);
+    ASSERT_EQ(2u, accepted.size());
+    EXPECT_EQ(2u, accepted[0]);
+    EXPECT_EQ(3u, accepted[1]);
+}
+
+TEST(LabelPlacerTest, KindOutranksMagnitude) {
+    // A faint planet still beats the brightest star
+    EXPECT_GT(labels::rankPriority(labels::Kind::Planet, 6.0f),
+              labels::rankPriority(labels::Kind::Star, -1.5f));
+    EXPECT_GT(labels::rankPriority(labels::Kind::Star, 1.0f),
+              labels::rankPriority(labels::Kind::Star, 2.0f));
+}
+
+TEST(LabelPlacerTest, PaddingSeparatesAdjacentBoxes) {
+    labels::Params params;
+    params.cellSize = 4;
+    params.padding = 4.0f;
+    labels::Placer placer(params);
+    placer.resize(200, 100);
+
+    // Boxes 2px apart collide once padded
+    labels::Candidate c[] = {box(1, 10, 10, 2.0f), box(2, 52, 10, 1.0f)};
+    EXPECT_EQ(1u, placer.place(c, 2).size());
+
+    // 20px apart is clear
+    c[1].x = 70;
+    EXPECT_EQ(2u, placer.place(c, 2).size());
+}
+
+TEST(LabelPlacerTest, OffscreenCandidatesAreSkipped) {
+    labels::Placer placer;
+    placer.resize(100, 100);
+    labels::Candidate c[] = {box(1, -200, 10, 9.0f), box(2, 10, 500, 9.0f), box(3, 90, 90, 0.0f)};
+
+    const auto& accepted = placer.place(c, 3);
+    ASSERT_EQ(1u, accepted.size());
+    EXPECT_EQ(3u, accepted[0]);  // Partially visible labels still place
+}
+
+TEST(LabelPlacerTest, HysteresisKeepsIncumbent) {
+    labels::Placer placer;
+    placer.resize(320, 240);
+    labels::Candidate c[] = {box(1, 100, 100, 1.0f), box(2, 110, 104, 1.5f)};
+    ASSERT_EQ(2u, placer.place(c, 2)[0]);
+
+    // Label 1 edges ahead, but not by more than the sticky bonus
+    c[0].priority = 2.0f;
+    auto accepted = placer.place(c, 2);
+    ASSERT_EQ(1u, accepted.size());
+    EXPECT_EQ(2u, accepted[0]);
+
+    // A decisive lead takes over
+    c[0].priority = 4.0f;
+    accepted = placer.place(c, 2);
+    EXPECT_EQ(1u, accepted[0]);
+
+    placer.resetHysteresis();
+    c[0].priority = 1.0f;
+    EXPECT_EQ(2u, placer.place(c, 2)[0]);
+}
+
+TEST(LabelPlacerTest, GridSpansMultipleWords) {
+    labels::Params params;
+    params.cellSize = 2;
+    params.padding = 0.0f;
+    labels::Placer placer(params);
+    placer.resize(1000, 20);
+    ASSERT_EQ(500, placer.columns());
+
+    // A box crossing the 64-cell word boundaries blocks anything it overlaps
+    labels::Candidate c[] = {box(1, 100, 0, 2.0f, 300, 4), box(2, 398, 0, 1.0f, 10, 4), box(3, 402, 0, 0.0f, 10, 4)};
+    const auto& accepted = placer.place(c, 3);
+    ASSERT_EQ(2u, accepted.size());
+    EXPECT_EQ(1u, accepted[0]);
+    EXPECT_EQ(3u, accepted[1]);
+}
+
+TEST(LabelPlacerTest, LabelLimitKeepsHighestPriority) {
+    labels::Placer placer;
+    placer.resize(640, 480);
+    labels::Candidate c[] = {box(1, 0, 0, 1.0f), box(2, 100, 0, 3.0f), box(3, 200, 0, 2.0f)};
+
+    const auto& accepted = placer.place(c, 3, 2);
+    ASSERT_EQ(2u, accepted.size());
+    EXPECT_EQ(2u, accepted[0]);
+    EXPECT_EQ(3u, accepted[1]);
+}
+
+TEST(LabelPlacerTest, ManyCandidatesStayWithinScreen) {
+    labels::Placer placer;
+    placer.resize(1920, 1080);
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> px(0.0f, 1920.0f), py(0.0f, 1080.0f), mag(-1.0f, 12.0f);
+    std::vector<labels::Candidate> c;
+    for (uint32_t i = 0; i < 10000; i++) {
+        c.push_back(box(i, px(rng), py(rng), labels::rankPriority(labels::Kind::Star, mag(rng)), 60, 14));
+    }
+
+    const auto& accepted = placer.place(c.data(), c.size());
+    // Padded 64x18 boxes: at most one per 64x16 area of the screen
+    EXPECT_GT(accepted.size(), 100u);
+    EXPECT_LT(accepted.size(), (1920u / 64 + 1) * (1080u / 16 + 1));
+}
+
+} // namespace
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "light_curve.h"
+
+namespace {
+
+using variability::Curve;
+using variability::Kind;
+
+sky::Object starAt(float x, float y, float z, uint8_t alpha) {
+    const float length = std::sqrt(x * x + y * y + z * z);
+    return {x / length, y / length, z / length, 0.0f, 0, alpha, sky::FLAG_STAR, sky::NO_NAME, 0};
+}
+
+TEST(LightCurveTest, PulsatingPeaksAtEpochAndBottomsOutAtHalfPeriod) {
+    const Curve curve{0, Kind::Pulsating, 1000.0, 10.0, 3.5f, 1.0f, 0.0f};
+    EXPECT_FLOAT_EQ(3.5f, variability::magnitudeAt(curve, 1000.0));
+    EXPECT_FLOAT_EQ(4.5f, variability::magnitudeAt(curve, 1005.0));
+    EXPECT_FLOAT_EQ(3.5f, variability::magnitudeAt(curve, 1030.0));
+    EXPECT_NEAR(4.0f, variability::magnitudeAt(curve, 997.5), 1e-5f);
+}
+
+TEST(LightCurveTest, EclipsingIsFlatOutsideEclipse) {
+    // Eclipse lasting a tenth of the period
+    const Curve curve{0, Kind::Eclipsing, 2000.0, 3.0, 2.1f, 1.2f, 0.1f};
+    EXPECT_FLOAT_EQ(3.3f, variability::magnitudeAt(curve, 2000.0 + 3.0 * 100));
+    EXPECT_NEAR(2.7f, variability::magnitudeAt(curve, 2000.0 + 0.075), 1e-4f);
+    EXPECT_FLOAT_EQ(2.1f, variability::magnitudeAt(curve, 2000.0 + 1.5));
+    EXPECT_FLOAT_EQ(2.1f, variability::magnitudeAt(curve, 2000.0 - 0.2));
+}
+
+TEST(LightCurveTest, EruptiveRisesThenDeclinesToQuiescence) {
+    // Nova: 10 magnitudes of outburst, 2 day rise, fading 0.5 magnitude a day
+    const Curve curve{0, Kind::Eruptive, 5000.0, 2.0, 4.0f, 10.0f, 0.5f};
+    EXPECT_FLOAT_EQ(14.0f, variability::magnitudeAt(curve, 4990.0));
+    EXPECT_FLOAT_EQ(9.0f, variability::magnitudeAt(curve, 4999.0));
+    EXPECT_FLOAT_EQ(4.0f, variability::magnitudeAt(curve, 5000.0));
+    EXPECT_FLOAT_EQ(6.0f, variability::magnitudeAt(curve, 5004.0));
+    EXPECT_FLOAT_EQ(14.0f, variability::magnitudeAt(curve, 5100.0));
+}
+
+TEST(LightCurveTest, AlphaFollowsFlux) {
+    const Curve curve{0, Kind::Pulsating, 0.0, 1.0, 2.0f, 5.0f, 0.0f};
+    EXPECT_EQ(200, variability::alphaAt(curve, 200, 2.0f));
+    EXPECT_EQ(200, variability::alphaAt(curve, 200, 1.0f));  // Never brighter than at maximum
+    EXPECT_EQ(20, variability::alphaAt(curve, 200, 4.5f));   // 2.5 magnitudes: a tenth
+    EXPECT_EQ(0, variability::alphaAt(curve, 200, 12.0f));
+}
+
+TEST(LightCurveTest, TrackerWritesOnlyChangedRows) {
+    std::vector<sky::Object> objects;
+    for (int i = 0; i < 100; i++) objects.push_back(starAt(1.0f, 0.01f * i, 0.02f * (i % 7), 255));
+    sky::Store store;
+    store.build(objects);
+
+    // A fast pulsator and a constant one (zero amplitude), bound by source index
+    variability::Tracker tracker;
+    ASSERT_EQ(2u, tracker.build({{17, Kind::Pulsating, 0.0, 1.0, 1.0f, 2.0f, 0.0f},
+                                 {42, Kind::Pulsating, 0.0, 1.0, 1.0f, 0.0f, 0.0f},
+                                 {1000, Kind::Pulsating, 0.0, 1.0, 1.0f, 2.0f, 0.0f}},
+                                store));
+
+    std::vector<variability::Update> updates;
+    EXPECT_EQ(2u, tracker.evaluate(0.5, updates));  // First pass writes every curve
+    variability::apply(updates, store);
+
+    uint32_t row17 = 0;
+    for (uint32_t r = 0; r < store.size(); r++) {
+        if (store.sourceIndex()[r] == 17) row17 = r;
+    }
+    EXPECT_EQ(40, store.alpha()[row17]);  // 2 magnitudes below maximum: 255 / 6.31
+
+    updates.clear();
+    EXPECT_EQ(0u, tracker.evaluate(0.5, updates));
+    EXPECT_EQ(1u, tracker.evaluate(0.0, updates));
+    ASSERT_EQ(1u, updates.size());
+    EXPECT_EQ(row17, updates[0].row);
+    EXPECT_EQ(255, updates[0].alpha);
+
+    tracker.restore(store);
+    EXPECT_EQ(255, store.alpha()[row17]);
+}
+
+TEST(LightCurveTest, TrackerRebindsAfterRebuild) {
+    std::vector<sky::Object> objects = {starAt(1, 0, 0, 255), starAt(0, 1, 0, 128), starAt(0, 0, 1, 255)};
+    sky::Store store;
+    store.build(objects);
+    variability::Tracker tracker;
+    tracker.build({{1, Kind::Eruptive, 10.0, 1.0, 0.0f, 10.0f, 1.0f}}, store);
+
+    store.build(objects);
+    tracker.build(tracker.curves(), store);
+    std::vector<variability::Update> updates;
+    tracker.evaluate(10.0, updates);
+    ASSERT_EQ(1u, updates.size());
+    EXPECT_EQ(1u, store.sourceIndex()[updates[0].row]);
+    EXPECT_EQ(128, updates[0].alpha);
+}
+
+} // namespace
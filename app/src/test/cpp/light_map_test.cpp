@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include "light_map.h"
+
+namespace {
+
+std::vector<lightmap::StarSample> sampleStars() {
+    // Two stars in the same direction, one elsewhere
+    return {
+        {1.0f, 0.0f, 0.0f, 8.0f, 1.0f, 0.0f, 0.0f},
+        {1.0f, 0.0f, 0.0f, 10.0f, 0.0f, 0.0f, 1.0f},
+        {0.0f, 0.0f, 1.0f, 12.0f, 1.0f, 1.0f, 1.0f},
+    };
+}
+
+float totalFlux(const lightmap::LightMap& map) {
+    double sum = 0.0;
+    for (const auto& px : map.pixels) sum += px.flux;
+    return static_cast<float>(sum);
+}
+
+TEST(LightMapTest, CutoffIncludesOnlyFainterStars) {
+    auto maps = lightmap::build(sampleStars(), {9.0f, 6.0f}, {2});
+    ASSERT_EQ(2u, maps.size());
+
+    const double f8 = lightmap::magnitudeToFlux(8.0);
+    const double f10 = lightmap::magnitudeToFlux(10.0);
+    const double f12 = lightmap::magnitudeToFlux(12.0);
+
+    EXPECT_FLOAT_EQ(9.0f, maps[0].cutoffMagnitude);
+    EXPECT_NEAR(f10 + f12, totalFlux(maps[0]), 1e-9);
+    EXPECT_FLOAT_EQ(6.0f, maps[1].cutoffMagnitude);
+    EXPECT_NEAR(f8 + f10 + f12, totalFlux(maps[1]), 1e-9);
+}
+
+TEST(LightMapTest, ColorIsFluxWeighted) {
+    auto maps = lightmap::build(sampleStars(), {6.0f}, {2});
+    const auto& px = maps[0].pixels[healpix::vecToNest(2, 1.0, 0.0, 0.0)];
+
+    const double f8 = lightmap::magnitudeToFlux(8.0);
+    const double f10 = lightmap::magnitudeToFlux(10.0);
+    EXPECT_NEAR(f8 / (f8 + f10), px.r, 1e-6);
+    EXPECT_NEAR(f10 / (f8 + f10), px.b, 1e-6);
+    EXPECT_NEAR(0.0, px.g, 1e-6);
+}
+
+TEST(LightMapTest, CoarseOrdersConserveFlux) {
+    auto maps = lightmap::build(sampleStars(), {6.0f}, {1, 4});
+    ASSERT_EQ(2u, maps.size());
+    EXPECT_EQ(1, maps[0].order);
+    EXPECT_EQ(4, maps[1].order);
+    EXPECT_EQ(healpix::npix(1), maps[0].pixels.size());
+    EXPECT_NEAR(totalFlux(maps[1]), totalFlux(maps[0]), 1e-9);
+    EXPECT_GT(maps[0].pixels[healpix::vecToNest(1, 0.0, 0.0, 1.0)].flux, 0.0f);
+}
+
+TEST(LightMapTest, OrdersAreClampedToTheDenseLimit) {
+    // Order 13 would need ~26 GB of accumulator; it is built at the limit instead
+    auto maps = lightmap::build(sampleStars(), {6.0f}, {13, -1});
+    ASSERT_EQ(2u, maps.size());
+    EXPECT_EQ(lightmap::MAX_MAP_ORDER, maps[0].order);
+    EXPECT_EQ(0, maps[1].order);
+    EXPECT_EQ(healpix::npix(0), maps[1].pixels.size());
+    EXPECT_NEAR(totalFlux(maps[0]), totalFlux(maps[1]), 1e-9);
+}
+
+TEST(LightMapTest, SerializeRoundTrip) {
+    auto maps = lightmap::build(sampleStars(), {9.0f, 6.0f}, {1, 3});
+    std::vector<uint8_t> bytes = lightmap::serialize(maps);
+
+    std::vector<lightmap::LightMap> loaded;
+    ASSERT_TRUE(lightmap::deserialize(bytes.data(), bytes.size(), loaded));
+    ASSERT_EQ(maps.size(), loaded.size());
+    for (size_t i = 0; i < maps.size(); i++) {
+        EXPECT_EQ(maps[i].order, loaded[i].order);
+        EXPECT_FLOAT_EQ(maps[i].cutoffMagnitude, loaded[i].cutoffMagnitude);
+        ASSERT_EQ(maps[i].pixels.size(), loaded[i].pixels.size());
+        for (size_t p = 0; p < maps[i].pixels.size(); p++) {
+            EXPECT_FLOAT_EQ(maps[i].pixels[p].flux, loaded[i].pixels[p].flux);
+            EXPECT_FLOAT_EQ(maps[i].pixels[p].r, loaded[i].pixels[p].r);
+        }
+    }
+}
+
+TEST(LightMapTest, DeserializeRejectsBadInput) {
+    std::vector<lightmap::LightMap> loaded;
+    std::vector<uint8_t> bytes = lightmap::serialize(lightmap::build(sampleStars(), {6.0f}, {2}));
+
+    EXPECT_FALSE(lightmap::deserialize(bytes.data(), bytes.size() - 1, loaded));
+    bytes[0] ^= 0xff;
+    EXPECT_FALSE(lightmap::deserialize(bytes.data(), bytes.size(), loaded));
+}
+
+TEST(LightMapTest, SelectPicksBrightestCoveringCutoff) {
+    auto maps = lightmap::build(sampleStars(), {6.0f, 9.0f, 11.0f}, {2, 4});
+
+    const lightmap::LightMap* map = lightmap::select(maps, 8.5f, 4);
+    ASSERT_NE(nullptr, map);
+    EXPECT_FLOAT_EQ(9.0f, map->cutoffMagnitude);
+    EXPECT_EQ(4, map->order);
+
+    map = lightmap::select(maps, 6.0f, 1);
+    ASSERT_NE(nullptr, map);
+    EXPECT_FLOAT_EQ(6.0f, map->cutoffMagnitude);
+    EXPECT_EQ(2, map->order);
+
+    EXPECT_EQ(nullptr, lightmap::select(maps, 11.5f, 2));
+}
+
+TEST(LightMapTest, PatchesCoverLitPixelsOnly) {
+    auto maps = lightmap::build(sampleStars(), {6.0f}, {2});
+    std::vector<float> vertices;
+    const size_t count = lightmap::appendPatchVertices(maps[0], 1000.0f, vertices);
+
+    EXPECT_GT(count, 0u);
+    EXPECT_EQ(0u, count % 6);
+    EXPECT_EQ(count * 7, vertices.size());
+    // Far fewer patches than pixels for a sparse map
+    EXPECT_LT(count / 6, healpix::npix(2) / 2);
+
+    for (size_t v = 0; v < count; v++) {
+        const float* p = &vertices[v * 7];
+        EXPECT_NEAR(1.0f, std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]), 1e-5f);
+        EXPECT_GE(p[6], 0.0f);
+        EXPECT_LT(p[6], 1.0f);
+    }
+}
+
+TEST(LightMapTest, EmptyMapProducesNoPatches) {
+    auto maps = lightmap::build({}, {6.0f}, {2});
+    std::vector<float> vertices;
+    EXPECT_EQ(0u, lightmap::appendPatchVertices(maps[0], 1.0f, vertices));
+    EXPECT_TRUE(vertices.empty());
+}
+
+TEST(LightMapTest, JobSystemMatchesSerialPatches) {
+    auto maps = lightmap::build(sampleStars(), {6.0f}, {5});
+    std::vector<float> serial;
+    std::vector<float> parallel = {1.0f};  // Appends after existing data
+    jobs::Config config;
+    config.workerCount = 3;
+    config.pinWorkers = false;
+    jobs::JobSystem system(config);
+
+    const size_t serialCount = lightmap::appendPatchVertices(maps[0], 1000.0f, serial);
+    const size_t parallelCount = lightmap::appendPatchVertices(maps[0], 1000.0f, parallel, &system);
+
+    EXPECT_EQ(serialCount, parallelCount);
+    ASSERT_EQ(serial.size() + 1, parallel.size());
+    EXPECT_TRUE(std::equal(serial.begin(), serial.end(), parallel.begin() + 1));
+}
+
+} // namespace
@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Compile Debug messages out of this test, as in a release build
+#define LOG_RING_MIN_LEVEL 4
+#include "log_ring.h"
+
+namespace {
+
+struct Captured {
+    logring::Level level;
+    std::string tag;
+    std::string text;
+    uint32_t thread;
+    uint32_t suppressed;
+};
+
+// Logger without a drain thread that keeps what reaches its sink
+struct CapturingLogger {
+    std::mutex mutex;
+    std::vector<Captured> messages;
+    logring::Logger logger;
+
+    explicit CapturingLogger(bool startThread = false) : logger(config(startThread)) {}
+
+    logring::Config config(bool startThread) {
+        logring::Config c;
+        c.startThread = startThread;
+        c.interval = std::chrono::milliseconds(1);
+        c.sink = [this](const logring::Message& m) {
+            std::lock_guard<std::mutex> lock(mutex);
+            messages.push_back({m.level, m.tag, m.text, m.thread, m.suppressed});
+        };
+        return c;
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return messages.size();
+    }
+};
+
+TEST(LogRingTest, DrainsFormattedMessages) {
+    CapturingLogger log;
+    LOG_RING(log.logger, logring::Level::Info, "Test", 0, "frame %d took %.1f ms", 7, 16.5);
+    LOG_RING(log.logger, logring::Level::Warn, "Other", 0, "%s", "failed");
+    EXPECT_EQ(log.size(), 0u);
+
+    EXPECT_EQ(log.logger.drain(), 2u);
+    ASSERT_EQ(log.messages.size(), 2u);
+    EXPECT_EQ(log.messages[0].level, logring::Level::Info);
+    EXPECT_EQ(log.messages[0].tag, "Test");
+    EXPECT_EQ(log.messages[0].text, "frame 7 took 16.5 ms");
+    EXPECT_EQ(log.messages[1].level, logring::Level::Warn);
+    EXPECT_EQ(log.messages[1].text, "failed");
+    EXPECT_EQ(log.messages[0].thread, log.messages[1].thread);
+    EXPECT_EQ(log.logger.drain(), 0u);
+}
+
+TEST(LogRingTest, ErrorsAreWrittenAtOnceAndNeverRateLimited) {
+    CapturingLogger log;
+    LOG_RING(log.logger, logring::Level::Info, "Test", 0, "before");
+    for (int i = 0; i < 5; i++) LOG_RING(log.logger, logring::Level::Error, "Test", 1, "error %d", i);
+
+    // No drain: the queued message went out first, then every error
+    ASSERT_EQ(log.size(), 6u);
+    EXPECT_EQ(log.messages[0].text, "before");
+    for (int i = 0; i < 5; i++) {
+        EXPECT_EQ(log.messages[i + 1].level, logring::Level::Error);
+        EXPECT_EQ(log.messages[i + 1].text, "error " + std::to_string(i));
+        EXPECT_EQ(log.messages[i + 1].suppressed, 0u);
+    }
+    EXPECT_EQ(log.messages[0].thread, log.messages[1].thread);
+    EXPECT_EQ(log.logger.drain(), 0u);
+}
+
+TEST(LogRingTest, LevelsBelowTheMinimumCompileAway) {
+    CapturingLogger log;
+    int evaluated = 0;
+    LOG_RING(log.logger, logring::Level::Debug, "Test", 0, "%d", ++evaluated);
+    LOG_RING(log.logger, logring::Level::Warn, "Test", 0, "%d", ++evaluated);
+    log.logger.drain();
+    EXPECT_EQ(evaluated, 1);
+    ASSERT_EQ(log.messages.size(), 1u);
+    EXPECT_EQ(log.messages[0].level, logring::Level::Warn);
+}
+
+TEST(LogRingTest, LongMessagesAreTruncated) {
+    CapturingLogger log;
+    const std::string longText(1000, 'x');
+    LOG_RING(log.logger, logring::Level::Info, "Test", 0, "%s", longText.c_str());
+    log.logger.drain();
+    ASSERT_EQ(log.messages.size(), 1u);
+    EXPECT_EQ(log.messages[0].text, std::string(logring::TEXT_BYTES - 1, 'x'));
+}
+
+TEST(LogRingTest, SitesAreRateLimitedPerWindow) {
+    logring::Site site("Test", 3);
+    const int64_t t0 = 5 * logring::RATE_WINDOW_NANOS;
+    int admitted = 0;
+    for (int i = 0; i < 10; i++) admitted += site.admit(t0 + i);
+    EXPECT_EQ(admitted, 3);
+    EXPECT_EQ(site.takeSuppressed(), 7u);
+    EXPECT_EQ(site.takeSuppressed(), 0u);
+
+    EXPECT_TRUE(site.admit(t0 + logring::RATE_WINDOW_NANOS));
+
+    logring::Site unlimited("Test", 0);
+    for (int i = 0; i < 1000; i++) ASSERT_TRUE(unlimited.admit(t0));
+}
+
+TEST(LogRingTest, SuppressedCountRidesOnTheNextMessage) {
+    CapturingLogger log;
+    auto burst = [&log](int from, int to) {
+        for (int i = from; i < to; i++) LOG_RING(log.logger, logring::Level::Info, "Test", 2, "message %d", i);
+    };
+    burst(0, 10);
+    log.logger.drain();
+    ASSERT_EQ(log.messages.size(), 2u);
+    EXPECT_EQ(log.messages[0].text, "message 0");
+    EXPECT_EQ(log.messages[1].text, "message 1");
+    EXPECT_EQ(log.messages[1].suppressed, 0u);
+
+    // The first message of the next window carries the count
+    std::this_thread::sleep_for(std::chrono::nanoseconds(logring::RATE_WINDOW_NANOS + 10000000));
+    burst(10, 12);
+    log.logger.drain();
+    ASSERT_EQ(log.messages.size(), 4u);
+    EXPECT_EQ(log.messages[2].text, "message 10");
+    EXPECT_EQ(log.messages[2].suppressed, 8u);
+    EXPECT_EQ(log.messages[3].suppressed, 0u);
+}
+
+TEST(LogRingTest, FullRingDropsAndReports) {
+    CapturingLogger log;
+    for (size_t i = 0; i < logring::RING_CAPACITY + 10; i++) {
+        LOG_RING(log.logger, logring::Level::Info, "Test", 0, "message %zu", i);
+    }
+    log.logger.drain();
+    ASSERT_EQ(log.messages.size(), logring::RING_CAPACITY + 1);
+    EXPECT_EQ(log.messages.front().text, "message 0");
+    EXPECT_EQ(log.messages[logring::RING_CAPACITY - 1].text, "message " + std::to_string(logring::RING_CAPACITY - 1));
+    EXPECT_EQ(log.messages.back().level, logring::Level::Warn);
+    EXPECT_EQ(log.messages.back().text, "10 messages dropped, log ring full");
+
+    // Drained slots are reused
+    LOG_RING(log.logger, logring::Level::Info, "Test", 0, "after");
+    log.logger.drain();
+    EXPECT_EQ(log.messages.back().text, "after");
+}
+
+TEST(LogRingTest, ThreadsKeepTheirOrderAndRingsOfExitedThreadsAreFreed) {
+    CapturingLogger log;
+    constexpr int THREADS = 4, MESSAGES = 100;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; t++) {
+        threads.emplace_back([&log, t] {
+            for (int i = 0; i < MESSAGES; i++) LOG_RING(log.logger, logring::Level::Info, "Test", 0, "%d %d", t, i);
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+    EXPECT_EQ(log.logger.ringCount(), static_cast<size_t>(THREADS));
+
+    EXPECT_EQ(log.logger.drain(), static_cast<size_t>(THREADS * MESSAGES));
+    int next[THREADS] = {};
+    for (const Captured& m : log.messages) {
+        int t, i;
+        ASSERT_EQ(sscanf(m.text.c_str(), "%d %d", &t, &i), 2);
+        EXPECT_EQ(i, next[t]++);
+    }
+    EXPECT_EQ(log.logger.ringCount(), 0u);
+}
+
+TEST(LogRingTest, BackgroundThreadDrains) {
+    CapturingLogger log(true);
+    LOG_RING(log.logger, logring::Level::Info, "Test", 0, "hello");
+    for (int i = 0; i < 1000 && log.size() == 0; i++) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    ASSERT_EQ(log.size(), 1u);
+    EXPECT_EQ(log.messages[0].text, "hello");
+}
+
+} // namespace
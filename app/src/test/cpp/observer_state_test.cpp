@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include "observer_state.h"
+
+namespace {
+
+using observer::DEG;
+
+// 2024-03-20 03:06 UTC
+constexpr double T0 = 1710903960.0;
+
+observer::Location location(double lat, double lon, double altitude = 0.0) {
+    observer::Location l;
+    l.latitudeDeg = lat;
+    l.longitudeDeg = lon;
+    l.altitudeM = altitude;
+    return l;
+}
+
+double dot(const double a[3], const double b[3]) { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; }
+
+TEST(ObserverStateTest, SiderealTimeAtJ2000) {
+    // 2000-01-01 12:00 UT
+    EXPECT_NEAR(observer::greenwichSiderealRad(946728000.0) / DEG, 280.46061837, 1e-6);
+    // One sidereal day later the Earth has turned once
+    EXPECT_NEAR(observer::greenwichSiderealRad(946728000.0 + 86164.0905) / DEG, 280.46061837, 1e-3);
+}
+
+TEST(ObserverStateTest, EcefOnTheEllipsoid) {
+    double ecef[3];
+    observer::geodeticToEcef(location(0.0, 0.0), ecef);
+    EXPECT_NEAR(ecef[0], 6378137.0, 1e-6);
+    EXPECT_NEAR(ecef[1], 0.0, 1e-6);
+    observer::geodeticToEcef(location(90.0, 0.0), ecef);
+    EXPECT_NEAR(ecef[2], 6356752.314, 1e-3);
+    observer::geodeticToEcef(location(0.0, 90.0, 1000.0), ecef);
+    EXPECT_NEAR(ecef[1], 6379137.0, 1e-6);
+}
+
+TEST(ObserverStateTest, FrameIsTheLocalZenithNorthEast) {
+    observer::State state;
+    EXPECT_FALSE(state.valid());
+    EXPECT_TRUE(state.update(location(52.0, 13.4), T0));
+    EXPECT_TRUE(state.valid());
+
+    // Zenith at RA = local sidereal time, Dec = latitude
+    const observer::Frame& f = state.frame();
+    const double lst = observer::greenwichSiderealRad(T0) + 13.4 * DEG;
+    EXPECT_NEAR(f.zenith[0], std::cos(52.0 * DEG) * std::cos(lst), 1e-12);
+    EXPECT_NEAR(f.zenith[1], std::cos(52.0 * DEG) * std::sin(lst), 1e-12);
+    EXPECT_NEAR(f.zenith[2], std::sin(52.0 * DEG), 1e-12);
+
+    EXPECT_NEAR(dot(f.zenith, f.north), 0.0, 1e-12);
+    EXPECT_NEAR(dot(f.zenith, f.east), 0.0, 1e-12);
+    EXPECT_NEAR(dot(f.north, f.north), 1.0, 1e-12);
+    EXPECT_GT(f.north[2], 0.0);  // North points toward the pole
+    // East = north x zenith
+    EXPECT_NEAR(f.north[1] * f.zenith[2] - f.north[2] * f.zenith[1], f.east[0], 1e-12);
+    EXPECT_NEAR(f.north[2] * f.zenith[0] - f.north[0] * f.zenith[2], f.east[1], 1e-12);
+
+    const observer::Horizon& h = state.horizon();
+    EXPECT_FLOAT_EQ(h.plane[0], static_cast<float>(f.zenith[0]));
+    EXPECT_FLOAT_EQ(h.plane[2], static_cast<float>(f.zenith[2]));
+}
+
+TEST(ObserverStateTest, SmallChangesKeepEveryVersion) {
+    observer::State state;
+    state.update(location(52.0, 13.4), T0);
+    const uint64_t version = state.version();
+
+    // One second turns the Earth 15", under the 30" threshold; 10 m is under 50 m
+    EXPECT_FALSE(state.update(location(52.00009, 13.4), T0 + 1.0));
+    EXPECT_EQ(state.version(), version);
+    EXPECT_FALSE(state.update(location(52.0, 13.4), T0 + 1.9));
+}
+
+TEST(ObserverStateTest, TimeMovesOnlyTheFrameAndHorizon) {
+    observer::State state;
+    state.update(location(52.0, 13.4), T0);
+    const observer::Site site = state.site();
+    const uint64_t refraction = state.refraction().version;
+    const uint64_t frame = state.frame().version;
+    const uint64_t horizon = state.horizon().version;
+
+    EXPECT_TRUE(state.update(location(52.0, 13.4), T0 + 3.0));
+    EXPECT_EQ(state.site().version, site.version);
+    EXPECT_EQ(state.refraction().version, refraction);
+    EXPECT_GT(state.frame().version, frame);
+    EXPECT_GT(state.horizon().version, horizon);
+    EXPECT_EQ(state.version(), state.horizon().version);
+
+    // The threshold is measured from the last recomputation, not the last call
+    EXPECT_FALSE(state.update(location(52.0, 13.4), T0 + 4.0));
+    EXPECT_TRUE(state.update(location(52.0, 13.4), T0 + 5.5));
+}
+
+TEST(ObserverStateTest, MovingTheSiteMovesEverythingDependingOnIt) {
+    observer::State state;
+    state.update(location(52.0, 13.4), T0);
+    const uint64_t site = state.site().version;
+    const uint64_t refraction = state.refraction().version;
+    const double depression = state.horizon().depressionRad;
+
+    // A kilometer north: new site and frame, same atmosphere
+    EXPECT_TRUE(state.update(location(52.009, 13.4), T0));
+    EXPECT_GT(state.site().version, site);
+    EXPECT_EQ(state.refraction().version, refraction);
+    EXPECT_NEAR(state.frame().zenith[2], std::sin(52.009 * DEG), 1e-12);
+
+    // A mountain: thinner air refracts less, but the horizon dips further
+    EXPECT_TRUE(state.update(location(52.009, 13.4, 2000.0), T0));
+    EXPECT_GT(state.refraction().version, refraction);
+    EXPECT_LT(state.refraction().pressureHpa, 800.0);
+    EXPECT_LT(state.refraction().at(0.0), 25.0 * 60.0 * observer::ARCSEC);
+    EXPECT_GT(state.horizon().depressionRad, depression + 1.0 * DEG);
+}
+
+TEST(ObserverStateTest, RefractionTableFollowsTheFormula) {
+    observer::State state;
+    state.update(location(0.0, 0.0), T0);
+    const observer::Refraction& r = state.refraction();
+
+    // About 29' at the horizon and 1' at 45 degrees
+    EXPECT_NEAR(r.at(0.0) / observer::ARCSEC / 60.0, 29.0, 0.5);
+    EXPECT_NEAR(r.at(45.0 * DEG) / observer::ARCSEC / 60.0, 1.0, 0.05);
+    EXPECT_NEAR(r.at(90.0 * DEG), 0.0, 1e-6);
+    for (double altitude = -1.0; altitude < 89.0; altitude += 0.37) {
+        const double exact = observer::refractionRad(altitude, r.pressureHpa, r.temperatureC);
+        EXPECT_NEAR(r.at(altitude * DEG), exact, 0.05 * 60.0 * observer::ARCSEC) << altitude;
+    }
+
+    // At sea level the visible horizon is the refracted astronomical one
+    EXPECT_NEAR(state.horizon().depressionRad, r.at(0.0), 1e-9);
+    EXPECT_NEAR(state.horizon().plane[3], std::sin(r.at(0.0)), 1e-6);
+}
+
+TEST(ObserverStateTest, AtmosphereReadingsPastTheThresholdRebuildRefraction) {
+    observer::State state;
+    state.update(location(52.0, 13.4), T0);
+    const uint64_t frame = state.frame().version;
+    const uint64_t refraction = state.refraction().version;
+    const double standard = state.refraction().at(0.0);
+
+    EXPECT_FALSE(state.setAtmosphere(1013.5, 10.5));
+    EXPECT_EQ(state.refraction().version, refraction);
+
+    EXPECT_TRUE(state.setAtmosphere(1030.0, -20.0));
+    EXPECT_GT(state.refraction().version, refraction);
+    EXPECT_EQ(state.horizon().version, state.version());
+    EXPECT_EQ(state.frame().version, frame);
+    EXPECT_GT(state.refraction().at(0.0), standard * 1.1);
+
+    // Readings stay in use as the site moves
+    state.update(location(52.0, 13.4, 500.0), T0);
+    EXPECT_DOUBLE_EQ(state.refraction().pressureHpa, 1030.0);
+}
+
+TEST(ObserverStateTest, AtmosphereSetBeforeTheFirstUpdateIsUsed) {
+    observer::State state;
+    EXPECT_FALSE(state.setAtmosphere(900.0, 30.0));
+    state.update(location(0.0, 0.0), T0);
+    EXPECT_DOUBLE_EQ(state.refraction().pressureHpa, 900.0);
+    EXPECT_DOUBLE_EQ(state.refraction().temperatureC, 30.0);
+    EXPECT_GT(state.refraction().at(0.0), 0.0);
+}
+
+} // namespace
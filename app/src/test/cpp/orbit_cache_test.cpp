@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "orbit_cache.h"
+
+namespace {
+
+constexpr double DEG = orbits::PI / 180.0;
+
+// Mars, J2000 mean elements (as in PlanetCalculator.kt)
+orbits::Elements mars() {
+    const double a = 1.52371034, e = 0.09339410;
+    const double perihelion = 336.05637041 * DEG, node = 49.55953891 * DEG;
+    const double n = orbits::GAUSS_K / (a * std::sqrt(a));
+    const double meanAnomaly = std::remainder(355.4329650 * DEG - perihelion, 2.0 * orbits::PI);
+    return {a * (1.0 - e), e, 1.84969142 * DEG, perihelion - node, node,
+            orbits::J2000 - meanAnomaly / n, orbits::Center::Sun};
+}
+
+constexpr double MARS_OPPOSITION_2003 = 2452879.5;  // 2003-08-28
+
+double norm(const double v[3]) {
+    return std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+}
+
+// Angle from p to the nearest drawn segment of a polyline (chords project to great-circle arcs)
+double distanceToPolyline(const double p[3], const std::vector<float>& points) {
+    double best = orbits::PI;
+    for (size_t i = 0; i + 6 <= points.size(); i += 3) {
+        const double a[3] = {points[i], points[i + 1], points[i + 2]};
+        const double b[3] = {points[i + 3], points[i + 4], points[i + 5]};
+        double n[3] = {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+        const double nl = norm(n);
+        for (double& c : n) c /= nl > 0.0 ? nl : 1.0;
+        // Inside the arc when p lies between a and b as seen around n
+        const double pa[3] = {n[1] * a[2] - n[2] * a[1], n[2] * a[0] - n[0] * a[2], n[0] * a[1] - n[1] * a[0]};
+        const double pb[3] = {n[1] * b[2] - n[2] * b[1], n[2] * b[0] - n[0] * b[2], n[0] * b[1] - n[1] * b[0]};
+        const double sa = p[0] * pa[0] + p[1] * pa[1] + p[2] * pa[2];
+        const double sb = p[0] * pb[0] + p[1] * pb[1] + p[2] * pb[2];
+        double d;
+        if (nl > 0.0 && sa >= 0.0 && sb <= 0.0) {
+            d = std::asin(std::min(1.0, std::abs(p[0] * n[0] + p[1] * n[1] + p[2] * n[2])));
+        } else {
+            const double da = std::acos(std::clamp(p[0] * a[0] + p[1] * a[1] + p[2] * a[2], -1.0, 1.0));
+            const double db = std::acos(std::clamp(p[0] * b[0] + p[1] * b[1] + p[2] * b[2], -1.0, 1.0));
+            d = std::min(da, db);
+        }
+        best = std::min(best, d);
+    }
+    return best;
+}
+
+TEST(OrbitCacheTest, EllipseReachesPericenterAndApocenter) {
+    const orbits::Elements el = {1.0, 0.5, 0.3, 0.7, 1.1, 2451000.0, orbits::Center::Sun};
+    const double a = el.q / (1.0 - el.e);
+    const double period = 2.0 * orbits::PI * a * std::sqrt(a) / orbits::GAUSS_K;
+    double p[3];
+    orbits::position(el, el.pericenterJd, p);
+    EXPECT_NEAR(el.q, norm(p), 1e-12);
+    orbits::position(el, el.pericenterJd + 0.5 * period, p);
+    EXPECT_NEAR(a * (1.0 + el.e), norm(p), 1e-9);
+
+    double q[3];
+    orbits::position(el, el.pericenterJd + 0.3 * period, p);
+    orbits::position(el, el.pericenterJd + 1.3 * period, q);
+    for (int i = 0; i < 3; i++) EXPECT_NEAR(p[i], q[i], 1e-9);
+}
+
+TEST(OrbitCacheTest, ConicsAgreeNearParabolic) {
+    const double jd = 2451000.0;
+    for (double dt : {-40.0, -5.0, 0.0, 12.0, 60.0}) {
+        double p[3], lower[3], upper[3];
+        orbits::position({0.5, 1.0, 0.4, 1.2, 2.0, jd, orbits::Center::Sun}, jd + dt, p);
+        orbits::position({0.5, 1.0 - 1e-6, 0.4, 1.2, 2.0, jd, orbits::Center::Sun}, jd + dt, lower);
+        orbits::position({0.5, 1.0 + 1e-6, 0.4, 1.2, 2.0, jd, orbits::Center::Sun}, jd + dt, upper);
+        for (int i = 0; i < 3; i++) {
+            EXPECT_NEAR(p[i], lower[i], 1e-5);
+            EXPECT_NEAR(p[i], upper[i], 1e-5);
+        }
+    }
+}
+
+TEST(OrbitCacheTest, MarsAtOpposition2003) {
+    double d[3];
+    orbits::skyDirection(mars(), orbits::earth(), MARS_OPPOSITION_2003, d);
+    const double ra = std::atan2(d[1], d[0]) / DEG + 360.0;
+    const double dec = std::asin(d[2]) / DEG;
+    EXPECT_NEAR(339.5, ra, 1.5);  // 22h38m
+    EXPECT_NEAR(-15.8, dec, 1.5);
+}
+
+TEST(OrbitCacheTest, SampledLoopStaysWithinTolerance) {
+    const double start = MARS_OPPOSITION_2003 - 100.0, end = MARS_OPPOSITION_2003 + 100.0;
+    const double tolerance = 1e-3;
+    std::vector<float> points;
+    orbits::sample(mars(), orbits::earth(), start, end, tolerance, points);
+    ASSERT_GE(points.size(), 3u * (orbits::SEED_SEGMENTS + 1));
+
+    double worst = 0.0;
+    for (int i = 0; i <= 2000; i++) {
+        double p[3];
+        orbits::skyDirection(mars(), orbits::earth(), start + (end - start) * i / 2000.0, p);
+        worst = std::max(worst, distanceToPolyline(p, points));
+    }
+    EXPECT_LT(worst, 1.5 * tolerance);
+
+    // A coarser tolerance needs far fewer vertices
+    std::vector<float> coarse;
+    orbits::sample(mars(), orbits::earth(), start, end, 16.0 * tolerance, coarse);
+    EXPECT_LT(coarse.size() * 2, points.size());
+}
+
+TEST(OrbitCacheTest, ResamplesOnlyOnSignificantChange) {
+    orbits::Cache cache;
+    cache.set({{1, mars(), 0xffff0000u}, {2, orbits::Elements{0.59, 0.967, 162.3 * DEG, 111.3 * DEG, 58.4 * DEG,
+                                                              2446467.5, orbits::Center::Sun}, 0x8000ff00u}});
+    const double start = MARS_OPPOSITION_2003 - 100.0, end = MARS_OPPOSITION_2003 + 100.0;
+    EXPECT_EQ(2u, cache.update(start, end, 1e-3));
+    EXPECT_GT(cache.lastEvaluations(), 0u);
+    cache.markClean();
+
+    EXPECT_EQ(0u, cache.update(start, end, 1e-3));
+    EXPECT_EQ(0u, cache.lastEvaluations());
+    EXPECT_EQ(0u, cache.update(start + 10.0, end + 10.0, 1e-3));  // 5% of the span
+    EXPECT_EQ(0u, cache.update(start, end, 1.5e-3));               // Small zoom change
+    EXPECT_FALSE(cache.dirty());
+
+    EXPECT_EQ(2u, cache.update(start, end, 0.4e-3));  // Zoomed in
+    EXPECT_EQ(2u, cache.update(start + 30.0, end + 30.0, 0.4e-3));
+    EXPECT_TRUE(cache.dirty());
+
+    // Same elements keep their polyline; changed ones are re-sampled
+    orbits::Elements moved = mars();
+    moved.e += 0.01;
+    cache.set({{1, mars(), 0xffffffffu}, {3, moved, 0xffffffffu}});
+    EXPECT_EQ(1u, cache.update(start + 30.0, end + 30.0, 0.4e-3));
+    EXPECT_EQ(2u, cache.size());
+}
+
+TEST(OrbitCacheTest, WritesOneLineList) {
+    orbits::Cache cache;
+    cache.set({{1, mars(), 0xff336699u}, {2, mars(), 0x80ffffffu}});
+    cache.update(MARS_OPPOSITION_2003 - 50.0, MARS_OPPOSITION_2003 + 50.0, 2e-3);
+
+    const size_t vertices = cache.vertexCount();
+    ASSERT_EQ(cache.indexCount(), 2 * (vertices - 2));
+    std::vector<float> v(vertices * 7);
+    std::vector<uint32_t> idx(cache.indexCount());
+    cache.write(v.data(), idx.data());
+
+    EXPECT_NEAR(0x33 / 255.0f, v[3], 1e-6f);
+    EXPECT_NEAR(0x66 / 255.0f, v[4], 1e-6f);
+    EXPECT_NEAR(0x99 / 255.0f, v[5], 1e-6f);
+    EXPECT_FLOAT_EQ(1.0f, v[6]);
+    EXPECT_NEAR(0x80 / 255.0f, v[(vertices - 1) * 7 + 6], 1e-6f);
+
+    // Consecutive pairs within each track, never bridging the two
+    const uint32_t first = static_cast<uint32_t>(vertices / 2);
+    for (size_t i = 0; i < idx.size(); i += 2) {
+        EXPECT_EQ(idx[i] + 1, idx[i + 1]);
+        EXPECT_NE(first, idx[i + 1]);
+        EXPECT_LT(idx[i + 1], vertices);
+    }
+}
+
+} // namespace
@@ -0,0 +1,108 @@
+// Cone culling benchmark for sky::Store over the synthetic sky (not a test;
+// run by hand).
+//
+// Builds the store from the benchmark sky (benchmark_sky.h) and culls cones
+// of several fields of view around fixed and random look directions, with
+// the whole catalog, the frame budget's thinning and a horizon plane. Prints
+// mean time and rows per cull.
+//
+//   ./sky_store_benchmark [stars] [repeats]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "benchmark_sky.h"
+#include "sky_store.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int RANDOM_DIRECTIONS = 64;
+
+struct Direction {
+    float v[3];
+};
+
+// The galactic center and pole (densest and sparsest fields), then random ones
+std::vector<Direction> lookDirections() {
+    std::vector<Direction> out;
+    for (const synthetic::Vec3& v : {synthetic::unitVector(synthetic::CENTER_RA, synthetic::CENTER_DEC),
+                                     synthetic::unitVector(synthetic::POLE_RA, synthetic::POLE_DEC)}) {
+        out.push_back({{static_cast<float>(v.x), static_cast<float>(v.y), static_cast<float>(v.z)}});
+    }
+    synthetic::Random random(bench::SKY_SEED, 0);
+    for (int i = 0; i < RANDOM_DIRECTIONS; i++) {
+        const double z = 2.0 * random.uniform() - 1.0;
+        const double phi = 2.0 * synthetic::PI * random.uniform();
+        const double r = std::sqrt(1.0 - z * z);
+        out.push_back({{static_cast<float>(r * std::cos(phi)), static_cast<float>(r * std::sin(phi)),
+                        static_cast<float>(z)}});
+    }
+    return out;
+}
+
+struct Result {
+    double microseconds;
+    double rows;
+};
+
+// Mean over directions of the best of `repeats` culls each
+Result cullAll(const sky::Store& store, const std::vector<Direction>& directions, float fovDeg,
+               const sky::Filter& filter, int repeats) {
+    const float halfAngle = fovDeg * 0.5f * static_cast<float>(synthetic::DEG);
+    std::vector<uint32_t> rows;
+    double totalUs = 0.0, totalRows = 0.0;
+    for (const Direction& d : directions) {
+        double best = 1e30;
+        for (int r = 0; r < repeats; r++) {
+            rows.clear();
+            const auto start = Clock::now();
+            store.cull(d.v, halfAngle, filter, rows);
+            best = std::min(best, std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+        }
+        totalUs += best;
+        totalRows += static_cast<double>(rows.size());
+    }
+    return {totalUs / directions.size(), totalRows / directions.size()};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const uint64_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const int repeats = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    const auto generateStart = Clock::now();
+    const std::vector<sky::Object> objects = bench::syntheticSky(count, &jobs::shared());
+    const double generateMs = std::chrono::duration<double, std::milli>(Clock::now() - generateStart).count();
+
+    sky::Store store;
+    const auto buildStart = Clock::now();
+    store.build(objects);
+    const double buildMs = std::chrono::duration<double, std::milli>(Clock::now() - buildStart).count();
+    std::printf("%zu stars (limit %.1f): generated in %.1f ms, store built in %.1f ms, %zu cells at order %d\n",
+                store.size(), synthetic::limitingMagnitude(count), generateMs, buildMs, store.cellCount(),
+                store.cellOrder());
+
+    const std::vector<Direction> directions = lookDirections();
+    sky::Filter all;
+    sky::Filter thinned;
+    thinned.fraction = 0.25f;
+    sky::Filter horizon;
+    horizon.horizon[2] = 1.0f;  // Zenith at the celestial pole
+    horizon.horizon[3] = 0.0f;
+
+    std::printf("%8s %12s %12s %12s %12s %12s %12s\n", "fov deg", "all us", "all rows", "1/4 us", "1/4 rows",
+                "horizon us", "horizon rows");
+    for (const float fov : {1.0f, 10.0f, 60.0f, 120.0f}) {
+        const Result a = cullAll(store, directions, fov, all, repeats);
+        const Result t = cullAll(store, directions, fov, thinned, repeats);
+        const Result h = cullAll(store, directions, fov, horizon, repeats);
+        std::printf("%8.0f %12.1f %12.0f %12.1f %12.0f %12.1f %12.0f\n", fov, a.microseconds, a.rows,
+                    t.microseconds, t.rows, h.microseconds, h.rows);
+    }
+    return 0;
+}
@@ -0,0 +1,318 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "sky_store.h"
+
+namespace {
+
+constexpr float DEG = 3.14159265f / 180.0f;
+
+sky::Object objectAt(float raDeg, float decDeg, float magnitude, uint8_t layer = 0,
+                     uint16_t flags = sky::FLAG_STAR, int32_t nameId = sky::NO_NAME) {
+    const float ra = raDeg * DEG, dec = decDeg * DEG;
+    return {std::cos(dec) * std::cos(ra), std::cos(dec) * std::sin(ra), std::sin(dec), magnitude,
+            7, 200, flags, nameId, layer};
+}
+
+std::vector<sky::Object> randomSky(size_t count, uint32_t seed = 1) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> ra(0.0f, 360.0f), sinDec(-1.0f, 1.0f), mag(-1.0f, 9.0f);
+    std::vector<sky::Object> objects;
+    for (size_t i = 0; i < count; i++) {
+        objects.push_back(objectAt(ra(rng), std::asin(sinDec(rng)) / DEG, mag(rng), static_cast<uint8_t>(i % 3)));
+    }
+    return objects;
+}
+
+float angleBetween(const float a[3], const sky::Object& o) {
+    return std::acos(std::min(1.0f, a[0] * o.x + a[1] * o.y + a[2] * o.z));
+}
+
+TEST(SkyStoreTest, RowsKeepEveryObjectOnce) {
+    const auto objects = randomSky(5000);
+    sky::Store store;
+    store.build(objects);
+
+    ASSERT_EQ(objects.size(), store.size());
+    std::vector<int> seen(objects.size(), 0);
+    for (size_t r = 0; r < store.size(); r++) {
+        const uint32_t source = store.sourceIndex()[r];
+        seen[source]++;
+        EXPECT_EQ(objects[source].x, store.x()[r]);
+        EXPECT_EQ(objects[source].magnitude, store.magnitude()[r]);
+        EXPECT_EQ(objects[source].layer, store.layer()[r]);
+    }
+    for (int count : seen) EXPECT_EQ(1, count);
+    EXPECT_GT(store.cellCount(), 1u);
+}
+
+TEST(SkyStoreTest, CullMatchesBruteForce) {
+    const auto objects = randomSky(20000, 7);
+    sky::Store store;
+    store.build(objects);
+
+    const float dir[3] = {0.6f, 0.0f, 0.8f};
+    for (float half : {2.0f * DEG, 20.0f * DEG, 100.0f * DEG}) {
+        std::vector<uint32_t> rows;
+        store.cull(dir, half, sky::Filter(), rows);
+
+        size_t expected = 0;
+        for (const auto& o : objects) {
+            if (o.x * dir[0] + o.y * dir[1] + o.z * dir[2] >= std::cos(half)) expected++;
+        }
+        EXPECT_EQ(expected, rows.size()) << "half angle " << half / DEG;
+        for (uint32_t r : rows) {
+            EXPECT_LE(angleBetween(dir, objects[store.sourceIndex()[r]]), half + 1e-4f);
+        }
+    }
+}
+
+TEST(SkyStoreTest, CullFiltersLayerMagnitudeAndFlags) {
+    std::vector<sky::Object> objects = {
+        objectAt(10, 0, 1.0f, 0),
+        objectAt(11, 0, 5.0f, 0),
+        objectAt(12, 0, 1.0f, 1),
+        objectAt(10, 1, 2.0f, 0, sky::FLAG_DEEP_SKY),
+    };
+    sky::Store store;
+    store.build(objects);
+    const float dir[3] = {std::cos(10 * DEG), std::sin(10 * DEG), 0.0f};
+
+    sky::Filter filter;
+    filter.layerMask = 1u << 0;
+    filter.requiredFlags = sky::FLAG_STAR;
+    filter.maxMagnitude = 3.0f;
+    std::vector<uint32_t> rows;
+    store.cull(dir, 10 * DEG, filter, rows);
+
+    ASSERT_EQ(1u, rows.size());
+    EXPECT_EQ(0u, store.sourceIndex()[rows[0]]);
+}
+
+TEST(SkyStoreTest, HorizonRejectsRowsBelowPlane) {
+    const auto objects = randomSky(20000, 3);
+    sky::Store store;
+    store.build(objects);
+
+    const sky::Object zenith = objectAt(40, 35, 0.0f);
+    sky::Filter filter;
+    filter.horizon[0] = zenith.x;
+    filter.horizon[1] = zenith.y;
+    filter.horizon[2] = zenith.z;
+    filter.horizon[3] = 0.01f;
+
+    // Look along the horizon so the view straddles it
+    const sky::Object look = objectAt(130, 0, 0.0f);
+    const float dir[3] = {look.x, look.y, look.z};
+    const float half = 60.0f * DEG;
+    std::vector<uint32_t> rows;
+    store.cull(dir, half, filter, rows);
+
+    size_t expected = 0;
+    for (const auto& o : objects) {
+        const bool inView = o.x * dir[0] + o.y * dir[1] + o.z * dir[2] >= std::cos(half);
+        if (inView && filter.aboveHorizon(o.x, o.y, o.z)) expected++;
+    }
+    EXPECT_EQ(expected, rows.size());
+    EXPECT_GT(expected, 0u);
+    for (uint32_t r : rows) EXPECT_TRUE(filter.aboveHorizon(store.x()[r], store.y()[r], store.z()[r]));
+
+    // Looking straight down finds nothing
+    const float nadir[3] = {-zenith.x, -zenith.y, -zenith.z};
+    rows.clear();
+    EXPECT_EQ(0u, store.cull(nadir, 30.0f * DEG, filter, rows));
+    EXPECT_EQ(-1, store.pick(nadir, 10.0f * DEG, filter));
+}
+
+TEST(SkyStoreTest, TerrainHidesRowsBehindSkyline) {
+    std::vector<sky::Object> objects = {
+        objectAt(0, 10, 1.0f),   // Behind the ridge
+        objectAt(0, 30, 1.0f),   // Above it
+        objectAt(90, 10, 1.0f),  // Where the skyline is flat
+    };
+    sky::Store store;
+    store.build(objects);
+
+    // Zenith +z, north +x: right ascension 0 lies at azimuth 0
+    horizon::Profile profile;
+    ASSERT_TRUE(profile.build({{340, 0}, {350, 20}, {10, 20}, {20, 0}}));
+    const float zenith[3] = {0.0f, 0.0f, 1.0f};
+    const float north[3] = {1.0f, 0.0f, 0.0f};
+    sky::Filter filter;
+    filter.terrain = {&profile, horizon::Frame::fromZenithNorth(zenith, north)};
+
+    const float up[3] = {0.0f, 0.0f, 1.0f};
+    std::vector<uint32_t> rows;
+    store.cull(up, 89.0f * DEG, filter, rows);
+    ASSERT_EQ(2u, rows.size());
+    for (uint32_t r : rows) EXPECT_NE(0u, store.sourceIndex()[r]);
+}
+
+TEST(SkyStoreTest, FractionKeepsBrightestOfEachCell) {
+    std::vector<sky::Object> objects;
+    for (int i = 0; i < 10; i++) objects.push_back(objectAt(45.0f + i * 0.01f, 30.0f, static_cast<float>(9 - i)));
+    sky::Store store;
+    store.build(objects);
+    ASSERT_EQ(1u, store.cellCount());
+
+    const float dir[3] = {objects[0].x, objects[0].y, objects[0].z};
+    sky::Filter filter;
+    filter.fraction = 0.3f;
+    std::vector<uint32_t> rows;
+    store.cull(dir, 5 * DEG, filter, rows);
+
+    ASSERT_EQ(3u, rows.size());
+    EXPECT_FLOAT_EQ(0.0f, store.magnitude()[rows[0]]);
+    EXPECT_FLOAT_EQ(1.0f, store.magnitude()[rows[1]]);
+    EXPECT_FLOAT_EQ(2.0f, store.magnitude()[rows[2]]);
+}
+
+TEST(SkyStoreTest, PickFindsNearestWithinRadius) {
+    std::vector<sky::Object> objects = {
+        objectAt(100, 20, 3.0f),
+        objectAt(100.5f, 20, 1.0f),
+        objectAt(250, -40, 0.0f),
+    };
+    sky::Store store;
+    store.build(objects);
+
+    const sky::Object target = objectAt(100.4f, 20, 0.0f);
+    const float dir[3] = {target.x, target.y, target.z};
+    const int64_t row = store.pick(dir, 1.0f * DEG);
+    ASSERT_GE(row, 0);
+    EXPECT_EQ(1u, store.sourceIndex()[row]);
+
+    const sky::Object empty = objectAt(0, -80, 0.0f);
+    const float far[3] = {empty.x, empty.y, empty.z};
+    EXPECT_EQ(-1, store.pick(far, 1.0f * DEG));
+}
+
+TEST(SkyStoreTest, FindNamePrefersBrightest) {
+    std::vector<sky::Object> objects = {
+        objectAt(1, 1, 4.0f, 0, sky::FLAG_STAR | sky::FLAG_NAMED, 42),
+        objectAt(2, 2, 1.0f, 0, sky::FLAG_STAR | sky::FLAG_NAMED, 42),
+        objectAt(3, 3, 0.0f, 0, sky::FLAG_STAR | sky::FLAG_NAMED, 7),
+        objectAt(4, 4, 0.0f),
+    };
+    sky::Store store;
+    store.build(objects);
+
+    ASSERT_GE(store.findName(42), 0);
+    EXPECT_EQ(1u, store.sourceIndex()[store.findName(42)]);
+    EXPECT_EQ(2u, store.sourceIndex()[store.findName(7)]);
+    EXPECT_EQ(-1, store.findName(3));
+}
+
+TEST(SkyStoreTest, StarVerticesMatchPackedLayout) {
+    std::vector<sky::Object> objects = {objectAt(30, 40, 2.0f)};
+    objects[0].colorIndex = 0x12;
+    objects[0].alpha = 0x34;
+    sky::Store store;
+    store.build(objects);
+
+    std::vector<uint32_t> rows = {0};
+    float vertex[4];
+    store.writeStarVertices(rows, vertex);
+    EXPECT_EQ(objects[0].x, vertex[0]);
+    EXPECT_EQ(objects[0].z, vertex[2]);
+    uint32_t bits;
+    std::memcpy(&bits, &vertex[3], sizeof(bits));
+    EXPECT_EQ(0x3412u, bits & 0xffffu);
+    EXPECT_EQ(sky::twinkleSeed(0), bits >> 16);
+}
+
+TEST(SkyStoreTest, TwinkleSeedsFollowSourceNotRow) {
+    sky::Store store;
+    const auto objects = randomSky(500, 9);
+    store.build(objects);
+
+    std::vector<uint32_t> rows(store.size());
+    for (uint32_t r = 0; r < rows.size(); r++) rows[r] = r;
+    std::vector<float> vertices(4 * rows.size());
+    store.writeStarVertices(rows, vertices.data());
+
+    std::vector<uint16_t> seeds;
+    for (uint32_t r = 0; r < rows.size(); r++) {
+        uint32_t bits;
+        std::memcpy(&bits, &vertices[4 * r + 3], sizeof(bits));
+        const uint16_t seed = static_cast<uint16_t>(bits >> 16);
+        EXPECT_EQ(sky::twinkleSeed(store.sourceIndex()[r]), seed);
+        EXPECT_NE(0u, seed);  // 0 would make star.vert derive a seed from the position
+        seeds.push_back(seed);
+    }
+    std::sort(seeds.begin(), seeds.end());
+    EXPECT_GT(std::unique(seeds.begin(), seeds.end()) - seeds.begin(), 450);
+}
+
+TEST(SkyStoreTest, DenseFieldGoesDeepAndCullsExactly) {
+    // 20000 stars in a patch a quarter of a degree across, as for a deep tile
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> offset(-0.125f, 0.125f), mag(5.0f, 15.0f);
+    std::vector<sky::Object> objects;
+    for (int i = 0; i < 20000; i++) objects.push_back(objectAt(83.8f + offset(rng), -5.4f + offset(rng), mag(rng)));
+    sky::Store store;
+    store.build(objects);
+    EXPECT_GT(store.cellOrder(), 8);
+    EXPECT_GT(store.cellCount(), sky::LINEAR_SCAN_CELLS);
+
+    const sky::Object center = objectAt(83.8f, -5.4f, 0.0f);
+    const float dir[3] = {center.x, center.y, center.z};
+    for (float half : {0.01f * DEG, 0.05f * DEG, 1.0f * DEG}) {
+        std::vector<uint32_t> rows;
+        store.cull(dir, half, sky::Filter(), rows);
+
+        // By chord: float dot products cannot resolve these angles
+        const double maxChord = 2.0 * std::sin(0.5 * half);
+        size_t expected = 0;
+        for (const auto& o : objects) {
+            if (std::hypot(o.x - dir[0], o.y - dir[1], o.z - dir[2]) <= maxChord) expected++;
+        }
+        EXPECT_EQ(expected, rows.size()) << "half angle " << half / DEG;
+    }
+    EXPECT_GE(store.pick(dir, 0.1f * DEG), 0);
+}
+
+TEST(SkyStoreTest, EvenSkyStaysCoarse) {
+    sky::Store store;
+    store.build(randomSky(20000, 5));
+    EXPECT_LE(store.cellOrder(), 4);
+}
+
+TEST(SkyStoreTest, RelativeVerticesReproducePositions) {
+    std::vector<sky::Object> objects = {objectAt(120.0f, 45.0f, 8.0f), objectAt(120.001f, 45.001f, 9.0f)};
+    sky::Store store;
+    store.build(objects);
+
+    const float dir[3] = {objects[0].x, objects[0].y, objects[0].z};
+    double anchor[3];
+    sky::Store::anchorFor(dir, anchor);
+    // The anchor is the center of the finest tile under dir, seconds of arc away
+    const double gap = std::hypot(anchor[0] - dir[0], anchor[1] - dir[1], anchor[2] - dir[2]);
+    EXPECT_LT(gap, 5.0 / 3600.0 * DEG);
+
+    std::vector<uint32_t> rows = {0, 1};
+    float vertices[8];
+    store.writeStarVertices(rows, vertices, anchor);
+    for (uint32_t r : rows) {
+        const float position[3] = {store.x()[r], store.y()[r], store.z()[r]};
+        for (int k = 0; k < 3; k++) {
+            EXPECT_LT(std::abs(vertices[r * 4 + k]), 1e-4f);
+            EXPECT_NEAR(position[k], vertices[r * 4 + k] + anchor[k], 1e-11);
+        }
+    }
+}
+
+TEST(SkyStoreTest, EmptyStore) {
+    sky::Store store;
+    store.build({});
+    const float dir[3] = {1, 0, 0};
+    std::vector<uint32_t> rows;
+    EXPECT_EQ(0u, store.cull(dir, 1.0f, sky::Filter(), rows));
+    EXPECT_EQ(-1, store.pick(dir, 1.0f));
+    EXPECT_EQ(-1, store.findName(0));
+}
+
+} // namespace
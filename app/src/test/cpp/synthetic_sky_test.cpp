@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "sky_tiles.h"
+#include "synthetic_sky.h"
+
+namespace {
+
+synthetic::Config config(uint64_t count, uint64_t seed = 7) {
+    synthetic::Config c;
+    c.count = count;
+    c.seed = seed;
+    return c;
+}
+
+std::vector<sky::Object> stars(const synthetic::Sky& sky) {
+    std::vector<sky::Object> out;
+    for (uint64_t i = 0; i < sky.config().count; i++) out.push_back(sky.star(i));
+    return out;
+}
+
+TEST(SyntheticSkyTest, CountLawInvertsMagnitude) {
+    for (double m : {-1.0, 3.0, 6.0, 10.0, 15.0, 20.0}) {
+        EXPECT_NEAR(synthetic::magnitudeForCount(synthetic::cumulativeCount(m)), m, 1e-9);
+    }
+    // About 5000 stars to naked-eye magnitude 6, a billion near 19-20
+    EXPECT_NEAR(synthetic::limitingMagnitude(5000), 6.0, 0.1);
+    EXPECT_GT(synthetic::limitingMagnitude(1000000000), 19.0);
+    EXPECT_LT(synthetic::limitingMagnitude(1000000000), 20.0);
+}
+
+TEST(SyntheticSkyTest, MagnitudesFollowStarCounts) {
+    const synthetic::Sky sky(config(200000));
+    const double bright = synthetic::cumulativeCount(synthetic::BRIGHTEST_MAGNITUDE);
+    const double total = synthetic::cumulativeCount(sky.limit()) - bright;
+    const std::vector<sky::Object> all = stars(sky);
+    for (double m : {5.0, 7.0, 8.0, 9.0}) {
+        size_t brighter = 0;
+        for (const sky::Object& o : all) brighter += o.magnitude < m;
+        const double expected = (synthetic::cumulativeCount(m) - bright) / total;
+        EXPECT_NEAR(static_cast<double>(brighter) / all.size(), expected, 0.01) << "m = " << m;
+    }
+    for (const sky::Object& o : all) {
+        ASSERT_LE(o.magnitude, sky.limit() + 1e-4);
+        ASSERT_NEAR(o.x * o.x + o.y * o.y + o.z * o.z, 1.0f, 1e-5f);
+        ASSERT_EQ(o.flags, sky::FLAG_STAR);
+    }
+}
+
+TEST(SyntheticSkyTest, FaintStarsCrowdTheGalacticPlane) {
+    synthetic::Config c = config(300000);
+    c.clusterFraction = 0.0;
+    const synthetic::Sky sky(c);
+
+    // Stars per unit sin(b) (equal-area bands) in the plane and toward the poles
+    auto contrast = [&](float minMagnitude, float maxMagnitude) {
+        size_t plane = 0, poles = 0;
+        for (uint64_t i = 0; i < c.count; i++) {
+            const sky::Object o = sky.star(i);
+            if (o.magnitude < minMagnitude || o.magnitude >= maxMagnitude) continue;
+            const double s = std::abs(sky.sinLatitude({o.x, o.y, o.z}));
+            if (s < 0.05) plane++;
+            else if (s > 0.7) poles++;
+        }
+        return (plane / 0.05) / (poles / 0.3);
+    };
+    const double bright = contrast(-2.0f, 7.0f);
+    const double faint = contrast(8.5f, 100.0f);
+    EXPECT_GT(bright, 1.5);
+    EXPECT_GT(faint, bright * 1.3);
+}
+
+TEST(SyntheticSkyTest, ClusterMembersSitNearTheirClusters) {
+    const synthetic::Sky sky(config(100000));
+    ASSERT_EQ(sky.clusters().size(), 20u);
+    size_t near = 0;
+    for (uint64_t i = 0; i < sky.config().count; i++) {
+        const sky::Object o = sky.star(i);
+        for (const synthetic::Cluster& cluster : sky.clusters()) {
+            const double d = o.x * cluster.center.x + o.y * cluster.center.y + o.z * cluster.center.z;
+            if (d > std::cos(3.0 * cluster.radius)) {
+                near++;
+                break;
+            }
+        }
+    }
+    // Most members fall within 3 Plummer radii; field stars rarely do
+    EXPECT_GT(near, 1500u);
+    EXPECT_LT(near, 2500u);
+}
+
+TEST(SyntheticSkyTest, OutputIsIndependentOfThreadsAndChunks) {
+    const synthetic::Config c = config(50000);
+    const std::vector<uint8_t> serial = synthetic::generate(c, nullptr, 50000);
+
+    jobs::Config jobConfig;
+    jobConfig.workerCount = 4;
+    jobConfig.pinWorkers = false;
+    jobs::JobSystem jobs(jobConfig);
+    EXPECT_EQ(synthetic::generate(c, &jobs, 1000), serial);
+    EXPECT_EQ(synthetic::generate(c, &jobs, 4093), serial);
+
+    EXPECT_NE(synthetic::generate(config(50000, 8), &jobs, 1000), serial);
+}
+
+TEST(SyntheticSkyTest, TilesHoldEveryStarInIndexOrder) {
+    synthetic::Config c = config(20000);
+    c.tileOrder = 2;
+    c.layer = 3;
+    const synthetic::Sky sky(c);
+    const std::vector<uint8_t> file = synthetic::generate(c, nullptr, 1500);
+    EXPECT_EQ(file.size(), tiles::fileSize(2, 20000));
+
+    tiles::View view;
+    ASSERT_TRUE(view.open(file.data(), file.size()));
+    EXPECT_EQ(view.tileOrder(), 2);
+    EXPECT_EQ(view.tileCount(), 192u);
+    EXPECT_EQ(view.objectCount(), 20000u);
+
+    // Stars in index order per tile, exactly as the generator makes them
+    std::vector<std::vector<sky::Object>> expected(view.tileCount());
+    for (uint64_t i = 0; i < c.count; i++) {
+        const sky::Object o = sky.star(i);
+        expected[tiles::tileOf(2, o.x, o.y, o.z)].push_back(o);
+    }
+    for (uint32_t t = 0; t < view.tileCount(); t++) {
+        std::vector<sky::Object> objects;
+        view.appendTile(t, objects);
+        ASSERT_EQ(objects.size(), expected[t].size());
+        for (size_t i = 0; i < objects.size(); i++) {
+            EXPECT_EQ(objects[i].x, expected[t][i].x);
+            EXPECT_EQ(objects[i].magnitude, expected[t][i].magnitude);
+            EXPECT_EQ(objects[i].colorIndex, expected[t][i].colorIndex);
+            EXPECT_EQ(objects[i].layer, 3);
+        }
+    }
+}
+
+TEST(SkyTilesTest, SerializeRoundTrips) {
+    std::vector<sky::Object> objects = {
+        {0.0f, 0.0f, 1.0f, 1.5f, 10, 255, sky::FLAG_STAR, 4, 0},
+        {1.0f, 0.0f, 0.0f, 7.0f, 200, 128, sky::FLAG_DEEP_SKY, sky::NO_NAME, 2},
+        {0.0f, 0.0f, -1.0f, 3.0f, 0, 64, sky::FLAG_STAR | sky::FLAG_NAMED, 9, 1},
+    };
+    const std::vector<uint8_t> file = tiles::serialize(objects, 1);
+    tiles::View view;
+    ASSERT_TRUE(view.open(file.data(), file.size()));
+
+    std::vector<sky::Object> loaded;
+    for (uint32_t t = 0; t < view.tileCount(); t++) view.appendTile(t, loaded);
+    ASSERT_EQ(loaded.size(), 3u);
+    for (const sky::Object& o : objects) {
+        bool found = false;
+        for (const sky::Object& l : loaded) {
+            found |= l.x == o.x && l.y == o.y && l.z == o.z && l.magnitude == o.magnitude &&
+                     l.colorIndex == o.colorIndex && l.alpha == o.alpha && l.flags == o.flags &&
+                     l.nameId == o.nameId && l.layer == o.layer;
+        }
+        EXPECT_TRUE(found);
+    }
+}
+
+TEST(SkyTilesTest, RejectsTruncatedOrForeignData) {
+    const std::vector<uint8_t> file = synthetic::generate(config(1000));
+    tiles::View view;
+    EXPECT_FALSE(view.open(file.data(), file.size() - 1));
+    EXPECT_FALSE(view.open(file.data(), tiles::recordsOffset(3) - 8));
+
+    std::vector<uint8_t> foreign = file;
+    foreign[0] ^= 0xff;
+    EXPECT_FALSE(view.open(foreign.data(), foreign.size()));
+
+    std::vector<uint8_t> unordered = file;
+    const uint64_t bad = 2000;
+    memcpy(unordered.data() + tiles::directoryOffset() + 8, &bad, sizeof(bad));
+    EXPECT_FALSE(view.open(unordered.data(), unordered.size()));
+}
+
+} // namespace
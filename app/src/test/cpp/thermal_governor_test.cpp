@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "thermal_governor.h"
+
+namespace {
+
+thermal::Reading headroom(float now, float forecast = NAN, thermal::Status status = thermal::Status::None) {
+    thermal::Reading r;
+    r.headroom = now;
+    r.forecastHeadroom = forecast;
+    r.status = status;
+    return r;
+}
+
+// Simulated device: headroom follows a scripted curve, hint calls are recorded
+class SimulatedPlatform : public thermal::Platform {
+public:
+    float headroomNow = 0.3f;
+    float headroomForecast = 0.3f;
+    thermal::Status status = thermal::Status::None;
+    int headroomQueries = 0;
+    std::vector<int64_t> targets;
+    std::vector<int64_t> actuals;
+
+    float thermalHeadroom(int forecastSeconds) override {
+        headroomQueries++;
+        return forecastSeconds == 0 ? headroomNow : headroomForecast;
+    }
+    thermal::Status thermalStatus() override { return status; }
+    void updateTargetWorkDuration(int64_t nanos) override { targets.push_back(nanos); }
+    void reportActualWorkDuration(int64_t nanos) override { actuals.push_back(nanos); }
+};
+
+TEST(ThermalGovernorTest, CoolDeviceStaysNominal) {
+    thermal::Governor governor;
+    for (int t = 0; t < 60; t++) {
+        EXPECT_FALSE(governor.update(t, headroom(0.4f, 0.5f)));
+    }
+    EXPECT_EQ(0, governor.tier());
+    EXPECT_EQ(60, governor.targetFps());
+    EXPECT_FLOAT_EQ(16.0f, governor.frameBudgetMs(16.0f));
+}
+
+TEST(ThermalGovernorTest, ForecastRaisesTierBeforeThrottling) {
+    thermal::Governor governor;
+    // Current headroom is fine but the forecast says throttling is coming
+    EXPECT_TRUE(governor.update(0.0, headroom(0.6f, 0.9f)));
+    EXPECT_EQ(2, governor.tier());
+    EXPECT_EQ(45, governor.targetFps());
+}
+
+TEST(ThermalGovernorTest, StatusSetsMinimumTier) {
+    thermal::Governor governor;
+    EXPECT_TRUE(governor.update(0.0, headroom(NAN, NAN, thermal::Status::Critical)));
+    EXPECT_EQ(3, governor.tier());
+    EXPECT_EQ(30, governor.targetFps());
+
+    // Headroom alone cannot lower the tier while the OS still reports Critical
+    for (int t = 1; t < 100; t++) governor.update(t, headroom(0.1f, 0.1f, thermal::Status::Critical));
+    EXPECT_EQ(3, governor.tier());
+}
+
+TEST(ThermalGovernorTest, UnknownSignalsKeepNominal) {
+    thermal::Governor governor;
+    EXPECT_FALSE(governor.update(0.0, thermal::Reading()));
+    EXPECT_EQ(0, governor.tier());
+}
+
+TEST(ThermalGovernorTest, CoolingStepsDownOneTierPerCoolDown) {
+    thermal::Config config;
+    config.coolDownSeconds = 10.0;
+    thermal::Governor governor(config);
+    governor.update(0.0, headroom(0.97f));
+    ASSERT_EQ(3, governor.tier());
+
+    // Just under the entry point is inside the hysteresis band: no change
+    for (int t = 1; t <= 30; t++) EXPECT_FALSE(governor.update(t, headroom(0.90f)));
+    EXPECT_EQ(3, governor.tier());
+
+    // Clearly cool: one tier per cool-down period
+    EXPECT_FALSE(governor.update(31.0, headroom(0.2f)));
+    EXPECT_FALSE(governor.update(40.0, headroom(0.2f)));
+    EXPECT_TRUE(governor.update(41.0, headroom(0.2f)));
+    EXPECT_EQ(2, governor.tier());
+    EXPECT_FALSE(governor.update(50.0, headroom(0.2f)));
+    EXPECT_TRUE(governor.update(51.0, headroom(0.2f)));
+    EXPECT_EQ(1, governor.tier());
+}
+
+TEST(ThermalGovernorTest, WarmSpellRestartsCoolDown) {
+    thermal::Governor governor;
+    governor.update(0.0, headroom(0.75f));
+    ASSERT_EQ(1, governor.tier());
+
+    governor.update(1.0, headroom(0.3f));
+    governor.update(9.0, headroom(0.68f));  // Back in the band: cooling resets
+    EXPECT_FALSE(governor.update(12.0, headroom(0.3f)));
+    EXPECT_FALSE(governor.update(21.0, headroom(0.3f)));
+    EXPECT_TRUE(governor.update(22.0, headroom(0.3f)));
+    EXPECT_EQ(0, governor.tier());
+}
+
+TEST(ThermalGovernorTest, FrameBudgetShrinksWithTier) {
+    thermal::Governor governor;
+    governor.update(0.0, headroom(0.96f));
+    // 30 fps gives 33 ms, but never more than the unthrottled budget, times 0.65
+    EXPECT_NEAR(16.0f * 0.65f, governor.frameBudgetMs(16.0f), 1e-4f);
+    EXPECT_EQ(1000000000LL / 30, governor.targetPeriodNanos());
+}
+
+TEST(ThermalControllerTest, ReportsWorkAndPollsAtInterval) {
+    SimulatedPlatform platform;
+    thermal::Controller controller(&platform);
+
+    // 60 fps for 3 seconds
+    for (int frame = 0; frame < 180; frame++) {
+        controller.onFrame(frame / 60.0, 8000000);
+    }
+    EXPECT_EQ(180u, platform.actuals.size());
+    ASSERT_EQ(1u, platform.targets.size());
+    EXPECT_EQ(1000000000LL / 60, platform.targets[0]);
+    // One headroom query per poll, one poll per second
+    EXPECT_EQ(3, platform.headroomQueries);
+}
+
+// Device-like platform: a second headroom query within one second returns NaN
+class RateLimitedPlatform : public SimulatedPlatform {
+public:
+    double now = 0.0;
+    bool forecastSupported = true;
+
+    float thermalHeadroom(int forecastSeconds) override {
+        const bool limited = now - lastQuery_ < 1.0;
+        lastQuery_ = now;
+        const float value = SimulatedPlatform::thermalHeadroom(forecastSeconds);
+        if (limited || (forecastSeconds > 0 && !forecastSupported)) return NAN;
+        return value;
+    }
+
+private:
+    double lastQuery_ = -1e9;
+};
+
+TEST(ThermalControllerTest, ForecastSurvivesTheQueryRateLimit) {
+    RateLimitedPlatform platform;
+    thermal::Controller controller(&platform);
+    platform.headroomNow = 0.5f;
+    platform.headroomForecast = 0.9f;
+
+    // Only the forecast says throttling is coming; it must get through
+    for (int frame = 0; frame < 180; frame++) {
+        platform.now = frame / 60.0;
+        controller.onFrame(platform.now, 8000000);
+    }
+    EXPECT_EQ(2, controller.governor().tier());
+    EXPECT_EQ(3, platform.headroomQueries);
+}
+
+TEST(ThermalControllerTest, CurrentHeadroomWithoutForecast) {
+    RateLimitedPlatform platform;
+    platform.forecastSupported = false;
+    thermal::Controller controller(&platform);
+    platform.headroomNow = 0.9f;
+
+    for (int second = 0; second < 3; second++) {
+        platform.now = second;
+        controller.onFrame(second, 8000000);
+    }
+    EXPECT_EQ(2, controller.governor().tier());
+
+    // Readings alternate, but the hot device is never taken for a cool one
+    for (int second = 3; second < 30; second++) {
+        platform.now = second;
+        controller.onFrame(second, 8000000);
+        EXPECT_EQ(2, controller.governor().tier()) << second;
+    }
+}
+
+TEST(ThermalControllerTest, SimulatedHeatUpAndCoolDown) {
+    SimulatedPlatform platform;
+    thermal::Controller controller(&platform);
+
+    // Headroom ramps from 0.3 to 1.0 over 70 s, then the device cools
+    int maxTier = 0;
+    std::vector<int> tiersSeen;
+    for (int second = 0; second < 200; second++) {
+        const float h = second < 70 ? 0.3f + second * 0.01f : std::max(0.2f, 1.0f - (second - 70) * 0.02f);
+        platform.headroomNow = h;
+        platform.headroomForecast = std::min(1.2f, h + 0.05f);
+        if (controller.onFrame(second, 10000000)) {
+            tiersSeen.push_back(controller.governor().tier());
+        }
+        maxTier = std::max(maxTier, controller.governor().tier());
+    }
+
+    EXPECT_EQ(3, maxTier);
+    ASSERT_GE(tiersSeen.size(), 6u);
+    EXPECT_EQ((std::vector<int>{1, 2, 3}), std::vector<int>(tiersSeen.begin(), tiersSeen.begin() + 3));
+    EXPECT_EQ(0, controller.governor().tier());
+    // Every tier change re-targets the hint session
+    EXPECT_EQ(1 + tiersSeen.size(), platform.targets.size());
+    EXPECT_EQ(1000000000LL / 30, platform.targets[3]);
+}
+
+TEST(ThermalControllerTest, NullPlatformIsInert) {
+    thermal::Controller controller(nullptr);
+    EXPECT_FALSE(controller.onFrame(0.0, 1000));
+    EXPECT_EQ(60, controller.governor().targetFps());
+}
+
+} // namespace
@@ -12,4 +12,8 @@ for catalog in stars messier; do
     mv "${OUTPUT_DIR}/data/${catalog}.bin" "${OUTPUT_DIR}/${catalog}.bin"
 done
 
+# Integrated-light maps for stars below the LOD cutoffs (native host tool)
+cmake -S src/main/cpp -B build/native >/dev/null && cmake --build build/native --target lightmap_tool
+build/native/lightmap_tool --input data/stars.csv --output "${OUTPUT_DIR}/lightmap.binary"
+
 echo "Binary files written to $OUTPUT_DIR"
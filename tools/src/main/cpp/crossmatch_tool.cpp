@@ -0,0 +1,130 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "crossmatch.h"
+
+/**
+ * Merges star catalogs (CSV: id,ra,dec,magnitude,name,spectral_type) by
+ * position into one catalog of the same format, plus the index of the input
+ * each star's position came from and how many later inputs matched it.
+ * Inputs are given highest priority first.
+ *
+ * Usage: crossmatch_tool --input <hip.csv> --input <tyc.csv> ... --output <merged.csv>
+ *                        [--radius 1.0] [--max-dmag 1.0] [--chunk 1000000] [--threads 0]
+ *
+ * --radius is the match radius in arcseconds. Each input is read in chunks
+ * of --chunk rows, so only the merged catalog is held in memory.
+ * --threads 0 uses every core.
+ */
+namespace {
+
+bool parseSource(const std::string& line, crossmatch::Source& source) {
+    std::vector<std::string> fields;
+    std::stringstream ss(line);
+    std::string field;
+    while (std::getline(ss, field, ',')) fields.push_back(field);
+    if (fields.size() < 4) return false;
+
+    source.id = std::strtoull(fields[0].c_str(), nullptr, 10);
+    source.ra = std::atof(fields[1].c_str());
+    source.dec = std::atof(fields[2].c_str());
+    source.magnitude = static_cast<float>(std::atof(fields[3].c_str()));
+    source.name = fields.size() > 4 ? fields[4] : std::string();
+    source.spectralType = fields.size() > 5 ? fields[5] : std::string();
+    return true;
+}
+
+/** Feed one catalog to the merger, chunkRows rows at a time. */
+bool mergeCatalog(const char* path, size_t chunkRows, crossmatch::Merger& merger, size_t& rows) {
+    std::ifstream in(path);
+    if (!in) return false;
+
+    merger.beginCatalog();
+    std::vector<crossmatch::Source> chunk;
+    chunk.reserve(chunkRows);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        crossmatch::Source source;
+        if (!parseSource(line, source)) continue;
+        chunk.push_back(std::move(source));
+        if (chunk.size() == chunkRows) {
+            rows += chunk.size();
+            merger.addChunk(chunk);
+            chunk.clear();
+        }
+    }
+    rows += chunk.size();
+    merger.addChunk(chunk);
+    merger.endCatalog();
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<const char*> inputs;
+    const char* output = nullptr;
+    crossmatch::Options options;
+    size_t chunkRows = 1000000;
+    unsigned threads = 0;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--input") == 0) inputs.push_back(argv[i + 1]);
+        else if (strcmp(argv[i], "--output") == 0) output = argv[i + 1];
+        else if (strcmp(argv[i], "--radius") == 0) options.radiusArcsec = std::atof(argv[i + 1]);
+        else if (strcmp(argv[i], "--max-dmag") == 0) options.maxMagnitudeDifference = static_cast<float>(std::atof(argv[i + 1]));
+        else if (strcmp(argv[i], "--chunk") == 0) chunkRows = std::strtoull(argv[i + 1], nullptr, 10);
+        else if (strcmp(argv[i], "--threads") == 0) threads = static_cast<unsigned>(std::atoi(argv[i + 1]));
+    }
+    if (inputs.empty() || output == nullptr || !(options.radiusArcsec > 0.0) || chunkRows == 0) {
+        std::cerr << "Usage: crossmatch_tool --input <catalog.csv> [--input <catalog.csv> ...] --output <merged.csv>"
+                     " [--radius 1.0] [--max-dmag 1.0] [--chunk 1000000] [--threads 0]" << std::endl;
+        return 1;
+    }
+
+    jobs::Config config;
+    config.workerCount = threads;
+    config.pinWorkers = false;
+    jobs::JobSystem jobs(config);
+    crossmatch::Merger merger(options, &jobs);
+
+    for (const char* input : inputs) {
+        const size_t before = merger.stars().size();
+        const size_t matchedBefore = merger.matched();
+        size_t rows = 0;
+        if (!mergeCatalog(input, chunkRows, merger, rows)) {
+            std::cerr << "Failed to read " << input << std::endl;
+            return 1;
+        }
+        std::cout << input << ": " << rows << " rows, " << merger.matched() - matchedBefore << " matched, "
+                  << merger.stars().size() - before << " new (index order " << merger.index().order() << ")"
+                  << std::endl;
+    }
+
+    std::ofstream out(output);
+    out << "# Merged catalog from " << inputs.size() << " inputs, match radius " << options.radiusArcsec
+        << " arcsec\n";
+    out << "# Format: id,ra,dec,magnitude,name,spectral_type,catalog,matches\n";
+    char number[64];
+    for (const crossmatch::Star& star : merger.stars()) {
+        const crossmatch::Source& s = star.source;
+        std::snprintf(number, sizeof(number), "%.8f,%.8f,%.3f", s.ra, s.dec, s.magnitude);
+        out << s.id << ',' << number << ',' << s.name << ',' << s.spectralType << ',' << star.catalog << ','
+            << star.matches << '\n';
+    }
+    if (!out) {
+        std::cerr << "Failed to write " << output << std::endl;
+        return 1;
+    }
+
+    std::cout << "Wrote " << merger.stars().size() << " stars to " << output << " (" << merger.matched()
+              << " cross-matches)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,121 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "light_map.h"
+
+/**
+ * Builds lightmap.binary from a star CSV (id,ra,dec,magnitude,name,spectral_type).
+ *
+ * Usage: lightmap_tool --input <stars.csv> --output <lightmap.binary>
+ *                      [--cutoffs 4,5,6,7] [--orders 3,5]
+ */
+namespace {
+
+// Approximate linear RGB of each spectral class, normalized to max channel 1
+void spectralColor(char type, float& r, float& g, float& b) {
+    switch (type) {
+        case 'O': r = 0.61f; g = 0.69f; b = 1.00f; break;
+        case 'B': r = 0.67f; g = 0.75f; b = 1.00f; break;
+        case 'A': r = 0.79f; g = 0.84f; b = 1.00f; break;
+        case 'F': r = 0.97f; g = 0.97f; b = 1.00f; break;
+        case 'G': r = 1.00f; g = 0.96f; b = 0.92f; break;
+        case 'K': r = 1.00f; g = 0.82f; b = 0.63f; break;
+        case 'M': r = 1.00f; g = 0.80f; b = 0.44f; break;
+        default:  r = 1.00f; g = 1.00f; b = 1.00f; break;
+    }
+}
+
+template <typename T>
+std::vector<T> parseList(const char* text) {
+    std::vector<T> values;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) values.push_back(static_cast<T>(std::atof(item.c_str())));
+    }
+    return values;
+}
+
+bool readStars(const char* path, std::vector<lightmap::StarSample>& stars) {
+    std::ifstream in(path);
+    if (!in) return false;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+
+        std::vector<std::string> fields;
+        std::stringstream ss(line);
+        std::string field;
+        while (std::getline(ss, field, ',')) fields.push_back(field);
+        if (fields.size() < 4) continue;
+
+        const double ra = std::atof(fields[1].c_str()) * healpix::PI / 180.0;
+        const double dec = std::atof(fields[2].c_str()) * healpix::PI / 180.0;
+
+        lightmap::StarSample s;
+        s.x = static_cast<float>(std::cos(dec) * std::cos(ra));
+        s.y = static_cast<float>(std::cos(dec) * std::sin(ra));
+        s.z = static_cast<float>(std::sin(dec));
+        s.magnitude = static_cast<float>(std::atof(fields[3].c_str()));
+        const char type = (fields.size() > 5 && !fields[5].empty()) ? fields[5][0] : '?';
+        spectralColor(type, s.r, s.g, s.b);
+        stars.push_back(s);
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* input = nullptr;
+    const char* output = nullptr;
+    std::vector<float> cutoffs = {4.0f, 5.0f, 6.0f, 7.0f};
+    std::vector<int> orders = {3, 5};
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--input") == 0) input = argv[i + 1];
+        else if (strcmp(argv[i], "--output") == 0) output = argv[i + 1];
+        else if (strcmp(argv[i], "--cutoffs") == 0) cutoffs = parseList<float>(argv[i + 1]);
+        else if (strcmp(argv[i], "--orders") == 0) orders = parseList<int>(argv[i + 1]);
+    }
+    if (input == nullptr || output == nullptr || cutoffs.empty() || orders.empty()) {
+        std::cerr << "Usage: lightmap_tool --input <stars.csv> --output <lightmap.binary>"
+                     " [--cutoffs 4,5,6,7] [--orders 3,5]" << std::endl;
+        return 1;
+    }
+
+    for (int order : orders) {
+        if (order < 0 || order > lightmap::MAX_MAP_ORDER) {
+            std::cerr << "Order " << order << " out of range: maps are dense, orders 0 to "
+                      << lightmap::MAX_MAP_ORDER << " are supported" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<lightmap::StarSample> stars;
+    if (!readStars(input, stars)) {
+        std::cerr << "Failed to read " << input << std::endl;
+        return 1;
+    }
+
+    const std::vector<lightmap::LightMap> maps = lightmap::build(stars, cutoffs, orders);
+    const std::vector<uint8_t> bytes = lightmap::serialize(maps);
+
+    std::ofstream out(output, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!out) {
+        std::cerr << "Failed to write " << output << std::endl;
+        return 1;
+    }
+
+    std::cout << "Wrote " << maps.size() << " light maps from " << stars.size()
+              << " stars to " << output << " (" << bytes.size() << " bytes)" << std::endl;
+    return 0;
+}
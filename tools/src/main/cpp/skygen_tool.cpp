@@ -0,0 +1,86 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "synthetic_sky.h"
+
+/**
+ * Generates a synthetic star catalog in the sky tile format, the standard
+ * input of the renderer and index benchmarks. The same --seed and --count
+ * always give the same file, whatever the thread count.
+ *
+ * Usage: skygen_tool --count <stars> --output <sky.tiles>
+ *                    [--seed 1] [--tile-order 3] [--clusters 0.02] [--threads 0]
+ *
+ * --clusters is the share of stars placed in clusters. The output is
+ * written through a memory map, so catalogs larger than memory work (1B
+ * stars is about 28 GB). --threads 0 uses every core.
+ */
+namespace {
+
+/** Create the output file at full size and map it for writing. */
+uint8_t* mapOutput(const char* path, size_t size) {
+    const int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return nullptr;
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        close(fd);
+        return nullptr;
+    }
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    return data == MAP_FAILED ? nullptr : static_cast<uint8_t*>(data);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    synthetic::Config config;
+    config.count = 0;
+    const char* output = nullptr;
+    unsigned threads = 0;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--count") == 0) config.count = std::strtoull(argv[i + 1], nullptr, 10);
+        else if (strcmp(argv[i], "--output") == 0) output = argv[i + 1];
+        else if (strcmp(argv[i], "--seed") == 0) config.seed = std::strtoull(argv[i + 1], nullptr, 10);
+        else if (strcmp(argv[i], "--tile-order") == 0) config.tileOrder = std::atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--clusters") == 0) config.clusterFraction = std::atof(argv[i + 1]);
+        else if (strcmp(argv[i], "--threads") == 0) threads = static_cast<unsigned>(std::atoi(argv[i + 1]));
+    }
+    if (config.count == 0 || output == nullptr || config.tileOrder < 0 ||
+        config.tileOrder > tiles::MAX_TILE_ORDER || config.clusterFraction < 0.0 || config.clusterFraction > 1.0) {
+        std::cerr << "Usage: skygen_tool --count <stars> --output <sky.tiles>"
+                     " [--seed 1] [--tile-order 3] [--clusters 0.02] [--threads 0]" << std::endl;
+        return 1;
+    }
+
+    const size_t size = tiles::fileSize(config.tileOrder, config.count);
+    uint8_t* out = mapOutput(output, size);
+    if (out == nullptr) {
+        std::cerr << "Failed to create " << output << " (" << size << " bytes)" << std::endl;
+        return 1;
+    }
+
+    jobs::Config jobConfig;
+    jobConfig.workerCount = threads;
+    jobConfig.pinWorkers = false;
+    jobs::JobSystem jobs(jobConfig);
+
+    const auto start = std::chrono::steady_clock::now();
+    synthetic::writeTiles(config, out, &jobs);
+    const bool synced = msync(out, size, MS_SYNC) == 0;
+    munmap(out, size);
+    if (!synced) {
+        std::cerr << "Failed to write " << output << std::endl;
+        return 1;
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Wrote " << config.count << " stars to magnitude " << synthetic::limitingMagnitude(config.count)
+              << " in " << tiles::tileCount(config.tileOrder) << " tiles to " << output << " (" << size
+              << " bytes, " << seconds << " s)" << std::endl;
+    return 0;
+}